@@ -0,0 +1,20 @@
+# Writes a program with n training regimens (awk -v n=50000 -f parse_bench.awk), to time the parsing with make parse-bench
+BEGIN {
+    print "/* Program generated for the parsing benchmark */"
+    print ""
+    print "total has this number of fans: 0"
+    for (i = 0; i < n; i++) {
+        print ""
+        print "Step" i " is starting their training with the famous x to increase their fame:"
+        print "    x joins " i " and hits x"
+        print "    x deals with 2 and hits x"
+        print "    x tosses away " i " and hits x"
+        print "    x is thrown out"
+        print "training is over"
+    }
+    print ""
+    print "The competition begins"
+    print "Step" (n - 1) " punches total with 21"
+    print "The ring girl shows the fans of total"
+    print "A time out is announced"
+}
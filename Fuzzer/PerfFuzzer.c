@@ -0,0 +1,537 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "ProgramGenerator.h"
+#include "../Utils/AST.h"
+#include "../Utils/Allocator.h"
+#include "../Parser-Bison/UF-C.tab.h"
+#include "../Translator/Translator.h"
+#include "../Interpreter/Interpreter.h"
+#include "../Optimizer/Optimizer.h"
+
+// Performance fuzzer : runs UF-C on generated programs of growing size (see ProgramGenerator.h), measuring the time of
+// each step and the memory of the program, and fits the exponent e of the cost growing as n^e with the size n.
+// A family of programs (one construct, or all of them mixed) whose cost grows faster than n^threshold is reported with
+// the smallest program showing it, written in the output directory. Each program is run in a child process, so that
+// a program overflowing the stack or running too long is reported too instead of stopping the fuzzer.
+
+// Steps of UF-C timed on each program, and the peak of the memory in use
+enum FuzzMeasure { measureParse, measureOptimize, measureTranslate, measureInterpret, measureMemory, FUZZ_MEASURE_COUNT };
+static const char* measureNames[FUZZ_MEASURE_COUNT] = { "parse", "optimize", "translate", "interpret", "memory" };
+
+enum FuzzStatus { fuzzPassed, fuzzParseError, fuzzTranslateError, fuzzInterpretError, fuzzCrashed, fuzzTimedOut };
+static const char* statusNames[] = { "passed", "parse error", "translation error", "interpretation error", "crashed", "timed out" };
+
+// Number of sizes, the largest ones, used to fit the exponent of a measure
+#define FIT_POINTS 4
+
+// Measures below these values are mostly noise and not used by the fits
+#define MEMORY_FLOOR (64 * 1024)
+
+// At most log2 of the largest size
+#define MAX_SWEEP_POINTS 32
+
+// Sweeps kept to be used again by the minimization of the reproducers
+#define SWEEP_CACHE_SIZE 64
+
+struct FuzzOptions {
+    unsigned seed;
+    int startSize;
+    int repeat;           // Runs of each program, the fastest one is kept
+    double maxTime;       // A family stops growing when a step takes longer (seconds)
+    double noiseFloor;    // Shortest time used by the fits (seconds)
+    double threshold;     // Exponent above which a measure is reported
+    int runTimeout;       // A run taking longer is stopped (seconds)
+    const char* outputDir;
+};
+
+struct FuzzRun {
+    int n;
+    enum FuzzStatus status;
+    int signal; // Signal that stopped the program when it crashed
+    double values[FUZZ_MEASURE_COUNT]; // Seconds, and bytes for the memory
+};
+
+struct FuzzSweep {
+    unsigned constructs;
+    struct FuzzRun runs[MAX_SWEEP_POINTS];
+    int runCount;
+};
+
+static struct FuzzSweep sweepCache[SWEEP_CACHE_SIZE];
+static int sweepCacheCount = 0;
+
+double ElapsedSeconds (struct timespec* start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) * 1e-9;
+}
+
+// Runs UF-C on the program in this process, the steps after a failing one are not run
+void MeasureProgram (unsigned constructs, int n, unsigned seed, struct FuzzRun* run) {
+    EnableAllocationTracking(0);
+
+    char* source = NULL;
+    size_t length = 0;
+    FILE* program = open_memstream(&source, &length);
+    FILE* devNull = fopen("/dev/null", "w");
+    if (program == NULL || devNull == NULL) {
+        run->status = fuzzCrashed;
+        return;
+    }
+    WriteProgram(program, constructs, n, seed);
+    fclose(program);
+
+    struct timespec start;
+    struct AstNode* ast = NULL;
+
+    FILE* input = fmemopen(source, length, "r");
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int error = input == NULL || ParseFile(input, devNull, &ast) != 0;
+    run->values[measureParse] = ElapsedSeconds(&start);
+    if (input != NULL)
+        fclose(input);
+    if (error) {
+        run->status = fuzzParseError;
+        return;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    OptimizeProgram(ast, NULL, 0, NULL);
+    run->values[measureOptimize] = ElapsedSeconds(&start);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    error = !TranslateAST(ast, devNull);
+    run->values[measureTranslate] = ElapsedSeconds(&start);
+    if (error) {
+        run->status = fuzzTranslateError;
+        return;
+    }
+
+    SetInterpreterOutput(devNull);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    error = !InterpreteProgram(ast);
+    run->values[measureInterpret] = ElapsedSeconds(&start);
+    if (error) {
+        run->status = fuzzInterpretError;
+        return;
+    }
+
+    size_t liveBytes, peakBytes;
+    GetAllocationStats(&liveBytes, &peakBytes);
+    run->values[measureMemory] = peakBytes;
+
+    FreeAST(ast);
+    fclose(devNull);
+    free(source);
+    run->status = fuzzPassed;
+}
+
+// Runs the program in a child process, whose output is thrown away
+void RunProgram (unsigned constructs, int n, struct FuzzOptions* options, struct FuzzRun* run) {
+    memset(run, 0, sizeof(struct FuzzRun));
+    run->n = n;
+
+    int results[2];
+    if (pipe(results) != 0) {
+        printf("Cannot create the pipe to run a program\n");
+        exit(1);
+    }
+    fflush(stdout);
+
+    pid_t child = fork();
+    if (child < 0) {
+        printf("Cannot start the process running a program\n");
+        exit(1);
+    }
+    if (child == 0) {
+        close(results[0]);
+        freopen("/dev/null", "w", stdout);
+        alarm(options->runTimeout);
+
+        MeasureProgram(constructs, n, options->seed, run);
+        ssize_t written = write(results[1], run, sizeof(struct FuzzRun));
+        _exit(written == sizeof(struct FuzzRun) ? 0 : 1);
+    }
+
+    close(results[1]);
+    ssize_t received = read(results[0], run, sizeof(struct FuzzRun));
+    close(results[0]);
+
+    int childStatus;
+    waitpid(child, &childStatus, 0);
+    if (WIFSIGNALED(childStatus)) {
+        run->signal = WTERMSIG(childStatus);
+        run->status = run->signal == SIGALRM ? fuzzTimedOut : fuzzCrashed;
+    }
+    else if (received != sizeof(struct FuzzRun))
+        run->status = fuzzCrashed;
+    run->n = n;
+}
+
+// Runs the program options->repeat times, keeping the fastest time of each step
+void MeasureSize (unsigned constructs, int n, struct FuzzOptions* options, struct FuzzRun* run) {
+    RunProgram(constructs, n, options, run);
+
+    for (int r = 1; r < options->repeat && run->status == fuzzPassed; r++) {
+        struct FuzzRun other;
+        RunProgram(constructs, n, options, &other);
+        if (other.status != fuzzPassed) {
+            *run = other;
+            break;
+        }
+        for (int m = 0; m < measureMemory; m++) {
+            if (other.values[m] < run->values[m])
+                run->values[m] = other.values[m];
+        }
+    }
+}
+
+int GetMaxSize (unsigned constructs) {
+    int maxSize = 1 << 30;
+    for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++) {
+        if ((constructs & (1u << c)) && GetConstructMaxSize(c) < maxSize)
+            maxSize = GetConstructMaxSize(c);
+    }
+    return maxSize;
+}
+
+// Doubles the size of the programs until a step takes longer than options->maxTime, the largest size is reached or a run fails
+// The sweeps already made for the same constructs are given again
+void Sweep (unsigned constructs, struct FuzzOptions* options, struct FuzzSweep* sweep) {
+    for (int i = 0; i < sweepCacheCount; i++) {
+        if (sweepCache[i].constructs == constructs) {
+            *sweep = sweepCache[i];
+            return;
+        }
+    }
+
+    int maxSize = GetMaxSize(constructs);
+
+    sweep->constructs = constructs;
+    sweep->runCount = 0;
+
+    for (int n = options->startSize; n <= maxSize && sweep->runCount < MAX_SWEEP_POINTS; n *= 2) {
+        struct FuzzRun* run = &sweep->runs[sweep->runCount++];
+        MeasureSize(constructs, n, options, run);
+        if (run->status != fuzzPassed)
+            break;
+
+        int slowest = 0;
+        for (int m = 0; m < measureMemory; m++)
+            slowest |= run->values[m] > options->maxTime;
+        if (slowest)
+            break;
+    }
+
+    if (sweepCacheCount < SWEEP_CACHE_SIZE)
+        sweepCache[sweepCacheCount++] = *sweep;
+}
+
+double MeasureFloor (enum FuzzMeasure measure, struct FuzzOptions* options) {
+    return measure == measureMemory ? MEMORY_FLOOR : options->noiseFloor;
+}
+
+// Fits log(value) = e * log(n) + c by least squares on the largest sizes that passed with a value above the noise
+// Returns 1 and writes e in *outExponent if there were enough of them, 0 otherwise
+int FitExponent (struct FuzzSweep* sweep, enum FuzzMeasure measure, struct FuzzOptions* options, double* outExponent) {
+    double xs[FIT_POINTS], ys[FIT_POINTS];
+    int count = 0;
+
+    for (int i = sweep->runCount - 1; i >= 0 && count < FIT_POINTS; i--) {
+        struct FuzzRun* run = &sweep->runs[i];
+        if (run->status != fuzzPassed || run->values[measure] < MeasureFloor(measure, options))
+            continue;
+        xs[count] = log(run->n);
+        ys[count] = log(run->values[measure]);
+        count++;
+    }
+    if (count < 3)
+        return 0;
+
+    double meanX = 0, meanY = 0;
+    for (int i = 0; i < count; i++) {
+        meanX += xs[i] / count;
+        meanY += ys[i] / count;
+    }
+    double covariance = 0, variance = 0;
+    for (int i = 0; i < count; i++) {
+        covariance += (xs[i] - meanX) * (ys[i] - meanY);
+        variance += (xs[i] - meanX) * (xs[i] - meanX);
+    }
+
+    *outExponent = covariance / variance;
+    return 1;
+}
+
+int IsSuperlinear (struct FuzzSweep* sweep, enum FuzzMeasure measure, struct FuzzOptions* options) {
+    double exponent;
+    return FitExponent(sweep, measure, options, &exponent) && exponent > options->threshold;
+}
+
+void WriteConstructNames (FILE* output, unsigned constructs) {
+    const char* separator = "";
+    for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++) {
+        if (constructs & (1u << c)) {
+            fprintf(output, "%s%s", separator, GetConstructName(c));
+            separator = "+";
+        }
+    }
+}
+
+void PrintSweep (const char* family, struct FuzzSweep* sweep, struct FuzzOptions* options) {
+    printf("%s\n%10s", family, "n");
+    for (int m = 0; m < FUZZ_MEASURE_COUNT; m++)
+        printf("%12s", measureNames[m]);
+    printf("\n");
+
+    for (int i = 0; i < sweep->runCount; i++) {
+        struct FuzzRun* run = &sweep->runs[i];
+        printf("%10d", run->n);
+        if (run->status != fuzzPassed) {
+            printf("  %s", statusNames[run->status]);
+            if (run->status == fuzzCrashed && run->signal != 0)
+                printf(" (%s)", strsignal(run->signal));
+            printf("\n");
+            continue;
+        }
+        for (int m = 0; m < measureMemory; m++)
+            printf("%12.6f", run->values[m]);
+        printf("%12.0f\n", run->values[measureMemory]);
+    }
+
+    printf("%10s", "exponent");
+    for (int m = 0; m < FUZZ_MEASURE_COUNT; m++) {
+        double exponent;
+        if (FitExponent(sweep, m, options, &exponent))
+            printf("%12.2f", exponent);
+        else
+            printf("%12s", "-");
+    }
+    printf("\n");
+}
+
+// Writes the program in the output directory, named after the family and what it shows
+// Returns the name of the file (to free), or NULL if it couldn't be written
+char* WriteReproducer (const char* family, const char* finding, unsigned constructs, int n, struct FuzzOptions* options) {
+    char* fileName = malloc(strlen(options->outputDir) + strlen(family) + strlen(finding) + 8);
+    if (fileName == NULL)
+        return NULL;
+    sprintf(fileName, "%s/%s-%s.ufc", options->outputDir, family, finding);
+
+    FILE* output = fopen(fileName, "w");
+    if (output == NULL) {
+        printf("Cannot create %s\n", fileName);
+        free(fileName);
+        return NULL;
+    }
+    WriteProgram(output, constructs, n, options->seed);
+    fclose(output);
+
+    return fileName;
+}
+
+// Finds the fewest constructs of a mixed program whose measure still grows faster than the threshold
+// Returns them, with their sweep in *outSweep
+unsigned MinimizeConstructs (struct FuzzSweep* sweep, enum FuzzMeasure measure, struct FuzzOptions* options, struct FuzzSweep* outSweep) {
+    *outSweep = *sweep;
+
+    // Usually a single construct shows it (the one growing the fastest is kept), and its family was already swept
+    double fastest = options->threshold;
+    for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++) {
+        if (sweep->constructs == (1u << c) || !(sweep->constructs & (1u << c)))
+            continue;
+
+        struct FuzzSweep single;
+        double exponent;
+        Sweep(1u << c, options, &single);
+        if (FitExponent(&single, measure, options, &exponent) && exponent > fastest) {
+            *outSweep = single;
+            fastest = exponent;
+        }
+    }
+    if (outSweep->constructs != sweep->constructs)
+        return outSweep->constructs;
+
+    // Otherwise the constructs are removed one by one, as long as the measure keeps growing as fast
+    for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++) {
+        unsigned fewer = outSweep->constructs & ~(1u << c);
+        if (fewer == outSweep->constructs || fewer == 0)
+            continue;
+
+        struct FuzzSweep candidate;
+        Sweep(fewer, options, &candidate);
+        if (IsSuperlinear(&candidate, measure, options))
+            *outSweep = candidate;
+    }
+
+    return outSweep->constructs;
+}
+
+// Smallest size of the sweep above the noise where doubling the size multiplies the measure by more than 2^threshold
+int FindReproducerSize (struct FuzzSweep* sweep, enum FuzzMeasure measure, struct FuzzOptions* options, double* outRatio) {
+    for (int i = 0; i + 1 < sweep->runCount; i++) {
+        struct FuzzRun* run = &sweep->runs[i];
+        struct FuzzRun* next = &sweep->runs[i + 1];
+        if (run->status != fuzzPassed || next->status != fuzzPassed || run->values[measure] < MeasureFloor(measure, options))
+            continue;
+
+        double ratio = next->values[measure] / run->values[measure];
+        if (ratio > pow(2, options->threshold)) {
+            *outRatio = ratio;
+            return run->n;
+        }
+    }
+
+    // The growth is only seen by the fit, the largest size that passed shows it best
+    int last = sweep->runCount - 1;
+    while (last > 0 && sweep->runs[last].status != fuzzPassed)
+        last--;
+    *outRatio = last > 0 ? sweep->runs[last].values[measure] / sweep->runs[last - 1].values[measure] : 0;
+    return sweep->runs[last].n;
+}
+
+// Finds the smallest size failing like the last run of the sweep, between the size before it (or 0) and its size
+int FindFailingSize (struct FuzzSweep* sweep, struct FuzzOptions* options) {
+    struct FuzzRun* failed = &sweep->runs[sweep->runCount - 1];
+    int passing = sweep->runCount > 1 ? sweep->runs[sweep->runCount - 2].n : 0;
+    int failing = failed->n;
+
+    while (failing - passing > 1) {
+        int middle = passing + (failing - passing) / 2;
+        struct FuzzRun run;
+        RunProgram(sweep->constructs, middle, options, &run);
+        if (run.status == failed->status)
+            failing = middle;
+        else
+            passing = middle;
+    }
+
+    return failing;
+}
+
+// Reports the measures of the family growing faster than linearly and its failure, if any
+// Returns the number of findings
+int ReportFindings (const char* family, struct FuzzSweep* sweep, struct FuzzOptions* options) {
+    int findings = 0;
+
+    for (int m = 0; m < FUZZ_MEASURE_COUNT; m++) {
+        double exponent;
+        if (!FitExponent(sweep, m, options, &exponent) || exponent <= options->threshold)
+            continue;
+        findings++;
+
+        struct FuzzSweep minimal;
+        unsigned constructs = MinimizeConstructs(sweep, m, options, &minimal);
+        FitExponent(&minimal, m, options, &exponent);
+
+        double ratio;
+        int n = FindReproducerSize(&minimal, m, options, &ratio);
+        char* fileName = WriteReproducer(family, measureNames[m], constructs, n, options);
+
+        printf("  %s grows as n^%.2f with ", measureNames[m], exponent);
+        WriteConstructNames(stdout, constructs);
+        printf(" : %s with n = %d, twice the size costs %.1f times more\n", fileName != NULL ? fileName : "(not written)", n, ratio);
+        free(fileName);
+    }
+
+    struct FuzzRun* last = &sweep->runs[sweep->runCount - 1];
+    if (last->status != fuzzPassed) {
+        findings++;
+
+        int n = FindFailingSize(sweep, options);
+        char* fileName = WriteReproducer(family, last->status == fuzzTimedOut ? "timeout" : "failure", sweep->constructs, n, options);
+        printf("  %s from n = %d : %s\n", statusNames[last->status], n, fileName != NULL ? fileName : "(not written)");
+        free(fileName);
+    }
+
+    return findings;
+}
+
+int FuzzFamily (const char* family, unsigned constructs, struct FuzzOptions* options) {
+    struct FuzzSweep sweep;
+    Sweep(constructs, options, &sweep);
+    PrintSweep(family, &sweep, options);
+
+    int findings = ReportFindings(family, &sweep, options);
+    printf("\n");
+    return findings;
+}
+
+int main(int argc, char* argv[]) {
+    struct FuzzOptions options = {
+        .seed = 1,
+        .startSize = 64,
+        .repeat = 3,
+        .maxTime = 0.5,
+        .noiseFloor = 0.001,
+        .threshold = 1.3,
+        .outputDir = "perf-fuzz",
+    };
+    const char* onlyFamily = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 == argc) {
+            printf("Error : %s needs a value\n", argv[i]);
+            return 1;
+        }
+
+        if (!strcmp(argv[i], "--family"))
+            onlyFamily = argv[i + 1];
+        else if (!strcmp(argv[i], "--seed"))
+            options.seed = strtoul(argv[i + 1], NULL, 10);
+        else if (!strcmp(argv[i], "--start-size"))
+            options.startSize = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--repeat"))
+            options.repeat = atoi(argv[i + 1]);
+        else if (!strcmp(argv[i], "--max-time"))
+            options.maxTime = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--threshold"))
+            options.threshold = atof(argv[i + 1]);
+        else if (!strcmp(argv[i], "--output-dir"))
+            options.outputDir = argv[i + 1];
+        else {
+            printf("Error : Unknown option %s\n", argv[i]);
+            return 1;
+        }
+        i++;
+    }
+
+    if (options.startSize <= 0 || options.repeat <= 0 || options.maxTime <= 0 || options.threshold <= 0) {
+        printf("Error : --start-size, --repeat, --max-time and --threshold need positive values\n");
+        return 1;
+    }
+    if (onlyFamily != NULL && strcmp(onlyFamily, "mix") && FindConstruct(onlyFamily) < 0) {
+        printf("Error : Unknown family %s (mix or one of the constructs :", onlyFamily);
+        for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++)
+            printf(" %s", GetConstructName(c));
+        printf(")\n");
+        return 1;
+    }
+    if (mkdir(options.outputDir, 0777) != 0 && errno != EEXIST) {
+        printf("Cannot create the directory %s\n", options.outputDir);
+        return 1;
+    }
+
+    // A run is stopped after many times the time a step can take before the family stops growing
+    options.runTimeout = (int) (options.maxTime * 20) + 10;
+
+    int findings = 0;
+    for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++) {
+        if (onlyFamily == NULL || !strcmp(onlyFamily, GetConstructName(c)))
+            findings += FuzzFamily(GetConstructName(c), 1u << c, &options);
+    }
+    if (onlyFamily == NULL || !strcmp(onlyFamily, "mix"))
+        findings += FuzzFamily("mix", ALL_PROGRAM_CONSTRUCTS, &options);
+
+    printf("%d finding%s, seed %u\n", findings, findings == 1 ? "" : "s", options.seed);
+    return findings > 0 ? 1 : 0;
+}
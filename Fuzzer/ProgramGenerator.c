@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "ProgramGenerator.h"
+
+// Writes the definitions of the construct (fighters and regimens) and its lines of the main phase
+typedef void (*ConstructWriter)(FILE* output, int n, unsigned seed);
+
+struct ConstructInfo {
+    const char* name;
+    int maxSize;
+    ConstructWriter writeDefinitions;
+    ConstructWriter writeMain;
+};
+
+// Choice number draw for the i-th repetition of a construct, the same whatever the other constructs of the program
+unsigned Draw (unsigned seed, enum ProgramConstruct construct, int i, unsigned draw) {
+    unsigned x = seed * 0x9E3779B1u ^ (construct + 1) * 0x85EBCA77u ^ (unsigned) i * 0xC2B2AE3Du ^ draw * 0x27D4EB2Fu;
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// Operation keeping a famous fighter small, whatever the number of times it is done
+void WriteUpdate (FILE* output, const char* fighter, unsigned choice) {
+    static const char* operations[] = { "joins", "tosses away", "deals with" };
+    const char* operation = operations[choice % 3];
+    fprintf(output, "%s %s %u and hits %s\n", fighter, operation, choice % 3 == 2 ? 1 : (choice >> 2) % 100, fighter);
+}
+
+// Argument of a call : the shared famous fighter or a famous constant
+void WriteCallArgument (FILE* output, unsigned choice) {
+    if (choice & 1)
+        fprintf(output, "acc\n");
+    else
+        fprintf(output, "%u\n", (choice >> 1) % 100);
+}
+
+// Loop running until counter reaches goal, counting from below : both conditions give the same rounds
+void WriteLoop (FILE* output, const char* goal, const char* counter, const char* regimen, unsigned choice) {
+    fprintf(output, "%s beats down %s %s\n", goal, counter, (choice & 1) ? "until they fight back" : "until they come to an agreement");
+    fprintf(output, "Meanwhile %s enrolls noone\n", regimen);
+}
+
+/*************************** Fighters ***************************/
+
+void WriteFightersDefinitions (FILE* output, int n, unsigned seed) {
+    for (int i = 0; i < n; i++) {
+        unsigned choice = Draw(seed, constructFighters, i, 0);
+        if (choice & 1)
+            fprintf(output, "Fighter%d has an IQ of %u.5\n", i, (choice >> 1) % 100);
+        else
+            fprintf(output, "Fighter%d has this number of fans: %u\n", i, (choice >> 1) % 100);
+    }
+    fprintf(output, "\n");
+}
+
+void WriteFightersMain (FILE* output, int n, unsigned seed) {
+    for (int i = 0; i < n; i++) {
+        unsigned choice = Draw(seed, constructFighters, i, 0);
+        if (choice & 1)
+            fprintf(output, "iq joins Fighter%d and hits iq\n", i);
+        else
+            fprintf(output, "acc joins Fighter%d and hits acc\n", i);
+    }
+}
+
+/*************************** Regimens ***************************/
+
+void WriteRegimensDefinitions (FILE* output, int n, unsigned seed) {
+    for (int i = 0; i < n; i++) {
+        fprintf(output, "Regimen%d is starting their training with the famous x to increase their fame:\n    ", i);
+        WriteUpdate(output, "x", Draw(seed, constructRegimens, i, 0));
+        fprintf(output, "    x is thrown out\ntraining is over\n\n");
+    }
+}
+
+void WriteRegimensMain (FILE* output, int n, unsigned seed) {
+    for (int i = 0; i < n; i++) {
+        fprintf(output, "Regimen%d punches acc with ", i);
+        WriteCallArgument(output, Draw(seed, constructRegimens, i, 1));
+    }
+}
+
+/*************************** Call chain ***************************/
+
+void WriteCallChainDefinitions (FILE* output, int n, unsigned seed) {
+    // The regimen called is defined before the one calling it
+    for (int i = n - 1; i >= 0; i--) {
+        fprintf(output, "Chain%d is starting their training with the famous x to increase their fame:\n", i);
+        if (i < n - 1)
+            fprintf(output, "    Chain%d punches x with x\n", i + 1);
+        fprintf(output, "    ");
+        WriteUpdate(output, "x", Draw(seed, constructCallChain, i, 0));
+        fprintf(output, "    x is thrown out\ntraining is over\n\n");
+    }
+}
+
+void WriteCallChainMain (FILE* output, int n, unsigned seed) {
+    (void) n; // Chain0 calls the n others
+    fprintf(output, "Chain0 punches acc with ");
+    WriteCallArgument(output, Draw(seed, constructCallChain, 0, 1));
+}
+
+/*************************** Tournament ***************************/
+
+void WriteTournamentMain (FILE* output, int n, unsigned seed) {
+    fprintf(output, "A new tournament begins :\n");
+    // Only the last match is won, so that all the bets are looked at
+    for (int i = 1; i < n; i++)
+        fprintf(output, "-Match %d: %u challenges big\n", i, Draw(seed, constructTournament, i, 0) % 1000000);
+    fprintf(output, "-Match %d: big challenges %u\n", n, Draw(seed, constructTournament, n, 0) % 1000000);
+
+    fprintf(output, "And the gambling den opens :\n");
+    for (int i = 1; i <= n; i++)
+        fprintf(output, "-Bump bets on %d using acc and gives the money to acc\n", i);
+    fprintf(output, "Finally Bump takes the rest of the bets using acc and gives the money to acc\n");
+    fprintf(output, "The gambling den closes\n");
+}
+
+/*************************** Body ***************************/
+
+void WriteBodyDefinitions (FILE* output, int n, unsigned seed) {
+    fprintf(output, "Drill is starting their training with the famous x to increase their fame:\n");
+    for (int i = 0; i < n; i++) {
+        fprintf(output, "    ");
+        WriteUpdate(output, "x", Draw(seed, constructBody, i, 0));
+    }
+    fprintf(output, "    x is thrown out\ntraining is over\n\n");
+}
+
+void WriteBodyMain (FILE* output, int n, unsigned seed) {
+    (void) n; // The n lines are in the definition of Drill
+    fprintf(output, "Drill punches acc with ");
+    WriteCallArgument(output, Draw(seed, constructBody, 0, 1));
+}
+
+/*************************** Expression ***************************/
+
+void WriteExpressionMain (FILE* output, int n, unsigned seed) {
+    fprintf(output, "acc");
+    for (int i = 0; i < n; i++) {
+        unsigned choice = Draw(seed, constructExpression, i, 0);
+        fprintf(output, " %s %u", (choice & 1) ? "joins" : "tosses away", (choice >> 1) % 100);
+    }
+    fprintf(output, " and hits acc\n");
+}
+
+/*************************** Joins ***************************/
+
+void WriteJoinsDefinitions (FILE* output, int n, unsigned seed) {
+    static const char* pieces[] = { "a", "bc", "def" };
+
+    fprintf(output, "text announces \"%s\"\n", pieces[Draw(seed, constructJoins, 0, 0) % 3]);
+    fprintf(output, "joinsDone has this number of fans: 0\n");
+    fprintf(output, "joinsGoal has this number of fans: %d\n\n", n);
+
+    fprintf(output, "Grow is starting their training with noone to increase their effectiveness:\n");
+    fprintf(output, "    text joins \"%s\" and hits text\n", pieces[Draw(seed, constructJoins, 0, 1) % 3]);
+    fprintf(output, "    joinsDone joins 1 and hits joinsDone\n");
+    fprintf(output, "training is over\n\n");
+}
+
+void WriteJoinsMain (FILE* output, int n, unsigned seed) {
+    (void) n; // joinsGoal is n
+    WriteLoop(output, "joinsGoal", "joinsDone", "Grow", Draw(seed, constructJoins, 0, 2));
+    fprintf(output, "The ring girl shows the flow of text\n");
+    fprintf(output, "A time out is announced\n");
+}
+
+/*************************** Main lines ***************************/
+
+void WriteMainLinesMain (FILE* output, int n, unsigned seed) {
+    for (int i = 0; i < n; i++) {
+        unsigned choice = Draw(seed, constructMainLines, i, 0);
+        switch (choice % 4) {
+            case 0:
+                fprintf(output, "The ring girl shows the fans of acc\n");
+                break;
+            case 1:
+                fprintf(output, "iq deals with 1.0 and hits iq\n");
+                break;
+            default:
+                WriteUpdate(output, "acc", choice >> 2);
+                break;
+        }
+    }
+    fprintf(output, "A time out is announced\n");
+}
+
+/*************************** Rounds ***************************/
+
+void WriteRoundsDefinitions (FILE* output, int n, unsigned seed) {
+    fprintf(output, "ticks has this number of fans: 0\n");
+    fprintf(output, "ticksGoal has this number of fans: %d\n\n", n);
+
+    fprintf(output, "Tick is starting their training with noone to increase their effectiveness:\n");
+    fprintf(output, "    ticks joins 1 and hits ticks\n    ");
+    WriteUpdate(output, "acc", Draw(seed, constructRounds, 0, 0));
+    fprintf(output, "training is over\n\n");
+}
+
+void WriteRoundsMain (FILE* output, int n, unsigned seed) {
+    (void) n; // ticksGoal is n
+    WriteLoop(output, "ticksGoal", "ticks", "Tick", Draw(seed, constructRounds, 0, 1));
+}
+
+/*************************** Team ***************************/
+
+void WriteTeamDefinitions (FILE* output, int n, unsigned seed) {
+    (void) seed; // The team operations are drawn in the main phase
+    fprintf(output, "Squad has a team of %d famous fighters\n", n);
+    fprintf(output, "Rival has a team of %d famous fighters\n\n", n);
+}
+
+void WriteTeamMain (FILE* output, int n, unsigned seed) {
+    fprintf(output, "%u hits Rival\n", Draw(seed, constructTeam, 0, 0) % 10);
+    fprintf(output, "Squad joins Rival and hits Squad\n");
+    fprintf(output, "Squad deals with 3 and hits Squad\n");
+    fprintf(output, "the strength of the team Squad hits acc\n");
+    fprintf(output, "Squad spars with Rival and hits acc\n");
+    fprintf(output, "the fighter %u of the team Squad hits acc\n", Draw(seed, constructTeam, 0, 1) % (unsigned) n);
+}
+
+// Indexed by enum ProgramConstruct
+static const struct ConstructInfo constructs[PROGRAM_CONSTRUCT_COUNT] = {
+    { "fighters", 1 << 20, WriteFightersDefinitions, WriteFightersMain },
+    { "regimens", 1 << 20, WriteRegimensDefinitions, WriteRegimensMain },
+    { "chain", 1 << 12, WriteCallChainDefinitions, WriteCallChainMain },
+    { "tournament", 1 << 20, NULL, WriteTournamentMain },
+    { "body", 1 << 20, WriteBodyDefinitions, WriteBodyMain },
+    { "expression", 1 << 14, NULL, WriteExpressionMain },
+    { "joins", 1 << 22, WriteJoinsDefinitions, WriteJoinsMain },
+    { "lines", 1 << 22, NULL, WriteMainLinesMain },
+    { "rounds", 1 << 24, WriteRoundsDefinitions, WriteRoundsMain },
+    { "team", 1 << 24, WriteTeamDefinitions, WriteTeamMain },
+};
+
+const char* GetConstructName(enum ProgramConstruct construct) {
+    return constructs[construct].name;
+}
+
+int FindConstruct(const char* name) {
+    for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++) {
+        if (!strcmp(constructs[c].name, name))
+            return c;
+    }
+    return -1;
+}
+
+int GetConstructMaxSize(enum ProgramConstruct construct) {
+    return constructs[construct].maxSize;
+}
+
+void WriteProgram(FILE* output, unsigned constructMask, int n, unsigned seed) {
+    fprintf(output, "/* Program generated by the performance fuzzer (n = %d, seed %u) :", n, seed);
+    for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++) {
+        if (constructMask & (1u << c))
+            fprintf(output, " %s", constructs[c].name);
+    }
+    fprintf(output, " */\n\n");
+
+    // Fighters and regimen used by all the constructs
+    fprintf(output, "acc has this number of fans: 0\n");
+    fprintf(output, "iq has an IQ of 0.0\n");
+    fprintf(output, "big has this number of fans: 1000000000\n\n");
+    fprintf(output, "Bump is starting their training with the famous x to increase their fame:\n");
+    fprintf(output, "    x joins 1 and hits x\n");
+    fprintf(output, "    x is thrown out\n");
+    fprintf(output, "training is over\n\n");
+
+    for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++) {
+        if ((constructMask & (1u << c)) && constructs[c].writeDefinitions != NULL)
+            constructs[c].writeDefinitions(output, n, seed);
+    }
+
+    fprintf(output, "And the competition begins\n\n");
+
+    for (int c = 0; c < PROGRAM_CONSTRUCT_COUNT; c++) {
+        if (constructMask & (1u << c))
+            constructs[c].writeMain(output, n, seed);
+    }
+
+    fprintf(output, "The ring girl shows the fans of acc\n");
+    fprintf(output, "A time out is announced\n");
+}
@@ -0,0 +1,39 @@
+#ifndef __PROGRAM_GENERATOR_H__
+#define __PROGRAM_GENERATOR_H__
+
+#include <stdio.h>
+
+// Writes valid UF-C programs whose size is given by a number n, for the performance fuzzer (see PerfFuzzer.c).
+// A program is made of constructs, each one following a rule of the grammar (UF-C.y) that the program repeats n times :
+// n fighters, n regimens, a tournament of n matches... The other choices (operations, constants, types, call arguments, loop conditions) are drawn
+// from the seed, and the same seed gives the same choices for every n, so that only the size changes from a program to the next.
+
+enum ProgramConstruct {
+    constructFighters,   // varDef : n fighters, each one read by a main line (lookups in the global symbol table)
+    constructRegimens,   // function_def : n regimens, each one called once by the main phase
+    constructCallChain,  // func_call : n regimens calling each other, n calls deep
+    constructTournament, // test : one tournament of n matches and n bets, only the last one taken
+    constructBody,       // body_lines : one regimen of n lines
+    constructExpression, // exp : one assignment of n operands
+    constructJoins,      // exp on strings : a loop of n rounds joining a string at the end of a fighter
+    constructMainLines,  // main_lines : n lines in the main phase
+    constructRounds,     // while_loop : a loop of n rounds
+    constructTeam,       // varDef of a team : operations on a team of n fighters
+    PROGRAM_CONSTRUCT_COUNT
+};
+
+// Mask of all the constructs, for a program mixing them
+#define ALL_PROGRAM_CONSTRUCTS ((1u << PROGRAM_CONSTRUCT_COUNT) - 1)
+
+const char* GetConstructName(enum ProgramConstruct construct);
+
+// Returns the construct named name, or -1 if there is none
+int FindConstruct(const char* name);
+
+// Largest n for a construct (the ones nesting n deep would overflow the stack of the interpreter before showing their cost)
+int GetConstructMaxSize(enum ProgramConstruct construct);
+
+// Writes the program repeating n times each construct of the mask constructs (one bit per construct)
+void WriteProgram(FILE* output, unsigned constructs, int n, unsigned seed);
+
+#endif
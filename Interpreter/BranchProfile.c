@@ -0,0 +1,157 @@
+#include <stdio.h>
+
+#include "BranchProfile.h"
+#include "Interpreter.h"
+
+// Profiling options, set once before any program is run
+static int branchReordering = 0;
+static int branchStatsEnabled = 0;
+
+void SetBranchProfiling(int adaptive, int printStats)
+{
+    branchReordering = adaptive;
+    branchStatsEnabled = printStats;
+}
+
+int IsBranchProfiling()
+{
+    return branchReordering || branchStatsEnabled;
+}
+
+int IsBranchReordering()
+{
+    return branchReordering;
+}
+
+void RecordBranch (struct AstNode* ast, int result) {
+    ast->evaluationCount++;
+    if (result)
+        ast->trueCount++;
+}
+
+// Cost of reading a member of a match, 0 if it is not a fighter nor a constant
+int ValueCost (struct AstNode* value) {
+    switch (value->type) {
+        case atConstant:
+            return 1;
+        case atId: // Found in a symbol table
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+int ConditionCost (struct AstNode* condition, struct Comparisons_Dict* comparisons) {
+    switch (condition->type) {
+        case atLogicalOr:
+        case atLogicalAnd:
+        {
+            int cost1 = ConditionCost(condition->child1, comparisons);
+            int cost2 = ConditionCost(condition->child2, comparisons);
+            return cost1 > 0 && cost2 > 0 ? cost1 + cost2 : 0;
+        }
+        case atComparisonId:
+        {
+            struct ComparisonValue* comparison;
+            if (!TryFind_ComparisonsDict(comparisons, condition->i, &comparison))
+                return 0;
+
+            int cost1 = ValueCost(comparison->value1);
+            int cost2 = ValueCost(comparison->value2);
+            return cost1 > 0 && cost2 > 0 ? cost1 + cost2 : 0;
+        }
+        default:
+            return 0;
+    }
+}
+
+// Average cost of the member for each time it decides the result of the and/or, -1 if it never did
+double DecisionCost (enum AstType logicalType, struct AstNode* member, int cost) {
+    unsigned long decisions = logicalType==atLogicalOr ? member->trueCount : member->evaluationCount - member->trueCount;
+    if (decisions == 0)
+        return -1;
+
+    return (double) cost * member->evaluationCount / decisions;
+}
+
+// Returns 1 if the order of the and/or whose first member is first must be checked again
+int IsReorderDue (struct AstNode* first) {
+    return branchReordering && first->evaluationCount > 0 && first->evaluationCount % REORDER_PERIOD == 0;
+}
+
+int ShouldSwapConditions (enum AstType logicalType, struct AstNode* first, int firstCost, struct AstNode* second, int secondCost) {
+    if (!IsReorderDue(first) || firstCost == 0 || secondCost == 0 || second->evaluationCount == 0)
+        return 0;
+
+    double firstDecisionCost = DecisionCost(logicalType, first, firstCost);
+    double secondDecisionCost = DecisionCost(logicalType, second, secondCost);
+    if (secondDecisionCost < 0)
+        return 0;
+
+    // The second one must be clearly better, so that two members as good as each other are not swapped back and forth
+    return firstDecisionCost < 0 || 10 * secondDecisionCost < 9 * firstDecisionCost;
+}
+
+int ShouldReorderCondition (struct AstNode* logical, struct Comparisons_Dict* comparisons) {
+    // The costs are only computed when the order is checked
+    if (!IsReorderDue(logical->child1))
+        return 0;
+
+    return ShouldSwapConditions(logical->type, logical->child1, ConditionCost(logical->child1, comparisons),
+        logical->child2, ConditionCost(logical->child2, comparisons));
+}
+
+// Prints the matches of the condition in the order they are evaluated
+void PrintConditionStats (struct AstNode* condition, FILE* output) {
+    if (condition->type == atLogicalOr || condition->type == atLogicalAnd) {
+        PrintConditionStats(condition->child1, output);
+        fprintf(output, "        %s\n", condition->type == atLogicalOr ? "or" : "and");
+        PrintConditionStats(condition->child2, output);
+        return;
+    }
+
+    fprintf(output, "        match %d : true %lu times out of %lu\n", condition->i, condition->trueCount, condition->evaluationCount);
+}
+
+// A branch is taken when its condition is true, and the rest of the bets when the condition of the last branch is false
+void PrintTestStats (struct AstNode* test, FILE* output) {
+    fprintf(output, "Tournament at line %d\n", test->lineNumInCode);
+
+    unsigned long restCount = 0;
+    for (struct AstNode* branches = test->child2; branches != NULL; branches = branches->child2) {
+        struct AstNode* branch = branches->child1;
+
+        if (branch->type == atTestElseBranch) {
+            fprintf(output, "    rest of the bets at line %d : taken %lu times\n", branch->lineNumInCode, restCount);
+            continue;
+        }
+
+        struct AstNode* condition = branch->child1;
+        fprintf(output, "    bets at line %d : taken %lu times out of %lu\n", branch->lineNumInCode, condition->trueCount, condition->evaluationCount);
+        PrintConditionStats(condition, output);
+        restCount = condition->evaluationCount - condition->trueCount;
+    }
+}
+
+// Prints the tournaments found in the node and its children
+void PrintNodeBranchStats (struct AstNode* ast, FILE* output) {
+    if (ast == NULL)
+        return;
+
+    if (ast->type == atTest) {
+        if (ast->child2 != NULL && ast->child2->child1->child1->evaluationCount > 0)
+            PrintTestStats(ast, output);
+        return;
+    }
+
+    PrintNodeBranchStats(ast->child1, output);
+    PrintNodeBranchStats(ast->child2, output);
+    PrintNodeBranchStats(ast->child3, output);
+}
+
+void PrintBranchStats (struct AstNode* ast) {
+    if (!branchStatsEnabled)
+        return;
+
+    PrintNodeBranchStats(ast, GetInterpreterOutput());
+}
@@ -0,0 +1,42 @@
+#ifndef __BRANCH_PROFILE_H__
+#define __BRANCH_PROFILE_H__
+
+#include "../Utils/AST.h"
+#include "../Utils/ComparisonDictionnary.h"
+
+// Profile of the tournaments, kept in the nodes of the AST (evaluationCount and trueCount) :
+// the condition of every branch, and every member of an and/or, counts how many times it was evaluated and found true.
+//
+// In the adaptive mode, every REORDER_PERIOD evaluations of an and/or, its two members are swapped if the second one costs less
+// for how often it decides the result on its own (true for an or, false for an and), the first one being skipped when it doesn't.
+// Only the members made of matches between fighters and constants are swapped : they can't fail nor change anything,
+// so the result of the condition doesn't depend on their order.
+// The AST is changed by the swaps, so the adaptive mode must not be used when threads run the same AST.
+
+#define REORDER_PERIOD 256
+
+// Sets whether the tournaments are profiled and reordered (disabled by default), and whether the profile is printed at the end of each program
+// The profile is kept as soon as one of them is set
+void SetBranchProfiling(int adaptive, int printStats);
+int IsBranchProfiling();
+int IsBranchReordering();
+
+// Counts an evaluation of the condition of a branch, or of a member of an and/or, with its result
+void RecordBranch (struct AstNode* ast, int result);
+
+// Returns the cost of evaluating the condition (the number of fighters and constants to read), or 0 if its members can't be swapped
+// The matches are found in comparisons
+int ConditionCost (struct AstNode* condition, struct Comparisons_Dict* comparisons);
+
+// Returns 1 if, in adaptive mode, the second member of the and/or (of type logicalType) should now be evaluated first
+// The costs are the ones given by ConditionCost, and it is only checked every REORDER_PERIOD evaluations of the first member
+int ShouldSwapConditions (enum AstType logicalType, struct AstNode* first, int firstCost, struct AstNode* second, int secondCost);
+
+// Same as ShouldSwapConditions for the members of the and/or logical, whose matches are found in comparisons
+int ShouldReorderCondition (struct AstNode* logical, struct Comparisons_Dict* comparisons);
+
+// Prints how often every branch of the tournaments of the program (ast is the atRoot) was taken, and every match found true,
+// if it was asked with SetBranchProfiling
+void PrintBranchStats (struct AstNode* ast);
+
+#endif
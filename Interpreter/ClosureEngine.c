@@ -0,0 +1,1242 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "ClosureEngine.h"
+#include "Interpreter.h"
+#include "BranchProfile.h"
+#include "../Utils/InputReader.h"
+#include "../Utils/ComparisonDictionnary.h"
+#include "../Utils/Allocator.h"
+
+#define ClosureError(msg) ClosureError_Expand(msg, closure->lineNumInCode)
+
+void ClosureError_Expand(char* error_msg, const int lineInCode)
+{
+    fprintf(GetInterpreterOutput(), "Error at line %d (closure engine) : %s\n", lineInCode, error_msg);
+}
+
+// Value computed by a closure
+// s is never owned by the value : it points to a fighter, a constant of the AST or the scratch string of a closure
+struct ClosureValue {
+    enum VariableType type;
+    int i;
+    float f;
+    char* s;
+};
+
+struct Closure;
+
+// Runs the closure and writes the value it computes in out (unused for the statements)
+// Returns 0 if there was an error, 1 otherwise
+typedef int (*ClosureHandler) (struct Closure* closure, struct ClosureValue* out);
+
+// A training regimen compiled to closures
+struct ClosureFunction {
+    struct VariableStruct* function;
+
+    // Fighters of the arguments, in the order of the call
+    int argCount;
+    struct VariableStruct** args;
+
+    // Statements before the return, and value returned (NULL if the regimen has no return)
+    struct Closure* body;
+    struct Closure* returnValue;
+
+    struct ClosureFunction* next;
+};
+
+struct Closure {
+    ClosureHandler handler;
+    int lineNumInCode;
+    // Type of the computed value if it is known before running, noType otherwise
+    enum VariableType type;
+
+    // Sub-expressions, fighter used and constant value
+    struct Closure* operand1;
+    struct Closure* operand2;
+    struct VariableStruct* variable;
+    struct ClosureValue constant;
+    // Comparator of a comparison, or operation (atAdd, atMinus, ...) of an arithmetic closure
+    enum ComparatorType comparator;
+    enum AstType operation;
+
+    // Statements of a list, values of the arguments of a call, or conditions of the branches of a test (NULL for the else branch)
+    int count;
+    struct Closure** list;
+    // Bodies of the branches of a test
+    struct Closure** branches;
+
+    struct ClosureFunction* callee;
+
+    // Cost of a condition of a test, 0 if its members can't be swapped (see BranchProfile.h)
+    int conditionCost;
+
+    // Node run by the tree interpreter, with the symbol tables to use
+    struct AstNode* ast;
+    struct HashStruct* globalSymbolTable;
+    struct HashStruct* localSymbolTable;
+
+    // String built by the closure (concatenation, or string given by the tree interpreter)
+    char* scratch;
+
+    // All the closures of an engine are chained to be freed together
+    struct Closure* nextAllocated;
+};
+
+struct ClosureEngine {
+    struct HashStruct* globalSymbolTable;
+    // Arguments of the training regimen being compiled, NULL for the main phase
+    struct HashStruct* localSymbolTable;
+    // Comparisons of the test being compiled
+    struct Comparisons_Dict* comparisons;
+
+    struct ClosureFunction* functions;
+    struct Closure* allocated;
+};
+
+
+/******************************* Helpers **************************************/
+
+struct Closure* NewClosure (struct ClosureEngine* engine, ClosureHandler handler, struct AstNode* ast) {
+    struct Closure* closure = UfcCalloc(1, sizeof(struct Closure));
+    if (closure==NULL) {
+        printf("Memory error : cannot allocate memory to a new closure\n");
+        exit(1);
+    }
+
+    closure->handler = handler;
+    closure->lineNumInCode = ast!=NULL ? ast->lineNumInCode : 0;
+    closure->type = noType;
+    closure->ast = ast;
+    closure->globalSymbolTable = engine->globalSymbolTable;
+    closure->localSymbolTable = engine->localSymbolTable;
+
+    closure->nextAllocated = engine->allocated;
+    engine->allocated = closure;
+
+    return closure;
+}
+
+struct Closure** NewClosureList (int count) {
+    // One more element so that the allocation is never empty
+    struct Closure** list = UfcCalloc(count + 1, sizeof(struct Closure*));
+    if (list==NULL) {
+        printf("Memory error : cannot allocate memory to a list of closures\n");
+        exit(1);
+    }
+
+    return list;
+}
+
+void FreeClosureEngine (struct ClosureEngine* engine) {
+    while (engine->allocated!=NULL) {
+        struct Closure* next = engine->allocated->nextAllocated;
+        UfcFree(engine->allocated->list);
+        UfcFree(engine->allocated->branches);
+        UfcFree(engine->allocated->scratch);
+        UfcFree(engine->allocated);
+        engine->allocated = next;
+    }
+
+    while (engine->functions!=NULL) {
+        struct ClosureFunction* next = engine->functions->next;
+        UfcFree(engine->functions->args);
+        UfcFree(engine->functions);
+        engine->functions = next;
+    }
+}
+
+// Looks for the fighter in the arguments of the regimen being compiled, then in the global symbol table, like GetSymbolValue
+struct VariableStruct* FindFighter (struct ClosureEngine* engine, char* id) {
+    struct VariableStruct* varStruct;
+    if ((engine->localSymbolTable!=NULL && TryFind_Hashtable(engine->localSymbolTable, id, &varStruct))
+        || TryFind_Hashtable(engine->globalSymbolTable, id, &varStruct))
+        return varStruct;
+
+    return NULL;
+}
+
+// Returns 1 if the node uses a team, so that it must be run by the tree interpreter
+int UsesTeams (struct ClosureEngine* engine, struct AstNode* ast) {
+    if (ast==NULL)
+        return 0;
+
+    if (ast->type==atTeamElement || ast->type==atTeamSize || ast->type==atTeamSum || ast->type==atTeamDot || ast->type==atPrintTeam)
+        return 1;
+
+    if (ast->type==atId) {
+        struct VariableStruct* fighter = FindFighter(engine, ast->s);
+        if (fighter!=NULL && fighter->team!=NULL)
+            return 1;
+    }
+
+    return UsesTeams(engine, ast->child1) || UsesTeams(engine, ast->child2) || UsesTeams(engine, ast->child3);
+}
+
+// Copies the value in the fighter, if they have the same type
+int AssignValue (struct Closure* closure, struct VariableStruct* fighter, struct ClosureValue* value) {
+    if (fighter->type != value->type) {
+        ClosureError("Type of the variable not matching the type of the other hand of the assignment");
+        return 0;
+    }
+
+    switch (fighter->type) {
+        case integer:
+            fighter->i = value->i;
+            break;
+        case floating:
+            fighter->f = value->f;
+            break;
+        case characters:
+            if (fighter->s!=value->s && !StrFreeAndCopy(&fighter->s, value->s)) {
+                ClosureError("Error while copying the string to assign");
+                return 0;
+            }
+            break;
+        default:
+            ClosureError("Impossible to assign this type of variable");
+            return 0;
+    }
+
+    return 1;
+}
+
+// Runs both operands of the closure
+int EvaluateOperands (struct Closure* closure, struct ClosureValue* a, struct ClosureValue* b) {
+    return closure->operand1->handler(closure->operand1, a) && closure->operand2->handler(closure->operand2, b);
+}
+
+
+/***************************** Values ****************************************/
+
+int ConstantHandler (struct Closure* closure, struct ClosureValue* out) {
+    *out = closure->constant;
+    return 1;
+}
+
+int VariableHandler (struct Closure* closure, struct ClosureValue* out) {
+    out->type = closure->variable->type;
+    out->i = closure->variable->i;
+    out->f = closure->variable->f;
+    out->s = closure->variable->s;
+    return 1;
+}
+
+// Value computed by the tree interpreter
+int InterpretedValueHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ValueHolder* holder;
+    if (!CreateValueHolder(&holder))
+        return 0;
+
+    if (!InterpreteAST(closure->ast, holder, closure->globalSymbolTable, closure->localSymbolTable, NULL, NULL, NULL, NULL)
+        || (closure->ast->type==atId && !GetSymbolValue(holder->s, &holder, closure->globalSymbolTable, closure->localSymbolTable))) {
+        FreeValueHolder(holder);
+        return 0;
+    }
+
+    if (IsTeamType(holder->variableType)) {
+        ClosureError("A team can't be used as a single fighter");
+        FreeValueHolder(holder);
+        return 0;
+    }
+
+    out->type = holder->variableType;
+    out->i = holder->i;
+    out->f = holder->f;
+    out->s = NULL;
+
+    // The string of the holder is freed with it, so it is kept in the scratch string of the closure
+    if (holder->variableType==characters) {
+        UfcFree(closure->scratch);
+        closure->scratch = holder->s;
+        holder->s = NULL;
+        out->s = closure->scratch;
+    }
+
+    FreeValueHolder(holder);
+    return 1;
+}
+
+
+/*************************** Arithmetic **************************************/
+
+// Operations with the types of both operands known when compiling
+#define ARITHMETIC_HANDLER(name, resultType, resultField, expression) \
+    int name (struct Closure* closure, struct ClosureValue* out) { \
+        struct ClosureValue a, b; \
+        if (!EvaluateOperands(closure, &a, &b)) \
+            return 0; \
+        *out = (struct ClosureValue) { resultType, 0, 0, NULL }; \
+        out->resultField = expression; \
+        return 1; \
+    }
+
+ARITHMETIC_HANDLER(AddIntInt, integer, i, a.i + b.i)
+ARITHMETIC_HANDLER(AddIntFloat, floating, f, a.i + b.f)
+ARITHMETIC_HANDLER(AddFloatInt, floating, f, a.f + b.i)
+ARITHMETIC_HANDLER(AddFloatFloat, floating, f, a.f + b.f)
+ARITHMETIC_HANDLER(MinusIntInt, integer, i, a.i - b.i)
+ARITHMETIC_HANDLER(MinusIntFloat, floating, f, a.i - b.f)
+ARITHMETIC_HANDLER(MinusFloatInt, floating, f, a.f - b.i)
+ARITHMETIC_HANDLER(MinusFloatFloat, floating, f, a.f - b.f)
+ARITHMETIC_HANDLER(MultiplyIntInt, integer, i, a.i * b.i)
+ARITHMETIC_HANDLER(MultiplyIntFloat, floating, f, a.i * b.f)
+ARITHMETIC_HANDLER(MultiplyFloatInt, floating, f, a.f * b.i)
+ARITHMETIC_HANDLER(MultiplyFloatFloat, floating, f, a.f * b.f)
+
+// Indexed by [operation][type of the first operand][type of the second operand] with the types integer (0) and floating (1)
+static const ClosureHandler arithmeticHandlers[3][2][2] = {
+    { { AddIntInt, AddIntFloat }, { AddFloatInt, AddFloatFloat } },
+    { { MinusIntInt, MinusIntFloat }, { MinusFloatInt, MinusFloatFloat } },
+    { { MultiplyIntInt, MultiplyIntFloat }, { MultiplyFloatInt, MultiplyFloatFloat } }
+};
+
+// Operation with types only known while running, with the same rules as the tree interpreter
+int ArithmeticHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue a, b;
+    if (!EvaluateOperands(closure, &a, &b))
+        return 0;
+
+    int aIsNumber = a.type==integer || a.type==floating;
+    int bIsNumber = b.type==integer || b.type==floating;
+
+    if (closure->operation==atAdd && a.type==characters && b.type==characters) {
+        char* concatenation = UfcMalloc(1 + strlen(a.s) + strlen(b.s));
+        if (concatenation==NULL) {
+            ClosureError("Could not allocate memory for the concatenation");
+            return 0;
+        }
+        strcpy(concatenation, a.s);
+        strcat(concatenation, b.s);
+
+        UfcFree(closure->scratch);
+        closure->scratch = concatenation;
+
+        out->type = characters;
+        out->s = concatenation;
+        return 1;
+    }
+
+    if (!aIsNumber || !bIsNumber) {
+        ClosureError("Can't do this operation with these types of data");
+        return 0;
+    }
+
+    float af = a.type==integer ? a.i : a.f;
+    float bf = b.type==integer ? b.i : b.f;
+
+    *out = (struct ClosureValue) { noType, 0, 0, NULL };
+
+    if (closure->operation==atDivide) { // The second member is divided by the first one, with the same checks as the tree interpreter
+        if ((b.type==integer && a.i==0) || (b.type==floating && a.f==0)) {
+            ClosureError("Division by 0");
+            return 0;
+        }
+
+        if (a.type==integer && b.type==integer) {
+            // An integer result only if the division is exact, otherwise the integer division as a floating
+            if (b.i==0 || a.i % b.i == 0) {
+                out->type = integer;
+                out->i = b.i / a.i;
+            }
+            else {
+                out->type = floating;
+                out->f = b.i / a.i;
+            }
+        }
+        else {
+            out->type = floating;
+            out->f = bf / af;
+        }
+
+        return 1;
+    }
+
+    if (a.type==integer && b.type==integer) {
+        out->type = integer;
+        out->i = closure->operation==atAdd ? a.i + b.i : closure->operation==atMinus ? a.i - b.i : a.i * b.i;
+    }
+    else {
+        out->type = floating;
+        out->f = closure->operation==atAdd ? af + bf : closure->operation==atMinus ? af - bf : af * bf;
+    }
+
+    return 1;
+}
+
+
+/*************************** Comparisons *************************************/
+
+// Result of the comparator on the two values
+#define COMPARE(comparator, left, right) \
+    ((comparator)==gtr ? (left) >= (right) : (comparator)==str_gtr ? (left) > (right) : (comparator)==neq ? (left) != (right) : (left) == (right))
+
+#define COMPARISON_HANDLER(name, expression) \
+    int name (struct Closure* closure, struct ClosureValue* out) { \
+        struct ClosureValue a, b; \
+        if (!EvaluateOperands(closure, &a, &b)) \
+            return 0; \
+        *out = (struct ClosureValue) { integer, expression, 0, NULL }; \
+        return 1; \
+    }
+
+// The comparators gtr, str_gtr, neq and eq for each pair of number types
+#define COMPARISON_HANDLERS(suffix, left, right) \
+    COMPARISON_HANDLER(GreaterOrEqual##suffix, COMPARE(gtr, left, right)) \
+    COMPARISON_HANDLER(Greater##suffix, COMPARE(str_gtr, left, right)) \
+    COMPARISON_HANDLER(NotEqual##suffix, COMPARE(neq, left, right)) \
+    COMPARISON_HANDLER(Equal##suffix, COMPARE(eq, left, right))
+
+COMPARISON_HANDLERS(IntInt, a.i, b.i)
+COMPARISON_HANDLERS(IntFloat, a.i, b.f)
+COMPARISON_HANDLERS(FloatInt, a.f, b.i)
+COMPARISON_HANDLERS(FloatFloat, a.f, b.f)
+COMPARISON_HANDLERS(String, strcmp(a.s, b.s), 0)
+
+// Indexed by [comparator][type of the first value][type of the second value]
+static const ClosureHandler comparisonHandlers[4][2][2] = {
+    { { GreaterOrEqualIntInt, GreaterOrEqualIntFloat }, { GreaterOrEqualFloatInt, GreaterOrEqualFloatFloat } },
+    { { GreaterIntInt, GreaterIntFloat }, { GreaterFloatInt, GreaterFloatFloat } },
+    { { NotEqualIntInt, NotEqualIntFloat }, { NotEqualFloatInt, NotEqualFloatFloat } },
+    { { EqualIntInt, EqualIntFloat }, { EqualFloatInt, EqualFloatFloat } }
+};
+
+static const ClosureHandler stringComparisonHandlers[4] = {
+    GreaterOrEqualString, GreaterString, NotEqualString, EqualString
+};
+
+// Comparison with types only known while running
+int ComparisonHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue a, b;
+    if (!EvaluateOperands(closure, &a, &b))
+        return 0;
+
+    *out = (struct ClosureValue) { integer, 0, 0, NULL };
+
+    if (a.type==integer && b.type==integer)
+        out->i = COMPARE(closure->comparator, a.i, b.i);
+    else if (a.type==integer && b.type==floating)
+        out->i = COMPARE(closure->comparator, a.i, b.f);
+    else if (a.type==floating && b.type==integer)
+        out->i = COMPARE(closure->comparator, a.f, b.i);
+    else if (a.type==floating && b.type==floating)
+        out->i = COMPARE(closure->comparator, a.f, b.f);
+    else if (a.type==characters && b.type==characters)
+        out->i = COMPARE(closure->comparator, strcmp(a.s, b.s), 0);
+    else {
+        ClosureError("Impossible to compare these types of value");
+        return 0;
+    }
+
+    return 1;
+}
+
+// The second member is only evaluated if the first one doesn't decide the result (true for an or, false for an and), like in the tree interpreter,
+// and in adaptive mode the members are swapped in the same way (see BranchProfile.h)
+int EvaluateLogical (struct Closure* closure, struct ClosureValue* out, int isOr) {
+    struct Closure* first = closure->operand1;
+    struct Closure* second = closure->operand2;
+    if (IsBranchReordering() && ShouldSwapConditions(closure->ast->type, first->ast, first->conditionCost, second->ast, second->conditionCost)) {
+        closure->operand1 = second;
+        closure->operand2 = first;
+        closure->ast->child1 = second->ast;
+        closure->ast->child2 = first->ast;
+    }
+
+    struct ClosureValue a;
+    if (!closure->operand1->handler(closure->operand1, &a))
+        return 0;
+    if (IsBranchProfiling())
+        RecordBranch(closure->operand1->ast, a.i);
+
+    if ((a.i != 0) != isOr) {
+        if (!closure->operand2->handler(closure->operand2, &a))
+            return 0;
+        if (IsBranchProfiling())
+            RecordBranch(closure->operand2->ast, a.i);
+    }
+
+    *out = (struct ClosureValue) { integer, a.i != 0, 0, NULL };
+    return 1;
+}
+
+int LogicalAndHandler (struct Closure* closure, struct ClosureValue* out) {
+    return EvaluateLogical(closure, out, 0);
+}
+
+int LogicalOrHandler (struct Closure* closure, struct ClosureValue* out) {
+    return EvaluateLogical(closure, out, 1);
+}
+
+
+/*************************** Statements **************************************/
+
+// Reading of the standard input into an integer or floating fighter (the strings and teams are read by the tree interpreter)
+#define READ_HANDLER(name, reader, field) \
+    int name (struct Closure* closure, struct ClosureValue* out) { \
+        int result = reader(&closure->variable->field); \
+        if (result==INPUT_READ) \
+            return 1; \
+        if (result==INPUT_END) \
+            return RaiseControlSignal(BREAK_SIGNAL, closure->lineNumInCode); \
+        ClosureError("The challenger entering the ring is not a number"); \
+        return 0; \
+    }
+
+READ_HANDLER(ReadIntHandler, ReadInputInt, i)
+READ_HANDLER(ReadFloatHandler, ReadInputFloat, f)
+
+// Like the tree interpreter, the next statements are still run after an error, but not after a break or a continue
+int StatementListHandler (struct Closure* closure, struct ClosureValue* out) {
+    int success = 1;
+    for (int k = 0; k < closure->count; k++) {
+        int result = closure->list[k]->handler(closure->list[k], NULL);
+        if (IsControlSignal(result))
+            return result;
+
+        success = result && success;
+    }
+
+    return success;
+}
+
+int BreakHandler (struct Closure* closure, struct ClosureValue* out) {
+    return RaiseControlSignal(BREAK_SIGNAL, closure->lineNumInCode);
+}
+
+int ContinueHandler (struct Closure* closure, struct ClosureValue* out) {
+    return RaiseControlSignal(CONTINUE_SIGNAL, closure->lineNumInCode);
+}
+
+// Statement run by the tree interpreter
+int InterpretedStatementHandler (struct Closure* closure, struct ClosureValue* out) {
+    return InterpreteAST(closure->ast, NULL, closure->globalSymbolTable, closure->localSymbolTable, NULL, NULL, NULL, NULL);
+}
+
+int AssignIntHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue value;
+    if (!closure->operand1->handler(closure->operand1, &value))
+        return 0;
+
+    closure->variable->i = value.i;
+    return 1;
+}
+
+int AssignFloatHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue value;
+    if (!closure->operand1->handler(closure->operand1, &value))
+        return 0;
+
+    closure->variable->f = value.f;
+    return 1;
+}
+
+int AssignHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue value;
+    if (!closure->operand1->handler(closure->operand1, &value))
+        return 0;
+
+    return AssignValue(closure, closure->variable, &value);
+}
+
+// In place updates (see RewriteSelfUpdates) with the types of the fighter and of the other member known when compiling
+#define UPDATE_HANDLER(name, field, operator, operandField) \
+    int name (struct Closure* closure, struct ClosureValue* out) { \
+        struct ClosureValue value; \
+        if (!closure->operand1->handler(closure->operand1, &value)) \
+            return 0; \
+        closure->variable->field operator value.operandField; \
+        return 1; \
+    }
+
+UPDATE_HANDLER(AddAssignIntInt, i, +=, i)
+UPDATE_HANDLER(AddAssignFloatInt, f, +=, i)
+UPDATE_HANDLER(AddAssignFloatFloat, f, +=, f)
+UPDATE_HANDLER(MinusAssignIntInt, i, -=, i)
+UPDATE_HANDLER(MinusAssignFloatInt, f, -=, i)
+UPDATE_HANDLER(MinusAssignFloatFloat, f, -=, f)
+UPDATE_HANDLER(MultiplyAssignIntInt, i, *=, i)
+UPDATE_HANDLER(MultiplyAssignFloatInt, f, *=, i)
+UPDATE_HANDLER(MultiplyAssignFloatFloat, f, *=, f)
+
+// Indexed by [operation][type of the fighter][type of the other member], NULL when the update is an error (a floating given to an integer fighter)
+static const ClosureHandler updateHandlers[3][2][2] = {
+    { { AddAssignIntInt, NULL }, { AddAssignFloatInt, AddAssignFloatFloat } },
+    { { MinusAssignIntInt, NULL }, { MinusAssignFloatInt, MinusAssignFloatFloat } },
+    { { MultiplyAssignIntInt, NULL }, { MultiplyAssignFloatInt, MultiplyAssignFloatFloat } }
+};
+
+// In place update with types only known while running, with the same rules as the tree interpreter
+int UpdateHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue value;
+    if (!closure->operand1->handler(closure->operand1, &value))
+        return 0;
+
+    if (value.type!=integer && value.type!=floating) {
+        ClosureError("Can't do this operation with these types of data");
+        return 0;
+    }
+
+    struct VariableStruct* fighter = closure->variable;
+    if (fighter->type==integer) {
+        if (value.type!=integer) {
+            ClosureError("Type of the variable not matching the type of the other hand of the assignment");
+            return 0;
+        }
+
+        fighter->i = closure->operation==atAddAssign ? fighter->i + value.i : (closure->operation==atMinusAssign ? fighter->i - value.i : fighter->i * value.i);
+    }
+    else if (fighter->type==floating) {
+        float f = value.type==integer ? value.i : value.f;
+        fighter->f = closure->operation==atAddAssign ? fighter->f + f : (closure->operation==atMinusAssign ? fighter->f - f : fighter->f * f);
+    }
+    else {
+        ClosureError("Impossible to update this type of variable in place");
+        return 0;
+    }
+
+    return 1;
+}
+
+// Call of a training regimen, whose result is assigned to closure->variable if it is not NULL
+int CallHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureFunction* callee = closure->callee;
+
+    // Fill the arguments with the values used to call the function
+    for (int k = 0; k < callee->argCount; k++) {
+        struct ClosureValue value;
+        if (!closure->list[k]->handler(closure->list[k], &value))
+            return 0;
+
+        if (value.type != callee->args[k]->type) {
+            ClosureError("The type of the argument doesn't match the type defined in the function");
+            return 0;
+        }
+
+        if (value.type==integer)
+            callee->args[k]->i = value.i;
+        else if (value.type==floating)
+            callee->args[k]->f = value.f;
+        else if (callee->args[k]->s!=value.s && !StrFreeAndCopy(&callee->args[k]->s, value.s)) {
+            ClosureError("Error while copying the string argument");
+            return 0;
+        }
+    }
+
+    struct ClosureValue result;
+    result.type = noType;
+    result.s = NULL;
+
+    // Same cache as the tree interpreter, only used when the result is
+    struct MemoCache* memoCache = closure->variable!=NULL ? callee->function->memoCache : NULL;
+    int32_t memoKey[MEMO_MAX_ARGS];
+    struct MemoEntry* entry;
+    if (memoCache!=NULL) {
+        GetMemoKey(callee->function, memoKey);
+
+        if (TryFind_MemoCache(memoCache, memoKey, &entry)) {
+            result.type = entry->resultType;
+            result.i = entry->i;
+            result.f = entry->f;
+            return AssignValue(closure, closure->variable, &result);
+        }
+    }
+
+    InterpreterCheckpoint();
+    int bodyResult = callee->body!=NULL ? callee->body->handler(callee->body, NULL) : 1;
+
+    // A break or a continue ends the regimen and goes up to the loop of the caller, without value
+    if (IsControlSignal(bodyResult))
+        return bodyResult;
+
+    if (!bodyResult) {
+        char msg[200];
+        snprintf(msg, sizeof(msg), "Error while calling the function %s", callee->function->id);
+        ClosureError(msg);
+        return 0;
+    }
+
+    if (callee->returnValue!=NULL) {
+        if (closure->variable==NULL) {
+            ClosureError("No fighter to hold the value returned by the function");
+            return 0;
+        }
+
+        if (!callee->returnValue->handler(callee->returnValue, &result))
+            return 0;
+
+        if (memoCache!=NULL && result.type==callee->function->type)
+            Add_MemoCache(memoCache, memoKey, result.type, result.i, result.f);
+    }
+
+    if (closure->variable==NULL)
+        return 1;
+
+    return AssignValue(closure, closure->variable, &result);
+}
+
+// Call whose result is not used : its errors are ignored, like in the tree interpreter
+int VoidCallHandler (struct Closure* closure, struct ClosureValue* out) {
+    int result = CallHandler(closure, out);
+    return IsControlSignal(result) ? result : 1;
+}
+
+// The errors of the body don't stop the loop, and an error in the condition ends it, like in the tree interpreter
+int WhileHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue condition;
+
+    while (closure->operand1->handler(closure->operand1, &condition) && condition.i) {
+        InterpreterCheckpoint();
+        if (closure->operand2->handler(closure->operand2, NULL) == BREAK_SIGNAL)
+            break;
+    }
+
+    return 1;
+}
+
+// Runs the body of the first branch whose condition is true (the else branch has no condition)
+// As in the tree interpreter, an error in a condition goes on with the next branch, and the errors of the bodies are ignored
+int TestHandler (struct Closure* closure, struct ClosureValue* out) {
+    int success = 1;
+
+    for (int k = 0; k < closure->count; k++) {
+        if (closure->list[k]!=NULL) {
+            struct ClosureValue condition;
+            if (!closure->list[k]->handler(closure->list[k], &condition)) {
+                success = 0;
+                continue;
+            }
+            if (IsBranchProfiling())
+                RecordBranch(closure->list[k]->ast, condition.i);
+            if (!condition.i)
+                continue;
+        }
+
+        int result = closure->branches[k]->handler(closure->branches[k], NULL);
+        if (IsControlSignal(result))
+            return result;
+
+        break;
+    }
+
+    return success;
+}
+
+int PrintIntHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue value;
+    if (!closure->operand1->handler(closure->operand1, &value))
+        return 0;
+
+    fprintf(GetInterpreterOutput(), "%d", value.i);
+    return 1;
+}
+
+int PrintFloatHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue value;
+    if (!closure->operand1->handler(closure->operand1, &value))
+        return 0;
+
+    fprintf(GetInterpreterOutput(), "%f", value.f);
+    return 1;
+}
+
+int PrintHandler (struct Closure* closure, struct ClosureValue* out) {
+    struct ClosureValue value;
+    if (!closure->operand1->handler(closure->operand1, &value))
+        return 0;
+
+    switch (value.type) {
+        case integer:
+            fprintf(GetInterpreterOutput(), "%d", value.i);
+            break;
+        case floating:
+            fprintf(GetInterpreterOutput(), "%f", value.f);
+            break;
+        case characters:
+            fprintf(GetInterpreterOutput(), "%s", value.s);
+            break;
+        default:
+            ClosureError("Not a valid variable type to print");
+            return 0;
+    }
+
+    return 1;
+}
+
+int PrintEndlHandler (struct Closure* closure, struct ClosureValue* out) {
+    fprintf(GetInterpreterOutput(), "\n");
+    return 1;
+}
+
+
+/**************************** Compilation ************************************/
+
+struct Closure* CompileStatement (struct ClosureEngine* engine, struct AstNode* ast);
+struct ClosureFunction* CompileFunction (struct ClosureEngine* engine, struct VariableStruct* function);
+
+struct Closure* CompileExpression (struct ClosureEngine* engine, struct AstNode* ast) {
+    struct Closure* closure;
+
+    switch (ast->type)
+    {
+        case atConstant:
+            closure = NewClosure(engine, ConstantHandler, ast);
+            closure->type = ast->variableType;
+            closure->constant.type = ast->variableType;
+            closure->constant.i = ast->i;
+            closure->constant.f = ast->f;
+            closure->constant.s = ast->s;
+            return closure;
+        case atId:
+        {
+            struct VariableStruct* fighter = FindFighter(engine, ast->s);
+            if (fighter==NULL || fighter->team!=NULL || fighter->functionBody!=NULL)
+                break;
+
+            closure = NewClosure(engine, VariableHandler, ast);
+            closure->type = fighter->type;
+            closure->variable = fighter;
+            return closure;
+        }
+        case atAdd:
+        case atMinus:
+        case atMultiply:
+        case atDivide:
+        {
+            if (UsesTeams(engine, ast))
+                break;
+
+            closure = NewClosure(engine, ArithmeticHandler, ast);
+            closure->operation = ast->type;
+            closure->operand1 = CompileExpression(engine, ast->child1);
+            closure->operand2 = CompileExpression(engine, ast->child2);
+
+            enum VariableType type1 = closure->operand1->type;
+            enum VariableType type2 = closure->operand2->type;
+            if (ast->type!=atDivide && (type1==integer || type1==floating) && (type2==integer || type2==floating)) {
+                closure->handler = arithmeticHandlers[ast->type - atAdd][type1==floating][type2==floating];
+                closure->type = type1==integer && type2==integer ? integer : floating;
+            }
+            else if (ast->type==atAdd && type1==characters && type2==characters)
+                closure->type = characters;
+
+            return closure;
+        }
+        default:
+            break;
+    }
+
+    // Anything else (teams, undefined fighters) is computed by the tree interpreter, which also gives the same errors
+    return NewClosure(engine, InterpretedValueHandler, ast);
+}
+
+struct Closure* CompileComparison (struct ClosureEngine* engine, enum ComparatorType comparator, struct AstNode* value1, struct AstNode* value2, struct AstNode* ast) {
+    struct Closure* closure = NewClosure(engine, ComparisonHandler, ast);
+    closure->type = integer;
+    closure->comparator = comparator;
+    closure->operand1 = CompileExpression(engine, value1);
+    closure->operand2 = CompileExpression(engine, value2);
+
+    enum VariableType type1 = closure->operand1->type;
+    enum VariableType type2 = closure->operand2->type;
+    if ((type1==integer || type1==floating) && (type2==integer || type2==floating))
+        closure->handler = comparisonHandlers[comparator][type1==floating][type2==floating];
+    else if (type1==characters && type2==characters)
+        closure->handler = stringComparisonHandlers[comparator];
+
+    return closure;
+}
+
+// Compiles the condition of a branch of a test, with the comparisons of engine->comparisons
+// Returns NULL if a comparison is not declared
+struct Closure* CompileCondition (struct ClosureEngine* engine, struct AstNode* ast) {
+    if (ast->type==atLogicalAnd || ast->type==atLogicalOr) {
+        struct Closure* closure = NewClosure(engine, ast->type==atLogicalAnd ? LogicalAndHandler : LogicalOrHandler, ast);
+        closure->type = integer;
+        closure->operand1 = CompileCondition(engine, ast->child1);
+        closure->operand2 = CompileCondition(engine, ast->child2);
+        closure->conditionCost = ConditionCost(ast, engine->comparisons);
+
+        return closure->operand1!=NULL && closure->operand2!=NULL ? closure : NULL;
+    }
+
+    struct ComparisonValue* comparison;
+    if (ast->type!=atComparisonId || !TryFind_ComparisonsDict(engine->comparisons, ast->i, &comparison))
+        return NULL;
+
+    struct Closure* closure = CompileComparison(engine, comparison->comparator, comparison->value1, comparison->value2, ast);
+    closure->conditionCost = ConditionCost(ast, engine->comparisons);
+
+    return closure;
+}
+
+struct Closure* CompileTest (struct ClosureEngine* engine, struct AstNode* ast) {
+    struct Comparisons_Dict* previousComparisons = engine->comparisons;
+    if (!CreateComparisonsDict(&engine->comparisons)) {
+        engine->comparisons = previousComparisons;
+        return NULL;
+    }
+
+    for (struct AstNode* declarations = ast->child1; declarations!=NULL; declarations = declarations->child2) {
+        struct AstNode* declaration = declarations->child1;
+        Add_ComparisonsDict(&engine->comparisons, declaration->i, declaration->comparator, declaration->child1, declaration->child2);
+    }
+
+    // The branches are a list of if, else if and else branches
+    int count = 0;
+    for (struct AstNode* branches = ast->child2; branches!=NULL; branches = branches->child2)
+        count++;
+
+    struct Closure* closure = NewClosure(engine, TestHandler, ast);
+    closure->count = count;
+    closure->list = NewClosureList(count);
+    closure->branches = NewClosureList(count);
+
+    int k = 0;
+    for (struct AstNode* branches = ast->child2; branches!=NULL; branches = branches->child2, k++) {
+        struct AstNode* branch = branches->child1;
+
+        if (branch->type==atTestElseBranch)
+            closure->branches[k] = CompileStatement(engine, branch->child1);
+        else {
+            closure->list[k] = CompileCondition(engine, branch->child1);
+            closure->branches[k] = CompileStatement(engine, branch->child2);
+
+            if (closure->list[k]==NULL) {
+                closure = NULL;
+                break;
+            }
+        }
+    }
+
+    FreeComparisonsDict(engine->comparisons);
+    engine->comparisons = previousComparisons;
+
+    return closure;
+}
+
+// Compiles the call of a training regimen, whose result is assigned to target (NULL if the result is not used)
+// Returns NULL if the call can't be compiled
+struct Closure* CompileCall (struct ClosureEngine* engine, struct AstNode* call, struct VariableStruct* target, struct AstNode* ast) {
+    struct VariableStruct* function;
+    if (!TryFind_Hashtable(engine->globalSymbolTable, call->child1->s, &function) || function->functionBody==NULL)
+        return NULL;
+
+    struct ClosureFunction* callee = CompileFunction(engine, function);
+    if (callee==NULL)
+        return NULL;
+
+    int argCount = 0;
+    for (struct AstNode* arg = call->child2; arg!=NULL && arg->type==atFuncCallArgList; arg = arg->child2)
+        argCount++;
+
+    if (argCount != callee->argCount)
+        return NULL;
+
+    struct Closure* closure = NewClosure(engine, CallHandler, ast);
+    closure->callee = callee;
+    closure->variable = target;
+    closure->count = argCount;
+    closure->list = NewClosureList(argCount);
+
+    int k = 0;
+    for (struct AstNode* arg = call->child2; arg!=NULL && arg->type==atFuncCallArgList; arg = arg->child2, k++)
+        closure->list[k] = CompileExpression(engine, arg->child1);
+
+    return closure;
+}
+
+struct Closure* CompileStatementList (struct ClosureEngine* engine, struct AstNode* ast) {
+    int count = 0;
+    for (struct AstNode* statements = ast; statements!=NULL; statements = statements->child2)
+        count++;
+
+    struct Closure* closure = NewClosure(engine, StatementListHandler, ast);
+    closure->count = count;
+    closure->list = NewClosureList(count);
+
+    int k = 0;
+    for (struct AstNode* statements = ast; statements!=NULL; statements = statements->child2, k++)
+        closure->list[k] = CompileStatement(engine, statements->child1);
+
+    return closure;
+}
+
+struct Closure* CompileStatement (struct ClosureEngine* engine, struct AstNode* ast) {
+    struct Closure* closure = NULL;
+
+    if (UsesTeams(engine, ast))
+        return NewClosure(engine, InterpretedStatementHandler, ast);
+
+    switch (ast->type)
+    {
+        case atStatementList:
+            return CompileStatementList(engine, ast);
+        case atAssignment:
+        {
+            struct VariableStruct* target = NULL;
+            if (ast->child1->type==atId) {
+                target = FindFighter(engine, ast->child1->s);
+                if (target==NULL || target->functionBody!=NULL)
+                    break;
+            }
+            else if (ast->child1->type!=atVoid || ast->child2->type!=atFuncCall)
+                break;
+
+            if (ast->child2->type==atFuncCall) {
+                closure = CompileCall(engine, ast->child2, target, ast);
+                if (closure!=NULL && target==NULL)
+                    closure->handler = VoidCallHandler;
+                break;
+            }
+
+            closure = NewClosure(engine, AssignHandler, ast);
+            closure->variable = target;
+            closure->operand1 = CompileExpression(engine, ast->child2);
+
+            if (closure->operand1->type==target->type && target->type==integer)
+                closure->handler = AssignIntHandler;
+            else if (closure->operand1->type==target->type && target->type==floating)
+                closure->handler = AssignFloatHandler;
+
+            break;
+        }
+        case atAddAssign:
+        case atMinusAssign:
+        case atMultiplyAssign:
+        {
+            struct VariableStruct* target = FindFighter(engine, ast->child1->s);
+            if (target==NULL || target->functionBody!=NULL)
+                break;
+
+            closure = NewClosure(engine, UpdateHandler, ast);
+            closure->variable = target;
+            closure->operation = ast->type;
+            closure->operand1 = CompileExpression(engine, ast->child2);
+
+            enum VariableType operandType = closure->operand1->type;
+            if ((target->type==integer || target->type==floating) && (operandType==integer || operandType==floating)) {
+                ClosureHandler handler = updateHandlers[ast->type - atAddAssign][target->type==floating][operandType==floating];
+                if (handler!=NULL)
+                    closure->handler = handler;
+            }
+
+            break;
+        }
+        case atFuncCall:
+            closure = CompileCall(engine, ast, NULL, ast);
+            break;
+        case atWhileLoop:
+            closure = NewClosure(engine, WhileHandler, ast);
+            closure->operand1 = CompileComparison(engine, ast->child1->comparator, ast->child1->child1, ast->child1->child2, ast->child1);
+            closure->operand2 = CompileStatement(engine, ast->child2);
+            break;
+        case atTest:
+            closure = CompileTest(engine, ast);
+            break;
+        case atPrint:
+            closure = NewClosure(engine, PrintHandler, ast);
+            closure->operand1 = CompileExpression(engine, ast->child1);
+
+            if (closure->operand1->type==integer)
+                closure->handler = PrintIntHandler;
+            else if (closure->operand1->type==floating)
+                closure->handler = PrintFloatHandler;
+
+            break;
+        case atPrintEndl:
+            closure = NewClosure(engine, PrintEndlHandler, ast);
+            break;
+        case atRead:
+        {
+            struct VariableStruct* target = FindFighter(engine, ast->child1->s);
+            if (target==NULL || target->functionBody!=NULL || (target->type!=integer && target->type!=floating))
+                break;
+
+            closure = NewClosure(engine, target->type==integer ? ReadIntHandler : ReadFloatHandler, ast);
+            closure->variable = target;
+            break;
+        }
+        case atBreak:
+            closure = NewClosure(engine, BreakHandler, ast);
+            break;
+        case atContinue:
+            closure = NewClosure(engine, ContinueHandler, ast);
+            break;
+        default:
+            break;
+    }
+
+    // What can't be compiled (return in the main phase, undefined fighters or regimens, ...) is run by the tree interpreter, which also gives the same errors
+    if (closure==NULL)
+        closure = NewClosure(engine, InterpretedStatementHandler, ast);
+
+    return closure;
+}
+
+// Compiles the body of the training regimen once, the calls then share it
+struct ClosureFunction* CompileFunction (struct ClosureEngine* engine, struct VariableStruct* function) {
+    for (struct ClosureFunction* compiled = engine->functions; compiled!=NULL; compiled = compiled->next) {
+        if (compiled->function==function)
+            return compiled;
+    }
+
+    struct ClosureFunction* compiled = UfcCalloc(1, sizeof(struct ClosureFunction));
+    if (compiled==NULL) {
+        printf("Memory error : cannot allocate memory to compile a function\n");
+        exit(1);
+    }
+
+    // Added before compiling the body, so that a recursive call finds it
+    compiled->function = function;
+    compiled->next = engine->functions;
+    engine->functions = compiled;
+
+    for (struct ArgList* arg = function->argumentsList; arg!=NULL; arg = arg->next)
+        compiled->argCount++;
+
+    compiled->args = UfcMalloc(sizeof(struct VariableStruct*) * (compiled->argCount + 1));
+    if (compiled->args==NULL) {
+        printf("Memory error : cannot allocate memory for the arguments of a compiled function\n");
+        exit(1);
+    }
+
+    int k = 0;
+    for (struct ArgList* arg = function->argumentsList; arg!=NULL; arg = arg->next, k++) {
+        if (!TryFind_Hashtable(function->argumentsTable, arg->id, &compiled->args[k]))
+            return NULL;
+    }
+
+    struct HashStruct* previousLocalSymbolTable = engine->localSymbolTable;
+    engine->localSymbolTable = function->argumentsTable;
+
+    // The statements up to the return (a return is always a line of the body itself, and ends it)
+    int count = 0;
+    for (struct AstNode* lines = function->functionBody; lines!=NULL && lines->child1->type!=atReturn; lines = lines->child2)
+        count++;
+
+    compiled->body = NewClosure(engine, StatementListHandler, function->functionBody);
+    compiled->body->count = count;
+    compiled->body->list = NewClosureList(count);
+
+    k = 0;
+    for (struct AstNode* lines = function->functionBody; lines!=NULL; lines = lines->child2, k++) {
+        if (lines->child1->type==atReturn) {
+            compiled->returnValue = CompileExpression(engine, lines->child1->child1);
+            break;
+        }
+
+        compiled->body->list[k] = CompileStatement(engine, lines->child1);
+    }
+
+    engine->localSymbolTable = previousLocalSymbolTable;
+
+    return compiled;
+}
+
+
+/****************************** Running **************************************/
+
+int InterpreteMainWithClosures (struct AstNode* ast, struct HashStruct* globalSymbolTable)
+{
+    if (ast==NULL || ast->type!=atRoot || globalSymbolTable==NULL) {
+        fprintf(GetInterpreterOutput(), "InterpreteMainWithClosures needs the root of the AST and a global symbol table\n");
+        return 0;
+    }
+
+    struct ClosureEngine engine;
+    engine.globalSymbolTable = globalSymbolTable;
+    engine.localSymbolTable = NULL;
+    engine.comparisons = NULL;
+    engine.functions = NULL;
+    engine.allocated = NULL;
+
+    int result = 1;
+    if (ast->child2!=NULL) {
+        struct Closure* main = CompileStatement(&engine, ast->child2);
+        result = main->handler(main, NULL);
+    }
+
+    // The signal is still returned, as by InterpreteMainLines
+    if (IsControlSignal(result))
+        ClosureError_Expand("The match can only be interrupted, or a round ended, inside a loop", GetControlSignalLine());
+
+    FreeClosureEngine(&engine);
+
+    return result;
+}
+
+int InterpreteWithClosures (struct AstNode* ast)
+{
+    struct HashStruct* globalSymbolTable;
+    if (!InterpreteDefinitions(ast, &globalSymbolTable))
+        return 0;
+
+    int result = InterpreteMainWithClosures(ast, globalSymbolTable);
+    if (IsControlSignal(result))
+        result = 0;
+
+    PrintMemoStats(globalSymbolTable);
+    PrintBranchStats(ast);
+
+    Free_Hashtable(globalSymbolTable);
+
+    return result;
+}
+
+int CompareEngines (struct AstNode* ast)
+{
+    FILE* output = GetInterpreterOutput();
+
+    char* treeOutput = NULL;
+    size_t treeOutputSize = 0;
+    char* closureOutput = NULL;
+    size_t closureOutputSize = 0;
+
+    FILE* treeStream = open_memstream(&treeOutput, &treeOutputSize);
+    FILE* closureStream = open_memstream(&closureOutput, &closureOutputSize);
+    if (treeStream==NULL || closureStream==NULL) {
+        fprintf(output, "Cannot capture the outputs of the engines\n");
+        if (treeStream!=NULL)
+            fclose(treeStream);
+        if (closureStream!=NULL)
+            fclose(closureStream);
+        free(treeOutput);
+        free(closureOutput);
+        return 0;
+    }
+
+    // Both engines are given the same values of the standard input
+    MarkInput();
+    SetInterpreterOutput(treeStream);
+    int treeResult = InterpreteAST(ast, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+    RewindInput();
+    SetInterpreterOutput(closureStream);
+    int closureResult = InterpreteWithClosures(ast);
+    SetInterpreterOutput(output);
+
+    fclose(treeStream);
+    fclose(closureStream);
+
+    fwrite(treeOutput, 1, treeOutputSize, output);
+
+    // The error messages of the two engines are not the same, so only the results are compared when both failed
+    int same = treeResult==closureResult
+        && (!treeResult || (treeOutputSize==closureOutputSize && !memcmp(treeOutput, closureOutput, treeOutputSize)));
+
+    if (same)
+        fprintf(stderr, "Engine comparison : same results (%zu bytes printed)\n", treeOutputSize);
+    else if (treeResult!=closureResult)
+        fprintf(stderr, "Engine comparison : the tree interpreter %s but the closure engine %s\n", treeResult ? "succeeded" : "failed", closureResult ? "succeeded" : "failed");
+    else {
+        size_t position = 0;
+        while (position < treeOutputSize && position < closureOutputSize && treeOutput[position]==closureOutput[position])
+            position++;
+        fprintf(stderr, "Engine comparison : the outputs differ from byte %zu (%zu bytes with the tree interpreter, %zu with the closure engine)\n", position, treeOutputSize, closureOutputSize);
+    }
+
+    free(treeOutput);
+    free(closureOutput);
+
+    return same && treeResult;
+}
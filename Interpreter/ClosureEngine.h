@@ -0,0 +1,26 @@
+#ifndef __CLOSURE_ENGINE_H__
+#define __CLOSURE_ENGINE_H__
+
+#include "../Utils/AST.h"
+#include "../Utils/Hash.h"
+
+// The closure engine turns every node of the main phase and of the called training regimens, once, into a closure :
+// a small structure holding the function that runs it, with its fighters, constants, comparator and called regimen already found.
+// Running the program is then one call through a function pointer per node, without looking at the type of the nodes or of the values again.
+// The definitions phase is interpreted by the tree interpreter, and the closures work directly on the fighters of its symbol tables.
+// The statements using teams are run by the tree interpreter.
+
+// Interpretes the whole program (ast is the atRoot) : the definitions with the tree interpreter, then the main phase with closures
+// Returns 0 if there was an error, 1 otherwise
+int InterpreteWithClosures (struct AstNode* ast);
+
+// Interpretes the main phase of the program with closures, with a global symbol table filled by InterpreteDefinitions
+// Returns 0 if there was an error, 1 otherwise, and like InterpreteMainLines the signal of a break or a continue met outside of a loop
+int InterpreteMainWithClosures (struct AstNode* ast, struct HashStruct* globalSymbolTable);
+
+// Runs the program with the tree interpreter then with the closures, each with its own fighters, and compares what they print
+// The output of the tree interpreter is kept, and the result of the comparison is written to the error output
+// Returns 1 if the program succeeded with both engines and they printed the same, 0 otherwise
+int CompareEngines (struct AstNode* ast);
+
+#endif
@@ -5,12 +5,77 @@
 #include "../Utils/Hash.h"
 #include "../Utils/ComparisonDictionnary.h"
 #include "../Utils/SymbolTableData.h"
+#include "../Utils/InputReader.h"
+#include "../Utils/Allocator.h"
+#include "TeamKernels.h"
+#include "ClosureEngine.h"
+#include "BranchProfile.h"
+#include "Trace.h"
+#include "ParallelReduction.h"
+#include "../Optimizer/Purity.h"
 
 #define InterpreterError(msg) InterpreterError_Expand(msg, __LINE__, ast->lineNumInCode)
 
+// Stream where the interpreted code writes, one per thread so that programs run in parallel don't mix their outputs
+static _Thread_local FILE* interpreterOutput = NULL;
+
+void SetInterpreterOutput(FILE* output)
+{
+    interpreterOutput = output;
+}
+
+FILE* GetInterpreterOutput()
+{
+    return interpreterOutput!=NULL ? interpreterOutput : stdout;
+}
+
+// Line of the break or continue that gave the last signal, reported if the signal ends the main phase
+static _Thread_local int controlSignalLine = 0;
+
+int RaiseControlSignal(int signal, int lineInCode)
+{
+    controlSignalLine = lineInCode;
+    return signal;
+}
+
+int GetControlSignalLine()
+{
+    return controlSignalLine;
+}
+
+// The output stream, the line of the last signal and the memory budget belong to the OS thread, so they are given back to the program when it is resumed
+void YieldToOtherPrograms()
+{
+    FILE* output = interpreterOutput;
+    int signalLine = controlSignalLine;
+    struct MemoryBudget* budget = GetMemoryBudget();
+    GreenThreadYield();
+    interpreterOutput = output;
+    controlSignalLine = signalLine;
+    SetMemoryBudget(budget);
+}
+
+// Memoization options, set once before any program is run
+static int memoizationEnabled = 1;
+static int memoStatsEnabled = 0;
+
+void SetMemoization(int enabled, int printStats)
+{
+    memoizationEnabled = enabled;
+    memoStatsEnabled = printStats;
+}
+
+// Engine running the programs, set once before any program is run
+static enum InterpreterEngine interpreterEngine = treeEngine;
+
+void SetInterpreterEngine(enum InterpreterEngine engine)
+{
+    interpreterEngine = engine;
+}
+
 void InterpreterError_Expand(char* error_msg, const int line, const int lineInCode)
 {
-    printf("Error at line %d (Interpreter.c line %d) : %s\n", lineInCode, line, error_msg);
+    fprintf(GetInterpreterOutput(), "Error at line %d (Interpreter.c line %d) : %s\n", lineInCode, line, error_msg);
 }
 
 // Copy a char* from source to dest
@@ -18,16 +83,16 @@ void InterpreterError_Expand(char* error_msg, const int line, const int lineInCo
 // Return 0 if there was an error, 1 otherwise
 int StrFreeAndCopy (char** dest, char* source) {
     if (source==NULL || source[0]=='\0') {
-        printf("The source cannot be NULL or an empty string (StrFreeAndCopy)\n");
+        fprintf(GetInterpreterOutput(), "The source cannot be NULL or an empty string (StrFreeAndCopy)\n");
         return 0;
     }
 
     if (*dest!=NULL)
-        free(dest);
+        UfcFree(*dest);
 
-    char* _dest = malloc(1 + strlen(source));
+    char* _dest = UfcMalloc(1 + strlen(source));
     if (_dest==NULL) {
-        printf("Error while allocating memory for the destination (StrFreeAndCopy)\n");
+        fprintf(GetInterpreterOutput(), "Error while allocating memory for the destination (StrFreeAndCopy)\n");
         return 0;
     }
 
@@ -40,16 +105,19 @@ int StrFreeAndCopy (char** dest, char* source) {
 
 int CreateValueHolder (struct ValueHolder** valHolder) {
     if (valHolder==NULL) {
-        printf("Error : need a pointer to store the created ValueHolder\n");
+        fprintf(GetInterpreterOutput(), "Error : need a pointer to store the created ValueHolder\n");
         return 0;
     }
 
-    struct ValueHolder* _valHolder = malloc(sizeof(struct ValueHolder));
+    struct ValueHolder* _valHolder = UfcMalloc(sizeof(struct ValueHolder));
     if (_valHolder == NULL) {
-        printf("Could not allocate memory for _valHolder in CreateValueHolder\n");
+        fprintf(GetInterpreterOutput(), "Could not allocate memory for _valHolder in CreateValueHolder\n");
         return 0;
     }
     _valHolder->s = NULL;
+    _valHolder->team = NULL;
+    _valHolder->ownsTeam = 0;
+    _valHolder->destinationTeam = NULL;
 
     *valHolder = _valHolder;
 
@@ -61,9 +129,21 @@ void FreeValueHolder (struct ValueHolder* value) {
         return;
 
     if (value->s!=NULL)
-        free(value->s);
+        UfcFree(value->s);
+
+    if (value->ownsTeam)
+        FreeTeam(value->team);
     
-    free(value);
+    UfcFree(value);
+}
+
+// Makes value hold team, freeing the team it was holding before if it owned it
+void SetValueHolderTeam (struct ValueHolder* value, struct Team* team, int ownsTeam) {
+    if (value->ownsTeam && value->team!=team)
+        FreeTeam(value->team);
+
+    value->team = team;
+    value->ownsTeam = ownsTeam;
 }
 
 // Copy all the values of the symbol with symbolName key in SymbolTable into outVal
@@ -73,7 +153,7 @@ int GetSymbolValue (char* symbolId, struct ValueHolder** outVal, struct HashStru
     struct VariableStruct* varStruct;
     // Using the lazy evaluation to first look at local variables
     if (!(localSymbolTable!=NULL && TryFind_Hashtable(localSymbolTable, symbolId, &varStruct)) && !TryFind_Hashtable(globalSymbolTable, symbolId, &varStruct)) {
-        printf("No defined symbol with the name %s (GetSymbolValue)\n", symbolId);
+        fprintf(GetInterpreterOutput(), "No defined symbol with the name %s (GetSymbolValue)\n", symbolId);
         return 0;
     }
 
@@ -81,14 +161,350 @@ int GetSymbolValue (char* symbolId, struct ValueHolder** outVal, struct HashStru
     (*outVal)->f = varStruct->f;
     (*outVal)->i = varStruct->i;
 
+    // The values of a team are not copied : the ValueHolder only points to the team of the fighter
+    if (varStruct->team!=NULL)
+        SetValueHolderTeam(*outVal, varStruct->team, 0);
+
     if (varStruct->s!=NULL && varStruct->s[0]!='\0' && !StrFreeAndCopy(&((*outVal)->s), varStruct->s)) {
-        printf("Error while copying varStruct->s into outVal->s in GetSymbolValue\n");
+        fprintf(GetInterpreterOutput(), "Error while copying varStruct->s into outVal->s in GetSymbolValue\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+// Writes the values of the arguments of the function, in the order of its list of arguments, in key (of size MEMO_MAX_ARGS)
+// The floats are written as their bits, so the key can be compared with memcmp
+void GetMemoKey (struct VariableStruct* function, int32_t* key) {
+    int k = 0;
+    for (struct ArgList* arg = function->argumentsList; arg!=NULL; arg = arg->next, k++) {
+        struct VariableStruct* argStruct;
+        TryFind_Hashtable(function->argumentsTable, arg->id, &argStruct); // Always found since the function has a MemoCache
+
+        if (argStruct->type==integer)
+            key[k] = argStruct->i;
+        else
+            memcpy(&key[k], &argStruct->f, sizeof(int32_t));
+    }
+}
+
+// Prints the hits and misses of the cache of every memoized function of the global symbol table, if they were asked with SetMemoization
+void PrintMemoStats (struct HashStruct* globalSymbolTable) {
+    if (!memoStatsEnabled)
+        return;
+
+    for (unsigned int k = 0; k < globalSymbolTable->size; k++) {
+        for (struct VariableStruct* function = globalSymbolTable->table[k]; function!=NULL; function = function->nextInHash) {
+            if (function->memoCache!=NULL)
+                fprintf(GetInterpreterOutput(), "Memoization of %s : %ld hits, %ld misses\n", function->id, function->memoCache->hits, function->memoCache->misses);
+        }
+    }
+}
+
+// Gives a pointer to the values of a team as floats in *outValues
+// An integer team is converted in a new team stored in *outConverted, that the caller must free (NULL otherwise)
+// Returns 0 if there was an error, 1 otherwise
+int GetTeamFloatValues (struct Team* team, float** outValues, struct Team** outConverted) {
+    *outConverted = NULL;
+
+    if (team->elementType==floating) {
+        *outValues = team->f;
+        return 1;
+    }
+
+    if (!CreateTeam(outConverted, floating, team->size)) {
+        fprintf(GetInterpreterOutput(), "Error while converting a team of famous fighters to smart fighters (GetTeamFloatValues)\n");
+        return 0;
+    }
+
+    TeamIntToFloat((*outConverted)->f, team->i, team->size);
+    *outValues = (*outConverted)->f;
+
+    return 1;
+}
+
+// Puts in outVal a new team holding left operation right, computed element by element
+// One of left and right can be a single fighter, which is then used with every fighter of the team
+// The result is a team of smart fighters if one of the members is smart, of famous fighters otherwise
+// Returns 0 if there was an error, 1 otherwise
+int InterpreteTeamOperation (struct AstNode* ast, enum TeamOperation operation, struct ValueHolder* left, struct ValueHolder* right, struct ValueHolder* outVal) {
+    int leftIsTeam = IsTeamType(left->variableType);
+    int rightIsTeam = IsTeamType(right->variableType);
+
+    if ((!leftIsTeam && left->variableType!=integer && left->variableType!=floating)
+        || (!rightIsTeam && right->variableType!=integer && right->variableType!=floating)) {
+        InterpreterError("A team can only fight with another team, fans or IQ");
+        return 0;
+    }
+
+    if (leftIsTeam && rightIsTeam && left->team->size != right->team->size) {
+        InterpreterError("The two teams don't have the same number of fighters");
+        return 0;
+    }
+
+    int size = leftIsTeam ? left->team->size : right->team->size;
+    int floatingResult = left->variableType==floating || left->variableType==floatingTeam
+                        || right->variableType==floating || right->variableType==floatingTeam;
+
+    // Each fighter of the result only depends on the fighters at the same place in left and right,
+    // so the result can be written in the team being assigned even if it is left or right
+    struct Team* destination = outVal->destinationTeam;
+    int inDestination = destination!=NULL && destination->size==size && destination->elementType==(floatingResult ? floating : integer);
+
+    struct Team* result = destination;
+    if (!inDestination && !CreateTeam(&result, floatingResult ? floating : integer, size)) {
+        InterpreterError("Error while creating the team holding the result of the operation");
+        return 0;
+    }
+
+    if (!floatingResult) {
+        if (operation==teamDivide && ((rightIsTeam && TeamIntHasZero(right->team->i, size)) || (!rightIsTeam && right->i==0))) {
+            InterpreterError("Division by 0");
+            if (!inDestination)
+                FreeTeam(result);
+            return 0;
+        }
+
+        if (leftIsTeam && rightIsTeam)
+            TeamIntOperation(operation, result->i, left->team->i, right->team->i, size);
+        else if (leftIsTeam)
+            TeamIntScalarOperation(operation, result->i, left->team->i, right->i, 0, size);
+        else
+            TeamIntScalarOperation(operation, result->i, right->team->i, left->i, 1, size);
+    }
+    else {
+        float* leftValues = NULL;
+        float* rightValues = NULL;
+        struct Team* leftConverted = NULL;
+        struct Team* rightConverted = NULL;
+
+        if ((leftIsTeam && !GetTeamFloatValues(left->team, &leftValues, &leftConverted))
+            || (rightIsTeam && !GetTeamFloatValues(right->team, &rightValues, &rightConverted))) {
+            InterpreterError("Error while getting the values of the teams as IQ");
+            FreeTeam(leftConverted);
+            if (!inDestination)
+                FreeTeam(result);
+            return 0;
+        }
+
+        float leftScalar = left->variableType==integer ? left->i : left->f;
+        float rightScalar = right->variableType==integer ? right->i : right->f;
+
+        if (operation==teamDivide && ((rightIsTeam && TeamFloatHasZero(rightValues, size)) || (!rightIsTeam && rightScalar==0))) {
+            InterpreterError("Division by 0");
+            FreeTeam(leftConverted);
+            FreeTeam(rightConverted);
+            if (!inDestination)
+                FreeTeam(result);
+            return 0;
+        }
+
+        if (leftIsTeam && rightIsTeam)
+            TeamFloatOperation(operation, result->f, leftValues, rightValues, size);
+        else if (leftIsTeam)
+            TeamFloatScalarOperation(operation, result->f, leftValues, rightScalar, 0, size);
+        else
+            TeamFloatScalarOperation(operation, result->f, rightValues, leftScalar, 1, size);
+
+        FreeTeam(leftConverted);
+        FreeTeam(rightConverted);
+    }
+
+    outVal->variableType = floatingResult ? floatingTeam : integerTeam;
+    SetValueHolderTeam(outVal, result, !inDestination);
+
+    return 1;
+}
+
+// Puts in outVal the sum of left[k] * right[k] for two teams of the same size
+// The result is famous (integer) if both teams are famous, smart (floating) otherwise
+// Returns 0 if there was an error, 1 otherwise
+int InterpreteTeamDot (struct AstNode* ast, struct ValueHolder* left, struct ValueHolder* right, struct ValueHolder* outVal) {
+    if (!IsTeamType(left->variableType) || !IsTeamType(right->variableType)) {
+        InterpreterError("Only two teams can spar with each other");
+        return 0;
+    }
+
+    if (left->team->size != right->team->size) {
+        InterpreterError("The two teams don't have the same number of fighters");
+        return 0;
+    }
+
+    int size = left->team->size;
+
+    if (left->variableType==integerTeam && right->variableType==integerTeam) {
+        outVal->variableType = integer;
+        outVal->i = TeamIntDot(left->team->i, right->team->i, size);
+        return 1;
+    }
+
+    float* leftValues;
+    float* rightValues;
+    struct Team* leftConverted = NULL;
+    struct Team* rightConverted = NULL;
+
+    if (!GetTeamFloatValues(left->team, &leftValues, &leftConverted) || !GetTeamFloatValues(right->team, &rightValues, &rightConverted)) {
+        InterpreterError("Error while getting the values of the teams as IQ");
+        FreeTeam(leftConverted);
+        return 0;
+    }
+
+    outVal->variableType = floating;
+    outVal->f = TeamFloatDot(leftValues, rightValues, size);
+
+    FreeTeam(leftConverted);
+    FreeTeam(rightConverted);
+
+    return 1;
+}
+
+// Finds the team fighter named by the atId node teamIdNode
+// Returns 0 if there was an error, 1 otherwise
+int GetTeamFighter (struct AstNode* teamIdNode, struct HashStruct* globalSymbolTable, struct HashStruct* localSymbolTable, struct VariableStruct** outTeamFighter) {
+    if (teamIdNode==NULL || teamIdNode->type!=atId) {
+        fprintf(GetInterpreterOutput(), "Not a valid team Id (GetTeamFighter)\n");
+        return 0;
+    }
+
+    if (!(localSymbolTable!=NULL && TryFind_Hashtable(localSymbolTable, teamIdNode->s, outTeamFighter)) && !TryFind_Hashtable(globalSymbolTable, teamIdNode->s, outTeamFighter)) {
+        fprintf(GetInterpreterOutput(), "No defined team with the name %s (GetTeamFighter)\n", teamIdNode->s);
+        return 0;
+    }
+
+    if ((*outTeamFighter)->team==NULL) {
+        fprintf(GetInterpreterOutput(), "%s is not a team (GetTeamFighter)\n", teamIdNode->s);
         return 0;
     }
 
     return 1;
 }
 
+// Finds the team and the index of the fighter targeted by an atTeamElement node
+// Returns 0 if there was an error (or the index is out of the team), 1 otherwise
+int GetTeamElement (struct AstNode* ast, struct HashStruct* globalSymbolTable, struct HashStruct* localSymbolTable, struct Team** outTeam, int* outIndex) {
+    struct VariableStruct* teamFighter;
+    if (!GetTeamFighter(ast->child1, globalSymbolTable, localSymbolTable, &teamFighter)) {
+        InterpreterError("Can't find the team of the fighter");
+        return 0;
+    }
+
+    struct ValueHolder* indexHolder;
+    if (!CreateValueHolder(&indexHolder)) {
+        InterpreterError("Error while creating the ValueHolder for indexHolder in GetTeamElement");
+        return 0;
+    }
+
+    if (!InterpreteAST(ast->child2, indexHolder, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL)
+        || (ast->child2->type == atId && !GetSymbolValue(indexHolder->s, &indexHolder, globalSymbolTable, localSymbolTable))) {
+        InterpreterError("Could not get the number of the fighter in the team");
+        FreeValueHolder(indexHolder);
+        return 0;
+    }
+
+    if (indexHolder->variableType != integer) {
+        InterpreterError("The number of a fighter in a team must be famous (an integer)");
+        FreeValueHolder(indexHolder);
+        return 0;
+    }
+
+    if (indexHolder->i < 0 || indexHolder->i >= teamFighter->team->size) {
+        char msg[200];
+        snprintf(msg, sizeof(msg), "There is no fighter %d in the team %s of %d fighters", indexHolder->i, teamFighter->id, teamFighter->team->size);
+        InterpreterError(msg);
+        FreeValueHolder(indexHolder);
+        return 0;
+    }
+
+    *outTeam = teamFighter->team;
+    *outIndex = indexHolder->i;
+
+    FreeValueHolder(indexHolder);
+    return 1;
+}
+
+// Assigns value to all the fighters of the team fighter teamFighter
+// value is either a team of the same size and type, or a single value given to every fighter of the team
+// Returns 0 if there was an error, 1 otherwise
+int AssignTeam (struct AstNode* ast, struct VariableStruct* teamFighter, struct ValueHolder* value) {
+    struct Team* team = teamFighter->team;
+
+    if (!IsTeamType(value->variableType)) {
+        if (value->variableType != team->elementType) {
+            InterpreterError("Type of the fighters of the team not matching the type of the other hand of the assignment");
+            return 0;
+        }
+
+        for (int k = 0; k < team->size; k++) {
+            if (team->elementType==integer)
+                team->i[k] = value->i;
+            else
+                team->f[k] = value->f;
+        }
+
+        return 1;
+    }
+
+    if (value->variableType != teamFighter->type || value->team->size != team->size) {
+        InterpreterError("The team assigned doesn't have the same type or number of fighters as the team it is assigned to");
+        return 0;
+    }
+
+    if (value->team == team) // A team assigned to itself
+        return 1;
+
+    if (value->ownsTeam) {
+        // The team is the result of an operation that is not used anymore : it can replace the team of the fighter without copying its values
+        teamFighter->team = value->team;
+        value->team = team;
+    }
+    else if (team->elementType==integer)
+        memcpy(team->i, value->team->i, sizeof(int) * team->size);
+    else
+        memcpy(team->f, value->team->f, sizeof(float) * team->size);
+
+    return 1;
+}
+
+// Gets the value of the other member of an in place update, reading a constant or a fighter directly instead of copying it in a ValueHolder
+// Returns 0 if there was an error, 1 otherwise
+int GetUpdateOperand (struct AstNode* ast, struct HashStruct* globalSymbolTable, struct HashStruct* localSymbolTable, enum VariableType* outType, int* outI, float* outF) {
+    if (ast->type==atConstant) {
+        *outType = ast->variableType;
+        *outI = ast->i;
+        *outF = ast->f;
+        return 1;
+    }
+
+    if (ast->type==atId) {
+        struct VariableStruct* varStruct;
+        if (!(localSymbolTable!=NULL && TryFind_Hashtable(localSymbolTable, ast->s, &varStruct)) && !TryFind_Hashtable(globalSymbolTable, ast->s, &varStruct)) {
+            fprintf(GetInterpreterOutput(), "No defined symbol with the name %s (GetUpdateOperand)\n", ast->s);
+            return 0;
+        }
+
+        *outType = varStruct->type;
+        *outI = varStruct->i;
+        *outF = varStruct->f;
+        return 1;
+    }
+
+    struct ValueHolder* value;
+    if (!CreateValueHolder(&value))
+        return 0;
+
+    if (!InterpreteAST(ast, value, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL)) {
+        FreeValueHolder(value);
+        return 0;
+    }
+
+    *outType = value->variableType;
+    *outI = value->i;
+    *outF = value->f;
+
+    FreeValueHolder(value);
+    return 1;
+}
+
 /*
 
 ast = the node of the AST to interpret
@@ -121,24 +537,33 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
 {
     if (ast==NULL)
         return 1;
+
+    TraceNodeEntry(ast);
     
     switch (ast->type)
     {
         case atRoot:
         {
-            struct HashStruct* _globalSymbolTable = NULL;
             if (!Create_Hashtable(&globalSymbolTable)) {
                 InterpreterError("Error while creating the global symbol table in atRoot");
                 return 0;
             }
 
             //Variables and functions definitions
-            int a = InterpreteAST(ast->child1, NULL, globalSymbolTable, NULL, NULL, NULL, NULL, NULL);
+            int a = InterpreteAST(ast->child1, NULL, globalSymbolTable, NULL, NULL, NULL, NULL, NULL)
+                && MarkPureFunctions(globalSymbolTable, memoizationEnabled);
             //Main body of the code
             int b = InterpreteAST(ast->child2, NULL, globalSymbolTable, NULL, NULL, NULL, NULL, NULL);
+            if (IsControlSignal(b)) {
+                InterpreterError_Expand("The match can only be interrupted, or a round ended, inside a loop", __LINE__, GetControlSignalLine());
+                b = 0;
+            }
+
+            PrintMemoStats(globalSymbolTable);
+            PrintBranchStats(ast);
+
+            Free_Hashtable(globalSymbolTable);
 
-            Free_Hashtable(_globalSymbolTable);
-            
             return a && b;
             break;
         }
@@ -156,9 +581,13 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                 stopEvaluationsHolder->i = 0; // Don't stop by default
 
                 int a = InterpreteAST(ast->child1, stopEvaluationsHolder, globalSymbolTable, localSymbolTable, NULL, NULL, returnValue, comparisonDict);
+                int branchTaken = stopEvaluationsHolder->i;
+                FreeValueHolder(stopEvaluationsHolder);
 
-                if (!stopEvaluationsHolder->i) // If the if/else if/else statement has not been realized
-                    return a && InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, returnValue, comparisonDict);
+                if (!IsControlSignal(a) && !branchTaken) { // If the if/else if/else statement has not been realized
+                    int b = InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, returnValue, comparisonDict);
+                    return IsControlSignal(b) ? b : a && b;
+                }
                 
                 return a;
             }
@@ -166,77 +595,61 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                 return InterpreteAST(ast->child1, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, returnValue, comparisonDict);
             }
             else {
-                int a = InterpreteAST(ast->child1, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, returnValue, comparisonDict);
-                int b = InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, returnValue, comparisonDict);
-
-                return a && b;
+                // The plain statements that follow are run by this loop instead of one call each,
+                // so that the stack doesn't grow with the length of the list (a program can have thousands of definitions)
+                int result = 1;
+                struct AstNode* statement = ast;
+                while (1) {
+                    int a = InterpreteAST(statement->child1, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, returnValue, comparisonDict);
+                    if (IsControlSignal(a)) // A break or a continue skips the rest of the statements up to the loop
+                        return a;
+                    result = result && a;
+
+                    statement = statement->child2;
+                    if (statement == NULL)
+                        return result;
+
+                    enum AstType nextType = statement->child1->type;
+                    if (statement->type != atStatementList || nextType == atTestIfBranch || nextType == atTestElseIfBranch || nextType == atReturn) {
+                        int b = InterpreteAST(statement, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, returnValue, comparisonDict);
+                        return IsControlSignal(b) ? b : result && b;
+                    }
+                }
             }
             break;
         }
         case atLogicalOr: // Set outVal->i to 1 if the statement is true, 0 otherwise
+        case atLogicalAnd:
         {
             if (outVal==NULL) {
-                InterpreterError("No pointer to hold the result of the OR evaluation : outVal is null in atLogicalOr");
+                InterpreterError("No pointer to hold the result of the OR or AND evaluation : outVal is null in atLogicalOr or atLogicalAnd");
                 return 0;
             }
 
-            struct ValueHolder* booleanAndHolder1;
-            if (!CreateValueHolder(&booleanAndHolder1)) {
-                InterpreterError("Error while creating the ValueHolder for booleanAndHolder1 in atLogicalOr");
-                return 0;
-            }
-
-            struct ValueHolder* booleanAndHolder2;
-            if (!CreateValueHolder(&booleanAndHolder2)) {
-                InterpreterError("Error while creating the ValueHolder for booleanAndHolder2 in atLogicalOr");
-                FreeValueHolder(booleanAndHolder1);
-                return 0;
+            // In adaptive mode, the member that decides the result the most often for its cost goes first (see BranchProfile.h)
+            if (IsBranchReordering() && ShouldReorderCondition(ast, *comparisonDict)) {
+                struct AstNode* first = ast->child1;
+                ast->child1 = ast->child2;
+                ast->child2 = first;
             }
 
-            // Evaluate the boolean value of the left and right expressions
-            if (!(InterpreteAST(ast->child1, booleanAndHolder1, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, comparisonDict)
-                    && InterpreteAST(ast->child2, booleanAndHolder2, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, comparisonDict))) {
-                InterpreterError("Error while evaluating the left or right expression of the OR comparison");
-                FreeValueHolder(booleanAndHolder1);
-                FreeValueHolder(booleanAndHolder2);
+            // The right expression is only evaluated if the left one doesn't decide the result (true for an or, false for an and)
+            if (!InterpreteAST(ast->child1, outVal, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, comparisonDict)) {
+                InterpreterError("Error while evaluating the left expression of the OR or AND comparison");
                 return 0;
             }
+            if (IsBranchProfiling())
+                RecordBranch(ast->child1, outVal->i);
 
-            outVal->i = booleanAndHolder1->i || booleanAndHolder2->i;
-
-            return 1;
-            break;
-        }
-        case atLogicalAnd: // Set outVal->i to 1 if the statement is true, 0 otherwise
-        {
-            if (outVal==NULL) {
-                InterpreterError("No pointer to hold the result of the AND evaluation : outVal is null in atLogicalAnd");
-                return 0;
-            }
-
-            struct ValueHolder* booleanAndHolder1;
-            if (!CreateValueHolder(&booleanAndHolder1)) {
-                InterpreterError("Error while creating the ValueHolder for booleanAndHolder1 in atLogicalAnd");
-                return 0;
-            }
-
-            struct ValueHolder* booleanAndHolder2;
-            if (!CreateValueHolder(&booleanAndHolder2)) {
-                InterpreterError("Error while creating the ValueHolder for booleanAndHolder2 in atLogicalAnd");
-                FreeValueHolder(booleanAndHolder1);
-                return 0;
-            }
+            if ((outVal->i != 0) == (ast->type == atLogicalOr))
+                return 1;
 
-            // Evaluate the boolean value of the left and right expressions
-            if (!(InterpreteAST(ast->child1, booleanAndHolder1, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, comparisonDict)
-                    && InterpreteAST(ast->child2, booleanAndHolder2, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, comparisonDict))) {
-                InterpreterError("Error while evaluating the left or right expression of the AND comparison");
-                FreeValueHolder(booleanAndHolder1);
-                FreeValueHolder(booleanAndHolder2);
+            if (!InterpreteAST(ast->child2, outVal, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, comparisonDict)) {
+                InterpreterError("Error while evaluating the right expression of the OR or AND comparison");
                 return 0;
             }
-
-            outVal->i = booleanAndHolder1->i && booleanAndHolder2->i;
+            if (IsBranchProfiling())
+                RecordBranch(ast->child2, outVal->i);
 
             return 1;
             break;
@@ -282,7 +695,17 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                             return 0;
                         }
 
-                        return 1;
+                        break;
+                    case integerTeam:
+                    case floatingTeam:
+                        // ast->i is the number of fighters of the team
+                        if (!CreateTeam(&varValue->team, ast->variableType==integerTeam ? integer : floating, ast->i)) {
+                            InterpreterError("Error while creating the fighters of the team in atVariableDef");
+                            FreeValueHolder(varIdHolder);
+                            FreeVariableStruct(varValue);
+                            return 0;
+                        }
+
                         break;
                     default:
                         InterpreterError("Cannot define a variable with this type");
@@ -293,14 +716,20 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                 }
 
                 // Add varValue to the local hashtable if it exists, to the global one otherwise
-                if ((localSymbolTable!=NULL && !Add_Hashtable(localSymbolTable, varValue->id, varValue))
-                    || !Add_Hashtable(globalSymbolTable, varValue->id, varValue))
+                int added = Add_Hashtable(localSymbolTable!=NULL ? localSymbolTable : globalSymbolTable, varValue->id, varValue);
+                if (!added)
                 {
                     InterpreterError("Error when adding the variable to the hashtable (atVariableDef)");
                     FreeValueHolder(varIdHolder);
                     FreeVariableStruct(varValue);
                     return 0;
                 }
+
+                // A variable defined again keeps its first value, the new one is not in any table
+                if (added == 2)
+                    FreeVariableStruct(varValue);
+                else
+                    TraceWrite(varValue->id, ast->lineNumInCode, varValue);
             }
             else {
                 InterpreterError("Cannot get the Id of the variable in arVariableDef");
@@ -381,6 +810,7 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                     FreeValueHolder(funcIdHolder);
                     Free_Hashtable(_argsTable);
                     FreeArgList(_listOfArgs);
+                    FreeVariableStruct(funcStruct);
                     return 0;
                 }
 
@@ -393,9 +823,7 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                 if (!Add_Hashtable(globalSymbolTable, funcIdHolder->s, funcStruct)) {
                     InterpreterError("Error while adding the function to the global symbol table");
                     FreeValueHolder(funcIdHolder);
-                    Free_Hashtable(_argsTable);
-                    FreeArgList(_listOfArgs);
-                    FreeVariableStruct(funcStruct);
+                    FreeVariableStruct(funcStruct); // Frees the arguments with it
                     return 0;
                 }
 
@@ -406,6 +834,7 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                 return 0;
             }
 
+            FreeValueHolder(funcIdHolder);
             return 1;
             break;
         }
@@ -425,14 +854,15 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                 }
 
                 //Interpretes the if/else_if/else statements using the dicionnary
-                if (!InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, &compDict)) {
+                int branchesResult = InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, &compDict);
+                if (!branchesResult) {
                     InterpreterError("Error in the if/else if/else statement (atTest)");
                     FreeComparisonsDict(compDict);
                     return 0;
                 }
 
                 FreeComparisonsDict(compDict);
-                return 1;
+                return IsControlSignal(branchesResult) ? branchesResult : 1;
                 break;
             }
         case atComparisonDeclaration: // Adds the comparison to the dictionnary
@@ -454,10 +884,9 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
 
             struct ComparisonValue *comparison;
             if (!TryFind_ComparisonsDict(*comparisonDict, ast->i, &comparison)) {
-                char* msg;
-                sprintf(msg, "Unable to find the comparison (match %d) in this dictionnary", ast->i);
+                char msg[80];
+                snprintf(msg, sizeof(msg), "Unable to find the comparison (match %d) in this dictionnary", ast->i);
                 InterpreterError(msg);
-                free(msg);
                 return 0;
             }
 
@@ -656,9 +1085,13 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
             }
 
             // Evaluate the condition and put the result in booleanValueHolder->i (0 = true, 1 = false)
+            int branchResult = 1;
             if (InterpreteAST(ast->child1, booleanValueHolder, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, comparisonDict)) {
+                if (IsBranchProfiling())
+                    RecordBranch(ast->child1, booleanValueHolder->i);
+
                 if (booleanValueHolder->i) { // If the comparison is true, interprete the branch
-                    InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
+                    branchResult = InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
                     outVal->i = 1;
                 }
             }
@@ -669,7 +1102,7 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
             }
 
             FreeValueHolder(booleanValueHolder);
-            return 1;
+            return IsControlSignal(branchResult) ? branchResult : 1;
             break;
         }
         case atTestElseIfBranch: // If the condition is true, launches the atAssignment and set outVal->i to 1
@@ -681,9 +1114,13 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
             }
 
             // Evaluate the condition and put the result in booleanValueHolder->i (0 = true, 1 = false)
+            int branchResult = 1;
             if (InterpreteAST(ast->child1, booleanValueHolder, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, comparisonDict)) {
+                if (IsBranchProfiling())
+                    RecordBranch(ast->child1, booleanValueHolder->i);
+
                 if (booleanValueHolder->i) { // If the comparison is true, interprete the branch
-                    InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
+                    branchResult = InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
                     outVal->i = 1;
                 }
             }
@@ -694,19 +1131,58 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
             }
 
             FreeValueHolder(booleanValueHolder);
-            return 1;
+            return IsControlSignal(branchResult) ? branchResult : 1;
             break;
         }
         case atTestElseBranch:
         {
-            InterpreteAST(ast->child1, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
-            return 1;
+            int branchResult = InterpreteAST(ast->child1, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
+            return IsControlSignal(branchResult) ? branchResult : 1;
             break;
         }
         case atAssignment:
         {
             if (ast->child1->type==atVoid && ast->child2->type==atFuncCall) { // then it's a call of a function without catching the return value
-                InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
+                int callResult = InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
+                if (IsControlSignal(callResult))
+                    return callResult;
+            }
+            else if (ast->child1->type==atTeamElement) // Assignment to a single fighter of a team
+            {
+                struct Team* team;
+                int index;
+                if (!GetTeamElement(ast->child1, globalSymbolTable, localSymbolTable, &team, &index)) {
+                    InterpreterError("Can't find the fighter of the team to assign to in atAssignment");
+                    return 0;
+                }
+
+                struct ValueHolder* valToAssign;
+                if (!CreateValueHolder(&valToAssign)) {
+                    InterpreterError("Error while creating the ValueHolder for valToAssign in atAssignment");
+                    return 0;
+                }
+
+                if (!InterpreteAST(ast->child2, valToAssign, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL)
+                    || (ast->child2->type == atId && !GetSymbolValue(valToAssign->s, &valToAssign, globalSymbolTable, localSymbolTable))) {
+                    InterpreterError("Error while evaluating the right side of the assignment : Cannot get the value to assign in atAssignment");
+                    FreeValueHolder(valToAssign);
+                    return 0;
+                }
+
+                if (valToAssign->variableType != team->elementType) {
+                    InterpreterError("Type of the fighter of the team not matching the type of the other hand of the assignment");
+                    FreeValueHolder(valToAssign);
+                    return 0;
+                }
+
+                if (team->elementType==integer)
+                    team->i[index] = valToAssign->i;
+                else
+                    team->f[index] = valToAssign->f;
+                TraceTeamWrite(ast->child1->child1->s, ast->lineNumInCode);
+
+                FreeValueHolder(valToAssign);
+                return 1;
             }
             else
             {
@@ -741,9 +1217,19 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                         FreeValueHolder(varIdHolder);
                         return 0;
                     }
+                    valToAssign->destinationTeam = varStruct->team;
 
                     // Get the value to assign
-                    if (InterpreteAST(ast->child2, valToAssign, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL)) 
+                    int valueResult = InterpreteAST(ast->child2, valToAssign, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
+
+                    // A called training regimen that met a break or a continue returns no value
+                    if (IsControlSignal(valueResult)) {
+                        FreeValueHolder(varIdHolder);
+                        FreeValueHolder(valToAssign);
+                        return valueResult;
+                    }
+
+                    if (valueResult) 
                     {
                         // If valToAssign is a variable, get its value and put it into valToAssign
                         if (ast->child2->type == atId && !GetSymbolValue(valToAssign->s, &valToAssign, globalSymbolTable, localSymbolTable)) {
@@ -753,6 +1239,16 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                             return 0;
                         }
 
+                        // Assignment to a whole team
+                        if (varStruct->team!=NULL) {
+                            int success = AssignTeam(ast, varStruct, valToAssign);
+                            if (success)
+                                TraceTeamWrite(varStruct->id, ast->lineNumInCode);
+                            FreeValueHolder(varIdHolder);
+                            FreeValueHolder(valToAssign);
+                            return success;
+                        }
+
                         // Check that the type of the variable and the valToAssign is matching
                         if (varStruct->type != valToAssign->variableType) {
                             InterpreterError("Type of the variable not matching the type of the other hand of the assignment");
@@ -785,6 +1281,7 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                                 return 0;
                                 break;
                         }
+                        TraceWrite(varStruct->id, ast->lineNumInCode, varStruct);
 
                         FreeValueHolder(varIdHolder);
                         FreeValueHolder(valToAssign);
@@ -826,6 +1323,8 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                 struct VariableStruct* funcVarStruct;
                 if (TryFind_Hashtable (globalSymbolTable, funcIdHolder->s, &funcVarStruct)) // If the function was defined
                 {
+                    TraceCall(funcVarStruct->id, ast->lineNumInCode);
+
                     // Fill the table of local arguments (argsTable) with the values used to call the function
                     if (ast->child2->type != atVoid)
                     {
@@ -837,15 +1336,53 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                         }
                     }
 
+                    // The result of a pure function only depends on its arguments, so it can be taken from its cache
+                    // (only when it is used : a call that drops its result still runs the body)
+                    struct MemoCache* memoCache = outVal!=NULL ? funcVarStruct->memoCache : NULL;
+                    int32_t memoKey[MEMO_MAX_ARGS];
+                    if (memoCache!=NULL)
+                    {
+                        GetMemoKey(funcVarStruct, memoKey);
+
+                        struct MemoEntry* entry;
+                        if (TryFind_MemoCache(memoCache, memoKey, &entry)) {
+                            outVal->variableType = entry->resultType;
+                            outVal->i = entry->i;
+                            outVal->f = entry->f;
+                            TraceReturn(funcVarStruct->id, ast->lineNumInCode, outVal->variableType, outVal->i, outVal->f);
+
+                            FreeValueHolder(funcIdHolder);
+                            return 1;
+                        }
+                    }
+
                     // Call the function and return the output value
-                    if (!InterpreteAST(funcVarStruct->functionBody, NULL, globalSymbolTable, funcVarStruct->argumentsTable, NULL, NULL, outVal, NULL)) { // If an error occurred while calling the function
-                        char* msg = malloc(37);
-                        sprintf(msg, "Error while calling the function %s", funcVarStruct->id);
+                    InterpreterCheckpoint();
+                    int bodyResult = InterpreteAST(funcVarStruct->functionBody, NULL, globalSymbolTable, funcVarStruct->argumentsTable, NULL, NULL, outVal, NULL);
+
+                    // A break or a continue ends the function and goes up to the loop of the caller
+                    if (IsControlSignal(bodyResult)) {
+                        TraceReturn(funcVarStruct->id, ast->lineNumInCode, noType, 0, 0);
+                        FreeValueHolder(funcIdHolder);
+                        return bodyResult;
+                    }
+
+                    if (!bodyResult) { // If an error occurred while calling the function
+                        char msg[200];
+                        snprintf(msg, sizeof(msg), "Error while calling the function %s", funcVarStruct->id);
                         InterpreterError(msg);
                         FreeValueHolder(funcIdHolder);
-                        free(msg);
                         return 0;
                     }
+
+                    // Only a returned value of the right type is kept (a call that didn't reach its return gives nothing to remember)
+                    if (memoCache!=NULL && outVal->variableType==funcVarStruct->type)
+                        Add_MemoCache(memoCache, memoKey, outVal->variableType, outVal->i, outVal->f);
+
+                    if (outVal!=NULL)
+                        TraceReturn(funcVarStruct->id, ast->lineNumInCode, outVal->variableType, outVal->i, outVal->f);
+                    else
+                        TraceReturn(funcVarStruct->id, ast->lineNumInCode, noType, 0, 0);
                 }
                 else {
                     InterpreterError("Call of an undefined function");
@@ -921,6 +1458,9 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                             return 0;
                             break;
                     }
+                    TraceWrite(foundArg->id, ast->lineNumInCode, foundArg);
+
+                    FreeValueHolder(argVal);
                 }
                 else {
                     InterpreterError("Could not get the value of the argument");
@@ -942,6 +1482,10 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
         }
         case atWhileLoop:
         {
+            // The rounds of a reduction of the main phase can be shared between threads (see ParallelReduction.h)
+            if (localSymbolTable==NULL && RunParallelReduction(ast, globalSymbolTable))
+                return 1;
+
             struct ValueHolder* comparisonResult;
             if (!CreateValueHolder(&comparisonResult)) {
                 InterpreterError("Error while creating the ValueHolder for comparisonResult in atWhileLoop");
@@ -951,8 +1495,10 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
             // Run the loop as long as comparisonResult->i == 0 ie as long as the condition is true
             for (InterpreteAST(ast->child1, comparisonResult, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL); comparisonResult->i; InterpreteAST(ast->child1, comparisonResult, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL))
             {
-                // Run the body of the loop
-                InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL);
+                // Run the body of the loop, a continue only ends the body of this round
+                InterpreterCheckpoint();
+                if (InterpreteAST(ast->child2, NULL, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL) == BREAK_SIGNAL)
+                    break;
             }
 
             FreeValueHolder(comparisonResult);
@@ -1155,9 +1701,8 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
             return 1;
             break;
         }
-        case atBreak:
-            // Need to implement
-            return 1;
+        case atBreak: // Ends the statements up to the nearest loop, which stops
+            return RaiseControlSignal(BREAK_SIGNAL, ast->lineNumInCode);
             break;
         case atReturn: // Assign the return value. The end of the flow is done in atStatementList since it is the only place where a return can exist
         {
@@ -1175,9 +1720,8 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
             return 1;
             break;
         }
-        case atContinue:
-            // Need to implement
-            return 1;
+        case atContinue: // Ends the statements up to the nearest loop, which goes on with its next round
+            return RaiseControlSignal(CONTINUE_SIGNAL, ast->lineNumInCode);
             break;
         case atId: // assigns outVal->s with the name of the variable or function
         {
@@ -1386,6 +1930,14 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                     return 0;
                 }
 
+                // Element-wise operation if one of the members is a team
+                if (IsTeamType(value1->variableType) || IsTeamType(value2->variableType)) {
+                    int success = InterpreteTeamOperation(ast, teamAdd, value1, value2, outVal);
+                    FreeValueHolder(value1);
+                    FreeValueHolder(value2);
+                    return success;
+                }
+
                 if(value2->variableType==integer)
                 {
                     if (value1->variableType==integer)
@@ -1427,9 +1979,9 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                     outVal->variableType=characters;
 
                     if (outVal->s!=NULL)
-                        free(outVal->s);
+                        UfcFree(outVal->s);
 
-                    outVal->s = malloc(1 + strlen(value1->s) + strlen(value2->s));
+                    outVal->s = UfcMalloc(1 + strlen(value1->s) + strlen(value2->s));
                     if (outVal->s == NULL) {
                         InterpreterError("Could not allocate memory for outVal->s in atAdd");
                         FreeValueHolder(value1);
@@ -1501,6 +2053,14 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                     return 0;
                 }
 
+                // Element-wise operation if one of the members is a team
+                if (IsTeamType(value1->variableType) || IsTeamType(value2->variableType)) {
+                    int success = InterpreteTeamOperation(ast, teamMinus, value1, value2, outVal);
+                    FreeValueHolder(value1);
+                    FreeValueHolder(value2);
+                    return success;
+                }
+
                 if(value2->variableType==integer)
                 {
                     if (value1->variableType==integer)
@@ -1597,6 +2157,14 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                     return 0;
                 }
 
+                // Element-wise operation if one of the members is a team
+                if (IsTeamType(value1->variableType) || IsTeamType(value2->variableType)) {
+                    int success = InterpreteTeamOperation(ast, teamMultiply, value1, value2, outVal);
+                    FreeValueHolder(value1);
+                    FreeValueHolder(value2);
+                    return success;
+                }
+
                 if(value2->variableType==integer)
                 {
                     if (value1->variableType==integer)
@@ -1693,6 +2261,14 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                     return 0;
                 }
 
+                // Element-wise operation if one of the members is a team (value2 is divided by value1, as for single fighters)
+                if (IsTeamType(value1->variableType) || IsTeamType(value2->variableType)) {
+                    int success = InterpreteTeamOperation(ast, teamDivide, value2, value1, outVal);
+                    FreeValueHolder(value1);
+                    FreeValueHolder(value2);
+                    return success;
+                }
+
                 if(value2->variableType==integer)
                 {
                     if (value1->i==0) {
@@ -1789,13 +2365,13 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
                 
                 switch(valueToPrint->variableType) {
                     case integer:
-                        printf("%d", valueToPrint->i);
+                        fprintf(GetInterpreterOutput(), "%d", valueToPrint->i);
                     break;
                     case floating:
-                        printf("%f", valueToPrint->f);
+                        fprintf(GetInterpreterOutput(), "%f", valueToPrint->f);
                     break;
                     case characters:
-                        printf("%s", valueToPrint->s);
+                        fprintf(GetInterpreterOutput(), "%s", valueToPrint->s);
                     break;
                     default:
                         InterpreterError("Not a valid variable type to print");
@@ -1816,7 +2392,251 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
         }
         case atPrintEndl:
         {
-            printf("\n");
+            fprintf(GetInterpreterOutput(), "\n");
+
+            return 1;
+            break;
+        }
+        case atTeamElement: // Copies the value of a fighter of a team in outVal
+        {
+            if (outVal==NULL) {
+                InterpreterError("No pointer to hold the value of the fighter : outVal is null in atTeamElement");
+                return 0;
+            }
+
+            struct Team* team;
+            int index;
+            if (!GetTeamElement(ast, globalSymbolTable, localSymbolTable, &team, &index)) {
+                InterpreterError("Can't get the fighter of the team in atTeamElement");
+                return 0;
+            }
+
+            outVal->variableType = team->elementType;
+            if (team->elementType==integer)
+                outVal->i = team->i[index];
+            else
+                outVal->f = team->f[index];
+
+            return 1;
+            break;
+        }
+        case atTeamSize:
+        {
+            if (outVal==NULL) {
+                InterpreterError("No pointer to hold the size of the team : outVal is null in atTeamSize");
+                return 0;
+            }
+
+            struct VariableStruct* teamFighter;
+            if (!GetTeamFighter(ast->child1, globalSymbolTable, localSymbolTable, &teamFighter)) {
+                InterpreterError("Can't find the team in atTeamSize");
+                return 0;
+            }
+
+            outVal->variableType = integer;
+            outVal->i = teamFighter->team->size;
+
+            return 1;
+            break;
+        }
+        case atTeamSum:
+        {
+            if (outVal==NULL) {
+                InterpreterError("No pointer to hold the strength of the team : outVal is null in atTeamSum");
+                return 0;
+            }
+
+            struct VariableStruct* teamFighter;
+            if (!GetTeamFighter(ast->child1, globalSymbolTable, localSymbolTable, &teamFighter)) {
+                InterpreterError("Can't find the team in atTeamSum");
+                return 0;
+            }
+
+            struct Team* team = teamFighter->team;
+            outVal->variableType = team->elementType;
+            if (team->elementType==integer)
+                outVal->i = TeamIntSum(team->i, team->size);
+            else
+                outVal->f = TeamFloatSum(team->f, team->size);
+
+            return 1;
+            break;
+        }
+        case atTeamDot:
+        {
+            if (outVal==NULL) {
+                InterpreterError("No pointer to hold the value of the sparring : outVal is null in atTeamDot");
+                return 0;
+            }
+
+            struct ValueHolder *value1;
+            if (!CreateValueHolder(&value1)) {
+                InterpreterError("Error while creating the ValueHolder for value1 in atTeamDot");
+                return 0;
+            }
+
+            struct ValueHolder *value2;
+            if (!CreateValueHolder(&value2)) {
+                InterpreterError("Error while creating the ValueHolder for value2 in atTeamDot");
+                FreeValueHolder(value1);
+                return 0;
+            }
+
+            if (!InterpreteAST(ast->child1, value1, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL)
+                || !InterpreteAST(ast->child2, value2, globalSymbolTable, localSymbolTable, NULL, NULL, NULL, NULL)
+                || (ast->child1->type == atId && !GetSymbolValue(value1->s, &value1, globalSymbolTable, localSymbolTable))
+                || (ast->child2->type == atId && !GetSymbolValue(value2->s, &value2, globalSymbolTable, localSymbolTable))) {
+                InterpreterError("Could not get the two teams sparring in atTeamDot");
+                FreeValueHolder(value1);
+                FreeValueHolder(value2);
+                return 0;
+            }
+
+            int success = InterpreteTeamDot(ast, value1, value2, outVal);
+
+            FreeValueHolder(value1);
+            FreeValueHolder(value2);
+            return success;
+            break;
+        }
+        case atPrintTeam: // Prints all the fighters of the team separated by spaces
+        {
+            struct VariableStruct* teamFighter;
+            if (!GetTeamFighter(ast->child1, globalSymbolTable, localSymbolTable, &teamFighter)) {
+                InterpreterError("Can't find the team to show in atPrintTeam");
+                return 0;
+            }
+
+            struct Team* team = teamFighter->team;
+            for (int k = 0; k < team->size; k++) {
+                if (team->elementType==integer)
+                    fprintf(GetInterpreterOutput(), k==0 ? "%d" : " %d", team->i[k]);
+                else
+                    fprintf(GetInterpreterOutput(), k==0 ? "%f" : " %f", team->f[k]);
+            }
+
+            return 1;
+            break;
+        }
+        case atAddAssign: // In place update of a fighter with itself (made by RewriteSelfUpdates) : x joins k and hits x
+        case atMinusAssign:
+        case atMultiplyAssign:
+        {
+            struct VariableStruct* varStruct;
+            if (!(localSymbolTable!=NULL && TryFind_Hashtable(localSymbolTable, ast->child1->s, &varStruct)) && !TryFind_Hashtable(globalSymbolTable, ast->child1->s, &varStruct)) {
+                InterpreterError("Can't find the fighter to update");
+                return 0;
+            }
+
+            enum VariableType operandType;
+            int operandI;
+            float operandF;
+            if (!GetUpdateOperand(ast->child2, globalSymbolTable, localSymbolTable, &operandType, &operandI, &operandF)) {
+                InterpreterError("Could not get the value to update the fighter with");
+                return 0;
+            }
+
+            if (operandType!=integer && operandType!=floating) {
+                InterpreterError("Can't do this operation with these types of data");
+                return 0;
+            }
+
+            if (varStruct->type==integer) {
+                // As in atAssignment, the floating result of an operation with a floating can't be given to an integer fighter
+                if (operandType!=integer) {
+                    InterpreterError("Type of the variable not matching the type of the other hand of the assignment");
+                    return 0;
+                }
+
+                if (ast->type==atAddAssign)
+                    varStruct->i += operandI;
+                else if (ast->type==atMinusAssign)
+                    varStruct->i -= operandI;
+                else
+                    varStruct->i *= operandI;
+            }
+            else if (varStruct->type==floating) {
+                float value = operandType==integer ? operandI : operandF;
+
+                if (ast->type==atAddAssign)
+                    varStruct->f += value;
+                else if (ast->type==atMinusAssign)
+                    varStruct->f -= value;
+                else
+                    varStruct->f *= value;
+            }
+            else {
+                InterpreterError("Impossible to update this type of variable in place");
+                return 0;
+            }
+            TraceWrite(varStruct->id, ast->lineNumInCode, varStruct);
+
+            return 1;
+            break;
+        }
+        case atRead: // Gives the next value of the standard input to the fighter, or ends the nearest loop like a break when there is none left
+        {
+            struct VariableStruct* varStruct;
+            if (!(localSymbolTable!=NULL && TryFind_Hashtable(localSymbolTable, ast->child1->s, &varStruct)) && !TryFind_Hashtable(globalSymbolTable, ast->child1->s, &varStruct)) {
+                InterpreterError("Can't find the fighter entering the ring");
+                return 0;
+            }
+            if (varStruct->functionBody!=NULL) {
+                InterpreterError("A training regimen can't enter the ring");
+                return 0;
+            }
+
+            int result;
+            switch (varStruct->type) {
+                case integer:
+                    result = ReadInputInt(&varStruct->i);
+                break;
+                case floating:
+                    result = ReadInputFloat(&varStruct->f);
+                break;
+                case characters:
+                {
+                    const char* word;
+                    int length;
+                    result = ReadInputWord(&word, &length);
+                    if (result!=INPUT_READ)
+                        break;
+
+                    char* s = UfcMalloc(length + 1);
+                    if (s==NULL) {
+                        InterpreterError("Error while allocating memory for the string entering the ring");
+                        return 0;
+                    }
+                    memcpy(s, word, length);
+                    s[length] = '\0';
+
+                    UfcFree(varStruct->s);
+                    varStruct->s = s;
+                break;
+                }
+                case integerTeam:
+                case floatingTeam:
+                {
+                    // The whole team is filled in one call, a team only partly filled at the end of the input keeps its other fighters
+                    struct Team* team = varStruct->team;
+                    result = varStruct->type==integerTeam ? ReadInputInts(team->i, team->size) : ReadInputFloats(team->f, team->size);
+                    if (result!=INPUT_NOT_A_NUMBER)
+                        result = result==team->size ? INPUT_READ : INPUT_END;
+                break;
+                }
+                default:
+                    InterpreterError("This fighter can't enter the ring");
+                    return 0;
+                break;
+            }
+
+            if (result==INPUT_END)
+                return RaiseControlSignal(BREAK_SIGNAL, ast->lineNumInCode);
+            if (result==INPUT_NOT_A_NUMBER) {
+                InterpreterError("The challenger entering the ring is not a number");
+                return 0;
+            }
+            TraceWrite(varStruct->id, ast->lineNumInCode, varStruct);
 
             return 1;
             break;
@@ -1826,4 +2646,86 @@ int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashS
             return 0;
         break;
     }
-}
\ No newline at end of file
+}
+
+int InterpreteDefinitions (struct AstNode* ast, struct HashStruct** outGlobalSymbolTable)
+{
+    if (ast==NULL || ast->type!=atRoot) {
+        fprintf(GetInterpreterOutput(), "InterpreteDefinitions needs the root of the AST\n");
+        return 0;
+    }
+
+    if (!Create_Hashtable(outGlobalSymbolTable)) {
+        InterpreterError("Error while creating the global symbol table in InterpreteDefinitions");
+        return 0;
+    }
+
+    if (!InterpreteMoreDefinitions(ast, *outGlobalSymbolTable)) {
+        Free_Hashtable(*outGlobalSymbolTable);
+        *outGlobalSymbolTable = NULL;
+        return 0;
+    }
+
+    return 1;
+}
+
+int InterpreteMoreDefinitions (struct AstNode* ast, struct HashStruct* globalSymbolTable)
+{
+    if (ast==NULL || ast->type!=atRoot || globalSymbolTable==NULL) {
+        fprintf(GetInterpreterOutput(), "InterpreteMoreDefinitions needs the root of the AST and a global symbol table\n");
+        return 0;
+    }
+
+    // The regimens found impure before are looked at again, since the regimens they call may only be defined now
+    if (!InterpreteAST(ast->child1, NULL, globalSymbolTable, NULL, NULL, NULL, NULL, NULL)
+        || !MarkPureFunctions(globalSymbolTable, memoizationEnabled)) {
+        InterpreterError("Error while interpreting the definitions");
+        return 0;
+    }
+
+    return 1;
+}
+
+int InterpreteMain (struct AstNode* ast, struct HashStruct* globalSymbolTable)
+{
+    int result = InterpreteMainLines(ast, globalSymbolTable);
+    if (IsControlSignal(result))
+        result = 0;
+
+    if (globalSymbolTable!=NULL)
+        PrintMemoStats(globalSymbolTable);
+    PrintBranchStats(ast);
+
+    return result;
+}
+
+int InterpreteMainLines (struct AstNode* ast, struct HashStruct* globalSymbolTable)
+{
+    if (ast==NULL || ast->type!=atRoot || globalSymbolTable==NULL) {
+        fprintf(GetInterpreterOutput(), "InterpreteMain needs the root of the AST and a global symbol table\n");
+        return 0;
+    }
+
+    if (interpreterEngine==closureEngine)
+        return InterpreteMainWithClosures(ast, globalSymbolTable);
+
+    int result = InterpreteAST(ast->child2, NULL, globalSymbolTable, NULL, NULL, NULL, NULL, NULL);
+
+    // The signal is still returned, so that the lines run after these ones can be skipped
+    if (IsControlSignal(result))
+        InterpreterError_Expand("The match can only be interrupted, or a round ended, inside a loop", __LINE__, GetControlSignalLine());
+
+    return result;
+}
+
+int InterpreteProgram (struct AstNode* ast)
+{
+    switch (interpreterEngine) {
+        case closureEngine:
+            return InterpreteWithClosures(ast);
+        case compareEngines:
+            return CompareEngines(ast);
+        default:
+            return InterpreteAST(ast, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+    }
+}
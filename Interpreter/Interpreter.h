@@ -5,6 +5,7 @@
 #include "../Utils/ComparisonDictionnary.h"
 #include "../Utils/Hash.h"
 #include "../Utils/SymbolTableData.h"
+#include "../Utils/GreenThreads.h"
 
 struct ValueHolder 
 {
@@ -13,10 +14,97 @@ struct ValueHolder
     int i;
     float f;
     char* s;
+
+    // Values of a team (variableType integerTeam or floatingTeam)
+    // The team is freed with the ValueHolder only if ownsTeam, otherwise it belongs to a fighter of a symbol table
+    struct Team* team;
+    int ownsTeam;
+    // Team being assigned the value, where the result of a team operation can be written directly instead of in a new team
+    struct Team* destinationTeam;
 };
 
 int CreateValueHolder (struct ValueHolder** valHolder);
 
+void FreeValueHolder (struct ValueHolder* value);
+
+// Sets the stream where the interpreted code writes its output and errors, for the calling thread only
+// NULL sets it back to stdout
+void SetInterpreterOutput(FILE* output);
+FILE* GetInterpreterOutput();
+
+// Sets whether the calls of pure functions are cached (enabled by default)
+// and whether the hits and misses of the caches are printed at the end of each program
+void SetMemoization(int enabled, int printStats);
+
+// Engines that can run the main phase of a program
+// treeEngine walks the AST, closureEngine first compiles it to closures (see ClosureEngine.h), compareEngines runs both and checks they print the same
+enum InterpreterEngine {
+    treeEngine, closureEngine, compareEngines
+};
+
+// Sets the engine used by InterpreteProgram and InterpreteMain (treeEngine by default)
+void SetInterpreterEngine(enum InterpreterEngine engine);
+
+// Interpretes the whole program (ast is the atRoot) with the engine chosen by SetInterpreterEngine
+// Returns 0 if there was an error, 1 otherwise
+int InterpreteProgram (struct AstNode* ast);
+
+// Creates a new global symbol table and fills it with the fighters and training regimens of the definitions phase of the program (ast is the atRoot)
+// Returns 0 if there was an error, 1 otherwise
+int InterpreteDefinitions (struct AstNode* ast, struct HashStruct** outGlobalSymbolTable);
+
+// Adds the fighters and training regimens of the definitions phase of the program (ast is the atRoot) to an existing global symbol table
+// Used by the REPL, where each input only defines or runs a few lines with the fighters and regimens of the previous ones
+// The AST must be kept as long as the global symbol table, since the regimens use their body in it
+// Returns 0 if there was an error (the definitions before the error are kept), 1 otherwise
+int InterpreteMoreDefinitions (struct AstNode* ast, struct HashStruct* globalSymbolTable);
+
+// Interpretes the main phase of the program (ast is the atRoot) with a global symbol table filled by InterpreteDefinitions
+// Returns 0 if there was an error, 1 otherwise
+int InterpreteMain (struct AstNode* ast, struct HashStruct* globalSymbolTable);
+
+// Same as InterpreteMain, without printing the hits and misses of the caches at the end
+// Used to run the main phase a few lines at a time, the statistics being printed once at the end
+// Returns BREAK_SIGNAL or CONTINUE_SIGNAL, after printing the error, if a break or a continue was met outside of a loop :
+// like in a whole main phase, the next lines must then not be run
+int InterpreteMainLines (struct AstNode* ast, struct HashStruct* globalSymbolTable);
+
+/****** Also used by the closure engine ******/
+
+// Copy a char* from source to dest, freeing dest first
+// Return 0 if there was an error (source NULL or empty), 1 otherwise
+int StrFreeAndCopy (char** dest, char* source);
+
+// Copy all the values of the symbol with symbolName key in SymbolTable into outVal
+// Return 0 of an error was met, 1 otherwise
+int GetSymbolValue (char* symbolId, struct ValueHolder** outVal, struct HashStruct* globalSymbolTable, struct HashStruct* localSymbolTable);
+
+// Writes the values of the arguments of a memoized function in key (of size MEMO_MAX_ARGS)
+void GetMemoKey (struct VariableStruct* function, int32_t* key);
+
+// Prints the hits and misses of the cache of every memoized function of the global symbol table, if they were asked with SetMemoization
+void PrintMemoStats (struct HashStruct* globalSymbolTable);
+
+// Suspends the program to let the green thread scheduler run the other ones (see GreenThreads.h), keeping its output stream
+void YieldToOtherPrograms ();
+
+// Checkpoint at every round of a loop and every call of a training regimen, the places where a program can run for a long time
+#define InterpreterCheckpoint() do { if (greenThreadCountdown > 0 && --greenThreadCountdown == 0) YieldToOtherPrograms(); } while (0)
+
+/*********************************************/
+
+// Values returned by InterpreteAST, besides 0 (error) and 1 (success), when a break or a continue was met
+// They end the statement lists, tests and calls of training regimens up to the nearest loop, which stops or goes on with its next round
+#define BREAK_SIGNAL 2
+#define CONTINUE_SIGNAL 3
+#define IsControlSignal(result) ((result)==BREAK_SIGNAL || (result)==CONTINUE_SIGNAL)
+
+// Returns signal after keeping lineInCode, the line of the statement giving it, for the error of a signal met outside of a loop
+int RaiseControlSignal (int signal, int lineInCode);
+
+// Line of the statement that gave the last signal of the program
+int GetControlSignalLine ();
+
 int InterpreteAST (struct AstNode* ast, struct ValueHolder* outVal, struct HashStruct* globalSymbolTable, struct HashStruct* localSymbolTable, struct HashStruct* argsTable, struct ArgList* listOfArgs, struct ValueHolder* returnValue, struct Comparisons_Dict** comparisonDict);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,257 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+
+#include "ParallelReduction.h"
+#include "Interpreter.h"
+#include "BranchProfile.h"
+#include "Trace.h"
+#include "../Optimizer/Reduction.h"
+#include "../Utils/WorkerPool.h"
+#include "../Utils/Allocator.h"
+
+// Parallel reductions option, set once before any program is run
+static int parallelReductions = 0;
+
+// Set while a worker runs a part, so that the loops of the rounds are not shared again
+static _Thread_local int runningPart = 0;
+
+void SetParallelReductions(int enabled)
+{
+    parallelReductions = enabled;
+}
+
+int IsParallelReductions()
+{
+    return parallelReductions;
+}
+
+struct ReductionRun {
+    struct AstNode* loop;
+    struct ReductionLoop* reduction;
+    struct HashStruct* globalSymbolTable;
+    // Memory budget of the program, charged by the workers too
+    struct MemoryBudget* budget;
+
+    int firstCounter;
+    int partCount;
+    int partRounds;
+
+    // Copy of the global symbol table of each worker, made the first time it runs a part and used for all its parts
+    struct HashStruct** workerTables;
+    // Value of each accumulator at the end of each part (part * accumulatorCount + accumulator)
+    int* partI;
+    // Values of the written fighters after the last round, copied at the end of the last part
+    // (the worker that ran it may run an earlier part after it)
+    int* lastI;
+    float* lastF;
+
+    atomic_int failed;
+};
+
+// Finds the fighters of the reduction in the symbol table
+int FindReductionFighter (struct HashStruct* symbolTable, char* id, struct VariableStruct** outFighter) {
+    if (!TryFind_Hashtable(symbolTable, id, outFighter)) {
+        fprintf(GetInterpreterOutput(), "No defined symbol with the name %s (parallel reduction)\n", id);
+        return 0;
+    }
+    return 1;
+}
+
+// Runs the rounds of the part on the copy of the fighters of the worker
+int RunReductionRounds (struct ReductionRun* run, int part, struct HashStruct* symbolTable) {
+    struct ReductionLoop* reduction = run->reduction;
+
+    int first = part * run->partRounds;
+    int last = first + run->partRounds < reduction->roundCount ? first + run->partRounds : reduction->roundCount;
+
+    struct VariableStruct* counter;
+    if (!FindReductionFighter(symbolTable, reduction->counter, &counter))
+        return 0;
+    counter->i = (int) (run->firstCounter + (long long) first * reduction->counterStep);
+
+    for (int a = 0; a < reduction->accumulatorCount; a++) {
+        struct VariableStruct* accumulator;
+        if (!FindReductionFighter(symbolTable, reduction->accumulators[a], &accumulator))
+            return 0;
+
+        accumulator->i = reduction->operations[a] == reductionSum ? 0 : 1;
+    }
+
+    for (int round = first; round < last; round++) {
+        if (atomic_load(&run->failed))
+            return 0;
+
+        // The body has no break nor continue, anything else than a success is an error
+        if (InterpreteAST(run->loop->child2, NULL, symbolTable, NULL, NULL, NULL, NULL, NULL) != 1)
+            return 0;
+    }
+
+    for (int a = 0; a < reduction->accumulatorCount; a++) {
+        struct VariableStruct* accumulator;
+        if (!FindReductionFighter(symbolTable, reduction->accumulators[a], &accumulator))
+            return 0;
+
+        run->partI[part * reduction->accumulatorCount + a] = accumulator->i;
+    }
+
+    if (part == run->partCount - 1) {
+        for (int w = 0; w < reduction->writtenCount; w++) {
+            struct VariableStruct* fighter;
+            if (!FindReductionFighter(symbolTable, reduction->written[w], &fighter))
+                return 0;
+
+            run->lastI[w] = fighter->i;
+            run->lastF[w] = fighter->f;
+        }
+    }
+
+    return 1;
+}
+
+// Runs a part on the worker, from its copy of the fighters
+void RunWorkerReductionPart (struct ReductionRun* run, int part, int workerIndex) {
+    if (atomic_load(&run->failed))
+        return;
+
+    if (run->workerTables[workerIndex] == NULL && !Clone_Hashtable(run->globalSymbolTable, &run->workerTables[workerIndex])) {
+        atomic_store(&run->failed, 1);
+        return;
+    }
+
+    // The errors are kept apart : the loop is then run again round by round, printing them in the order of its rounds
+    char* output = NULL;
+    size_t outputSize = 0;
+    FILE* stream = open_memstream(&output, &outputSize);
+    if (stream == NULL) {
+        atomic_store(&run->failed, 1);
+        return;
+    }
+
+    // The worker 0 is the thread running the program, whose output (a captured stream in batch and table modes) is given back
+    FILE* programOutput = GetInterpreterOutput();
+    SetInterpreterOutput(stream);
+    runningPart = 1;
+    int success = RunReductionRounds(run, part, run->workerTables[workerIndex]);
+    runningPart = 0;
+    SetInterpreterOutput(programOutput);
+
+    fclose(stream);
+    if (!success || outputSize > 0)
+        atomic_store(&run->failed, 1);
+    free(output);
+}
+
+void RunReductionPart (int part, int workerIndex, void* userData) {
+    struct ReductionRun* run = userData;
+
+    // The memory of the part is charged to the program, and the calling thread (the worker 0) gets its own budget back
+    struct MemoryBudget* workerBudget = GetMemoryBudget();
+    SetMemoryBudget(run->budget);
+    RunWorkerReductionPart(run, part, workerIndex);
+    SetMemoryBudget(workerBudget);
+}
+
+// Gives the global fighters the values of the whole loop, from the parts
+int GatherReduction (struct ReductionRun* run) {
+    struct ReductionLoop* reduction = run->reduction;
+
+    struct VariableStruct** accumulators = UfcMalloc(sizeof(struct VariableStruct*) * reduction->accumulatorCount);
+    int* startI = UfcMalloc(sizeof(int) * reduction->accumulatorCount);
+    if (accumulators == NULL || startI == NULL) {
+        UfcFree(accumulators);
+        UfcFree(startI);
+        return 0;
+    }
+
+    int success = 1;
+    for (int a = 0; success && a < reduction->accumulatorCount; a++) {
+        success = FindReductionFighter(run->globalSymbolTable, reduction->accumulators[a], &accumulators[a]);
+        if (success)
+            startI[a] = accumulators[a]->i;
+    }
+
+    // The counter and the fighters assigned by the rounds keep the values of the last round
+    for (int w = 0; success && w < reduction->writtenCount; w++) {
+        struct VariableStruct* fighter;
+        success = FindReductionFighter(run->globalSymbolTable, reduction->written[w], &fighter);
+        if (success) {
+            fighter->i = run->lastI[w];
+            fighter->f = run->lastF[w];
+        }
+    }
+
+    for (int a = 0; success && a < reduction->accumulatorCount; a++) {
+        struct VariableStruct* accumulator = accumulators[a];
+        accumulator->i = startI[a];
+
+        for (int part = 0; part < run->partCount; part++) {
+            int partI = run->partI[part * reduction->accumulatorCount + a];
+            if (reduction->operations[a] == reductionSum)
+                accumulator->i += partI;
+            else
+                accumulator->i *= partI;
+        }
+    }
+
+    UfcFree(accumulators);
+    UfcFree(startI);
+    return success;
+}
+
+int RunParallelReduction (struct AstNode* loop, struct HashStruct* globalSymbolTable) {
+    // The copies of the fighters don't record the trace nor share the profile of the tournaments
+    if (!parallelReductions || runningPart || traceEnabled || IsBranchProfiling())
+        return 0;
+
+    struct ReductionLoop reduction;
+    if (!FindReductionLoop(loop, globalSymbolTable, &reduction))
+        return 0;
+
+    if (reduction.roundCount < REDUCTION_MIN_ROUNDS) {
+        FreeReductionLoop(&reduction);
+        return 0;
+    }
+
+    struct VariableStruct* counter;
+    if (!TryFind_Hashtable(globalSymbolTable, reduction.counter, &counter)) {
+        FreeReductionLoop(&reduction);
+        return 0;
+    }
+
+    struct ReductionRun run = {
+        .loop = loop,
+        .reduction = &reduction,
+        .globalSymbolTable = globalSymbolTable,
+        .budget = GetMemoryBudget(),
+        .firstCounter = counter->i,
+        .partRounds = (reduction.roundCount + REDUCTION_PART_COUNT - 1) / REDUCTION_PART_COUNT
+    };
+    run.partCount = (reduction.roundCount + run.partRounds - 1) / run.partRounds;
+    atomic_init(&run.failed, 0);
+
+    int workerCount = GetProcessorCount();
+    run.workerTables = UfcCalloc(workerCount, sizeof(struct HashStruct*));
+    run.partI = UfcMalloc(sizeof(int) * run.partCount * reduction.accumulatorCount);
+    run.lastI = UfcMalloc(sizeof(int) * reduction.writtenCount);
+    run.lastF = UfcMalloc(sizeof(float) * reduction.writtenCount);
+
+    int success = run.workerTables != NULL && run.partI != NULL && run.lastI != NULL && run.lastF != NULL
+        && RunOnWorkerPool(run.partCount, workerCount, RunReductionPart, &run)
+        && !atomic_load(&run.failed)
+        && GatherReduction(&run);
+
+    if (run.workerTables != NULL) {
+        for (int w = 0; w < workerCount; w++) {
+            if (run.workerTables[w] != NULL)
+                Free_Hashtable(run.workerTables[w]);
+        }
+    }
+    UfcFree(run.workerTables);
+    UfcFree(run.partI);
+    UfcFree(run.lastI);
+    UfcFree(run.lastF);
+    FreeReductionLoop(&reduction);
+
+    return success;
+}
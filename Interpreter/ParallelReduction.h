@@ -0,0 +1,28 @@
+#ifndef __PARALLEL_REDUCTION_H__
+#define __PARALLEL_REDUCTION_H__
+
+#include "../Utils/AST.h"
+#include "../Utils/Hash.h"
+
+// Runs the rounds of a reduction loop (see Reduction.h) on the worker pool. The rounds are cut in parts of consecutive rounds,
+// each run by a worker on its own copy of the global symbol table, starting from the counter of its first round and from
+// accumulators set to 0 (or 1 for a product). The results of the parts are then summed (or multiplied) into the accumulators
+// in the order of the parts, and the other fighters written by the body take their values from the last part.
+// The accumulators are famous fighters, whose sums and products don't depend on their order, so the result is the one of the loop.
+
+// Number of parts the rounds are cut in
+#define REDUCTION_PART_COUNT 64
+
+// Smallest number of rounds for which the loop is shared between the threads, copying the fighters costing more below it
+#define REDUCTION_MIN_ROUNDS 1024
+
+// Sets whether the tree engine runs the reductions on several threads (disabled by default)
+void SetParallelReductions(int enabled);
+int IsParallelReductions();
+
+// Runs the loop (atWhileLoop of the main phase) on several threads if it is a reduction with enough rounds
+// The loops met by the rounds themselves, the traced programs and the profiled tournaments are always run round by round
+// Returns 1 if the loop was run, 0 if it must be run round by round : nothing was changed then, even when one of its parts met an error
+int RunParallelReduction (struct AstNode* loop, struct HashStruct* globalSymbolTable);
+
+#endif
@@ -0,0 +1,252 @@
+#include <string.h>
+
+#include "TeamKernels.h"
+
+// Number of values handled by one vector instruction
+// The floating reductions of the translated C (teamRuntimeCode in Translator.c) add in as many lanes, in the same order
+#define TEAM_VECTOR_LENGTH 8
+
+typedef int IntVector __attribute__ ((vector_size (TEAM_VECTOR_LENGTH * sizeof(int))));
+typedef float FloatVector __attribute__ ((vector_size (TEAM_VECTOR_LENGTH * sizeof(float))));
+
+// The vectors are loaded and stored with memcpy so that any pointer can be used, gcc turns them into plain (unaligned) loads and stores
+
+// out[k] = left[k] op right[k] on whole vectors, then on the last values one by one
+#define TEAM_BINARY_LOOP(vectorType, op) \
+    { \
+        int k = 0; \
+        for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) { \
+            vectorType a, b; \
+            memcpy(&a, left + k, sizeof(vectorType)); \
+            memcpy(&b, right + k, sizeof(vectorType)); \
+            a = a op b; \
+            memcpy(out + k, &a, sizeof(vectorType)); \
+        } \
+        for (; k < size; k++) \
+            out[k] = left[k] op right[k]; \
+    }
+
+// out[k] = team[k] op scalar, or scalar op team[k] if scalarOnLeft
+#define TEAM_SCALAR_LOOP(vectorType, op) \
+    { \
+        int k = 0; \
+        if (scalarOnLeft) { \
+            for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) { \
+                vectorType a; \
+                memcpy(&a, team + k, sizeof(vectorType)); \
+                a = scalar op a; \
+                memcpy(out + k, &a, sizeof(vectorType)); \
+            } \
+            for (; k < size; k++) \
+                out[k] = scalar op team[k]; \
+        } \
+        else { \
+            for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) { \
+                vectorType a; \
+                memcpy(&a, team + k, sizeof(vectorType)); \
+                a = a op scalar; \
+                memcpy(out + k, &a, sizeof(vectorType)); \
+            } \
+            for (; k < size; k++) \
+                out[k] = team[k] op scalar; \
+        } \
+    }
+
+void TeamIntOperation (enum TeamOperation operation, int* out, const int* left, const int* right, int size) {
+    switch (operation) {
+        case teamAdd:
+            TEAM_BINARY_LOOP(IntVector, +)
+            break;
+        case teamMinus:
+            TEAM_BINARY_LOOP(IntVector, -)
+            break;
+        case teamMultiply:
+            TEAM_BINARY_LOOP(IntVector, *)
+            break;
+        case teamDivide: // right must not hold any 0 (checked by the caller)
+            TEAM_BINARY_LOOP(IntVector, /)
+            break;
+    }
+}
+
+void TeamFloatOperation (enum TeamOperation operation, float* out, const float* left, const float* right, int size) {
+    switch (operation) {
+        case teamAdd:
+            TEAM_BINARY_LOOP(FloatVector, +)
+            break;
+        case teamMinus:
+            TEAM_BINARY_LOOP(FloatVector, -)
+            break;
+        case teamMultiply:
+            TEAM_BINARY_LOOP(FloatVector, *)
+            break;
+        case teamDivide:
+            TEAM_BINARY_LOOP(FloatVector, /)
+            break;
+    }
+}
+
+void TeamIntScalarOperation (enum TeamOperation operation, int* out, const int* team, int scalar, int scalarOnLeft, int size) {
+    switch (operation) {
+        case teamAdd:
+            TEAM_SCALAR_LOOP(IntVector, +)
+            break;
+        case teamMinus:
+            TEAM_SCALAR_LOOP(IntVector, -)
+            break;
+        case teamMultiply:
+            TEAM_SCALAR_LOOP(IntVector, *)
+            break;
+        case teamDivide: // The divisor must not be 0 (checked by the caller)
+            TEAM_SCALAR_LOOP(IntVector, /)
+            break;
+    }
+}
+
+void TeamFloatScalarOperation (enum TeamOperation operation, float* out, const float* team, float scalar, int scalarOnLeft, int size) {
+    switch (operation) {
+        case teamAdd:
+            TEAM_SCALAR_LOOP(FloatVector, +)
+            break;
+        case teamMinus:
+            TEAM_SCALAR_LOOP(FloatVector, -)
+            break;
+        case teamMultiply:
+            TEAM_SCALAR_LOOP(FloatVector, *)
+            break;
+        case teamDivide:
+            TEAM_SCALAR_LOOP(FloatVector, /)
+            break;
+    }
+}
+
+void TeamIntToFloat (float* out, const int* in, int size) {
+    int k = 0;
+    for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) {
+        IntVector a;
+        memcpy(&a, in + k, sizeof(IntVector));
+        FloatVector b = __builtin_convertvector(a, FloatVector);
+        memcpy(out + k, &b, sizeof(FloatVector));
+    }
+    for (; k < size; k++)
+        out[k] = in[k];
+}
+
+int TeamIntHasZero (const int* values, int size) {
+    IntVector zeros = { 0 };
+    int k = 0;
+    for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) {
+        IntVector a;
+        memcpy(&a, values + k, sizeof(IntVector));
+        zeros |= a == 0; // -1 where the value is 0
+    }
+    for (int lane = 0; lane < TEAM_VECTOR_LENGTH; lane++) {
+        if (zeros[lane])
+            return 1;
+    }
+
+    for (; k < size; k++) {
+        if (values[k] == 0)
+            return 1;
+    }
+
+    return 0;
+}
+
+int TeamFloatHasZero (const float* values, int size) {
+    IntVector zeros = { 0 };
+    int k = 0;
+    for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) {
+        FloatVector a;
+        memcpy(&a, values + k, sizeof(FloatVector));
+        zeros |= a == 0;
+    }
+    for (int lane = 0; lane < TEAM_VECTOR_LENGTH; lane++) {
+        if (zeros[lane])
+            return 1;
+    }
+
+    for (; k < size; k++) {
+        if (values[k] == 0)
+            return 1;
+    }
+
+    return 0;
+}
+
+// The sums are made in TEAM_VECTOR_LENGTH separate accumulators added together at the end,
+// so a float sum can differ from the sum made in the order of the team in its last digits
+
+int TeamIntSum (const int* values, int size) {
+    IntVector sums = { 0 };
+    int k = 0;
+    for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) {
+        IntVector a;
+        memcpy(&a, values + k, sizeof(IntVector));
+        sums += a;
+    }
+
+    int sum = 0;
+    for (int lane = 0; lane < TEAM_VECTOR_LENGTH; lane++)
+        sum += sums[lane];
+    for (; k < size; k++)
+        sum += values[k];
+
+    return sum;
+}
+
+float TeamFloatSum (const float* values, int size) {
+    FloatVector sums = { 0 };
+    int k = 0;
+    for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) {
+        FloatVector a;
+        memcpy(&a, values + k, sizeof(FloatVector));
+        sums += a;
+    }
+
+    float sum = 0;
+    for (int lane = 0; lane < TEAM_VECTOR_LENGTH; lane++)
+        sum += sums[lane];
+    for (; k < size; k++)
+        sum += values[k];
+
+    return sum;
+}
+
+int TeamIntDot (const int* left, const int* right, int size) {
+    IntVector sums = { 0 };
+    int k = 0;
+    for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) {
+        IntVector a, b;
+        memcpy(&a, left + k, sizeof(IntVector));
+        memcpy(&b, right + k, sizeof(IntVector));
+        sums += a * b;
+    }
+
+    int sum = 0;
+    for (int lane = 0; lane < TEAM_VECTOR_LENGTH; lane++)
+        sum += sums[lane];
+    for (; k < size; k++)
+        sum += left[k] * right[k];
+
+    return sum;
+}
+
+float TeamFloatDot (const float* left, const float* right, int size) {
+    FloatVector sums = { 0 };
+    int k = 0;
+    for (; k + TEAM_VECTOR_LENGTH <= size; k += TEAM_VECTOR_LENGTH) {
+        FloatVector a, b;
+        memcpy(&a, left + k, sizeof(FloatVector));
+        memcpy(&b, right + k, sizeof(FloatVector));
+        sums += a * b;
+    }
+
+    float sum = 0;
+    for (int lane = 0; lane < TEAM_VECTOR_LENGTH; lane++)
+        sum += sums[lane];
+    for (; k < size; k++)
+        sum += left[k] * right[k];
+
+    return sum;
+}
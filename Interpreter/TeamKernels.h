@@ -0,0 +1,39 @@
+#ifndef __TEAM_KERNELS_H__
+#define __TEAM_KERNELS_H__
+
+#include "../Utils/SymbolTableData.h"
+
+// Element-wise operations between teams
+enum TeamOperation
+{
+    teamAdd, teamMinus, teamMultiply, teamDivide
+};
+
+// Bulk arithmetic used by the interpreter when one of the members of joins / tosses away / deals with / tears apart is a team.
+// The loops work on TEAM_VECTOR_LENGTH values at a time with the vector extensions of gcc,
+// which are compiled to SIMD instructions (SSE by default, AVX with -mavx)
+
+// out[k] = left[k] op right[k], for the teams of size values
+void TeamIntOperation (enum TeamOperation operation, int* out, const int* left, const int* right, int size);
+void TeamFloatOperation (enum TeamOperation operation, float* out, const float* left, const float* right, int size);
+
+// out[k] = team[k] op scalar if scalarOnLeft is 0, out[k] = scalar op team[k] otherwise
+void TeamIntScalarOperation (enum TeamOperation operation, int* out, const int* team, int scalar, int scalarOnLeft, int size);
+void TeamFloatScalarOperation (enum TeamOperation operation, float* out, const float* team, float scalar, int scalarOnLeft, int size);
+
+// out[k] = (float) in[k]
+void TeamIntToFloat (float* out, const int* in, int size);
+
+// Returns 1 if one of the values is 0 (to check the divisions before running them)
+int TeamIntHasZero (const int* values, int size);
+int TeamFloatHasZero (const float* values, int size);
+
+// Sum of all the values of a team
+int TeamIntSum (const int* values, int size);
+float TeamFloatSum (const float* values, int size);
+
+// Sum of left[k] * right[k]
+int TeamIntDot (const int* left, const int* right, int size);
+float TeamFloatDot (const float* left, const float* right, int size);
+
+#endif
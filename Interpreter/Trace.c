@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "Trace.h"
+#include "../Utils/Allocator.h"
+
+int traceEnabled = 0;
+
+// Name given a number in the trace, found by the address of its characters (the id of a fighter or of a node)
+struct TraceName {
+    const char* pointer; // NULL for an empty slot of the table
+    char* copy; // To find out when the address is used again by another name
+    uint32_t number;
+};
+
+struct TraceRing {
+    FILE* file;
+
+    // TRACE_CHUNK_COUNT chunks of TRACE_CHUNK_EVENTS events
+    struct TraceEvent* events;
+    int chunkLengths[TRACE_CHUNK_COUNT];
+
+    // Chunk filled by the interpreter, and number of events already in it
+    int fillingChunk;
+    int position;
+
+    // Chunk written by the thread, and number of chunks waiting to be written (from writingChunk)
+    int writingChunk;
+    int readyChunks;
+    int stopping;
+    int writeFailed;
+
+    pthread_mutex_t lock;
+    pthread_cond_t chunkReady;
+    pthread_cond_t chunkWritten;
+    pthread_t writer;
+
+    // Table with open addressing (linear probing), whose capacity is a power of 2 and that is never more than half full
+    struct TraceName* names;
+    size_t nameCapacity;
+    uint32_t nameCount;
+};
+
+static struct TraceRing trace = { .lock = PTHREAD_MUTEX_INITIALIZER, .chunkReady = PTHREAD_COND_INITIALIZER, .chunkWritten = PTHREAD_COND_INITIALIZER };
+
+// Writes the chunks handed over by the interpreter, in order, until the trace is stopped and nothing is left
+void* TraceWriterThread (void* userData) {
+    pthread_mutex_lock(&trace.lock);
+    for (;;) {
+        while (trace.readyChunks == 0 && !trace.stopping)
+            pthread_cond_wait(&trace.chunkReady, &trace.lock);
+        if (trace.readyChunks == 0)
+            break;
+
+        int chunk = trace.writingChunk;
+        pthread_mutex_unlock(&trace.lock);
+
+        size_t length = trace.chunkLengths[chunk];
+        if (fwrite(trace.events + (size_t) chunk * TRACE_CHUNK_EVENTS, sizeof(struct TraceEvent), length, trace.file) != length)
+            trace.writeFailed = 1;
+
+        pthread_mutex_lock(&trace.lock);
+        trace.writingChunk = (chunk + 1) % TRACE_CHUNK_COUNT;
+        trace.readyChunks--;
+        pthread_cond_signal(&trace.chunkWritten);
+    }
+    pthread_mutex_unlock(&trace.lock);
+
+    return NULL;
+}
+
+// Gives the filled chunk to the thread and goes on with the next one, waiting for it to be written if it is still waiting
+void HandOverChunk () {
+    pthread_mutex_lock(&trace.lock);
+    trace.chunkLengths[trace.fillingChunk] = trace.position;
+    trace.readyChunks++;
+    pthread_cond_signal(&trace.chunkReady);
+
+    while (trace.readyChunks == TRACE_CHUNK_COUNT)
+        pthread_cond_wait(&trace.chunkWritten, &trace.lock);
+    pthread_mutex_unlock(&trace.lock);
+
+    trace.fillingChunk = (trace.fillingChunk + 1) % TRACE_CHUNK_COUNT;
+    trace.position = 0;
+}
+
+// Returns count events following each other in a chunk, set to zero
+struct TraceEvent* ReserveEvents (int count) {
+    if (trace.position + count > TRACE_CHUNK_EVENTS)
+        HandOverChunk();
+
+    struct TraceEvent* events = trace.events + (size_t) trace.fillingChunk * TRACE_CHUNK_EVENTS + trace.position;
+    trace.position += count;
+
+    memset(events, 0, sizeof(struct TraceEvent) * count);
+    return events;
+}
+
+int CharacterEvents (size_t length) {
+    return (length + sizeof(struct TraceEvent) - 1) / sizeof(struct TraceEvent);
+}
+
+size_t HashName (const char* pointer) {
+    size_t hash = (size_t) pointer;
+    hash ^= hash >> 17;
+    hash *= 0x9E3779B97F4A7C15ull;
+    return hash ^ (hash >> 29);
+}
+
+int GrowNames () {
+    size_t capacity = trace.nameCapacity * 2;
+    struct TraceName* names = UfcCalloc(capacity, sizeof(struct TraceName));
+    if (names == NULL)
+        return 0;
+
+    for (size_t i = 0; i < trace.nameCapacity; i++) {
+        if (trace.names[i].pointer == NULL)
+            continue;
+
+        size_t slot = HashName(trace.names[i].pointer) & (capacity - 1);
+        while (names[slot].pointer != NULL)
+            slot = (slot + 1) & (capacity - 1);
+        names[slot] = trace.names[i];
+    }
+
+    UfcFree(trace.names);
+    trace.names = names;
+    trace.nameCapacity = capacity;
+    return 1;
+}
+
+// Returns the number of the name, recording it the first time it is used
+uint32_t GetNameNumber (const char* name) {
+    size_t slot = HashName(name) & (trace.nameCapacity - 1);
+    while (trace.names[slot].pointer != NULL) {
+        if (trace.names[slot].pointer == name) {
+            if (!strcmp(trace.names[slot].copy, name))
+                return trace.names[slot].number;
+            break;
+        }
+        slot = (slot + 1) & (trace.nameCapacity - 1);
+    }
+
+    uint32_t number = trace.nameCount++;
+    size_t length = strlen(name);
+    if (length > TRACE_MAX_NAME)
+        length = TRACE_MAX_NAME;
+
+    struct TraceEvent* events = ReserveEvents(1 + CharacterEvents(length));
+    events[0].type = traceName;
+    events[0].name = number;
+    events[0].value.length = length;
+    memcpy(events + 1, name, length);
+
+    // The address now holds another name (the previous one was freed) : it takes its place
+    if (trace.names[slot].pointer == name) {
+        char* copy = UfcStrdup(name);
+        if (copy != NULL) {
+            UfcFree(trace.names[slot].copy);
+            trace.names[slot].copy = copy;
+            trace.names[slot].number = number;
+        }
+        return number;
+    }
+
+    if ((trace.nameCount + 1) * 2 > trace.nameCapacity) {
+        if (!GrowNames())
+            return number;
+        slot = HashName(name) & (trace.nameCapacity - 1);
+        while (trace.names[slot].pointer != NULL)
+            slot = (slot + 1) & (trace.nameCapacity - 1);
+    }
+
+    char* copy = UfcStrdup(name);
+    if (copy != NULL)
+        trace.names[slot] = (struct TraceName) { .pointer = name, .copy = copy, .number = number };
+    return number;
+}
+
+int StartTrace (const char* fileName) {
+    trace.file = fopen(fileName, "wb");
+    if (trace.file == NULL)
+        return 0;
+
+    trace.events = UfcMalloc(sizeof(struct TraceEvent) * TRACE_CHUNK_EVENTS * TRACE_CHUNK_COUNT);
+    trace.nameCapacity = 256;
+    trace.names = UfcCalloc(trace.nameCapacity, sizeof(struct TraceName));
+    if (trace.events == NULL || trace.names == NULL) {
+        UfcFree(trace.events);
+        UfcFree(trace.names);
+        fclose(trace.file);
+        return 0;
+    }
+
+    uint32_t header[4];
+    memcpy(header, TRACE_MAGIC, 8);
+    header[2] = TRACE_VERSION;
+    header[3] = sizeof(struct TraceEvent);
+    fwrite(header, sizeof(header), 1, trace.file);
+
+    trace.fillingChunk = trace.position = 0;
+    trace.writingChunk = trace.readyChunks = 0;
+    trace.stopping = trace.writeFailed = 0;
+    trace.nameCount = 0;
+
+    if (pthread_create(&trace.writer, NULL, TraceWriterThread, NULL) != 0) {
+        UfcFree(trace.events);
+        UfcFree(trace.names);
+        fclose(trace.file);
+        return 0;
+    }
+
+    traceEnabled = 1;
+    return 1;
+}
+
+int StopTrace () {
+    if (!traceEnabled)
+        return 1;
+    traceEnabled = 0;
+
+    if (trace.position > 0)
+        HandOverChunk();
+
+    pthread_mutex_lock(&trace.lock);
+    trace.stopping = 1;
+    pthread_cond_signal(&trace.chunkReady);
+    pthread_mutex_unlock(&trace.lock);
+    pthread_join(trace.writer, NULL);
+
+    int success = !trace.writeFailed && fclose(trace.file) == 0;
+
+    for (size_t i = 0; i < trace.nameCapacity; i++)
+        UfcFree(trace.names[i].copy);
+    UfcFree(trace.names);
+    UfcFree(trace.events);
+
+    return success;
+}
+
+void RecordNodeEntry (struct AstNode* ast) {
+    // The leaves are only read by the node above them
+    if (ast->type == atId || ast->type == atConstant || ast->type == atVoid)
+        return;
+
+    struct TraceEvent* event = ReserveEvents(1);
+    event->type = traceNode;
+    event->nodeType = ast->type;
+    event->line = ast->lineNumInCode;
+}
+
+void RecordCall (const char* name, int line) {
+    uint32_t number = GetNameNumber(name);
+
+    struct TraceEvent* event = ReserveEvents(1);
+    event->type = traceCall;
+    event->line = line;
+    event->name = number;
+}
+
+void RecordReturn (const char* name, int line, enum VariableType type, int i, float f) {
+    uint32_t number = GetNameNumber(name);
+
+    struct TraceEvent* event = ReserveEvents(1);
+    event->type = traceReturn;
+    event->line = line;
+    event->name = number;
+    event->valueType = type;
+    if (type == integer)
+        event->value.i = i;
+    else if (type == floating)
+        event->value.f = f;
+}
+
+void RecordWrite (const char* name, int line, struct VariableStruct* fighter) {
+    if (IsTeamType(fighter->type)) {
+        RecordTeamWrite(name, line);
+        return;
+    }
+
+    uint32_t number = GetNameNumber(name);
+
+    size_t length = fighter->type == characters && fighter->s != NULL ? strlen(fighter->s) : 0;
+    size_t kept = length < TRACE_MAX_STRING ? length : TRACE_MAX_STRING;
+
+    struct TraceEvent* events = ReserveEvents(1 + CharacterEvents(kept));
+    events[0].type = traceWrite;
+    events[0].line = line;
+    events[0].name = number;
+    events[0].valueType = fighter->type;
+    if (fighter->type == integer)
+        events[0].value.i = fighter->i;
+    else if (fighter->type == floating)
+        events[0].value.f = fighter->f;
+    else {
+        events[0].value.length = length;
+        memcpy(events + 1, fighter->s, kept);
+    }
+}
+
+void RecordTeamWrite (const char* name, int line) {
+    uint32_t number = GetNameNumber(name);
+
+    struct TraceEvent* event = ReserveEvents(1);
+    event->type = traceTeamWrite;
+    event->line = line;
+    event->name = number;
+}
@@ -0,0 +1,79 @@
+#ifndef __TRACE_H__
+#define __TRACE_H__
+
+#include <stdint.h>
+#include "../Utils/AST.h"
+#include "../Utils/SymbolTableData.h"
+
+// Execution trace (--trace) : the tree engine records the nodes it enters, the calls of the training regimens and their returns,
+// and every value given to a fighter, each one as a 16 bytes event keyed by the line of the node (lineNumInCode).
+// The events are written in a ring of chunks : the interpreter fills a chunk and hands it to a background thread writing it
+// to the trace file, and only waits when all the chunks are waiting to be written. Reading the events back (TraceReader) replays
+// the program, finds its hot paths and gives the values a fighter went through.
+//
+// Trace file : a header of 16 bytes (TRACE_MAGIC, then the version and the size of an event as uint32_t), then the events.
+// A name (of a fighter or a regimen) is given a number the first time it is used, with a traceName event followed by its characters ;
+// a string given to a fighter follows its traceWrite event the same way (only its first TRACE_MAX_STRING characters).
+// The characters fill as many events as needed, padded with zeros.
+//
+// Only one program can be traced at a time, and the leaves of the AST (fighters, constants, noone) are not recorded.
+
+#define TRACE_MAGIC "UFCTRACE"
+#define TRACE_VERSION 1
+
+#define TRACE_MAX_STRING 64
+// Names longer than this are cut
+#define TRACE_MAX_NAME 240
+
+// Size of the chunks handed to the thread writing the file, and number of chunks of the ring
+#define TRACE_CHUNK_EVENTS 4096
+#define TRACE_CHUNK_COUNT 64
+
+enum TraceEventType {
+    tracePadding,   // Ignored
+    traceName,      // name : number given to the name, length : number of characters following
+    traceNode,      // nodeType : the node entered
+    traceCall,      // name : the regimen called
+    traceReturn,    // name : the regimen, valueType and value : its result (noType if it gave none)
+    traceWrite,     // name : the fighter, valueType and value : its new value (length for a string, followed by its characters)
+    traceTeamWrite  // name : the team, one or all of its fighters changed
+};
+
+struct TraceEvent {
+    uint8_t type;      // enum TraceEventType
+    uint8_t valueType; // enum VariableType
+    uint16_t nodeType; // enum AstType
+    uint32_t line;
+    uint32_t name;
+    union {
+        int32_t i;
+        float f;
+        uint32_t length;
+    } value;
+};
+
+// Set while a trace is recorded, tested by the macros below so that the interpreter only pays for a test without --trace
+extern int traceEnabled;
+
+// Starts recording the programs interpreted by the tree engine in the file fileName
+// Returns 1 if the file and the thread writing it were created, 0 otherwise
+int StartTrace (const char* fileName);
+
+// Writes the events left and closes the trace file
+// Returns 1 if all the events were written, 0 otherwise
+int StopTrace ();
+
+void RecordNodeEntry (struct AstNode* ast);
+void RecordCall (const char* name, int line);
+void RecordReturn (const char* name, int line, enum VariableType type, int i, float f);
+// The new value of the fighter is read in it
+void RecordWrite (const char* name, int line, struct VariableStruct* fighter);
+void RecordTeamWrite (const char* name, int line);
+
+#define TraceNodeEntry(ast) do { if (traceEnabled) RecordNodeEntry(ast); } while (0)
+#define TraceCall(name, line) do { if (traceEnabled) RecordCall(name, line); } while (0)
+#define TraceReturn(name, line, type, i, f) do { if (traceEnabled) RecordReturn(name, line, type, i, f); } while (0)
+#define TraceWrite(name, line, fighter) do { if (traceEnabled) RecordWrite(name, line, fighter); } while (0)
+#define TraceTeamWrite(name, line) do { if (traceEnabled) RecordTeamWrite(name, line); } while (0)
+
+#endif
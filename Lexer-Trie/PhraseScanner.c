@@ -0,0 +1,662 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "PhraseScanner.h"
+#include "../Utils/Allocator.h"
+
+/*************************** Phrases ***************************/
+
+// Characters allowed after the last word of a phrase, like the end of its pattern in UF-C.l
+enum PhraseSuffix {
+    suffixNone,
+    suffixComma, // [,]?
+    suffixColon  // [ ]?[:]?
+};
+
+// Phrases written like the patterns of UF-C.l : [Tt] is one of the characters, (...)? a part that can be left out.
+// When two patterns give the same text, the first one gives the token, as with flex.
+// The single characters (: - ,) are found by the scanner itself
+struct PhrasePattern {
+    const char* pattern;
+    int token;
+    enum PhraseSuffix suffix;
+};
+
+static const struct PhrasePattern phrasePatterns[] = {
+    { "is starting their training with", FUNC_DEF_BEGIN_ARGS, suffixNone },
+    { "to increase their", FUNC_DEF_END_ARGS, suffixNone },
+    { "the smart", FLOAT_FUNC_ARG, suffixNone },
+    { "the famous", INT_FUNC_ARG, suffixNone },
+    { "the massive", STRING_FUNC_ARG, suffixNone },
+    { "noone", VOID, suffixNone },
+    { "[Tt]raining is over", END_FUNC, suffixNone },
+
+    { "has this number of fans", FANS, suffixColon },
+    { "has an IQ of", IQ, suffixNone },
+    { "announces", ANNOUNCES, suffixNone },
+    { "has a team of", TEAM, suffixNone },
+    { "famous fighters", TEAM_INT, suffixNone },
+    { "smart fighters", TEAM_FLOAT, suffixNone },
+
+    { "IQ", TYPE_FLOAT, suffixNone },
+    { "fame", TYPE_INT, suffixNone },
+    { "size", TYPE_STRING, suffixNone },
+    { "effectiveness", TYPE_VOID, suffixNone },
+
+    { "is thrown out", RETURN, suffixNone },
+    { "hits", ASSIGN, suffixNone },
+    { "punches", ASSIGN_FUNC, suffixNone },
+    { "bets on", BEGIN_CONDITION, suffixNone },
+    { "takes the rest of the bets", BEGIN_ELSE, suffixNone },
+    { "[Ff]inally", BEGIN_ELSE_BRANCH, suffixComma },
+    { "([Aa]nd )?[Tt]he gambling den closes", END_CONDITION, suffixNone },
+    { "and", AND, suffixNone },
+    { "using", BEGIN_ARGS, suffixNone },
+    { "with", BEGIN_ARGS, suffixNone },
+    { "enrolls", BEGIN_ARGS, suffixNone },
+    { "and gives the money to", BEGIN_RETURN_VAR, suffixNone },
+    { "[Aa] new tournament begins", BEGIN_TEST, suffixNone },
+    { "([Aa]nd )?[Tt]he gambling den opens", BEGIN_BRANCH, suffixNone },
+    { "[Mm]atch", BEGIN_COMPARISON, suffixNone },
+
+    { "challenges", TEST_GTR, suffixNone },
+    { "fights", TEST_STR_GTR, suffixNone },
+
+    { "beats down", WHILE, suffixNone },
+    { "until they give up", LOOP_NOTNULL, suffixNone },
+    { "until someone splits them up", LOOP_EQ, suffixNone },
+    { "until they fight back", LOOP_GTR, suffixNone },
+    { "until they come to an agreement", LOOP_NOT_EQ, suffixNone },
+    { "[Mm]eanwhile", LOOP_BEGIN_ACTION, suffixComma },
+
+    { "[Tt]he match is interrupted", BREAK, suffixNone },
+    { "[Ee]nd of the round", CONTINUE, suffixNone },
+    { "[Aa] challenger enters the ring as", READ, suffixNone },
+
+    { "[tT]he ring girl shows", PRINT, suffixNone },
+    { "the fans of", PRINT_INT, suffixNone },
+    { "the wits of", PRINT_FLOAT, suffixNone },
+    { "the flow of", PRINT_STRING, suffixNone },
+    { "the team", PRINT_TEAM, suffixNone },
+    { "[Aa] time out is announced", PRINT_ENDL, suffixNone },
+
+    { "joins", ADD, suffixNone },
+    { "tosses away", MINUS, suffixNone },
+    { "tears apart", DIVIDE, suffixNone },
+    { "deals with", MULTIPLY, suffixNone },
+    { "spars with", TEAM_DOT, suffixNone },
+
+    { "the fighter", TEAM_ELEMENT, suffixNone },
+    { "of the team", TEAM_OF, suffixNone },
+    { "the size of the team", TEAM_SIZE, suffixNone },
+    { "the strength of the team", TEAM_SUM, suffixNone },
+
+    { "([Aa]nd )?[Tt]he competition begins", DEFINITIONS_END, suffixNone },
+};
+
+/*************************** Trie ***************************/
+
+// Room for the trie of the phrases above, with all their spellings
+#define PHRASE_MAX_NODES 512
+#define PHRASE_MAX_LENGTH 128
+#define PHRASE_WORDS_SIZE 4096
+// Number of slots of the table of the edges (a power of 2, well above the number of nodes)
+#define PHRASE_EDGE_SLOTS 2048
+
+// A node is reached from its parent by one word, the root (node 0) being the start of every phrase
+struct PhraseNode {
+    const char* word;
+    int length;
+
+    // Token of the phrase ending with this word, 0 if no phrase ends here
+    int token;
+    enum PhraseSuffix suffix;
+
+    int hasChildren;
+    // Children ending a phrase, linked through nextEndingSibling (0 ends the list), for the words cut by the next token
+    int firstEndingChild;
+    int nextEndingSibling;
+};
+
+// Edges of the trie in one table, found from the parent and the hash of the word
+struct PhraseEdge {
+    unsigned hash;
+    int parent;
+    int child; // 0 for a free slot
+};
+
+static struct PhraseNode phraseNodes[PHRASE_MAX_NODES];
+static int phraseNodeCount = 1;
+static struct PhraseEdge phraseEdges[PHRASE_EDGE_SLOTS];
+static char phraseWords[PHRASE_WORDS_SIZE];
+static int phraseWordsLength = 0;
+
+// Letters, digits and underscores, the characters of the identifiers ([a-zA-Z0-9_]+) and of the words of the phrases
+static unsigned char wordCharacters[256];
+
+static pthread_once_t trieOnce = PTHREAD_ONCE_INIT;
+static int trieCompiled = 0;
+
+#define IsWordCharacter(c) wordCharacters[(unsigned char) (c)]
+#define IsDigit(c) ((c) >= '0' && (c) <= '9')
+
+// Hash of a word, computed by the scanner while it reads the word
+#define HashCharacter(hash, c) ((hash) * 33 + (unsigned char) (c))
+
+static unsigned GetEdgeSlot (int parent, unsigned hash) {
+    return (hash + (unsigned) parent * 2654435761u) & (PHRASE_EDGE_SLOTS - 1);
+}
+
+// Returns the child of parent reached by the word, 0 if there is none
+static int FindChild (int parent, const char* word, int length, unsigned hash) {
+    unsigned slot = GetEdgeSlot(parent, hash);
+    while (phraseEdges[slot].child != 0) {
+        struct PhraseEdge* edge = &phraseEdges[slot];
+        struct PhraseNode* child = &phraseNodes[edge->child];
+        if (edge->hash == hash && edge->parent == parent && child->length == length && !memcmp(child->word, word, length))
+            return edge->child;
+        slot = (slot + 1) & (PHRASE_EDGE_SLOTS - 1);
+    }
+    return 0;
+}
+
+static int AddChild (int parent, const char* word, int length, unsigned hash) {
+    if (phraseNodeCount == PHRASE_MAX_NODES || phraseWordsLength + length > PHRASE_WORDS_SIZE || phraseNodeCount * 2 > PHRASE_EDGE_SLOTS)
+        return 0;
+
+    int child = phraseNodeCount++;
+    memcpy(phraseWords + phraseWordsLength, word, length);
+    phraseNodes[child].word = phraseWords + phraseWordsLength;
+    phraseNodes[child].length = length;
+    phraseWordsLength += length;
+    phraseNodes[parent].hasChildren = 1;
+
+    unsigned slot = GetEdgeSlot(parent, hash);
+    while (phraseEdges[slot].child != 0)
+        slot = (slot + 1) & (PHRASE_EDGE_SLOTS - 1);
+    phraseEdges[slot] = (struct PhraseEdge) { hash, parent, child };
+
+    return child;
+}
+
+// Adds the words of the phrase (separated by single spaces) to the trie
+static int AddPhrase (const char* phrase, int token, enum PhraseSuffix suffix) {
+    int parent = 0, node = 0;
+
+    while (*phrase != '\0') {
+        const char* word = phrase;
+        unsigned hash = 0;
+        while (*phrase != '\0' && *phrase != ' ') {
+            hash = HashCharacter(hash, *phrase);
+            phrase++;
+        }
+        int length = (int) (phrase - word);
+        if (*phrase == ' ')
+            phrase++;
+
+        parent = node;
+        node = FindChild(parent, word, length, hash);
+        if (node == 0)
+            node = AddChild(parent, word, length, hash);
+        if (node == 0)
+            return 0;
+    }
+
+    if (node != 0 && phraseNodes[node].token == 0) {
+        phraseNodes[node].token = token;
+        phraseNodes[node].suffix = suffix;
+        phraseNodes[node].nextEndingSibling = phraseNodes[parent].firstEndingChild;
+        phraseNodes[parent].firstEndingChild = node;
+    }
+    return 1;
+}
+
+// Adds every spelling of the pattern, the beginning of which was already written in phrase
+static int ExpandPattern (const char* pattern, char* phrase, int length, int token, enum PhraseSuffix suffix) {
+    if (length >= PHRASE_MAX_LENGTH)
+        return 0;
+
+    if (*pattern == '\0') {
+        phrase[length] = '\0';
+        return AddPhrase(phrase, token, suffix);
+    }
+
+    if (*pattern == '[') {
+        const char* end = strchr(pattern, ']');
+        for (const char* c = pattern + 1; c < end; c++) {
+            phrase[length] = *c;
+            if (!ExpandPattern(end + 1, phrase, length + 1, token, suffix))
+                return 0;
+        }
+        return 1;
+    }
+
+    if (*pattern == '(') {
+        const char* end = strchr(pattern, ')');
+        const char* rest = end + 2; // After ")?"
+        char withPart[PHRASE_MAX_LENGTH];
+        snprintf(withPart, sizeof(withPart), "%.*s%s", (int) (end - pattern - 1), pattern + 1, rest);
+
+        return ExpandPattern(rest, phrase, length, token, suffix) && ExpandPattern(withPart, phrase, length, token, suffix);
+    }
+
+    phrase[length] = *pattern;
+    return ExpandPattern(pattern + 1, phrase, length + 1, token, suffix);
+}
+
+static void CompilePhraseTrie () {
+    for (int c = 0; c < 256; c++)
+        wordCharacters[c] = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || IsDigit(c) || c == '_';
+
+    char phrase[PHRASE_MAX_LENGTH];
+    for (size_t p = 0; p < sizeof(phrasePatterns) / sizeof(phrasePatterns[0]); p++) {
+        if (!ExpandPattern(phrasePatterns[p].pattern, phrase, 0, phrasePatterns[p].token, phrasePatterns[p].suffix))
+            return;
+    }
+
+    trieCompiled = 1;
+}
+
+/*************************** Scanner ***************************/
+
+// Start conditions of UF-C.l
+enum PhraseCondition {
+    conditionInitial, conditionComment, conditionString
+};
+
+#define NO_LINE_END ((size_t) -1)
+
+struct PhraseScanner {
+    FILE* input;
+    struct ParserState* state;
+    int interactive;
+
+    // The characters not scanned yet start at position, and buffer[length] is always '\0'
+    char* buffer;
+    size_t capacity, length, position;
+    int inputOver;
+    // First end of line at or after position, or NO_LINE_END if it must be looked for
+    size_t lineEnd;
+
+    enum PhraseCondition condition;
+
+    // Text of the last token, ended by a '\0' written over the character following it and put back by the next call
+    char* text;
+    char* heldPlace;
+    char heldCharacter;
+};
+
+// Stops the program like flex does when it can't get memory
+static void PhraseScannerFatalError (const char* message) {
+    fprintf(stderr, "%s\n", message);
+    exit(2);
+}
+
+static void ReserveBuffer (struct PhraseScanner* scanner, size_t size) {
+    if (size <= scanner->capacity)
+        return;
+
+    size_t capacity = scanner->capacity * 2 > size ? scanner->capacity * 2 : size;
+    char* buffer = UfcRealloc(scanner->buffer, capacity);
+    if (buffer == NULL)
+        PhraseScannerFatalError("out of dynamic memory in the phrase scanner");
+    scanner->buffer = buffer;
+    scanner->capacity = capacity;
+}
+
+// Reads more of the input after the characters not scanned yet, which are first moved to the start of the buffer
+static void ReadInput (struct PhraseScanner* scanner) {
+    if (scanner->position > 0) {
+        memmove(scanner->buffer, scanner->buffer + scanner->position, scanner->length - scanner->position);
+        scanner->length -= scanner->position;
+        if (scanner->lineEnd != NO_LINE_END)
+            scanner->lineEnd -= scanner->position;
+        scanner->position = 0;
+    }
+
+    if (!scanner->interactive) {
+        ReserveBuffer(scanner, scanner->length + PHRASE_READ_SIZE + 1);
+        size_t count = fread(scanner->buffer + scanner->length, 1, PHRASE_READ_SIZE, scanner->input);
+        scanner->length += count;
+        if (count == 0)
+            scanner->inputOver = 1;
+    }
+    else {
+        // Nothing after the end of the line is waited for
+        int c;
+        do {
+            c = getc(scanner->input);
+            if (c == EOF) {
+                scanner->inputOver = 1;
+                break;
+            }
+            ReserveBuffer(scanner, scanner->length + 2);
+            scanner->buffer[scanner->length++] = (char) c;
+        } while (c != '\n');
+    }
+
+    scanner->buffer[scanner->length] = '\0';
+}
+
+// Returns the index of the first character c at or after the position, reading the input until it comes,
+// or the length of the buffer if the input ends before
+static size_t FindCharacter (struct PhraseScanner* scanner, char c) {
+    size_t from = scanner->position;
+    for (;;) {
+        char* found = memchr(scanner->buffer + from, c, scanner->length - from);
+        if (found != NULL)
+            return found - scanner->buffer;
+        if (scanner->inputOver)
+            return scanner->length;
+
+        size_t scanned = scanner->length - scanner->position;
+        ReadInput(scanner);
+        from = scanner->position + scanned;
+    }
+}
+
+// Makes sure the whole line of the position is in the buffer : no token but the strings goes past the end of a line
+static void ReadLine (struct PhraseScanner* scanner) {
+    if (scanner->lineEnd == NO_LINE_END || scanner->lineEnd < scanner->position)
+        scanner->lineEnd = FindCharacter(scanner, '\n');
+}
+
+// Same as YY_USER_ACTION in UF-C.l, for a match of length characters
+static void MatchCharacters (struct ParserState* state, int length) {
+    state->charPosInLine += length;
+    state->previousTokenLength = state->currentTokenLength;
+    state->currentTokenLength = length;
+}
+
+static void NewLine (struct ParserState* state) {
+    ++state->lineNumber;
+    state->charPosInLine = 1;
+    state->previousTokenLength = 0;
+    state->currentTokenLength = 0;
+}
+
+// Goes over count characters ignored one at a time by the scanner
+static void SkipCharacters (struct PhraseScanner* scanner, int count) {
+    struct ParserState* state = scanner->state;
+    state->charPosInLine += count;
+    state->previousTokenLength = count > 1 ? 1 : state->currentTokenLength;
+    state->currentTokenLength = 1;
+    scanner->position += count;
+}
+
+// Goes over a match that gives no token
+static void SkipMatch (struct PhraseScanner* scanner, int length) {
+    MatchCharacters(scanner->state, length);
+    scanner->position += length;
+}
+
+// Gives the length characters at the position as the text of the token
+static int GiveToken (struct PhraseScanner* scanner, int length, int token) {
+    MatchCharacters(scanner->state, length);
+    scanner->text = scanner->buffer + scanner->position;
+    scanner->position += length;
+
+    scanner->heldPlace = scanner->buffer + scanner->position;
+    scanner->heldCharacter = *scanner->heldPlace;
+    *scanner->heldPlace = '\0';
+    return token;
+}
+
+// Number of characters of the end of the pattern of the node found at text
+static int GetSuffixLength (struct PhraseNode* node, const char* text) {
+    switch (node->suffix) {
+        case suffixComma:
+            return *text == ',';
+        case suffixColon:
+        {
+            int length = *text == ' ';
+            return length + (text[length] == ':');
+        }
+        default:
+            return 0;
+    }
+}
+
+// Integer or float, or an identifier starting with digits if it is longer
+static int ScanNumber (struct PhraseScanner* scanner, YYSTYPE* value) {
+    const char* start = scanner->buffer + scanner->position;
+    const char* end = *start == '-' ? start + 1 : start;
+    while (IsDigit(*end))
+        end++;
+
+    if (*start != '-') {
+        const char* identifierEnd = end;
+        while (IsWordCharacter(*identifierEnd))
+            identifierEnd++;
+
+        if (identifierEnd > end) {
+            GiveToken(scanner, (int) (identifierEnd - start), STRING);
+            value->sval = UfcStrdup(scanner->text);
+            return STRING;
+        }
+    }
+
+    if (*end == '.' && IsDigit(end[1])) {
+        end++;
+        while (IsDigit(*end))
+            end++;
+
+        GiveToken(scanner, (int) (end - start), FLOAT);
+        value->fval = atof(scanner->text);
+        return FLOAT;
+    }
+
+    GiveToken(scanner, (int) (end - start), INT);
+    value->ival = atoi(scanner->text);
+    return INT;
+}
+
+// Longest phrase starting at the position, or the identifier made of its first word
+static int ScanPhrase (struct PhraseScanner* scanner, YYSTYPE* value) {
+    const char* start = scanner->buffer + scanner->position;
+    const char* end = start;
+    unsigned hash = 0;
+    while (IsWordCharacter(*end)) {
+        hash = HashCharacter(hash, *end);
+        end++;
+    }
+    int identifierLength = (int) (end - start);
+
+    int bestLength = 0, bestToken = 0;
+    int node = FindChild(0, start, identifierLength, hash);
+    if (node != 0 && phraseNodes[node].token != 0) {
+        bestLength = identifierLength + GetSuffixLength(&phraseNodes[node], end);
+        bestToken = phraseNodes[node].token;
+    }
+
+    // Each word followed adds its length to the phrase, so the last phrase found is the longest one
+    while (node != 0 && phraseNodes[node].hasChildren && *end == ' ' && IsWordCharacter(end[1])) {
+        const char* word = end + 1;
+        end = word;
+        hash = 0;
+        while (IsWordCharacter(*end)) {
+            hash = HashCharacter(hash, *end);
+            end++;
+        }
+        int length = (int) (end - word);
+
+        int child = FindChild(node, word, length, hash);
+        if (child != 0 && phraseNodes[child].token != 0) {
+            bestLength = (int) (end - start) + GetSuffixLength(&phraseNodes[child], end);
+            bestToken = phraseNodes[child].token;
+        }
+        else {
+            // As flex matches characters and not words, a phrase can end in the middle of a word (the fightersX is the fighter, then fightersX)
+            for (int ending = phraseNodes[node].firstEndingChild; ending != 0; ending = phraseNodes[ending].nextEndingSibling) {
+                struct PhraseNode* endingNode = &phraseNodes[ending];
+                int endingLength = (int) (word - start) + endingNode->length;
+                if (endingNode->length < length && endingLength > bestLength && !memcmp(endingNode->word, word, endingNode->length)) {
+                    bestLength = endingLength;
+                    bestToken = endingNode->token;
+                }
+            }
+        }
+
+        node = child;
+    }
+
+    // A phrase of one word is as long as the identifier, and comes before it in UF-C.l
+    if (bestToken != 0)
+        return GiveToken(scanner, bestLength, bestToken);
+
+    GiveToken(scanner, identifierLength, STRING);
+    value->sval = UfcStrdup(scanner->text);
+    return STRING;
+}
+
+int CreatePhraseScanner(FILE* input, struct ParserState* state, struct PhraseScanner** outScanner) {
+    pthread_once(&trieOnce, CompilePhraseTrie);
+    if (!trieCompiled)
+        return 0;
+
+    struct PhraseScanner* scanner = UfcCalloc(1, sizeof(struct PhraseScanner));
+    if (scanner == NULL)
+        return 0;
+
+    scanner->capacity = PHRASE_READ_SIZE + 1;
+    scanner->buffer = UfcMalloc(scanner->capacity);
+    if (scanner->buffer == NULL) {
+        UfcFree(scanner);
+        return 0;
+    }
+    scanner->buffer[0] = '\0';
+    scanner->text = scanner->buffer;
+
+    scanner->input = input;
+    scanner->state = state;
+    // Like flex, a terminal is read one line at a time
+    scanner->interactive = isatty(fileno(input)) > 0;
+    scanner->lineEnd = NO_LINE_END;
+    scanner->condition = conditionInitial;
+
+    *outScanner = scanner;
+    return 1;
+}
+
+void DestroyPhraseScanner(struct PhraseScanner* scanner) {
+    UfcFree(scanner->buffer);
+    UfcFree(scanner);
+}
+
+void SetPhraseScannerInteractive(struct PhraseScanner* scanner, int interactive) {
+    scanner->interactive = interactive;
+}
+
+char* GetPhraseTokenText(struct PhraseScanner* scanner) {
+    return scanner->text;
+}
+
+struct ParserState* GetPhraseScannerState(struct PhraseScanner* scanner) {
+    return scanner->state;
+}
+
+int NextPhraseToken(struct PhraseScanner* scanner, YYSTYPE* value) {
+    struct ParserState* state = scanner->state;
+
+    if (scanner->heldPlace != NULL) {
+        *scanner->heldPlace = scanner->heldCharacter;
+        scanner->heldPlace = NULL;
+    }
+
+    for (;;) {
+        if (scanner->condition == conditionString) {
+            size_t quote = FindCharacter(scanner, '"');
+            if (scanner->position == scanner->length)
+                break;
+
+            state->stringLength++;
+            if (quote == scanner->position) {
+                SkipMatch(scanner, 1);
+                scanner->condition = conditionInitial;
+            }
+            else if (quote == scanner->position + 1 && scanner->buffer[scanner->position] == '\n') {
+                SkipMatch(scanner, 1);
+                NewLine(state);
+            }
+            else {
+                // The lines of the string are not counted, as in UF-C.l
+                GiveToken(scanner, (int) (quote - scanner->position), STRING_CONSTANT);
+                value->sval = UfcStrdup(scanner->text);
+                return STRING_CONSTANT;
+            }
+            continue;
+        }
+
+        ReadLine(scanner);
+        if (scanner->position == scanner->length)
+            break;
+
+        const char* start = scanner->buffer + scanner->position;
+
+        if (scanner->condition == conditionComment) {
+            if (start[0] == '*' && start[1] == '/') {
+                SkipMatch(scanner, 2);
+                scanner->condition = conditionInitial;
+            }
+            else if (start[0] == '\n') {
+                SkipMatch(scanner, 1);
+                NewLine(state);
+            }
+            else {
+                const char* end = start + 1;
+                while (*end != '*' && *end != '\n' && end < scanner->buffer + scanner->length)
+                    end++;
+                SkipCharacters(scanner, (int) (end - start));
+            }
+            continue;
+        }
+
+        if (IsWordCharacter(*start))
+            return IsDigit(*start) ? ScanNumber(scanner, value) : ScanPhrase(scanner, value);
+
+        switch (*start) {
+            case '\n':
+                GiveToken(scanner, 1, ENDL);
+                NewLine(state);
+                return ENDL;
+            case ':':
+                return GiveToken(scanner, 1, COLON);
+            case ',':
+                return GiveToken(scanner, 1, COMMA);
+            case '-':
+                if (IsDigit(start[1]))
+                    return ScanNumber(scanner, value);
+                return GiveToken(scanner, 1, HYPHEN);
+            case '/':
+                if (start[1] == '*') {
+                    SkipMatch(scanner, 2);
+                    scanner->condition = conditionComment;
+                }
+                else
+                    SkipCharacters(scanner, 1);
+                break;
+            case '"':
+                SkipMatch(scanner, 1);
+                scanner->condition = conditionString;
+                state->stringLength = 0;
+                break;
+            default:
+            {
+                // Spaces, tabs and the other characters are ignored one at a time
+                const char* end = start + 1;
+                while ((*end == ' ' || *end == '\t') && end < scanner->buffer + scanner->length)
+                    end++;
+                SkipCharacters(scanner, (int) (end - start));
+                break;
+            }
+        }
+    }
+
+    // End of the input, in every start condition
+    scanner->text = scanner->buffer + scanner->length;
+    state->inputEnded = 1;
+    return 0;
+}
@@ -0,0 +1,38 @@
+#ifndef __PHRASE_SCANNER_H__
+#define __PHRASE_SCANNER_H__
+
+#include <stdio.h>
+
+#include "../Parser-Bison/UF-C.tab.h"
+
+// Scanner giving the same tokens as the flex scanner (UF-C.l), with the same positions in the state of the parsing.
+// Most tokens of UF-C are phrases of several words : instead of one automaton running character by character over all the
+// patterns, the phrases are put in a trie of words, compiled once. The scanner reads a whole word (a run of letters, digits
+// and underscores) while hashing it, and follows the trie one word at a time as long as the input goes on with a space and
+// another word. The longest phrase found is then compared with the identifier made of the first word, like flex does.
+// TrieLexer.c gives it the interface of the flex scanner, so that the parser can be built with either of them.
+
+// Size of the blocks read from the input (one line at a time for an interactive input)
+#define PHRASE_READ_SIZE (64 * 1024)
+
+struct PhraseScanner;
+
+// Creates a scanner reading the input, keeping the position of the tokens in state
+// Returns 1 if it was created, 0 otherwise
+int CreatePhraseScanner(FILE* input, struct ParserState* state, struct PhraseScanner** outScanner);
+
+void DestroyPhraseScanner(struct PhraseScanner* scanner);
+
+// Makes the scanner read the input one line at a time, like it already does for a terminal,
+// so that the lines coming from a pipe are parsed as soon as they arrive
+void SetPhraseScannerInteractive(struct PhraseScanner* scanner, int interactive);
+
+// Returns the next token, with its value in value for the identifiers, numbers and strings, or 0 at the end of the input
+int NextPhraseToken(struct PhraseScanner* scanner, YYSTYPE* value);
+
+// Text of the last token given, valid until the next call
+char* GetPhraseTokenText(struct PhraseScanner* scanner);
+
+struct ParserState* GetPhraseScannerState(struct PhraseScanner* scanner);
+
+#endif
@@ -0,0 +1,39 @@
+#include "PhraseScanner.h"
+
+// Interface of the flex scanner used by the parser (see UF-C.y), given by the phrase scanner
+// Built instead of lex.UF-C.c by make UF-C-trie
+
+int yylex(YYSTYPE* yylval_param, yyscan_t scanner)
+{
+  return NextPhraseToken(scanner, yylval_param);
+}
+
+struct ParserState* yyget_extra(yyscan_t scanner)
+{
+  return GetPhraseScannerState(scanner);
+}
+
+char* yyget_text(yyscan_t scanner)
+{
+  return GetPhraseTokenText(scanner);
+}
+
+int CreateLexer(FILE* input, struct ParserState* state, yyscan_t* outScanner)
+{
+  struct PhraseScanner* scanner;
+  if (!CreatePhraseScanner(input, state, &scanner))
+    return 0;
+
+  *outScanner = scanner;
+  return 1;
+}
+
+void DestroyLexer(yyscan_t scanner)
+{
+  DestroyPhraseScanner(scanner);
+}
+
+void SetLexerInteractive(yyscan_t scanner, int interactive)
+{
+  SetPhraseScannerInteractive(scanner, interactive);
+}
@@ -0,0 +1,381 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../Lexer-Trie/PhraseScanner.h"
+#include "../Utils/Allocator.h"
+#include "../Utils/FileReader.h"
+
+// Compares the phrase scanner (PhraseScanner.h) with the flex scanner (UF-C.l) :
+//   UF-C-lex-bench compare FILE... : both scanners must give the same tokens, values, texts and positions for each file
+//   UF-C-lex-bench fuzz [COUNT] [SEED] : same as compare, on COUNT (1000 by default) inputs made of random pieces of phrases
+//   UF-C-lex-bench bench FILE [REPEAT] : speed of both scanners on the file, in MB/s (best of REPEAT runs, 5 by default)
+//   UF-C-lex-bench tokens FILE [flex|phrase] : tokens given by one of the scanners (the phrase scanner by default)
+// The inputs are read from memory, so that only the scanning is timed.
+
+#define DEFAULT_FUZZ_COUNT 1000
+#define DEFAULT_BENCH_REPEAT 5
+
+// Most pieces put together by a fuzzed input
+#define FUZZ_MAX_PIECES 300
+
+// Interface of the flex scanner (lex.UF-C.c)
+extern int yylex(YYSTYPE* yylval_param, yyscan_t scanner);
+extern char* yyget_text(yyscan_t scanner);
+extern int CreateLexer(FILE* input, struct ParserState* state, yyscan_t* outScanner);
+extern void DestroyLexer(yyscan_t scanner);
+
+struct ScannerInterface {
+    const char* name;
+    int (*create)(FILE* input, struct ParserState* state, void** outScanner);
+    void (*destroy)(void* scanner);
+    int (*next)(void* scanner, YYSTYPE* value);
+    char* (*text)(void* scanner);
+};
+
+int CreateFlexScanner (FILE* input, struct ParserState* state, void** outScanner) {
+    return CreateLexer(input, state, outScanner);
+}
+
+int NextFlexToken (void* scanner, YYSTYPE* value) {
+    return yylex(value, scanner);
+}
+
+int CreatePhrase (FILE* input, struct ParserState* state, void** outScanner) {
+    struct PhraseScanner* scanner;
+    if (!CreatePhraseScanner(input, state, &scanner))
+        return 0;
+    *outScanner = scanner;
+    return 1;
+}
+
+void DestroyPhrase (void* scanner) {
+    DestroyPhraseScanner(scanner);
+}
+
+int NextPhrase (void* scanner, YYSTYPE* value) {
+    return NextPhraseToken(scanner, value);
+}
+
+char* GetPhraseText (void* scanner) {
+    return GetPhraseTokenText(scanner);
+}
+
+static const struct ScannerInterface flexScanner = {
+    "flex", CreateFlexScanner, DestroyLexer, NextFlexToken, yyget_text
+};
+static const struct ScannerInterface phraseScanner = {
+    "phrase", CreatePhrase, DestroyPhrase, NextPhrase, GetPhraseText
+};
+
+// A scanner reading an input from memory
+struct ScannerRun {
+    const struct ScannerInterface* interface;
+    FILE* input;
+    struct ParserState state;
+    void* scanner;
+};
+
+int StartRun (struct ScannerRun* run, const struct ScannerInterface* interface, char* text, size_t size) {
+    memset(run, 0, sizeof(struct ScannerRun));
+    run->interface = interface;
+    run->state.lineNumber = 1;
+    run->state.charPosInLine = 1;
+
+    run->input = fmemopen(text, size, "r");
+    if (run->input == NULL)
+        return 0;
+    if (!interface->create(run->input, &run->state, &run->scanner)) {
+        fclose(run->input);
+        return 0;
+    }
+    return 1;
+}
+
+void EndRun (struct ScannerRun* run) {
+    run->interface->destroy(run->scanner);
+    fclose(run->input);
+}
+
+int HasStringValue (int token) {
+    return token == STRING || token == STRING_CONSTANT;
+}
+
+void PrintToken (int token, YYSTYPE* value, const char* text, struct ParserState* state) {
+    printf("token %d \"", token);
+    for (const char* c = text; *c != '\0'; c++) {
+        if (*c == '\n')
+            printf("\\n");
+        else if (*c == '"' || *c == '\\')
+            printf("\\%c", *c);
+        else
+            putchar(*c);
+    }
+    printf("\"");
+
+    if (HasStringValue(token))
+        printf(" value \"%s\"", value->sval);
+    else if (token == INT)
+        printf(" value %d", value->ival);
+    else if (token == FLOAT)
+        printf(" value %f", value->fval);
+
+    printf(" at %d:%d (lengths %d %d, string %d%s)\n", state->lineNumber, state->charPosInLine,
+        state->previousTokenLength, state->currentTokenLength, state->stringLength, state->inputEnded ? ", input ended" : "");
+}
+
+int SameToken (int token, YYSTYPE* flexValue, YYSTYPE* phraseValue) {
+    if (HasStringValue(token))
+        return !strcmp(flexValue->sval, phraseValue->sval);
+    if (token == INT)
+        return flexValue->ival == phraseValue->ival;
+    if (token == FLOAT)
+        return !memcmp(&flexValue->fval, &phraseValue->fval, sizeof(float));
+    return 1;
+}
+
+int SameState (struct ParserState* flexState, struct ParserState* phraseState) {
+    return flexState->lineNumber == phraseState->lineNumber && flexState->charPosInLine == phraseState->charPosInLine
+        && flexState->previousTokenLength == phraseState->previousTokenLength && flexState->currentTokenLength == phraseState->currentTokenLength
+        && flexState->stringLength == phraseState->stringLength && flexState->inputEnded == phraseState->inputEnded;
+}
+
+// Returns 1 if both scanners give the same tokens for the input, otherwise shows the first one that differs
+int CompareScanners (const char* name, char* text, size_t size) {
+    struct ScannerRun flexRun, phraseRun;
+    if (!StartRun(&flexRun, &flexScanner, text, size))
+        return 0;
+    if (!StartRun(&phraseRun, &phraseScanner, text, size)) {
+        EndRun(&flexRun);
+        return 0;
+    }
+
+    int same = 1;
+    for (long count = 1; same; count++) {
+        YYSTYPE flexValue, phraseValue;
+        int flexToken = flexScanner.next(flexRun.scanner, &flexValue);
+        int phraseToken = phraseScanner.next(phraseRun.scanner, &phraseValue);
+
+        same = flexToken == phraseToken && SameToken(flexToken, &flexValue, &phraseValue)
+            && !strcmp(flexScanner.text(flexRun.scanner), phraseScanner.text(phraseRun.scanner))
+            && SameState(&flexRun.state, &phraseRun.state);
+        if (!same) {
+            printf("%s : token %ld differs\n  flex   ", name, count);
+            PrintToken(flexToken, &flexValue, flexScanner.text(flexRun.scanner), &flexRun.state);
+            printf("  phrase ");
+            PrintToken(phraseToken, &phraseValue, phraseScanner.text(phraseRun.scanner), &phraseRun.state);
+        }
+
+        if (HasStringValue(flexToken))
+            UfcFree(flexValue.sval);
+        if (HasStringValue(phraseToken))
+            UfcFree(phraseValue.sval);
+        if (flexToken == 0 || phraseToken == 0)
+            break;
+    }
+
+    EndRun(&flexRun);
+    EndRun(&phraseRun);
+    return same;
+}
+
+// Returns the content of the file (ended by a '\0'), or NULL if it can't be read
+char* ReadBenchFile (const char* fileName, size_t* outSize) {
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL) {
+        printf("Cannot open %s\n", fileName);
+        return NULL;
+    }
+
+    char* text = ReadWholeFile(file, outSize);
+    fclose(file);
+
+    if (text == NULL)
+        printf("Not enough memory to read %s\n", fileName);
+    return text;
+}
+
+/*************************** Fuzzing ***************************/
+
+// Pieces of the inputs : phrases, parts of phrases, and what flex matches around them
+static const char* fuzzPieces[] = {
+    "is starting their training with", "to increase their", "the smart", "the famous", "the massive", "noone",
+    "Training is over", "training is over", "training is", "has this number of fans", "has this number of fans:",
+    "has this number of fans :", "has this number of", "has an IQ of", "announces", "has a team of", "famous fighters",
+    "smart fighters", "IQ", "fame", "size", "effectiveness", "is thrown out", "hits", "punches", "bets on",
+    "takes the rest of the bets", "Finally", "finally,", "And the gambling den closes", "and The gambling den opens",
+    "The gambling den", "and", "And", "using", "with", "enrolls", "and gives the money to", "and gives",
+    "A new tournament begins", "a new", "Match", "match", "challenges", "fights", "beats down", "until they give up",
+    "until someone splits them up", "until they fight back", "until they come to an agreement", "until they",
+    "Meanwhile,", "meanwhile", "The match is interrupted", "End of the round", "A challenger enters the ring as",
+    "The ring girl shows", "the ring girl", "the fans of", "the wits of", "the flow of", "the team",
+    "A time out is announced", "joins", "tosses away", "tears apart", "deals with", "spars with", "the fighter",
+    "of the team", "the size of the team", "the strength of the team", "the strength of", "The competition begins",
+    "the", "The", "of", "a", "x", "Step1", "_", "s", "X", "ers", "0", "42", "-7", "3.25", "-0.5", "1.", ".5", "12ab",
+    "-", ":", ",", ".", "\"", "\"a string\"", "\"\n\"", "/*", "*/", "*", "/", "\n", "\n", "\t", " ", "  ", "\r", "\xC3\xA9"
+};
+
+// Characters put between two pieces
+static const char* fuzzSeparators[] = { "", " ", " ", " ", " ", "\n", "  " };
+
+unsigned NextRandom (unsigned* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+// Writes an input of random pieces, returns its size
+size_t WriteFuzzInput (char* text, unsigned* random) {
+    size_t size = 0;
+    int pieceCount = 1 + NextRandom(random) % FUZZ_MAX_PIECES;
+
+    for (int p = 0; p < pieceCount; p++) {
+        const char* piece = fuzzPieces[NextRandom(random) % (sizeof(fuzzPieces) / sizeof(fuzzPieces[0]))];
+        const char* separator = fuzzSeparators[NextRandom(random) % (sizeof(fuzzSeparators) / sizeof(fuzzSeparators[0]))];
+        size += sprintf(text + size, "%s%s", piece, separator);
+    }
+    return size;
+}
+
+int Fuzz (int count, unsigned seed) {
+    // Longest piece and separator for each piece
+    static char text[FUZZ_MAX_PIECES * 40 + 1];
+    unsigned random = seed != 0 ? seed : 1;
+
+    int failures = 0;
+    for (int i = 0; i < count && failures < 10; i++) {
+        size_t size = WriteFuzzInput(text, &random);
+
+        char name[64];
+        snprintf(name, sizeof(name), "input %d", i);
+        if (!CompareScanners(name, text, size)) {
+            printf("%s was :\n%s\n\n", name, text);
+            failures++;
+        }
+    }
+
+    if (failures == 0)
+        printf("Same tokens for %d inputs, seed %u\n", count, seed);
+    return failures == 0;
+}
+
+/*************************** Benchmark ***************************/
+
+double GetTimeInSeconds () {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Scans the whole text, returns the number of tokens or -1 if the scanner can't be created
+long ScanAll (const struct ScannerInterface* interface, char* text, size_t size) {
+    struct ScannerRun run;
+    if (!StartRun(&run, interface, text, size))
+        return -1;
+
+    long count = 0;
+    YYSTYPE value;
+    int token;
+    while ((token = interface->next(run.scanner, &value)) != 0) {
+        if (HasStringValue(token))
+            UfcFree(value.sval);
+        count++;
+    }
+
+    EndRun(&run);
+    return count;
+}
+
+int Bench (const char* fileName, int repeat) {
+    size_t size;
+    char* text = ReadBenchFile(fileName, &size);
+    if (text == NULL)
+        return 0;
+
+    const struct ScannerInterface* interfaces[] = { &flexScanner, &phraseScanner };
+    double speeds[2];
+    for (int s = 0; s < 2; s++) {
+        double best = 0;
+        long tokens = 0;
+        for (int r = 0; r < repeat; r++) {
+            double start = GetTimeInSeconds();
+            tokens = ScanAll(interfaces[s], text, size);
+            double time = GetTimeInSeconds() - start;
+            if (r == 0 || time < best)
+                best = time;
+        }
+        if (tokens < 0) {
+            printf("Cannot create the %s scanner\n", interfaces[s]->name);
+            free(text);
+            return 0;
+        }
+
+        speeds[s] = size / 1e6 / best;
+        printf("%-7s %9.1f MB/s  %10ld tokens in %.3f s\n", interfaces[s]->name, speeds[s], tokens, best);
+    }
+    printf("phrase / flex : %.2f\n", speeds[1] / speeds[0]);
+
+    free(text);
+    return 1;
+}
+
+int PrintTokens (const char* fileName, const struct ScannerInterface* interface) {
+    size_t size;
+    char* text = ReadBenchFile(fileName, &size);
+    if (text == NULL)
+        return 0;
+
+    struct ScannerRun run;
+    if (!StartRun(&run, interface, text, size)) {
+        printf("Cannot create the %s scanner\n", interface->name);
+        free(text);
+        return 0;
+    }
+
+    YYSTYPE value;
+    int token;
+    do {
+        token = interface->next(run.scanner, &value);
+        PrintToken(token, &value, interface->text(run.scanner), &run.state);
+        if (HasStringValue(token))
+            UfcFree(value.sval);
+    } while (token != 0);
+
+    EndRun(&run);
+    free(text);
+    return 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && !strcmp(argv[1], "compare")) {
+        int same = 1;
+        for (int i = 2; i < argc; i++) {
+            size_t size;
+            char* text = ReadBenchFile(argv[i], &size);
+            if (text == NULL)
+                return 1;
+            if (CompareScanners(argv[i], text, size))
+                printf("%s : same tokens\n", argv[i]);
+            else
+                same = 0;
+            free(text);
+        }
+        return same ? 0 : 1;
+    }
+    if (argc >= 2 && argc <= 4 && !strcmp(argv[1], "fuzz"))
+        return Fuzz(argc >= 3 ? atoi(argv[2]) : DEFAULT_FUZZ_COUNT, argc >= 4 ? strtoul(argv[3], NULL, 10) : 1) ? 0 : 1;
+    if ((argc == 3 || argc == 4) && !strcmp(argv[1], "bench"))
+        return Bench(argv[2], argc == 4 && atoi(argv[3]) > 0 ? atoi(argv[3]) : DEFAULT_BENCH_REPEAT) ? 0 : 1;
+    if ((argc == 3 || argc == 4) && !strcmp(argv[1], "tokens")) {
+        if (argc == 4 && strcmp(argv[3], "flex") && strcmp(argv[3], "phrase")) {
+            printf("Unknown scanner %s (flex or phrase)\n", argv[3]);
+            return 1;
+        }
+        return PrintTokens(argv[2], argc == 4 && !strcmp(argv[3], "flex") ? &flexScanner : &phraseScanner) ? 0 : 1;
+    }
+
+    printf("Usage : %s compare FILE... | fuzz [COUNT] [SEED] | bench FILE [REPEAT] | tokens FILE [flex|phrase]\n", argv[0]);
+    return 1;
+}
@@ -0,0 +1,415 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "BatchRunner.h"
+#include "../Utils/AST.h"
+#include "../Utils/WorkerPool.h"
+#include "../Utils/GreenThreads.h"
+#include "../Utils/Allocator.h"
+#include "../Parser-Bison/UF-C.tab.h"
+#include "../Interpreter/Interpreter.h"
+#include "../Optimizer/Optimizer.h"
+
+struct BatchScript {
+    char* path;
+
+    // Everything the script printed (output and errors)
+    char* output;
+    size_t outputSize;
+
+    int status;
+    double parseTime; // in seconds
+    double runTime; // wall time, which includes the slices of the other scripts with the green threads
+    double cpuTime; // processor time of the interpretation of this script only
+    int sliceCount; // number of slices it was given by the green thread scheduler
+};
+
+struct BatchList {
+    struct BatchScript* scripts;
+    int count;
+    int capacity;
+};
+
+double GetTimeInSeconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Adds a script to run at the end of the list
+// Returns 1 if it was added, 0 otherwise
+int AddBatchScript (struct BatchList* list, const char* path) {
+    if (list->count == list->capacity) {
+        int newCapacity = list->capacity == 0 ? 64 : 2 * list->capacity;
+        struct BatchScript* newScripts = realloc(list->scripts, sizeof(struct BatchScript) * newCapacity);
+        if (newScripts == NULL) {
+            printf("Unable to allocate memory for the list of scripts\n");
+            return 0;
+        }
+
+        list->scripts = newScripts;
+        list->capacity = newCapacity;
+    }
+
+    struct BatchScript* script = &list->scripts[list->count];
+    script->path = strdup(path);
+    if (script->path == NULL) {
+        printf("Unable to allocate memory for the path of the script %s\n", path);
+        return 0;
+    }
+    script->output = NULL;
+    script->outputSize = 0;
+    script->status = BATCH_CANNOT_OPEN;
+    script->parseTime = 0;
+    script->runTime = 0;
+    script->cpuTime = 0;
+    script->sliceCount = 0;
+
+    list->count++;
+    return 1;
+}
+
+int CompareNames (const void* a, const void* b) {
+    return strcmp(*(char* const*) a, *(char* const*) b);
+}
+
+// Adds all the .ufc files of a directory, sorted by name so that the order of the report doesn't depend on the file system
+// Returns 1 if they were added, 0 otherwise
+int AddBatchDirectory (struct BatchList* list, const char* dirName) {
+    DIR* dir = opendir(dirName);
+    if (dir == NULL) {
+        printf("Cannot open the directory %s\n", dirName);
+        return 0;
+    }
+
+    char** names = NULL;
+    int nameCount = 0, nameCapacity = 0;
+    int success = 1;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        char* extension = strrchr(entry->d_name, '.');
+        if (extension == NULL || strcmp(extension, ".ufc"))
+            continue;
+
+        if (nameCount == nameCapacity) {
+            nameCapacity = nameCapacity == 0 ? 64 : 2 * nameCapacity;
+            char** newNames = realloc(names, sizeof(char*) * nameCapacity);
+            if (newNames == NULL) {
+                printf("Unable to allocate memory for the files of %s\n", dirName);
+                success = 0;
+                break;
+            }
+            names = newNames;
+        }
+
+        // Full path of the file
+        names[nameCount] = malloc(strlen(dirName) + strlen(entry->d_name) + 2);
+        if (names[nameCount] == NULL) {
+            printf("Unable to allocate memory for the files of %s\n", dirName);
+            success = 0;
+            break;
+        }
+        sprintf(names[nameCount], "%s/%s", dirName, entry->d_name);
+        nameCount++;
+    }
+    closedir(dir);
+
+    qsort(names, nameCount, sizeof(char*), CompareNames);
+
+    for (int i = 0; i<nameCount; i++) {
+        if (success && !AddBatchScript(list, names[i]))
+            success = 0;
+        free(names[i]);
+    }
+    free(names);
+
+    return success;
+}
+
+// Adds a .ufc file or all the .ufc files of a directory
+int AddBatchPath (struct BatchList* list, const char* path) {
+    struct stat pathInfo;
+    if (stat(path, &pathInfo) == 0 && S_ISDIR(pathInfo.st_mode))
+        return AddBatchDirectory(list, path);
+
+    // Files that don't exist are still added so that they appear as failed in the report
+    return AddBatchScript(list, path);
+}
+
+// Adds every path listed in the manifest (one per line, empty lines and lines starting with '#' are ignored)
+int AddBatchManifest (struct BatchList* list, const char* manifestName) {
+    FILE* manifest = fopen(manifestName, "r");
+    if (manifest == NULL) {
+        printf("Cannot open the manifest %s\n", manifestName);
+        return 0;
+    }
+
+    char* line = NULL;
+    size_t lineCapacity = 0;
+    ssize_t lineLength;
+    int success = 1;
+
+    while (success && (lineLength = getline(&line, &lineCapacity, manifest)) != -1) {
+        // Remove the line break and trailing spaces
+        while (lineLength > 0 && (line[lineLength-1] == '\n' || line[lineLength-1] == '\r' || line[lineLength-1] == ' ' || line[lineLength-1] == '\t'))
+            line[--lineLength] = '\0';
+
+        if (lineLength == 0 || line[0] == '#')
+            continue;
+
+        success = AddBatchPath(list, line);
+    }
+
+    free(line);
+    fclose(manifest);
+
+    return success;
+}
+
+// Parses and interpretes one script, writing everything it prints to output
+void RunBatchScriptCode (struct BatchScript* script, FILE* output) {
+    FILE* codeFile = fopen(script->path, "r");
+    if (codeFile == NULL) {
+        fprintf(output, "Cannot open %s\n", script->path);
+        script->status = BATCH_CANNOT_OPEN;
+        return;
+    }
+
+    // Parsing
+    double start = GetTimeInSeconds();
+
+    struct AstNode* ast = NULL;
+    int error = ParseFile(codeFile, output, &ast);
+    fclose(codeFile);
+
+    script->parseTime = GetTimeInSeconds() - start;
+
+    if (error != 0) {
+        fprintf(output, "Error during parsing\n");
+        FreeAST(ast);
+        script->status = BATCH_PARSE_ERROR;
+        return;
+    }
+
+    OptimizeProgram(ast, NULL, 0, output);
+
+    // Interpretation, with everything printed going to the captured output
+    SetInterpreterOutput(output);
+    start = GetTimeInSeconds();
+    double cpuStart = GetGreenThreadCpuTime();
+
+    if (InterpreteProgram(ast))
+        script->status = BATCH_SUCCESS;
+    else {
+        fprintf(output, "Error while interpreting the AST\n");
+        script->status = BATCH_RUNTIME_ERROR;
+    }
+
+    script->runTime = GetTimeInSeconds() - start;
+    script->cpuTime = GetGreenThreadCpuTime() - cpuStart;
+    script->sliceCount = GetGreenThreadSliceCount();
+    SetInterpreterOutput(NULL);
+
+    FreeAST(ast);
+}
+
+// Runs one script with its own memory budget, capturing everything it prints
+void RunBatchScript (int taskIndex, int workerIndex, void* userData) {
+    struct BatchScript* script = &((struct BatchScript*) userData)[taskIndex];
+
+    FILE* output = open_memstream(&script->output, &script->outputSize);
+    if (output == NULL) {
+        printf("Cannot capture the output of %s\n", script->path);
+        script->status = BATCH_CANNOT_OPEN;
+        return;
+    }
+
+    struct MemoryBudget budget;
+    StartMemoryBudget(&budget);
+    RunBatchScriptCode(script, output);
+    EndMemoryBudget(&budget);
+
+    // The script stopped on the allocation that failed, whatever the error it gave
+    if (PrintMemoryLimitError(output, &budget))
+        script->status = BATCH_MEMORY_LIMIT;
+
+    fclose(output);
+}
+
+// Scripts run as green threads, split in one group per worker
+struct BatchGroups {
+    struct BatchScript* scripts;
+    int scriptCount;
+    int groupCount;
+    int timeSlice;
+};
+
+void RunBatchGreenScript (int taskIndex, void* userData) {
+    RunBatchScript(taskIndex, -1, userData);
+}
+
+// Runs the scripts groupIndex, groupIndex + groupCount, ... as green threads interleaved on the worker
+// Taking every groupCount-th script mixes the long and the short scripts given next to each other
+void RunBatchGroup (int taskIndex, int workerIndex, void* userData) {
+    struct BatchGroups* groups = userData;
+
+    int* scriptIndexes = malloc(sizeof(int) * (groups->scriptCount / groups->groupCount + 1));
+    if (scriptIndexes == NULL) {
+        printf("Unable to allocate memory for the green threads of the worker %d\n", workerIndex);
+        return;
+    }
+
+    int count = 0;
+    for (int i = taskIndex; i<groups->scriptCount; i += groups->groupCount)
+        scriptIndexes[count++] = i;
+
+    RunGreenThreads(scriptIndexes, count, groups->timeSlice, RunBatchGreenScript, groups->scripts);
+
+    free(scriptIndexes);
+}
+
+// Writes the output of the script to outputDir/<name of the script without .ufc>.out
+int WriteBatchOutput (struct BatchScript* script, const char* outputDir) {
+    const char* baseName = strrchr(script->path, '/');
+    baseName = baseName == NULL ? script->path : baseName + 1;
+
+    char* outName = malloc(strlen(outputDir) + strlen(baseName) + 6);
+    if (outName == NULL) {
+        printf("Unable to allocate memory for the output file name of %s\n", script->path);
+        return 0;
+    }
+    sprintf(outName, "%s/%s", outputDir, baseName);
+
+    char* extension = strrchr(outName, '.');
+    if (extension != NULL && !strcmp(extension, ".ufc"))
+        *extension = '\0';
+    strcat(outName, ".out");
+
+    FILE* outFile = fopen(outName, "w");
+    if (outFile == NULL) {
+        printf("Can't create the output file %s\n", outName);
+        free(outName);
+        return 0;
+    }
+
+    fwrite(script->output, 1, script->outputSize, outFile);
+    fclose(outFile);
+    free(outName);
+
+    return 1;
+}
+
+const char* BatchStatusName (int status) {
+    switch (status) {
+        case BATCH_SUCCESS:
+            return "ok";
+        case BATCH_RUNTIME_ERROR:
+            return "error";
+        case BATCH_PARSE_ERROR:
+            return "parse error";
+        case BATCH_CANNOT_OPEN:
+            return "not found";
+        case BATCH_MEMORY_LIMIT:
+            return "memory limit";
+        default:
+            return "unknown";
+    }
+}
+
+int RunBatch (char** paths, int pathCount, const char* manifestName, int workerCount, const char* outputDir, int timeSlice) {
+    struct BatchList list = { NULL, 0, 0 };
+
+    int success = 1;
+    for (int i = 0; success && i<pathCount; i++)
+        success = AddBatchPath(&list, paths[i]);
+
+    if (success && manifestName != NULL)
+        success = AddBatchManifest(&list, manifestName);
+
+    if (!success || list.count == 0) {
+        if (success)
+            printf("Error : No script to run\n");
+
+        for (int i = 0; i<list.count; i++)
+            free(list.scripts[i].path);
+        free(list.scripts);
+        return -1;
+    }
+
+    if (workerCount <= 0)
+        workerCount = GetProcessorCount();
+
+    // Run all the scripts
+    double start = GetTimeInSeconds();
+
+    if (timeSlice > 0) {
+        struct BatchGroups groups = { list.scripts, list.count, workerCount < list.count ? workerCount : list.count, timeSlice };
+
+        if (!RunOnWorkerPool(groups.groupCount, groups.groupCount, RunBatchGroup, &groups)) {
+            printf("Error while running the scripts\n");
+            success = 0;
+        }
+    }
+    else if (!RunOnWorkerPool(list.count, workerCount, RunBatchScript, list.scripts)) {
+        printf("Error while running the scripts\n");
+        success = 0;
+    }
+
+    double wallTime = GetTimeInSeconds() - start;
+
+    // Outputs of the scripts, in the order they were given
+    for (int i = 0; success && i<list.count; i++) {
+        struct BatchScript* script = &list.scripts[i];
+
+        if (outputDir != NULL) {
+            if (!WriteBatchOutput(script, outputDir) && script->status == BATCH_SUCCESS)
+                script->status = BATCH_CANNOT_OPEN;
+        }
+        else {
+            printf("==> %s <==\n", script->path);
+            fwrite(script->output, 1, script->outputSize, stdout);
+            if (script->outputSize > 0 && script->output[script->outputSize-1] != '\n')
+                printf("\n");
+        }
+    }
+
+    // Report
+    int failedCount = 0;
+    double totalParseTime = 0, totalRunTime = 0, totalCpuTime = 0;
+
+    printf("\n%-12s %12s %12s %12s", "status", "parse (ms)", "run (ms)", "cpu (ms)");
+    if (timeSlice > 0)
+        printf(" %8s", "slices");
+    printf("   %s\n", "script");
+    for (int i = 0; i<list.count; i++) {
+        struct BatchScript* script = &list.scripts[i];
+
+        if (script->status != BATCH_SUCCESS)
+            failedCount++;
+        totalParseTime += script->parseTime;
+        totalRunTime += script->runTime;
+        totalCpuTime += script->cpuTime;
+
+        printf("%-12s %12.3f %12.3f %12.3f", BatchStatusName(script->status), script->parseTime * 1e3, script->runTime * 1e3, script->cpuTime * 1e3);
+        if (timeSlice > 0)
+            printf(" %8d", script->sliceCount);
+        printf("   %s\n", script->path);
+    }
+
+    printf("\n%d scripts on %d workers : %d succeeded, %d failed\n", list.count, workerCount < list.count ? workerCount : list.count, list.count - failedCount, failedCount);
+    printf("Total parse time %.3f ms, total run time %.3f ms, total cpu time %.3f ms, wall time %.3f ms\n", totalParseTime * 1e3, totalRunTime * 1e3, totalCpuTime * 1e3, wallTime * 1e3);
+
+    for (int i = 0; i<list.count; i++) {
+        free(list.scripts[i].path);
+        free(list.scripts[i].output);
+    }
+    free(list.scripts);
+
+    return success ? failedCount : -1;
+}
@@ -0,0 +1,21 @@
+#ifndef __BATCH_RUNNER_H__
+#define __BATCH_RUNNER_H__
+
+// Status of a script run in batch mode
+#define BATCH_SUCCESS 0
+#define BATCH_RUNTIME_ERROR 1
+#define BATCH_PARSE_ERROR 2
+#define BATCH_CANNOT_OPEN 3
+#define BATCH_MEMORY_LIMIT 4 // went over --memory-limit, which each script has for itself
+
+// Interpretes all the scripts given in paths (.ufc files or directories containing .ufc files)
+// and listed in the manifest (one path per line, can be NULL) on workerCount threads (0 means one per processor).
+// The output of each script is captured in its own buffer, then written to outputDir/<script name>.out,
+// or printed in the order of the scripts once they are all done if outputDir is NULL.
+// With timeSlice > 0, each worker interleaves its share of the scripts as green threads (see GreenThreads.h),
+// switching to the next script after timeSlice loop rounds and regimen calls, so that a script that never ends doesn't hold the worker.
+// A report with the status, timings and processor time of every script is printed at the end.
+// Returns the number of scripts that failed, or -1 if the batch could not be run
+int RunBatch (char** paths, int pathCount, const char* manifestName, int workerCount, const char* outputDir, int timeSlice);
+
+#endif
@@ -1,36 +1,45 @@
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "../Utils/AST.h"
 #include "../Parser-Bison/UF-C.tab.h"
+#include "../Parser-Bison/ParallelParser.h"
 #include "../Utils/ComparisonDictionnary.h"
+#include "../Utils/Allocator.h"
+#include "../Utils/InputReader.h"
 #include "../Translator/Translator.h"
+#include "../Translator/AsmTranslator.h"
 #include "../Interpreter/Interpreter.h"
+#include "../Interpreter/BranchProfile.h"
+#include "../Interpreter/Trace.h"
+#include "../Interpreter/ParallelReduction.h"
+#include "../Optimizer/Inliner.h"
+#include "../Optimizer/DeadCode.h"
+#include "../Optimizer/Optimizer.h"
+#include "BatchRunner.h"
+#include "TableRunner.h"
+#include "Repl.h"
+#include "StreamRunner.h"
+#include "WatchRunner.h"
 
-// Flex: file to read from
-extern FILE *yyin;
-// Bison: parsing function
-extern int yyparse();
+// Set by --asm : the code is translated into x86-64 assembly (.s file) instead of C
+static int assemblyOutput = 0;
 
+// Set by --split-c : the code is translated into a directory of C files, one per training regimen, built by a Makefile
+static int splitOutput = 0;
 
-int main(int argc, char* argv[]) 
-{
-    if (argc == 1)
-    {
-        printf("Error : Not enough arguments\n");
-        return 1;
-    }
-    else if (argc > 2)
-    {
-        printf("Error : Too many arguments\n");
-        return 1;
-    }
+// Set by --parse-only : the code is only parsed, and the time it took is printed
+static int parseOnly = 0;
 
+int RunParsedFile(struct AstNode* ast, char* fileName);
+int TranslateAndInterprete(struct AstNode* ast, char* fileName);
 
+// Parses, translates and interpretes a single code file
+int RunFile(char* fileName)
+{
     /**************** Opening the code file ***********************/
 
-    char* fileName = argv[1];
-
     // open the input file
     FILE *myfile = fopen(fileName, "r");
     if (!myfile) 
@@ -42,16 +51,17 @@ int main(int argc, char* argv[])
 
     /******************* Creating the AST ***********************/
 
-    struct AstNode* ast;
+    struct AstNode* ast = NULL;
 
-    // Set flex to read from it instead of defaulting to STDIN:
-    yyin = myfile;
     // Not zero to trace Bison states (debug)
     extern int yydebug;
     yydebug = 0;
 
-    // Parse through the input and get the AST
-    int error = yyparse(&ast);
+    struct timespec parseStart, parseEnd;
+    clock_gettime(CLOCK_MONOTONIC, &parseStart);
+
+    // Parse through the input and get the AST, in parts on several threads for the big programs
+    int error = ParseFileInParallel(myfile, NULL, &ast);
     if (error != 0)
     {
         printf("Error during parsing\n");
@@ -62,7 +72,20 @@ int main(int argc, char* argv[])
     // We don't need the input file anymore
     fclose(myfile);
 
+    if (parseOnly)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &parseEnd);
+        printf("Parsed %s in %.3f s\n", fileName, (parseEnd.tv_sec - parseStart.tv_sec) + (parseEnd.tv_nsec - parseStart.tv_nsec) * 1e-9);
+        FreeAST(ast);
+        return 0;
+    }
+
+    return RunParsedFile(ast, fileName);
+}
 
+// Translates and interpretes the AST of a code file, leaving it as it is
+int TranslateAndInterprete(struct AstNode* ast, char* fileName)
+{
     /**************** Creating the output '.c' file ********************/
 
     // Getting the name of the output file (removing the extension .ufc)
@@ -86,11 +109,36 @@ int main(int argc, char* argv[])
     // Assign 'end of char*' character at that position
     *extension = '\0';
 
-    // Now we can concatenate because ".ufc" is longer than ".c" so no memory problem
-    strcat(outFileName, ".c");
+    // The split C goes in the directory <name>_c, with a program named after the file
+    if (splitOutput)
+    {
+        char* directoryName = malloc(strlen(outFileName) + 3);
+        if (directoryName == NULL)
+        {
+            printf("Can't create the name of the output directory\n");
+            free(outFileName);
+                return 1;
+        }
+        sprintf(directoryName, "%s_c", outFileName);
+
+        char* programName = strrchr(outFileName, '/');
+        programName = programName != NULL ? programName + 1 : outFileName;
+
+        if (!TranslateASTToUnits(ast, directoryName, programName))
+            printf("Error while translating the AST\n");
+        free(directoryName);
+        free(outFileName);
+
+        if (!InterpreteProgram(ast))
+            printf("Error while interpreting the AST\n");
+        return 0;
+    }
+
+    // Now we can concatenate because ".ufc" is longer than ".c" and ".s" so no memory problem
+    strcat(outFileName, assemblyOutput ? ".s" : ".c");
 
 
-    // From here on, outputFileName is the name of the file with the .c extension
+    // From here on, outputFileName is the name of the file with the .c (or .s) extension
     // Creating the output file
     FILE* outFile = fopen(outFileName, "w");
     if (outFile==NULL)
@@ -105,19 +153,388 @@ int main(int argc, char* argv[])
 
     /******** Translating the AST into the output file and closing it *********/
 
-    if (!TranslateAST (ast, outFile))
+    if (assemblyOutput ? !TranslateASTToAssembly (ast, outFile) : !TranslateAST (ast, outFile))
         printf("Error while translating the AST\n");
     fclose(outFile);
 
 
     /************************ Interpreting the AST *************************/
 
-    if (!InterpreteAST(ast, NULL, NULL, NULL, NULL, NULL, NULL, NULL))
+    if (!InterpreteProgram(ast))
         printf("Error while interpreting the AST\n");
 
-        
+    return 0;
+}
+
+// Optimizes, translates and interpretes the AST of a code file, then frees it
+int RunParsedFile(struct AstNode* ast, char* fileName)
+{
+    // Remove the dead code, inline the small training regimens and rewrite the self updates, for both the translation and the interpretation
+    OptimizeProgram(ast, NULL, 0, stdout);
+
+    int result = TranslateAndInterprete(ast, fileName);
+
     // We don't need the AST anymore
     FreeAST(ast);
 
-    return 0;
-}
\ No newline at end of file
+    return result;
+}
+
+int main(int argc, char* argv[]) 
+{
+    /************************ Reading the arguments *************************/
+
+    // Batch mode options
+    int batchMode = 0;
+    int workerCount = 0;
+    char* manifestName = NULL;
+    char* outputDir = NULL;
+    int timeSlice = 0;
+
+    // Table mode option
+    char* tableName = NULL;
+    int jobsGiven = 0;
+
+    // Interactive mode
+    int replMode = 0;
+
+    // Each line of the main phase run as soon as it is parsed
+    int streamMode = 0;
+
+    // The code file run again each time it is saved
+    int watchMode = 0;
+
+    // Optimized C for the translated file
+    int optimizeC = 0;
+
+    // Memoization options
+    int memoization = 1;
+    int memoStats = 0;
+
+    // Reductions run on several threads (see ParallelReduction.h)
+    int parallelReductions = 0;
+
+    // Removal of the unreachable definitions (see DeadCode.h)
+    int deadCodeElimination = 1;
+    int deadCodeReport = 0;
+
+    // Profile of the tournaments
+    int adaptiveBranches = 0;
+    int branchStats = 0;
+
+    // Engine running the programs
+    enum InterpreterEngine engine = treeEngine;
+
+    // Memory of the programs : limit in bytes (0 for none) and report of what was not released at the end
+    size_t memoryLimit = 0;
+    int leakReport = 0;
+
+    // File where the execution is traced (see Trace.h)
+    char* traceName = NULL;
+
+    // The arguments that are not options are the code files
+    char** fileNames = malloc(sizeof(char*) * argc);
+    int fileCount = 0;
+    if (fileNames == NULL)
+    {
+        printf("Can't allocate memory for the list of files\n");
+        return 1;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--batch"))
+            batchMode = 1;
+        else if (!strcmp(argv[i], "--repl"))
+            replMode = 1;
+        else if (!strcmp(argv[i], "--stream"))
+            streamMode = 1;
+        else if (!strcmp(argv[i], "--watch"))
+            watchMode = 1;
+        else if (!strcmp(argv[i], "--optimize-c"))
+            optimizeC = 1;
+        else if (!strcmp(argv[i], "--asm"))
+            assemblyOutput = 1;
+        else if (!strcmp(argv[i], "--parse-only"))
+            parseOnly = 1;
+        else if (!strcmp(argv[i], "--split-c"))
+            splitOutput = 1;
+        else if (!strcmp(argv[i], "--adaptive-branches"))
+            adaptiveBranches = 1;
+        else if (!strcmp(argv[i], "--branch-stats"))
+            branchStats = 1;
+        else if (!strcmp(argv[i], "--no-memo"))
+            memoization = 0;
+        else if (!strcmp(argv[i], "--memo-stats"))
+            memoStats = 1;
+        else if (!strcmp(argv[i], "--leak-report"))
+            leakReport = 1;
+        else if (!strcmp(argv[i], "--parallel-reductions"))
+            parallelReductions = 1;
+        else if (!strcmp(argv[i], "--keep-dead-code"))
+            deadCodeElimination = 0;
+        else if (!strcmp(argv[i], "--dead-code-report"))
+            deadCodeReport = 1;
+        else if (!strcmp(argv[i], "--table") || !strcmp(argv[i], "--inline-threshold") || !strcmp(argv[i], "--engine") || !strcmp(argv[i], "--parse-threads") || !strcmp(argv[i], "--memory-limit") || !strcmp(argv[i], "--trace"))
+        {
+            if (i + 1 == argc)
+            {
+                printf("Error : %s needs a value\n", argv[i]);
+                free(fileNames);
+                return 1;
+            }
+
+            if (!strcmp(argv[i], "--table"))
+                tableName = argv[i + 1];
+            else if (!strcmp(argv[i], "--inline-threshold"))
+                SetInlineThreshold(atoi(argv[i + 1]));
+            else if (!strcmp(argv[i], "--parse-threads"))
+                SetParseThreadCount(atoi(argv[i + 1]));
+            else if (!strcmp(argv[i], "--trace"))
+                traceName = argv[i + 1];
+            else if (!strcmp(argv[i], "--memory-limit"))
+            {
+                if (!ParseMemorySize(argv[i + 1], &memoryLimit) || memoryLimit == 0)
+                {
+                    printf("Error : --memory-limit needs a positive number of bytes, with an optional k, M or G suffix\n");
+                    free(fileNames);
+                    return 1;
+                }
+            }
+            else if (!strcmp(argv[i + 1], "tree"))
+                engine = treeEngine;
+            else if (!strcmp(argv[i + 1], "closure"))
+                engine = closureEngine;
+            else if (!strcmp(argv[i + 1], "compare"))
+                engine = compareEngines;
+            else
+            {
+                printf("Error : Unknown engine %s (tree, closure or compare)\n", argv[i + 1]);
+                free(fileNames);
+                return 1;
+            }
+
+            i++;
+        }
+        else if (!strcmp(argv[i], "--jobs") || !strcmp(argv[i], "--manifest") || !strcmp(argv[i], "--output-dir") || !strcmp(argv[i], "--time-slice"))
+        {
+            if (i + 1 == argc)
+            {
+                printf("Error : %s needs a value\n", argv[i]);
+                free(fileNames);
+                return 1;
+            }
+
+            // --jobs is shared with the table mode, so it only implies the batch mode without --table
+            if (!strcmp(argv[i], "--jobs"))
+            {
+                workerCount = atoi(argv[i + 1]);
+                jobsGiven = 1;
+            }
+            else if (!strcmp(argv[i], "--manifest"))
+            {
+                manifestName = argv[i + 1];
+                batchMode = 1;
+            }
+            else if (!strcmp(argv[i], "--output-dir"))
+            {
+                outputDir = argv[i + 1];
+                batchMode = 1;
+            }
+            else
+            {
+                timeSlice = atoi(argv[i + 1]);
+                if (timeSlice <= 0)
+                {
+                    printf("Error : --time-slice needs a positive number of loop rounds and calls\n");
+                    free(fileNames);
+                    return 1;
+                }
+                batchMode = 1;
+            }
+
+            i++;
+        }
+        else if (!strncmp(argv[i], "--", 2))
+        {
+            printf("Error : Unknown option %s\n", argv[i]);
+            free(fileNames);
+            return 1;
+        }
+        else
+            fileNames[fileCount++] = argv[i];
+    }
+
+
+    /************************ Running the code *************************/
+
+    int result;
+
+    SetMemoization(memoization, memoStats);
+    SetBranchProfiling(adaptiveBranches, branchStats);
+    SetTranslatorOptimization(optimizeC);
+    SetInterpreterEngine(engine);
+    SetParallelReductions(parallelReductions);
+    SetDeadCodeElimination(deadCodeElimination, deadCodeReport);
+
+    // The allocations are only counted when they are asked for, the C library does them directly otherwise
+    if (memoryLimit != 0 || leakReport)
+        EnableAllocationTracking(memoryLimit);
+
+    if (jobsGiven && tableName == NULL)
+        batchMode = 1;
+
+    if (splitOutput && (optimizeC || assemblyOutput))
+    {
+        printf("Error : --split-c can't be used with --optimize-c or --asm\n");
+        free(fileNames);
+        return 1;
+    }
+
+    if (!deadCodeElimination && deadCodeReport)
+    {
+        printf("Error : --dead-code-report can't be used with --keep-dead-code\n");
+        free(fileNames);
+        return 1;
+    }
+
+    if (parseOnly && (streamMode || replMode || batchMode || tableName != NULL))
+    {
+        printf("Error : --parse-only can't be used with --stream, --repl, the batch mode or --table\n");
+        free(fileNames);
+        return 1;
+    }
+
+    // The watch mode runs a single file, and runs its AST again after each change : the profile of the tournaments would reorder it
+    if (watchMode && (streamMode || replMode || batchMode || tableName != NULL || parseOnly || traceName != NULL || adaptiveBranches || branchStats))
+    {
+        printf("Error : --watch can't be used with --stream, --repl, the batch mode, --table, --parse-only, --trace, --adaptive-branches or --branch-stats\n");
+        free(fileNames);
+        return 1;
+    }
+
+    // The events of a single program are recorded, the closure engine doesn't record them
+    if (traceName != NULL && (batchMode || tableName != NULL || engine != treeEngine))
+    {
+        printf("Error : --trace can't be used with the batch mode, --table or --engine closure or compare\n");
+        free(fileNames);
+        return 1;
+    }
+
+    // The closures don't look for the reductions
+    if (parallelReductions && engine != treeEngine)
+    {
+        printf("Error : --parallel-reductions can't be used with --engine closure or compare\n");
+        free(fileNames);
+        return 1;
+    }
+
+    if (traceName != NULL && !StartTrace(traceName))
+    {
+        printf("Error : Cannot create the trace file %s\n", traceName);
+        free(fileNames);
+        return 1;
+    }
+
+    if (watchMode && fileCount != 1)
+    {
+        printf("Error : --watch needs exactly one code file\n");
+        result = 1;
+    }
+    else if (watchMode)
+        result = RunWatch(fileNames[0], TranslateAndInterprete);
+    else if (streamMode && (replMode || batchMode || tableName != NULL))
+    {
+        printf("Error : --stream can't be used with --repl, the batch mode or --table\n");
+        result = 1;
+    }
+    else if (streamMode && engine == compareEngines)
+    {
+        printf("Error : --engine compare can't be used with --stream\n");
+        result = 1;
+    }
+    else if (streamMode && fileCount != 1)
+    {
+        printf("Error : --stream needs exactly one code file (- for the standard input)\n");
+        result = 1;
+    }
+    else if (streamMode)
+        result = RunStream(fileNames[0]);
+    else if (replMode && (batchMode || tableName != NULL))
+    {
+        printf("Error : --repl can't be used with the batch mode or --table\n");
+        result = 1;
+    }
+    else if (replMode && engine == compareEngines)
+    {
+        printf("Error : --engine compare can't be used with --repl\n");
+        result = 1;
+    }
+    else if (replMode && fileCount > 1)
+    {
+        printf("Error : --repl takes at most one code file\n");
+        result = 1;
+    }
+    else if (replMode)
+        result = RunRepl(fileCount == 1 ? fileNames[0] : NULL);
+    else if (tableName != NULL && batchMode)
+    {
+        printf("Error : --table can't be used with the batch mode\n");
+        result = 1;
+    }
+    else if (tableName != NULL && (adaptiveBranches || branchStats))
+    {
+        printf("Error : --adaptive-branches and --branch-stats can't be used with --table\n");
+        result = 1;
+    }
+    else if (tableName != NULL && engine == compareEngines)
+    {
+        printf("Error : --engine compare can't be used with --table\n");
+        result = 1;
+    }
+    else if (tableName != NULL && fileCount != 1)
+    {
+        printf("Error : --table needs exactly one code file\n");
+        result = 1;
+    }
+    else if (tableName != NULL)
+    {
+        int failedCount = RunTable(fileNames[0], tableName, workerCount);
+        result = failedCount == 0 ? 0 : 1;
+    }
+    else if (batchMode)
+    {
+        int failedCount = RunBatch(fileNames, fileCount, manifestName, workerCount, outputDir, timeSlice);
+        result = failedCount == 0 ? 0 : 1;
+    }
+    else if (fileCount == 0)
+    {
+        printf("Error : Not enough arguments\n");
+        result = 1;
+    }
+    else if (fileCount > 1)
+    {
+        printf("Error : Too many arguments\n");
+        result = 1;
+    }
+    else
+        result = RunFile(fileNames[0]);
+
+    free(fileNames);
+
+    if (traceName != NULL && !StopTrace())
+    {
+        printf("Error : The trace could not be written completely\n");
+        result = 1;
+    }
+
+    // The memory of the runs of the batch and table modes was limited run by run, their errors were given with them
+    if (PrintMemoryLimitError(stdout, NULL))
+        result = MEMORY_LIMIT_EXIT_CODE;
+
+    ReleaseInput();
+    if (leakReport)
+        PrintAllocationReport(stdout);
+
+    return result;
+}
@@ -0,0 +1,184 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Repl.h"
+#include "../Utils/AST.h"
+#include "../Utils/Hash.h"
+#include "../Parser-Bison/UF-C.tab.h"
+#include "../Interpreter/Interpreter.h"
+#include "../Optimizer/Peephole.h"
+
+#define REPL_PROMPT "UF-C> "
+#define REPL_CONTINUATION_PROMPT "...   "
+
+struct ReplSession {
+    struct HashStruct* globalSymbolTable;
+
+    // ASTs of the inputs with definitions, kept until the end since the training regimens run their body in them
+    struct AstNode** definitions;
+    int definitionCount;
+    int definitionCapacity;
+};
+
+// Keeps the AST of an input with definitions until the end of the session
+// Returns 1 if it was kept, 0 otherwise
+int KeepReplDefinitions (struct ReplSession* session, struct AstNode* ast) {
+    if (session->definitionCount == session->definitionCapacity) {
+        int newCapacity = session->definitionCapacity == 0 ? 16 : 2 * session->definitionCapacity;
+        struct AstNode** newDefinitions = realloc(session->definitions, sizeof(struct AstNode*) * newCapacity);
+        if (newDefinitions == NULL) {
+            printf("Unable to allocate memory for the definitions of the REPL\n");
+            return 0;
+        }
+
+        session->definitions = newDefinitions;
+        session->definitionCapacity = newCapacity;
+    }
+
+    session->definitions[session->definitionCount++] = ast;
+    return 1;
+}
+
+// Adds the definitions of a parsed input to the session, then runs its main phase
+// The AST is freed, or kept by the session if it has definitions
+// Returns 1 if it succeeded, 0 otherwise
+int RunReplInput (struct ReplSession* session, struct AstNode* ast) {
+    // The regimens are not inlined, since they can be called by the next inputs
+    RewriteSelfUpdates(ast);
+
+    int success = 1;
+
+    if (ast->child1 != NULL) {
+        success = InterpreteMoreDefinitions(ast, session->globalSymbolTable);
+
+        // The regimens defined before an error are kept in the global symbol table, so their body must be kept too
+        // (if it can't be kept by the session, it is simply never freed)
+        KeepReplDefinitions(session, ast);
+    }
+
+    if (ast->child2 != NULL && !InterpreteMain(ast, session->globalSymbolTable))
+        success = 0;
+
+    if (ast->child1 == NULL)
+        FreeAST(ast);
+
+    return success;
+}
+
+// Runs a whole file at the start of the session
+// Returns 1 if it was run, 0 if it could not be opened or parsed
+int RunReplFile (struct ReplSession* session, const char* fileName) {
+    FILE* codeFile = fopen(fileName, "r");
+    if (codeFile == NULL) {
+        printf("Cannot open %s\n", fileName);
+        return 0;
+    }
+
+    struct AstNode* ast = NULL;
+    int error = ParseFile(codeFile, NULL, &ast);
+    fclose(codeFile);
+
+    if (error != 0) {
+        printf("Error during parsing\n");
+        FreeAST(ast);
+        return 0;
+    }
+
+    if (!RunReplInput(session, ast))
+        printf("Error while interpreting %s\n", fileName);
+
+    return 1;
+}
+
+int RunRepl (const char* fileName) {
+    struct ReplSession session = { NULL, NULL, 0, 0 };
+    if (!Create_Hashtable(&session.globalSymbolTable)) {
+        printf("Error while creating the global symbol table of the REPL\n");
+        return 1;
+    }
+
+    if (fileName != NULL && !RunReplFile(&session, fileName)) {
+        Free_Hashtable(session.globalSymbolTable);
+        return 1;
+    }
+
+    int interactive = isatty(STDIN_FILENO);
+
+    // Lines of the input not run yet, because the statement they start is not over
+    char* chunk = NULL;
+    size_t chunkLength = 0;
+
+    char* line = NULL;
+    size_t lineCapacity = 0;
+    ssize_t lineLength;
+
+    while (1) {
+        if (interactive) {
+            printf(chunkLength == 0 ? REPL_PROMPT : REPL_CONTINUATION_PROMPT);
+            fflush(stdout);
+        }
+
+        if ((lineLength = getline(&line, &lineCapacity, stdin)) == -1)
+            break;
+
+        // Nothing to run before the first line that is not empty
+        if (chunkLength == 0 && strspn(line, " \t\r\n") == (size_t) lineLength)
+            continue;
+
+        char* newChunk = realloc(chunk, chunkLength + lineLength + 2);
+        if (newChunk == NULL) {
+            printf("Unable to allocate memory for the input of the REPL\n");
+            break;
+        }
+        chunk = newChunk;
+        memcpy(chunk + chunkLength, line, lineLength);
+        chunkLength += lineLength;
+
+        // The last line of a file may have no line break, but a statement always ends with one
+        if (chunk[chunkLength-1] != '\n')
+            chunk[chunkLength++] = '\n';
+        chunk[chunkLength] = '\0';
+
+        // The whole statement is parsed again with each of its lines, the grammar telling whether it is over
+        FILE* input = fmemopen(chunk, chunkLength, "r");
+        if (input == NULL) {
+            printf("Cannot read the input of the REPL\n");
+            break;
+        }
+
+        struct AstNode* ast = NULL;
+        int error = ParseChunk(input, NULL, &ast);
+        fclose(input);
+
+        if (error == PARSE_INCOMPLETE)
+            continue;
+
+        chunkLength = 0;
+
+        if (error != 0) {
+            FreeAST(ast);
+            continue;
+        }
+
+        if (!RunReplInput(&session, ast))
+            printf("Error while interpreting the input\n");
+        fflush(stdout);
+    }
+
+    if (chunkLength != 0)
+        printf("Error : The input ended in the middle of a statement\n");
+    else if (interactive)
+        printf("\n");
+
+    free(line);
+    free(chunk);
+
+    Free_Hashtable(session.globalSymbolTable);
+    for (int i = 0; i<session.definitionCount; i++)
+        FreeAST(session.definitions[i]);
+    free(session.definitions);
+
+    return 0;
+}
@@ -0,0 +1,11 @@
+#ifndef __REPL_H__
+#define __REPL_H__
+
+// Reads UF-C from the standard input and runs each definition or line of the main phase as soon as it is complete
+// The fighters and training regimens stay defined until the end of the input, so each input only costs its own lines.
+// A statement written on several lines (training regimen, tournament, loop) is run once its last line is given.
+// If fileName is not NULL, the file is run first and the REPL goes on with its fighters and regimens.
+// Returns 0 if the input ended normally, 1 if the REPL could not be started
+int RunRepl (const char* fileName);
+
+#endif
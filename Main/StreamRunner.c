@@ -0,0 +1,87 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "StreamRunner.h"
+#include "../Utils/AST.h"
+#include "../Utils/Hash.h"
+#include "../Parser-Bison/UF-C.tab.h"
+#include "../Interpreter/Interpreter.h"
+#include "../Interpreter/BranchProfile.h"
+#include "../Optimizer/Inliner.h"
+#include "../Optimizer/Peephole.h"
+
+struct StreamRun {
+    struct HashStruct* globalSymbolTable;
+    struct AstNode* root; // with the definitions, and the line of the main phase being run
+    int success;
+    int stopped; // a break or a continue outside of a loop stops the main phase, the next lines are only parsed
+};
+
+void RunStreamDefinitions (struct AstNode* root, void* userData) {
+    struct StreamRun* run = userData;
+    run->root = root;
+
+    // The regimens can only be inlined in each other, the main phase is not known yet
+    InlineFunctions(root);
+    RewriteSelfUpdates(root);
+
+    // As in the whole program, the main phase still runs with the definitions made before an error
+    if (!Create_Hashtable(&run->globalSymbolTable)) {
+        printf("Error while creating the global symbol table\n");
+        run->success = 0;
+        return;
+    }
+
+    if (!InterpreteMoreDefinitions(root, run->globalSymbolTable))
+        run->success = 0;
+}
+
+void RunStreamStatement (struct AstNode* statement, void* userData) {
+    struct StreamRun* run = userData;
+
+    if (run->globalSymbolTable != NULL && !run->stopped) {
+        run->root->child2 = statement;
+        int result = InterpreteMainLines(run->root, run->globalSymbolTable);
+        run->root->child2 = NULL;
+
+        if (result != 1)
+            run->success = 0;
+        if (IsControlSignal(result))
+            run->stopped = 1;
+
+        // What the line printed is shown before the next line is read
+        fflush(GetInterpreterOutput());
+    }
+
+    FreeAST(statement);
+}
+
+int RunStream (const char* fileName) {
+    FILE* codeFile = strcmp(fileName, "-") ? fopen(fileName, "r") : stdin;
+    if (codeFile == NULL) {
+        printf("Cannot open %s\n", fileName);
+        return 1;
+    }
+
+    struct StreamRun run = { NULL, NULL, 1, 0 };
+    struct AstNode* root = NULL;
+
+    int error = ParseStream(codeFile, NULL, RunStreamDefinitions, RunStreamStatement, &run, &root);
+    if (codeFile != stdin)
+        fclose(codeFile);
+
+    if (error != 0)
+        printf("Error during parsing\n");
+    else if (!run.success)
+        printf("Error while interpreting the AST\n");
+
+    if (run.globalSymbolTable != NULL) {
+        PrintMemoStats(run.globalSymbolTable);
+        Free_Hashtable(run.globalSymbolTable);
+    }
+    PrintBranchStats(root);
+    FreeAST(root);
+
+    return error != 0 || !run.success;
+}
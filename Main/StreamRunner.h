@@ -0,0 +1,11 @@
+#ifndef __STREAM_RUNNER_H__
+#define __STREAM_RUNNER_H__
+
+// Interpretes a code file (the standard input if fileName is "-") while it is parsed :
+// the definitions phase as soon as it is over, then each line of the main phase as soon as it is parsed, freed right after.
+// The memory used doesn't grow with the length of the main phase, and a program written by another process through a pipe
+// starts running with its first lines. The program is not translated, since the translation needs the whole AST.
+// Returns 0 if the program was parsed and interpreted without error, 1 otherwise
+int RunStream (const char* fileName);
+
+#endif
@@ -0,0 +1,593 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "TableRunner.h"
+#include "../Utils/AST.h"
+#include "../Utils/Hash.h"
+#include "../Utils/SymbolTableData.h"
+#include "../Utils/WorkerPool.h"
+#include "../Utils/Allocator.h"
+#include "../Utils/FileReader.h"
+#include "../Parser-Bison/UF-C.tab.h"
+#include "../Parser-Bison/ParallelParser.h"
+#include "../Interpreter/Interpreter.h"
+#include "../Optimizer/Optimizer.h"
+
+struct TableColumn {
+    char* name;
+
+    // Type of the fighter overridden by the column
+    enum VariableType fighterType;
+
+    // Values of a binary table (only one of them is used, depending on the type of the column)
+    int32_t* intValues;
+    float* floatValues;
+};
+
+struct OverrideTable {
+    int columnCount;
+    int rowCount;
+    struct TableColumn* columns;
+
+    // For CSV tables : text of each cell (cells[row * columnCount + column]), pointing inside text
+    char** cells;
+    char* text;
+};
+
+struct TableRowResult {
+    // Everything the row printed
+    char* output;
+    size_t outputSize;
+
+    int done;
+    int success;
+};
+
+struct TableRun {
+    struct AstNode* ast;
+    // Symbol table after the definitions, copied for each row
+    struct HashStruct* templateSymbolTable;
+    struct OverrideTable* table;
+
+    struct TableRowResult* results;
+    // The rows are printed in order by the worker that finishes the next row to print
+    int nextRowToPrint;
+    int failedCount;
+    pthread_mutex_t printLock;
+};
+
+void FreeOverrideTable (struct OverrideTable* table) {
+    if (table==NULL)
+        return;
+
+    if (table->columns!=NULL) {
+        for (int i = 0; i<table->columnCount; i++) {
+            free(table->columns[i].name);
+            free(table->columns[i].intValues);
+            free(table->columns[i].floatValues);
+        }
+        free(table->columns);
+    }
+
+    free(table->cells);
+    free(table->text);
+    free(table);
+}
+
+// Reads the CSV field starting at *cursor, in place : the field is '\0' terminated (and unquoted) inside the text
+// Moves *cursor after the field and returns 1 if it was the last field of the line, 0 otherwise
+int ReadCsvField (char** cursor, char** outField) {
+    char* read = *cursor;
+
+    while (*read==' ' || *read=='\t')
+        read++;
+
+    char* field = read;
+    char* write = read;
+
+    if (*read=='"') { // Quoted field, "" is a quote inside the field
+        read++;
+        while (*read!='\0') {
+            if (*read=='"' && read[1]=='"') {
+                *write++ = '"';
+                read += 2;
+            }
+            else if (*read=='"') {
+                read++;
+                break;
+            }
+            else
+                *write++ = *read++;
+        }
+        // Ignore anything between the closing quote and the separator
+        while (*read!='\0' && *read!=',' && *read!='\n')
+            read++;
+    }
+    else {
+        while (*read!='\0' && *read!=',' && *read!='\n')
+            read++;
+        write = read;
+        // Remove the trailing spaces and '\r'
+        while (write > field && (write[-1]==' ' || write[-1]=='\t' || write[-1]=='\r'))
+            write--;
+    }
+
+    int endOfLine = *read!=',';
+    if (*read!='\0')
+        read++;
+
+    *write = '\0';
+    *outField = field;
+    *cursor = read;
+
+    return endOfLine;
+}
+
+// Returns 1 if the line starting at cursor only has spaces
+int IsBlankLine (char* cursor) {
+    while (*cursor==' ' || *cursor=='\t' || *cursor=='\r')
+        cursor++;
+
+    return *cursor=='\n' || *cursor=='\0';
+}
+
+// Loads a CSV table : the header gives the names of the columns and each line is a row
+int LoadCsvTable (char* text, struct OverrideTable* table) {
+    table->text = text;
+    char* cursor = text;
+
+    // Header
+    int capacity = 8;
+    table->columns = calloc(capacity, sizeof(struct TableColumn));
+    if (table->columns==NULL) {
+        printf("Unable to allocate memory for the columns of the table\n");
+        return 0;
+    }
+
+    int endOfLine = 0;
+    while (!endOfLine) {
+        char* name;
+        endOfLine = ReadCsvField(&cursor, &name);
+
+        if (table->columnCount == capacity) {
+            capacity *= 2;
+            struct TableColumn* newColumns = realloc(table->columns, sizeof(struct TableColumn) * capacity);
+            if (newColumns==NULL) {
+                printf("Unable to allocate memory for the columns of the table\n");
+                return 0;
+            }
+            table->columns = newColumns;
+            memset(table->columns + table->columnCount, 0, sizeof(struct TableColumn) * (capacity - table->columnCount));
+        }
+
+        if ((table->columns[table->columnCount++].name = strdup(name)) == NULL) {
+            printf("Unable to allocate memory for the name of a column of the table\n");
+            return 0;
+        }
+    }
+
+    // Rows
+    int cellCapacity = 1024;
+    table->cells = malloc(sizeof(char*) * cellCapacity);
+    if (table->cells==NULL) {
+        printf("Unable to allocate memory for the cells of the table\n");
+        return 0;
+    }
+
+    int lineNum = 1;
+    while (*cursor!='\0') {
+        lineNum++;
+
+        if (IsBlankLine(cursor)) {
+            cursor = strchr(cursor, '\n');
+            cursor = cursor==NULL ? "" : cursor + 1;
+            continue;
+        }
+
+        if ((long) (table->rowCount + 1) * table->columnCount > cellCapacity) {
+            cellCapacity *= 2;
+            char** newCells = realloc(table->cells, sizeof(char*) * cellCapacity);
+            if (newCells==NULL) {
+                printf("Unable to allocate memory for the cells of the table\n");
+                return 0;
+            }
+            table->cells = newCells;
+        }
+
+        char** rowCells = table->cells + (long) table->rowCount * table->columnCount;
+        int fieldCount = 0;
+        endOfLine = 0;
+        while (!endOfLine) {
+            char* field;
+            endOfLine = ReadCsvField(&cursor, &field);
+
+            if (fieldCount < table->columnCount)
+                rowCells[fieldCount] = field;
+            fieldCount++;
+        }
+
+        if (fieldCount != table->columnCount) {
+            printf("Error at line %d of the table : %d values for %d columns\n", lineNum, fieldCount, table->columnCount);
+            return 0;
+        }
+
+        table->rowCount++;
+    }
+
+    return 1;
+}
+
+// Reads count values of 4 bytes at *cursor, checking that they are inside the file
+int ReadBinaryValues (char** cursor, char* end, void* out, int count) {
+    size_t size = (size_t) count * 4;
+    if ((size_t) (end - *cursor) < size) {
+        printf("The binary table ends too early\n");
+        return 0;
+    }
+
+    memcpy(out, *cursor, size);
+    *cursor += size;
+    return 1;
+}
+
+// Loads a binary table (see TableRunner.h for the format)
+int LoadBinaryTable (char* text, size_t length, struct OverrideTable* table) {
+    char* end = text + length;
+    char* cursor = text + strlen(TABLE_BINARY_MAGIC);
+
+    int32_t header[2];
+    if (!ReadBinaryValues(&cursor, end, header, 2))
+        return 0;
+
+    if (header[0] <= 0 || header[1] < 0) {
+        printf("Not a valid number of columns or rows in the binary table\n");
+        return 0;
+    }
+
+    table->columnCount = header[0];
+    table->rowCount = header[1];
+    table->columns = calloc(table->columnCount, sizeof(struct TableColumn));
+    if (table->columns==NULL) {
+        printf("Unable to allocate memory for the columns of the table\n");
+        return 0;
+    }
+
+    // Name and type of the columns
+    int32_t* columnTypes = malloc(sizeof(int32_t) * table->columnCount);
+    if (columnTypes==NULL) {
+        printf("Unable to allocate memory for the columns of the table\n");
+        return 0;
+    }
+
+    for (int i = 0; i<table->columnCount; i++) {
+        int32_t nameLength;
+        if (!ReadBinaryValues(&cursor, end, &nameLength, 1) || nameLength <= 0 || nameLength > end - cursor) {
+            printf("Not a valid name for the column %d of the binary table\n", i);
+            free(columnTypes);
+            return 0;
+        }
+
+        table->columns[i].name = strndup(cursor, nameLength);
+        cursor += nameLength;
+
+        if (table->columns[i].name==NULL || !ReadBinaryValues(&cursor, end, &columnTypes[i], 1)) {
+            free(columnTypes);
+            return 0;
+        }
+    }
+
+    // Values
+    for (int i = 0; i<table->columnCount; i++) {
+        struct TableColumn* column = &table->columns[i];
+        size_t size = sizeof(int32_t) * (table->rowCount > 0 ? table->rowCount : 1);
+
+        if (columnTypes[i] == TABLE_COLUMN_INT)
+            column->intValues = malloc(size);
+        else if (columnTypes[i] == TABLE_COLUMN_FLOAT)
+            column->floatValues = malloc(size);
+        else {
+            printf("Not a valid type for the column %s of the binary table\n", column->name);
+            free(columnTypes);
+            return 0;
+        }
+
+        void* values = column->intValues!=NULL ? (void*) column->intValues : (void*) column->floatValues;
+        if (values==NULL || !ReadBinaryValues(&cursor, end, values, table->rowCount)) {
+            free(columnTypes);
+            return 0;
+        }
+    }
+
+    free(columnTypes);
+    free(text);
+    return 1;
+}
+
+// Loads a CSV or binary table
+struct OverrideTable* LoadOverrideTable (char* tableFileName) {
+    FILE* tableFile = fopen(tableFileName, "rb");
+    if (tableFile==NULL) {
+        printf("Cannot open the table %s\n", tableFileName);
+        return NULL;
+    }
+
+    size_t length;
+    char* text = ReadWholeFile(tableFile, &length);
+    fclose(tableFile);
+    if (text==NULL) {
+        printf("Unable to read the table %s\n", tableFileName);
+        return NULL;
+    }
+
+    struct OverrideTable* table = calloc(1, sizeof(struct OverrideTable));
+    if (table==NULL) {
+        printf("Unable to allocate memory for the table\n");
+        free(text);
+        return NULL;
+    }
+
+    int success;
+    if (length >= strlen(TABLE_BINARY_MAGIC) && !memcmp(text, TABLE_BINARY_MAGIC, strlen(TABLE_BINARY_MAGIC)))
+        success = LoadBinaryTable(text, length, table); // text is freed once the values are copied
+    else
+        success = LoadCsvTable(text, table); // The cells point inside text, that is freed with the table
+
+    if (!success) {
+        if (table->text==NULL)
+            free(text);
+        FreeOverrideTable(table);
+        return NULL;
+    }
+
+    return table;
+}
+
+// Checks that every column names a fighter of the definitions that can take the values of the column
+int BindTableColumns (struct OverrideTable* table, struct HashStruct* symbolTable) {
+    for (int i = 0; i<table->columnCount; i++) {
+        struct TableColumn* column = &table->columns[i];
+        struct VariableStruct* fighter;
+
+        if (!TryFind_Hashtable(symbolTable, column->name, &fighter)) {
+            printf("The column %s of the table is not a fighter of the definitions\n", column->name);
+            return 0;
+        }
+        if (fighter->functionBody!=NULL) {
+            printf("The column %s of the table is a training regimen, not a fighter\n", column->name);
+            return 0;
+        }
+        if (fighter->team!=NULL) {
+            printf("The column %s of the table is a team, not a single fighter\n", column->name);
+            return 0;
+        }
+
+        column->fighterType = fighter->type;
+
+        if ((column->intValues!=NULL && fighter->type!=integer && fighter->type!=floating)
+            || (column->floatValues!=NULL && fighter->type!=floating)) {
+            printf("The values of the column %s don't match the type of the fighter\n", column->name);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Assigns the values of a row to the fighters of the symbol table
+// Errors are written to output
+int ApplyTableRow (struct OverrideTable* table, int row, struct HashStruct* symbolTable, FILE* output) {
+    for (int i = 0; i<table->columnCount; i++) {
+        struct TableColumn* column = &table->columns[i];
+        struct VariableStruct* fighter;
+
+        if (!TryFind_Hashtable(symbolTable, column->name, &fighter)) {
+            fprintf(output, "Row %d : no fighter named %s\n", row + 1, column->name);
+            return 0;
+        }
+
+        // Binary table
+        if (column->intValues!=NULL) {
+            if (fighter->type==integer)
+                fighter->i = column->intValues[row];
+            else
+                fighter->f = column->intValues[row];
+            continue;
+        }
+        if (column->floatValues!=NULL) {
+            fighter->f = column->floatValues[row];
+            continue;
+        }
+
+        // CSV table
+        char* cell = table->cells[(long) row * table->columnCount + i];
+        char* end;
+
+        switch (fighter->type) {
+            case integer:
+                fighter->i = (int) strtol(cell, &end, 10);
+                if (end==cell || *end!='\0') {
+                    fprintf(output, "Row %d : %s is not a number of fans for %s\n", row + 1, cell, column->name);
+                    return 0;
+                }
+                break;
+            case floating:
+                fighter->f = strtof(cell, &end);
+                if (end==cell || *end!='\0') {
+                    fprintf(output, "Row %d : %s is not an IQ for %s\n", row + 1, cell, column->name);
+                    return 0;
+                }
+                break;
+            case characters:
+            {
+                char* copy = UfcStrdup(cell);
+                if (copy==NULL) {
+                    fprintf(output, "Row %d : unable to allocate memory for %s\n", row + 1, column->name);
+                    return 0;
+                }
+                UfcFree(fighter->s);
+                fighter->s = copy;
+                break;
+            }
+            default:
+                fprintf(output, "Row %d : %s can't be given a value\n", row + 1, column->name);
+                return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Runs the main phase for one row of the table, then prints all the rows that are done in order
+void RunTableRow (int row, int workerIndex, void* userData) {
+    struct TableRun* run = (struct TableRun*) userData;
+    struct TableRowResult* result = &run->results[row];
+    int success = 0;
+
+    FILE* output = open_memstream(&result->output, &result->outputSize);
+    if (output==NULL) {
+        printf("Row %d : cannot capture the output\n", row + 1);
+    }
+    else {
+        // Each row has the whole memory limit for itself
+        struct MemoryBudget budget;
+        StartMemoryBudget(&budget);
+
+        struct HashStruct* symbolTable;
+        if (!Clone_Hashtable(run->templateSymbolTable, &symbolTable))
+            fprintf(output, "Row %d : unable to copy the symbol table\n", row + 1);
+        else {
+            if (ApplyTableRow(run->table, row, symbolTable, output)) {
+                SetInterpreterOutput(output);
+                success = InterpreteMain(run->ast, symbolTable);
+                SetInterpreterOutput(NULL);
+
+                if (!success)
+                    fprintf(output, "Row %d : error while interpreting the AST\n", row + 1);
+            }
+
+            Free_Hashtable(symbolTable);
+        }
+
+        EndMemoryBudget(&budget);
+        if (PrintMemoryLimitError(output, &budget)) {
+            fprintf(output, "Row %d : memory limit exceeded\n", row + 1);
+            success = 0;
+        }
+
+        fclose(output);
+    }
+
+    pthread_mutex_lock(&run->printLock);
+
+    result->done = 1;
+    result->success = success;
+    if (!success)
+        run->failedCount++;
+
+    int printed = 0;
+    while (run->nextRowToPrint < run->table->rowCount && run->results[run->nextRowToPrint].done) {
+        struct TableRowResult* next = &run->results[run->nextRowToPrint];
+
+        fwrite(next->output, 1, next->outputSize, stdout);
+        free(next->output);
+        next->output = NULL;
+
+        run->nextRowToPrint++;
+        printed = 1;
+    }
+    if (printed)
+        fflush(stdout);
+
+    pthread_mutex_unlock(&run->printLock);
+}
+
+int RunTable (char* codeFileName, char* tableFileName, int workerCount) {
+    /************************** Parsing the code ******************************/
+
+    FILE* codeFile = fopen(codeFileName, "r");
+    if (codeFile==NULL) {
+        printf("Cannot open %s\n", codeFileName);
+        return -1;
+    }
+
+    struct AstNode* ast = NULL;
+    int error = ParseFileInParallel(codeFile, NULL, &ast);
+    fclose(codeFile);
+    if (error != 0) {
+        printf("Error during parsing\n");
+        FreeAST(ast);
+        return -1;
+    }
+
+    /************************** Loading the table *****************************/
+
+    struct OverrideTable* table = LoadOverrideTable(tableFileName);
+    if (table==NULL) {
+        FreeAST(ast);
+        return -1;
+    }
+
+    // The fighters of the columns are kept even if the code never uses them, the report goes with the errors of the rows
+    char** columnNames = malloc(sizeof(char*) * (table->columnCount > 0 ? table->columnCount : 1));
+    if (columnNames==NULL) {
+        printf("Unable to allocate memory for the names of the columns\n");
+        FreeOverrideTable(table);
+        FreeAST(ast);
+        return -1;
+    }
+    for (int k = 0; k < table->columnCount; k++)
+        columnNames[k] = table->columns[k].name;
+
+    OptimizeProgram(ast, columnNames, table->columnCount, stderr);
+    free(columnNames);
+
+    /************** Interpreting the definitions once **************/
+
+    struct HashStruct* templateSymbolTable;
+    if (!InterpreteDefinitions(ast, &templateSymbolTable)) {
+        printf("Error while interpreting the definitions\n");
+        FreeOverrideTable(table);
+        FreeAST(ast);
+        return -1;
+    }
+
+    if (!BindTableColumns(table, templateSymbolTable)) {
+        FreeOverrideTable(table);
+        Free_Hashtable(templateSymbolTable);
+        FreeAST(ast);
+        return -1;
+    }
+
+    /************************** Running every row *****************************/
+
+    struct TableRun run;
+    run.ast = ast;
+    run.templateSymbolTable = templateSymbolTable;
+    run.table = table;
+    run.nextRowToPrint = 0;
+    run.failedCount = 0;
+    run.results = calloc(table->rowCount > 0 ? table->rowCount : 1, sizeof(struct TableRowResult));
+    pthread_mutex_init(&run.printLock, NULL);
+
+    int result = -1;
+    if (run.results==NULL)
+        printf("Unable to allocate memory for the results of the rows\n");
+    else if (!RunOnWorkerPoolInOrder(table->rowCount, workerCount, RunTableRow, &run))
+        printf("Error while running the rows of the table\n");
+    else {
+        result = run.failedCount;
+        if (run.failedCount > 0)
+            fprintf(stderr, "%d of the %d rows failed\n", run.failedCount, table->rowCount);
+    }
+
+    pthread_mutex_destroy(&run.printLock);
+    free(run.results);
+    FreeOverrideTable(table);
+    Free_Hashtable(templateSymbolTable);
+    FreeAST(ast);
+
+    return result;
+}
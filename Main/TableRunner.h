@@ -0,0 +1,25 @@
+#ifndef __TABLE_RUNNER_H__
+#define __TABLE_RUNNER_H__
+
+// Magic number at the beginning of a binary table file
+#define TABLE_BINARY_MAGIC "UFCT"
+
+// Type of a column in a binary table file
+#define TABLE_COLUMN_INT 0
+#define TABLE_COLUMN_FLOAT 1
+
+// Parses the code file and interpretes its definitions only once, then interpretes the main phase once per row of the table,
+// with the fighters named in the header of the table starting with the values of the row instead of the ones of the definitions.
+// Every row runs with its own copy of the symbol table, on workerCount threads (0 means one per processor),
+// and the outputs of the rows are printed in the order of the rows as soon as they are available.
+//
+// The table is either a CSV file whose first line holds the names of the fighters,
+// or a binary file (native endianness) made of:
+//   "UFCT", int32 number of columns, int32 number of rows,
+//   for each column : int32 length of the name, the name (without '\0'), int32 type (TABLE_COLUMN_INT or TABLE_COLUMN_FLOAT),
+//   then the values of each column one after the other (int32 or float32)
+//
+// Returns the number of rows that failed, or -1 if the table could not be run
+int RunTable (char* codeFileName, char* tableFileName, int workerCount);
+
+#endif
@@ -0,0 +1,442 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include "WatchRunner.h"
+#include "../Parser-Bison/UF-C.tab.h"
+#include "../Parser-Bison/ParallelParser.h"
+#include "../Utils/FileReader.h"
+
+// Bytes compared at once when looking for the change of the file
+#define WATCH_COMPARE_BLOCK 4096
+
+// A part of the watched file, ending after a training regimen (or at the end of the file for the last one)
+struct WatchPart {
+    size_t start, length;
+    // Line of the file where the part starts
+    int firstLine;
+
+    // Definitions of the part in the list of the definitions of the program : its first and its last list node (NULL if it has none)
+    struct AstNode* firstDefinition;
+    struct AstNode* lastDefinition;
+};
+
+struct WatchedFile {
+    // Text of the file when it was last parsed without error, and the places where it can be cut (see FindParseCuts)
+    char* source;
+    size_t length;
+    struct ParseCut* cuts;
+    int cutCount;
+
+    struct WatchPart* parts;
+    int partCount;
+
+    // The program that is run : the atRoot of the last part, with the main phase, whose list of definitions goes through
+    // the definitions of all the parts in order
+    struct AstNode* program;
+};
+
+void FreeWatchedFile (struct WatchedFile* watched) {
+    // The definitions of all the parts are linked to the program
+    FreeAST(watched->program);
+    free(watched->parts);
+    free(watched->cuts);
+    free(watched->source);
+}
+
+size_t CommonPrefixLength (const char* a, const char* b, size_t length) {
+    size_t prefix = 0;
+    while (length - prefix >= WATCH_COMPARE_BLOCK && !memcmp(a + prefix, b + prefix, WATCH_COMPARE_BLOCK))
+        prefix += WATCH_COMPARE_BLOCK;
+    while (prefix < length && a[prefix] == b[prefix])
+        prefix++;
+    return prefix;
+}
+
+// Same as CommonPrefixLength from the ends of a and b (aLength and bLength bytes), over at most length bytes
+size_t CommonSuffixLength (const char* a, size_t aLength, const char* b, size_t bLength, size_t length) {
+    const char* aEnd = a + aLength;
+    const char* bEnd = b + bLength;
+
+    size_t suffix = 0;
+    while (length - suffix >= WATCH_COMPARE_BLOCK && !memcmp(aEnd - suffix - WATCH_COMPARE_BLOCK, bEnd - suffix - WATCH_COMPARE_BLOCK, WATCH_COMPARE_BLOCK))
+        suffix += WATCH_COMPARE_BLOCK;
+    while (suffix < length && *(aEnd - suffix - 1) == *(bEnd - suffix - 1))
+        suffix++;
+    return suffix;
+}
+
+// Finds the cuts of the new source, whose first prefix and last suffix bytes are the ones of the watched source.
+// The cuts before the change are kept, since the text before them didn't change, and the source is scanned again from the last one
+// up to the first old cut after the change. If the scan cuts there too, the scanner is outside of the comments and the strings there
+// as it was before, and the text after it didn't change, so the next old cuts are kept (moved with the change).
+// Returns the number of cuts written in *outCuts (to free), or -1 if there is not enough memory
+int FindChangedCuts (struct WatchedFile* watched, const char* source, size_t length, size_t prefix, size_t suffix, struct ParseCut** outCuts) {
+    int keptStart = 0;
+    while (keptStart < watched->cutCount && watched->cuts[keptStart].offset <= prefix)
+        keptStart++;
+    size_t scanStart = keptStart > 0 ? watched->cuts[keptStart - 1].offset : 0;
+    int scanLine = keptStart > 0 ? watched->cuts[keptStart - 1].line : 1;
+
+    // First old cut followed by the same text, which is now at offset + length - watched->length
+    int keptEnd = keptStart;
+    while (keptEnd < watched->cutCount && (watched->cuts[keptEnd].offset < watched->length - suffix
+            || watched->cuts[keptEnd].offset + length - watched->length <= scanStart))
+        keptEnd++;
+    size_t scanEnd = keptEnd < watched->cutCount ? watched->cuts[keptEnd].offset + length - watched->length : length;
+
+    struct ParseCut* scanned = NULL;
+    int scannedCount = FindParseCuts(source + scanStart, scanEnd - scanStart, &scanned);
+    int aligned = scannedCount > 0 && keptEnd < watched->cutCount && scanned[scannedCount - 1].offset == scanEnd - scanStart;
+
+    // The change opened or closed a comment or a string : the rest of the file is scanned
+    if (scannedCount >= 0 && !aligned && scanEnd < length) {
+        free(scanned);
+        scanEnd = length;
+        scannedCount = FindParseCuts(source + scanStart, scanEnd - scanStart, &scanned);
+    }
+    if (scannedCount < 0)
+        return -1;
+
+    int movedCount = aligned ? watched->cutCount - keptEnd - 1 : 0;
+    struct ParseCut* cuts = malloc(sizeof(struct ParseCut) * (keptStart + scannedCount + movedCount + 1));
+    if (cuts == NULL) {
+        free(scanned);
+        return -1;
+    }
+
+    int count = 0;
+    for (int i = 0; i < keptStart; i++)
+        cuts[count++] = watched->cuts[i];
+
+    // The scan counted the lines from 1 at scanStart
+    for (int i = 0; i < scannedCount; i++)
+        cuts[count++] = (struct ParseCut) { scanStart + scanned[i].offset, scanLine - 1 + scanned[i].line };
+
+    if (aligned) {
+        int lineDelta = cuts[count - 1].line - watched->cuts[keptEnd].line;
+        for (int i = keptEnd + 1; i < watched->cutCount; i++)
+            cuts[count++] = (struct ParseCut) { watched->cuts[i].offset + length - watched->length, watched->cuts[i].line + lineDelta };
+    }
+
+    free(scanned);
+    *outCuts = cuts;
+    return count;
+}
+
+int CountLines (const char* text, size_t length) {
+    int count = 0;
+    for (const char* end = text + length; (text = memchr(text, '\n', end - text)) != NULL; text++)
+        count++;
+    return count;
+}
+
+// Parses the part of source, from its line in the file so that the line numbers of the nodes and of the errors are the right ones
+// Returns 0 if the part was parsed without error
+int ParseWatchedPart (const char* source, struct WatchPart* part, struct AstNode** outAst) {
+    // fmemopen can't open an empty buffer, an empty file is the empty program
+    if (part->length == 0) {
+        *outAst = CreateBasicNode(atRoot, NULL, NULL, NULL, part->firstLine);
+        return *outAst == NULL;
+    }
+
+    FILE* input = fmemopen((void*) (source + part->start), part->length, "r");
+    if (input == NULL) {
+        printf("Cannot read the part of the program starting at line %d\n", part->firstLine);
+        return 1;
+    }
+
+    int error = ParseFileFromLine(input, NULL, part->firstLine, outAst);
+    fclose(input);
+
+    return error;
+}
+
+// Returns 1 if the new part has the text of the old one : it is in the unchanged start of the file at the same place,
+// or in the unchanged end of the file, moved by the change of length
+int IsSamePart (struct WatchPart* oldPart, size_t oldLength, struct WatchPart* part, size_t length, size_t prefix, size_t suffix) {
+    if (oldPart->length != part->length)
+        return 0;
+
+    return (part->start == oldPart->start && part->start + part->length <= prefix)
+        || (part->start == oldPart->start + length - oldLength && part->start >= length - suffix);
+}
+
+// Adds delta to the line numbers of the nodes of the tree
+void MoveLines (struct AstNode* ast, int delta) {
+    // The statement lists are followed in a loop, since they can be as long as the program
+    for (; ast != NULL; ast = ast->child2) {
+        ast->lineNumInCode += delta;
+        MoveLines(ast->child1, delta);
+        MoveLines(ast->child3, delta);
+    }
+}
+
+// Adds delta to the line numbers of the definitions of the part, which are followed by the ones of the next parts
+void MovePartLines (struct WatchPart* part, int delta) {
+    for (struct AstNode* list = part->firstDefinition; list != NULL; list = list->child2) {
+        list->lineNumInCode += delta;
+        MoveLines(list->child1, delta);
+        if (list == part->lastDefinition)
+            break;
+    }
+}
+
+// Takes the list of the definitions out of the atRoot of a parsed part
+void TakePartDefinitions (struct WatchPart* part, struct AstNode* partAst) {
+    part->firstDefinition = partAst->child1;
+    part->lastDefinition = partAst->child1;
+    while (part->lastDefinition != NULL && part->lastDefinition->child2 != NULL)
+        part->lastDefinition = part->lastDefinition->child2;
+    partAst->child1 = NULL;
+}
+
+// Links the definitions of the parts, in order, to the program
+void LinkWatchedProgram (struct WatchedFile* watched) {
+    struct AstNode** link = &watched->program->child1;
+    for (int i = 0; i < watched->partCount; i++) {
+        if (watched->parts[i].firstDefinition == NULL)
+            continue;
+
+        *link = watched->parts[i].firstDefinition;
+        link = &watched->parts[i].lastDefinition->child2;
+    }
+    *link = NULL;
+}
+
+// Reads fileName again and parses the parts whose text changed since the last time, putting their definitions in the program
+// in place of the old ones. The other parts keep their nodes, with their line numbers moved if lines were added or removed above them.
+// If a part has a parse error, the program is left as it was, so that the next change is compared to the last correct program
+// Returns 0 if the file could not be read or parsed
+int UpdateWatchedFile (struct WatchedFile* watched, char* fileName, int* outParsedParts, int* outParsedLines) {
+    // inotify doesn't tell what changed, so the file is read again and compared with the last one
+    FILE* codeFile = fopen(fileName, "r");
+    if (codeFile == NULL) {
+        printf("Cannot open %s\n", fileName);
+        return 0;
+    }
+
+    size_t length;
+    char* source = ReadWholeFile(codeFile, &length);
+    fclose(codeFile);
+    if (source == NULL) {
+        printf("Unable to allocate memory for the program\n");
+        return 0;
+    }
+
+    size_t prefix = 0, suffix = 0;
+    if (watched->source != NULL) {
+        size_t shorter = length < watched->length ? length : watched->length;
+        prefix = CommonPrefixLength(watched->source, source, shorter);
+        suffix = CommonSuffixLength(watched->source, watched->length, source, length, shorter - prefix);
+    }
+
+    struct ParseCut* cuts = NULL;
+    int cutCount = FindChangedCuts(watched, source, length, prefix, suffix, &cuts);
+    // As in ParseFileInParallel, the last part keeps a regimen : the definitions phase can't be empty before the competition begins
+    int partCount = cutCount > 1 ? cutCount : 1;
+    struct WatchPart* parts = cutCount >= 0 ? calloc(partCount, sizeof(struct WatchPart)) : NULL;
+    struct AstNode** partAsts = cutCount >= 0 ? calloc(partCount, sizeof(struct AstNode*)) : NULL;
+    if (parts == NULL || partAsts == NULL) {
+        printf("Unable to allocate memory for the parts of the program\n");
+        free(parts);
+        free(partAsts);
+        free(cuts);
+        free(source);
+        return 0;
+    }
+
+    for (int i = 0; i < partCount; i++) {
+        parts[i].start = i == 0 ? 0 : cuts[i - 1].offset;
+        parts[i].firstLine = i == 0 ? 1 : cuts[i - 1].line;
+        parts[i].length = (i == partCount - 1 ? length : cuts[i].offset) - parts[i].start;
+    }
+
+    // The parts that didn't change at the start and at the end of the file keep their nodes, the ones in between are parsed again.
+    // The last part, holding the main phase, can only be kept from the end
+    int sameStart = 0;
+    while (sameStart < partCount - 1 && sameStart < watched->partCount - 1
+            && IsSamePart(&watched->parts[sameStart], watched->length, &parts[sameStart], length, prefix, suffix))
+        sameStart++;
+
+    int sameEnd = 0;
+    while (sameEnd < partCount - sameStart && sameEnd < watched->partCount - sameStart
+            && IsSamePart(&watched->parts[watched->partCount - 1 - sameEnd], watched->length, &parts[partCount - 1 - sameEnd], length, prefix, suffix))
+        sameEnd++;
+
+    int error = 0;
+    *outParsedParts = partCount - sameStart - sameEnd;
+    *outParsedLines = 0;
+    for (int i = sameStart; i < partCount - sameEnd; i++) {
+        // Every changed part is parsed, so that all their errors are shown at once
+        if (ParseWatchedPart(source, &parts[i], &partAsts[i]) != 0)
+            error = 1;
+        *outParsedLines += CountLines(source + parts[i].start, parts[i].length);
+    }
+
+    if (error) {
+        for (int i = sameStart; i < partCount - sameEnd; i++)
+            FreeAST(partAsts[i]);
+        free(partAsts);
+        free(parts);
+        free(cuts);
+        free(source);
+        return 0;
+    }
+
+    // The definitions of the changed parts are freed, without the ones of the next parts that follow them in the program
+    for (int i = sameStart; i < watched->partCount - sameEnd; i++) {
+        struct WatchPart* oldPart = &watched->parts[i];
+        if (oldPart->lastDefinition != NULL) {
+            oldPart->lastDefinition->child2 = NULL;
+            FreeAST(oldPart->firstDefinition);
+        }
+    }
+
+    // The program is the root of the last part, with its main phase
+    if (sameEnd == 0) {
+        if (watched->program != NULL) {
+            watched->program->child1 = NULL;
+            FreeAST(watched->program);
+        }
+        watched->program = partAsts[partCount - 1];
+    }
+    else if (parts[partCount - 1].firstLine != watched->parts[watched->partCount - 1].firstLine) {
+        int delta = parts[partCount - 1].firstLine - watched->parts[watched->partCount - 1].firstLine;
+        watched->program->lineNumInCode += delta;
+        MoveLines(watched->program->child2, delta);
+    }
+
+    for (int i = 0; i < sameStart; i++) {
+        parts[i].firstDefinition = watched->parts[i].firstDefinition;
+        parts[i].lastDefinition = watched->parts[i].lastDefinition;
+    }
+    for (int i = sameStart; i < partCount - sameEnd; i++) {
+        TakePartDefinitions(&parts[i], partAsts[i]);
+        if (i < partCount - 1)
+            FreeAST(partAsts[i]);
+    }
+    for (int i = 0; i < sameEnd; i++) {
+        struct WatchPart* oldPart = &watched->parts[watched->partCount - 1 - i];
+        struct WatchPart* part = &parts[partCount - 1 - i];
+        part->firstDefinition = oldPart->firstDefinition;
+        part->lastDefinition = oldPart->lastDefinition;
+        if (part->firstLine != oldPart->firstLine)
+            MovePartLines(part, part->firstLine - oldPart->firstLine);
+    }
+
+    free(partAsts);
+    free(watched->parts);
+    free(watched->cuts);
+    free(watched->source);
+    watched->source = source;
+    watched->length = length;
+    watched->cuts = cuts;
+    watched->cutCount = cutCount;
+    watched->parts = parts;
+    watched->partCount = partCount;
+
+    LinkWatchedProgram(watched);
+    return 1;
+}
+
+double GetElapsedMilliseconds (struct timespec* start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) * 1e3 + (end.tv_nsec - start->tv_nsec) * 1e-6;
+}
+
+void RunWatchedFile (struct WatchedFile* watched, char* fileName, WatchedFileRunner runFile) {
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    int parsedParts, parsedLines;
+    if (!UpdateWatchedFile(watched, fileName, &parsedParts, &parsedLines))
+        printf("Error during parsing\n");
+    else {
+        printf("==> %s : %d of %d parts parsed (%d lines) in %.3f ms <==\n", fileName, parsedParts, watched->partCount, parsedLines, GetElapsedMilliseconds(&start));
+        runFile(watched->program, fileName);
+    }
+
+    fflush(stdout);
+}
+
+// Waits until the file named name of the watched directory is written or replaced (editors often write a new file and rename it),
+// then until it stays unchanged for WATCH_SETTLE_DELAY
+// Returns 1 if the file changed, or 0 if the watch is over, with the result of RunWatch in *outResult
+int WaitForChange (int watcher, const char* name, int* outResult) {
+    char events[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    int changed = 0;
+    while (!changed) {
+        ssize_t size = read(watcher, events, sizeof(events));
+        if (size < 0 && errno == EINTR)
+            continue;
+        if (size <= 0) {
+            printf("Cannot read the changes of the directory\n");
+            *outResult = WATCH_READ_ERROR;
+            return 0;
+        }
+
+        for (char* position = events; position < events + size; ) {
+            struct inotify_event* event = (struct inotify_event*) position;
+            // The directory was removed, or its file system unmounted
+            if (event->mask & IN_IGNORED) {
+                *outResult = WATCH_ENDED;
+                return 0;
+            }
+            if (event->len > 0 && !strcmp(event->name, name))
+                changed = 1;
+            position += sizeof(struct inotify_event) + event->len;
+        }
+    }
+
+    struct pollfd watcherPoll = { .fd = watcher, .events = POLLIN };
+    while (poll(&watcherPoll, 1, WATCH_SETTLE_DELAY) > 0) {
+        if (read(watcher, events, sizeof(events)) <= 0)
+            break;
+    }
+
+    return 1;
+}
+
+int RunWatch (char* fileName, WatchedFileRunner runFile) {
+    // The directory is watched rather than the file, whose inode changes when it is replaced
+    char* directory = strdup(fileName);
+    if (directory == NULL) {
+        printf("Unable to allocate memory for the name of the directory\n");
+        return WATCH_CANNOT_WATCH;
+    }
+    char* name = strrchr(directory, '/');
+    if (name != NULL)
+        *name++ = '\0';
+    else
+        name = directory;
+
+    int watcher = inotify_init1(IN_CLOEXEC);
+    if (watcher < 0 || inotify_add_watch(watcher, name != directory ? (*directory ? directory : "/") : ".", IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        printf("Cannot watch %s\n", fileName);
+        if (watcher >= 0)
+            close(watcher);
+        free(directory);
+        return WATCH_CANNOT_WATCH;
+    }
+
+    int result;
+    struct WatchedFile watched = { 0 };
+    RunWatchedFile(&watched, fileName, runFile);
+    while (WaitForChange(watcher, name, &result))
+        RunWatchedFile(&watched, fileName, runFile);
+
+    printf("Stopped watching %s\n", fileName);
+    FreeWatchedFile(&watched);
+    close(watcher);
+    free(directory);
+
+    return result;
+}
@@ -0,0 +1,26 @@
+#ifndef __WATCH_RUNNER_H__
+#define __WATCH_RUNNER_H__
+
+#include "../Utils/AST.h"
+
+// Delay (in milliseconds) without any change of the file before it is parsed again, an editor saving a file can write it several times
+#define WATCH_SETTLE_DELAY 50
+
+// Results of RunWatch
+#define WATCH_ENDED 0 // the directory of the file was removed (or its file system unmounted)
+#define WATCH_CANNOT_WATCH 1 // the file could not be watched, it wasn't run
+#define WATCH_READ_ERROR 2 // the changes of the directory could not be read anymore
+
+// Translates and interpretes the AST of fileName, leaving it as it is : the same AST is run again after the next change
+typedef int (*WatchedFileRunner)(struct AstNode* ast, char* fileName);
+
+// Runs the code file with runFile, then again each time it is saved (watched with inotify), until the process is stopped.
+// The file is kept in parts ending after a training regimen (see FindParseCuts), and the program in a single AST whose definitions
+// are the ones of the parts in order. When the file changes, it is compared with the last one and the cuts are looked for again
+// only around the change. Only the parts whose text changed are parsed again, and their definitions replace the old ones in the AST,
+// while the others keep their nodes (with their line numbers moved), so a change of a training regimen only costs the parsing of
+// that regimen. The last part holds the main phase.
+// Returns WATCH_CANNOT_WATCH if the file could not be watched, or else the reason why the watch ended
+int RunWatch (char* fileName, WatchedFileRunner runFile);
+
+#endif
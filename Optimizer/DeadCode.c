@@ -0,0 +1,255 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "DeadCode.h"
+#include "../Utils/Allocator.h"
+
+static int deadCodeElimination = 1;
+static int deadCodeReport = 0;
+
+void SetDeadCodeElimination(int enabled, int report)
+{
+    deadCodeElimination = enabled;
+    deadCodeReport = report;
+}
+
+// A definition of the definitions phase
+struct DeadCodeDefinition {
+    // atVariableDef or atFuncDef node
+    struct AstNode* definition;
+
+    int reached;
+};
+
+struct DeadCodeContext {
+    // Definitions in the order of the definitions phase
+    struct DeadCodeDefinition* definitions;
+    int definitionCount;
+
+    // Open addressing table of the names : index + 1 of the first definition of the name, 0 for an empty slot
+    int* slots;
+    unsigned int slotMask;
+
+    // Indexes of the reached regimens whose body wasn't looked at yet
+    int* pending;
+    int pendingCount;
+};
+
+unsigned int HashDefinitionName (const char* name) {
+    unsigned int hash = 5381;
+    for (; *name; name++)
+        hash = hash * 33 + (unsigned char)*name;
+    return hash;
+}
+
+// Returns the index of the first definition of name, -1 if it isn't defined
+int FindDefinition (struct DeadCodeContext* context, const char* name) {
+    for (unsigned int slot = HashDefinitionName(name) & context->slotMask; context->slots[slot] != 0; slot = (slot + 1) & context->slotMask) {
+        int index = context->slots[slot] - 1;
+        if (!strcmp(context->definitions[index].definition->child1->s, name))
+            return index;
+    }
+    return -1;
+}
+
+// Returns 0 if the name was already defined
+int AddDefinitionName (struct DeadCodeContext* context, int index) {
+    const char* name = context->definitions[index].definition->child1->s;
+
+    unsigned int slot = HashDefinitionName(name) & context->slotMask;
+    for (; context->slots[slot] != 0; slot = (slot + 1) & context->slotMask) {
+        if (!strcmp(context->definitions[context->slots[slot] - 1].definition->child1->s, name))
+            return 0;
+    }
+
+    context->slots[slot] = index + 1;
+    return 1;
+}
+
+void ReachDefinition (struct DeadCodeContext* context, int index) {
+    struct DeadCodeDefinition* definition = &context->definitions[index];
+    if (definition->reached)
+        return;
+
+    definition->reached = 1;
+    if (definition->definition->type == atFuncDef)
+        context->pending[context->pendingCount++] = index;
+}
+
+// Reaches every definition whose name is used by an atId of the tree
+void ReachNames (struct DeadCodeContext* context, struct AstNode* ast) {
+    // The statement lists are followed in a loop, since they can be as long as the program
+    while (ast != NULL) {
+        if (ast->type == atId) {
+            int index = FindDefinition(context, ast->s);
+            if (index >= 0)
+                ReachDefinition(context, index);
+        }
+
+        ReachNames(context, ast->child1);
+        ReachNames(context, ast->child3);
+        ast = ast->child2;
+    }
+}
+
+// Returns 1 if two arguments of the regimen have the same name, which is an error when it is defined
+int HasDuplicatedArgument (struct AstNode* definition) {
+    for (struct AstNode* args = definition->child2; args != NULL && args->type == atFuncDefArgsList; args = args->child2) {
+        for (struct AstNode* others = args->child2; others != NULL && others->type == atFuncDefArgsList; others = others->child2) {
+            if (!strcmp(args->child1->child1->s, others->child1->child1->s))
+                return 1;
+        }
+    }
+    return 0;
+}
+
+// Returns 1 if name is the one of an argument of the regimen
+int IsArgumentName (struct AstNode* definition, const char* name) {
+    for (struct AstNode* args = definition->child2; args != NULL && args->type == atFuncDefArgsList; args = args->child2) {
+        if (!strcmp(args->child1->child1->s, name))
+            return 1;
+    }
+    return 0;
+}
+
+// Returns the first atId of the tree naming neither an argument of the regimen nor a definition of the program, NULL if there is none
+struct AstNode* FindUndefinedName (struct DeadCodeContext* context, struct AstNode* definition, struct AstNode* ast) {
+    for (; ast != NULL; ast = ast->child2) {
+        if (ast->type == atId && FindDefinition(context, ast->s) < 0 && !IsArgumentName(definition, ast->s))
+            return ast;
+
+        struct AstNode* undefined = FindUndefinedName(context, definition, ast->child1);
+        if (undefined == NULL)
+            undefined = FindUndefinedName(context, definition, ast->child3);
+        if (undefined != NULL)
+            return undefined;
+    }
+    return NULL;
+}
+
+// Returns 1 if the definition must be kept even if nothing uses its name
+int IsAlwaysKept (struct DeadCodeContext* context, int index) {
+    struct AstNode* definition = context->definitions[index].definition;
+
+    if (definition->type == atFuncDef)
+        return HasDuplicatedArgument(definition);
+
+    return IsTeamType(definition->variableType) && definition->i <= 0;
+}
+
+void PrintRemovedDefinition (FILE* output, struct AstNode* definition) {
+    const char* kind = definition->type == atFuncDef ? "regimen" : IsTeamType(definition->variableType) ? "team" : "fighter";
+    fprintf(output, "    %s %s (line %d)\n", kind, definition->child1->s, definition->child1->lineNumInCode);
+}
+
+int RemoveDeadDefinitions (struct AstNode* ast, char** keptNames, int keptCount, FILE* output, FILE* errors) {
+    if (!deadCodeElimination || ast == NULL || ast->child1 == NULL)
+        return 0;
+
+    struct DeadCodeContext context;
+    context.definitionCount = 0;
+    for (struct AstNode* definitions = ast->child1; definitions != NULL; definitions = definitions->child2)
+        context.definitionCount++;
+
+    unsigned int slotCount = 16;
+    while (slotCount < 2 * (unsigned int)context.definitionCount)
+        slotCount *= 2;
+    context.slotMask = slotCount - 1;
+    context.pendingCount = 0;
+
+    context.definitions = UfcCalloc(context.definitionCount, sizeof(struct DeadCodeDefinition));
+    context.slots = UfcCalloc(slotCount, sizeof(int));
+    context.pending = UfcMalloc(sizeof(int) * context.definitionCount);
+    if (context.definitions == NULL || context.slots == NULL || context.pending == NULL) {
+        printf("Could not allocate memory for the definitions in RemoveDeadDefinitions\n");
+        UfcFree(context.definitions);
+        UfcFree(context.slots);
+        UfcFree(context.pending);
+        return 0;
+    }
+
+    /************** Finding the definitions kept whatever the program does **************/
+
+    int index = 0;
+    for (struct AstNode* definitions = ast->child1; definitions != NULL; definitions = definitions->child2, index++) {
+        context.definitions[index].definition = definitions->child1;
+
+        // A second definition of a name is either ignored or an error, depending on the first one, so they are all kept
+        if (!AddDefinitionName(&context, index)) {
+            ReachDefinition(&context, FindDefinition(&context, definitions->child1->child1->s));
+            ReachDefinition(&context, index);
+        }
+        else if (IsAlwaysKept(&context, index))
+            ReachDefinition(&context, index);
+    }
+
+    for (int k = 0; k < keptCount; k++) {
+        int kept = FindDefinition(&context, keptNames[k]);
+        if (kept >= 0)
+            ReachDefinition(&context, kept);
+    }
+
+    /************** Following the names from the main phase **************/
+
+    ReachNames(&context, ast->child2);
+
+    // A regimen the main phase can't reach is still checked : one naming an undefined fighter or regimen is reported and kept,
+    // like the other definitions giving an error. It is checked in pass 0 and its names are followed in pass 1
+    for (int pass = 0; pass < 2; pass++) {
+        while (context.pendingCount > 0) {
+            struct AstNode* definition = context.definitions[context.pending[--context.pendingCount]].definition;
+            // The arguments are not looked at : they hide the global fighters of the same name and are never global names
+            ReachNames(&context, definition->child3);
+        }
+
+        for (int k = 0; pass == 0 && k < context.definitionCount; k++) {
+            struct AstNode* definition = context.definitions[k].definition;
+            struct AstNode* undefined = context.definitions[k].reached || definition->type != atFuncDef ? NULL : FindUndefinedName(&context, definition, definition->child3);
+            if (undefined == NULL)
+                continue;
+
+            if (errors != NULL)
+                fprintf(errors, "Error at line %d : No defined symbol with the name %s in the training regimen %s, which the main phase never reaches\n",
+                    undefined->lineNumInCode, undefined->s, definition->child1->s);
+            ReachDefinition(&context, k);
+        }
+    }
+
+    /************** Removing the definitions that weren't reached **************/
+
+    int removedRegimens = 0;
+    int removedFighters = 0;
+    for (int k = 0; k < context.definitionCount; k++) {
+        if (!context.definitions[k].reached) {
+            if (context.definitions[k].definition->type == atFuncDef)
+                removedRegimens++;
+            else
+                removedFighters++;
+        }
+    }
+
+    if (deadCodeReport && output != NULL && removedRegimens + removedFighters > 0)
+        fprintf(output, "Dead code : %d training regimens and %d fighters removed\n", removedRegimens, removedFighters);
+
+    index = 0;
+    for (struct AstNode** link = &ast->child1; *link != NULL; index++) {
+        struct AstNode* definitions = *link;
+        if (context.definitions[index].reached) {
+            link = &definitions->child2;
+            continue;
+        }
+
+        if (deadCodeReport && output != NULL)
+            PrintRemovedDefinition(output, definitions->child1);
+
+        *link = definitions->child2;
+        definitions->child2 = NULL;
+        FreeAST(definitions);
+    }
+
+    UfcFree(context.definitions);
+    UfcFree(context.slots);
+    UfcFree(context.pending);
+
+    return removedRegimens + removedFighters;
+}
@@ -0,0 +1,22 @@
+#ifndef __DEAD_CODE_H__
+#define __DEAD_CODE_H__
+
+#include <stdio.h>
+
+#include "../Utils/AST.h"
+
+// Sets whether the definitions the main phase never reaches are removed (enabled by default),
+// and whether the removed ones are listed by RemoveDeadDefinitions
+void SetDeadCodeElimination(int enabled, int report);
+
+// Removes from the definitions phase of ast (the atRoot) the training regimens and the fighters that the main phase can't reach :
+// the main phase reaches the fighters and the regimens it names, and a regimen it reaches reaches the ones its body names.
+// The names in keptNames (the columns of a table) are reached too. A name defined more than once, a regimen with two arguments
+// of the same name and a team without fighters are always kept, since their definitions give an error or depend on their order.
+// A regimen the main phase can't reach but whose body names an undefined fighter or regimen is kept too, and the name is reported
+// in errors (if not NULL), so that removing the regimen doesn't hide the error
+// The removed definitions are listed in output if it was asked with SetDeadCodeElimination
+// Returns the number of removed definitions
+int RemoveDeadDefinitions (struct AstNode* ast, char** keptNames, int keptCount, FILE* output, FILE* errors);
+
+#endif
@@ -0,0 +1,362 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "Inliner.h"
+#include "../Utils/Allocator.h"
+
+static int inlineThreshold = DEFAULT_INLINE_THRESHOLD;
+
+void SetInlineThreshold(int threshold)
+{
+    inlineThreshold = threshold;
+}
+
+// A training regimen of the definitions phase
+struct InlineCandidate {
+    // atFuncDef node of the regimen
+    struct AstNode* definition;
+
+    // atFuncDefArg nodes of the arguments, in order, and the names of the global fighters replacing them
+    int argCount;
+    struct AstNode** args;
+    char** inlinedNames;
+
+    int hasReturn;
+    int inlinable;
+    int inlinedCalls;
+};
+
+int IsInlinedArgument (char* id) {
+    return !strncmp(id, INLINED_ARGUMENT_PREFIX, strlen(INLINED_ARGUMENT_PREFIX));
+}
+
+struct InlineContext {
+    struct AstNode* root;
+    struct InlineCandidate* candidates;
+    int candidateCount;
+
+    // Definition of the regimen whose body is being changed, NULL for the main phase
+    struct AstNode* caller;
+};
+
+int CountNodes (struct AstNode* ast) {
+    if (ast==NULL)
+        return 0;
+
+    return 1 + CountNodes(ast->child1) + CountNodes(ast->child2) + CountNodes(ast->child3);
+}
+
+// Returns 1 if id is the name of an argument of the regimen defined by definition
+int IsArgumentOf (struct AstNode* definition, char* id) {
+    for (struct AstNode* args = definition->child2; args!=NULL && args->type==atFuncDefArgsList; args = args->child2) {
+        if (!strcmp(args->child1->child1->s, id))
+            return 1;
+    }
+
+    return 0;
+}
+
+// Returns 1 if id is defined as a team in the definitions phase
+int IsTeamId (struct AstNode* root, char* id) {
+    for (struct AstNode* definitions = root->child1; definitions!=NULL; definitions = definitions->child2) {
+        struct AstNode* definition = definitions->child1;
+        if (definition->type==atVariableDef && IsTeamType(definition->variableType) && !strcmp(definition->child1->s, id))
+            return 1;
+    }
+
+    return 0;
+}
+
+struct InlineCandidate* FindCandidate (struct InlineContext* context, char* id) {
+    for (int k = 0; k < context->candidateCount; k++) {
+        if (!strcmp(context->candidates[k].definition->child1->s, id))
+            return &context->candidates[k];
+    }
+
+    return NULL;
+}
+
+// Returns 1 if the regimen target can be called from this part of a body, directly or through other regimens
+// visited marks the regimens already looked at
+int CanReach (struct InlineContext* context, struct AstNode* ast, struct InlineCandidate* target, int* visited) {
+    if (ast==NULL)
+        return 0;
+
+    if (ast->type==atFuncCall) {
+        struct InlineCandidate* callee = FindCandidate(context, ast->child1->s);
+        if (callee==target)
+            return 1;
+
+        if (callee!=NULL && !visited[callee - context->candidates]) {
+            visited[callee - context->candidates] = 1;
+            if (CanReach(context, callee->definition->child3, target, visited))
+                return 1;
+        }
+    }
+
+    return CanReach(context, ast->child1, target, visited) || CanReach(context, ast->child2, target, visited) || CanReach(context, ast->child3, target, visited);
+}
+
+// Returns 1 if a fighter read by the body of the candidate (other than its arguments) is hidden by an argument of the caller
+// In the caller the local arguments are looked at before the global fighters, so the inlined body would use the wrong fighter
+int IsShadowed (struct AstNode* ast, struct InlineCandidate* candidate, struct AstNode* caller) {
+    if (ast==NULL)
+        return 0;
+
+    // The name of a called regimen is always looked for in the global symbol table
+    if (ast->type==atFuncCall)
+        return IsShadowed(ast->child2, candidate, caller);
+
+    if (ast->type==atId && !IsArgumentOf(candidate->definition, ast->s) && IsArgumentOf(caller, ast->s))
+        return 1;
+
+    return IsShadowed(ast->child1, candidate, caller) || IsShadowed(ast->child2, candidate, caller) || IsShadowed(ast->child3, candidate, caller);
+}
+
+// Gives to the arguments of the candidate in a copy of its body the names of the global fighters replacing them
+void RenameArguments (struct AstNode* ast, struct InlineCandidate* candidate) {
+    if (ast==NULL)
+        return;
+
+    if (ast->type==atFuncCall) {
+        RenameArguments(ast->child2, candidate);
+        return;
+    }
+
+    if (ast->type==atId) {
+        for (int k = 0; k < candidate->argCount; k++) {
+            if (!strcmp(ast->s, candidate->args[k]->child1->s)) {
+                UfcFree(ast->s);
+                if ((ast->s = UfcStrdup(candidate->inlinedNames[k])) == NULL) {
+                    printf("Memory error : cannot allocate memory to rename an argument in RenameArguments\n");
+                    exit(1);
+                }
+                break;
+            }
+        }
+    }
+
+    RenameArguments(ast->child1, candidate);
+    RenameArguments(ast->child2, candidate);
+    RenameArguments(ast->child3, candidate);
+}
+
+struct AstNode* CreateIdNode (char* id, const int lineNum) {
+    struct AstNode* idNode = CreateBasicNode(atId, NULL, NULL, NULL, lineNum);
+    if ((idNode->s = UfcStrdup(id)) == NULL) {
+        printf("Memory error : cannot allocate memory for the id of a node in CreateIdNode\n");
+        exit(1);
+    }
+
+    return idNode;
+}
+
+// Adds the statement at the end of the list whose last child2 is *tail
+void AppendStatement (struct AstNode*** tail, struct AstNode* statement) {
+    **tail = CreateBasicNode(atStatementList, statement, NULL, NULL, statement->lineNumInCode);
+    *tail = &(**tail)->child2;
+}
+
+struct AstNode* InlineCalls (struct InlineContext* context, struct AstNode* ast);
+
+// Builds the statements replacing the call, or returns NULL if the called regimen can't be inlined there
+// target is the fighter receiving the returned value (atId), atVoid or NULL if the value is not used
+struct AstNode* ExpandCall (struct InlineContext* context, struct AstNode* target, struct AstNode* call) {
+    struct InlineCandidate* candidate = FindCandidate(context, call->child1->s);
+    if (candidate==NULL || !candidate->inlinable)
+        return NULL;
+
+    // A call that doesn't use the returned value (or uses a value that is never returned) is an error, kept for the interpreter to report
+    int usesResult = target!=NULL && target->type==atId;
+    if (usesResult != candidate->hasReturn || (usesResult && IsTeamId(context->root, target->s)))
+        return NULL;
+
+    int argCount = 0;
+    for (struct AstNode* arg = call->child2; arg!=NULL && arg->type==atFuncCallArgList; arg = arg->child2)
+        argCount++;
+
+    if (argCount != candidate->argCount
+        || (context->caller!=NULL && IsShadowed(candidate->definition->child3, candidate, context->caller)))
+        return NULL;
+
+    struct AstNode* statements = NULL;
+    struct AstNode** tail = &statements;
+
+    // The values of the call are assigned to the arguments one after the other, like in atFuncCallArgList
+    int k = 0;
+    for (struct AstNode* arg = call->child2; arg!=NULL && arg->type==atFuncCallArgList; arg = arg->child2, k++)
+        AppendStatement(&tail, CreateBasicNode(atAssignment, CreateIdNode(candidate->inlinedNames[k], call->lineNumInCode), CopyAST(arg->child1), NULL, call->lineNumInCode));
+
+    // The body is copied up to its return (the return can only be a line of the body itself, never in a loop or a condition)
+    for (struct AstNode* line = candidate->definition->child3; line!=NULL; line = line->child2) {
+        struct AstNode* statement = CopyAST(line->child1->type==atReturn ? line->child1->child1 : line->child1);
+        RenameArguments(statement, candidate);
+
+        if (line->child1->type==atReturn) {
+            AppendStatement(&tail, CreateBasicNode(atAssignment, CopyAST(target), statement, NULL, call->lineNumInCode));
+            break;
+        }
+
+        AppendStatement(&tail, statement);
+    }
+
+    candidate->inlinedCalls++;
+
+    // The copied body can call other small regimens too
+    return InlineCalls(context, statements);
+}
+
+// Returns the node replacing ast once the calls it contains are inlined
+struct AstNode* InlineCalls (struct InlineContext* context, struct AstNode* ast) {
+    if (ast==NULL)
+        return NULL;
+
+    if (ast->type==atFuncCall || (ast->type==atAssignment && ast->child2->type==atFuncCall)) {
+        struct AstNode* inlined = ast->type==atFuncCall ? ExpandCall(context, NULL, ast) : ExpandCall(context, ast->child1, ast->child2);
+        if (inlined==NULL)
+            return ast;
+
+        FreeAST(ast);
+        return inlined;
+    }
+
+    ast->child1 = InlineCalls(context, ast->child1);
+    ast->child2 = InlineCalls(context, ast->child2);
+    ast->child3 = InlineCalls(context, ast->child3);
+
+    return ast;
+}
+
+void FreeCandidates (struct InlineCandidate* candidates, int candidateCount) {
+    for (int k = 0; k < candidateCount; k++) {
+        for (int a = 0; a < candidates[k].argCount; a++)
+            UfcFree(candidates[k].inlinedNames[a]);
+
+        UfcFree(candidates[k].args);
+        UfcFree(candidates[k].inlinedNames);
+    }
+
+    UfcFree(candidates);
+}
+
+// Fills the candidate for the regimen defined by definition
+// Returns 0 if there was an error, 1 otherwise
+int SetUpCandidate (struct InlineCandidate* candidate, struct AstNode* definition) {
+    candidate->definition = definition;
+    candidate->argCount = 0;
+    candidate->hasReturn = ContainsNodeType(definition->child3, atReturn);
+    candidate->inlinable = CountNodes(definition->child3) <= inlineThreshold;
+    candidate->inlinedCalls = 0;
+
+    for (struct AstNode* args = definition->child2; args!=NULL && args->type==atFuncDefArgsList; args = args->child2)
+        candidate->argCount++;
+
+    // One more element so that the allocations are never empty
+    candidate->args = UfcMalloc(sizeof(struct AstNode*) * (candidate->argCount + 1));
+    candidate->inlinedNames = UfcCalloc(candidate->argCount + 1, sizeof(char*));
+    if (candidate->args==NULL || candidate->inlinedNames==NULL) {
+        printf("Could not allocate memory for the arguments of the candidate in SetUpCandidate\n");
+        candidate->argCount = 0;
+        return 0;
+    }
+
+    int k = 0;
+    for (struct AstNode* args = definition->child2; args!=NULL && args->type==atFuncDefArgsList; args = args->child2, k++) {
+        struct AstNode* arg = args->child1;
+        candidate->args[k] = arg;
+
+        // The strings would need a starting value for their global fighter
+        if (arg->variableType!=integer && arg->variableType!=floating)
+            candidate->inlinable = 0;
+
+        size_t length = strlen(INLINED_ARGUMENT_PREFIX) + strlen(definition->child1->s) + 1 + strlen(arg->child1->s) + 1;
+        if ((candidate->inlinedNames[k] = UfcMalloc(length)) == NULL) {
+            printf("Could not allocate memory for the name of the argument in SetUpCandidate\n");
+            return 0;
+        }
+        snprintf(candidate->inlinedNames[k], length, INLINED_ARGUMENT_PREFIX "%s$%s", definition->child1->s, arg->child1->s);
+    }
+
+    return 1;
+}
+
+int InlineFunctions (struct AstNode* ast) {
+    if (inlineThreshold <= 0 || ast==NULL || ast->type!=atRoot)
+        return 0;
+
+    struct InlineContext context;
+    context.root = ast;
+    context.caller = NULL;
+    context.candidateCount = 0;
+
+    for (struct AstNode* definitions = ast->child1; definitions!=NULL; definitions = definitions->child2) {
+        if (definitions->child1->type==atFuncDef)
+            context.candidateCount++;
+    }
+
+    if (context.candidateCount==0)
+        return 0;
+
+    context.candidates = UfcCalloc(context.candidateCount, sizeof(struct InlineCandidate));
+    int* visited = UfcMalloc(sizeof(int) * context.candidateCount);
+    if (context.candidates==NULL || visited==NULL) {
+        printf("Could not allocate memory for the candidates in InlineFunctions\n");
+        UfcFree(context.candidates);
+        UfcFree(visited);
+        return 0;
+    }
+
+    int k = 0;
+    for (struct AstNode* definitions = ast->child1; definitions!=NULL; definitions = definitions->child2) {
+        if (definitions->child1->type==atFuncDef && !SetUpCandidate(&context.candidates[k++], definitions->child1)) {
+            FreeCandidates(context.candidates, k);
+            UfcFree(visited);
+            return 0;
+        }
+    }
+
+    // A regimen that can call itself would be copied forever
+    for (k = 0; k < context.candidateCount; k++) {
+        memset(visited, 0, sizeof(int) * context.candidateCount);
+        if (CanReach(&context, context.candidates[k].definition->child3, &context.candidates[k], visited))
+            context.candidates[k].inlinable = 0;
+    }
+    UfcFree(visited);
+
+    // The '$' keeps the names of the arguments of two regimens apart, but two definitions of the same regimen would share them
+    for (k = 0; k < context.candidateCount; k++) {
+        for (int other = 0; other < k; other++) {
+            if (!strcmp(context.candidates[k].definition->child1->s, context.candidates[other].definition->child1->s))
+                context.candidates[k].inlinable = context.candidates[other].inlinable = 0;
+        }
+    }
+
+    // Inline in the bodies of the regimens, then in the main phase
+    for (k = 0; k < context.candidateCount; k++) {
+        context.caller = context.candidates[k].definition;
+        context.caller->child3 = InlineCalls(&context, context.caller->child3);
+    }
+    context.caller = NULL;
+    ast->child2 = InlineCalls(&context, ast->child2);
+
+    // Define the global fighters replacing the arguments of the inlined regimens, before the rest of the definitions
+    int inlinedCalls = 0;
+    for (k = 0; k < context.candidateCount; k++) {
+        struct InlineCandidate* candidate = &context.candidates[k];
+        inlinedCalls += candidate->inlinedCalls;
+
+        if (candidate->inlinedCalls==0)
+            continue;
+
+        for (int a = 0; a < candidate->argCount; a++) {
+            struct AstNode* argDefinition = CreateBasicNode(atVariableDef, CreateIdNode(candidate->inlinedNames[a], candidate->definition->lineNumInCode), NULL, NULL, candidate->definition->lineNumInCode);
+            argDefinition->variableType = candidate->args[a]->variableType;
+
+            ast->child1 = CreateBasicNode(atStatementList, argDefinition, ast->child1, NULL, candidate->definition->lineNumInCode);
+        }
+    }
+
+    FreeCandidates(context.candidates, context.candidateCount);
+
+    return inlinedCalls;
+}
@@ -0,0 +1,29 @@
+#ifndef __INLINER_H__
+#define __INLINER_H__
+
+#include "../Utils/AST.h"
+
+// Largest body (in number of AST nodes) of the training regimens inlined by default
+#define DEFAULT_INLINE_THRESHOLD 40
+
+// Start of the names of the global fighters replacing the arguments of the inlined regimens. The scanners only put letters, digits
+// and '_' in the names of the code, so a name with a '$' can't be one of them (the C compilers and the assembler accept it)
+#define INLINED_ARGUMENT_PREFIX "inline$"
+
+// Sets the largest body (in number of AST nodes) of the training regimens that are inlined, 0 disables the inlining
+void SetInlineThreshold(int threshold);
+
+// Number of nodes of the tree, used as the size of a training regimen
+int CountNodes (struct AstNode* ast);
+
+// Replaces the calls of the small training regimens by their body, in the main phase and in the bodies of the other regimens (ast is the atRoot)
+// The arguments of an inlined regimen become global fighters named INLINED_ARGUMENT_PREFIX<regimen>$<argument>, defined at the start of the definitions phase
+// Only the regimens that can't call themselves (directly or not) and only take integers and floatings are inlined
+// Returns the number of inlined calls
+int InlineFunctions (struct AstNode* ast);
+
+// Returns 1 if id is the name of a global fighter replacing an argument of an inlined regimen
+// Such a fighter is always assigned before being read by the inlined body, so it is never shared between two calls
+int IsInlinedArgument (char* id);
+
+#endif
@@ -0,0 +1,14 @@
+#include "Optimizer.h"
+#include "DeadCode.h"
+#include "Inliner.h"
+#include "Peephole.h"
+
+void OptimizeProgram (struct AstNode* ast, char** keptNames, int keptCount, FILE* output) {
+    RemoveDeadDefinitions(ast, keptNames, keptCount, output, output);
+
+    InlineFunctions(ast);
+    RewriteSelfUpdates(ast);
+
+    // The regimens whose calls were all inlined are not reached anymore. The undefined names were already reported
+    RemoveDeadDefinitions(ast, keptNames, keptCount, output, NULL);
+}
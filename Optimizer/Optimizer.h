@@ -0,0 +1,14 @@
+#ifndef __OPTIMIZER_H__
+#define __OPTIMIZER_H__
+
+#include <stdio.h>
+
+#include "../Utils/AST.h"
+
+// Runs the passes of the optimizer on ast (the atRoot), for both the translation and the interpretation :
+// removes the definitions the main phase can't reach, so that they are neither inlined nor run, replaces the calls of the small
+// training regimens by their body and the self updates by in place updates, then removes the regimens whose calls were all inlined.
+// keptNames and output are the ones of RemoveDeadDefinitions, the undefined names of the unreached regimens being reported in output too
+void OptimizeProgram (struct AstNode* ast, char** keptNames, int keptCount, FILE* output);
+
+#endif
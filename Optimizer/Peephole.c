@@ -0,0 +1,83 @@
+#include <string.h>
+
+#include "Peephole.h"
+
+// Type of the fighter named id : an argument of the regimen defined by function (NULL for the main phase), or else a fighter of the definitions
+// Returns noType if it is not defined
+enum VariableType FindDefinedType (struct AstNode* root, struct AstNode* function, char* id) {
+    if (function!=NULL) {
+        for (struct AstNode* args = function->child2; args!=NULL && args->type==atFuncDefArgsList; args = args->child2) {
+            if (!strcmp(args->child1->child1->s, id))
+                return args->child1->variableType;
+        }
+    }
+
+    for (struct AstNode* definitions = root->child1; definitions!=NULL; definitions = definitions->child2) {
+        struct AstNode* definition = definitions->child1;
+        if (definition->type==atVariableDef && !strcmp(definition->child1->s, id))
+            return definition->variableType;
+    }
+
+    return noType;
+}
+
+int IsSameId (struct AstNode* ast, char* id) {
+    return ast->type==atId && !strcmp(ast->s, id);
+}
+
+// Rewrites the self updates in this part of the main phase or of the body of function
+int RewriteStatements (struct AstNode* ast, struct AstNode* root, struct AstNode* function) {
+    if (ast==NULL)
+        return 0;
+
+    if (ast->type!=atAssignment)
+        return RewriteStatements(ast->child1, root, function)
+            + RewriteStatements(ast->child2, root, function)
+            + RewriteStatements(ast->child3, root, function);
+
+    struct AstNode* target = ast->child1;
+    struct AstNode* operation = ast->child2;
+    if (target->type!=atId || (operation->type!=atAdd && operation->type!=atMinus && operation->type!=atMultiply))
+        return 0;
+
+    enum VariableType type = FindDefinedType(root, function, target->s);
+    if (type!=integer && type!=floating)
+        return 0;
+
+    // x op k, or k op x when op doesn't depend on the order (for numbers, + and * give the same result both ways)
+    struct AstNode* operand;
+    if (IsSameId(operation->child1, target->s)) {
+        operand = operation->child2;
+        operation->child2 = NULL;
+    }
+    else if (operation->type!=atMinus && IsSameId(operation->child2, target->s)) {
+        operand = operation->child1;
+        operation->child1 = NULL;
+    }
+    else
+        return 0;
+
+    ast->type = operation->type==atAdd ? atAddAssign : (operation->type==atMinus ? atMinusAssign : atMultiplyAssign);
+    ast->child2 = operand;
+
+    // Frees the operation with the second copy of the id of the fighter
+    FreeAST(operation);
+
+    return 1;
+}
+
+int RewriteSelfUpdates (struct AstNode* ast) {
+    if (ast==NULL || ast->type!=atRoot)
+        return 0;
+
+    int rewritten = 0;
+
+    for (struct AstNode* definitions = ast->child1; definitions!=NULL; definitions = definitions->child2) {
+        if (definitions->child1->type==atFuncDef)
+            rewritten += RewriteStatements(definitions->child1->child3, ast, definitions->child1);
+    }
+
+    rewritten += RewriteStatements(ast->child2, ast, NULL);
+
+    return rewritten;
+}
@@ -0,0 +1,16 @@
+#ifndef __PEEPHOLE_H__
+#define __PEEPHOLE_H__
+
+#include "../Utils/AST.h"
+
+// Type of the fighter named id : an argument of the regimen defined by function (NULL for the main phase), or else a fighter of the definitions
+// Returns noType if it is not defined
+enum VariableType FindDefinedType (struct AstNode* root, struct AstNode* function, char* id);
+
+// Replaces the assignments updating a fighter with itself (x joins k and hits x, x tosses away k and hits x, x deals with k and hits x)
+// by in place update nodes (atAddAssign, atMinusAssign, atMultiplyAssign) whose child1 is the fighter and child2 the other member
+// Only the smart and famous fighters (integers and floatings) are rewritten, so that k joins x can be rewritten too
+// Returns the number of rewritten assignments
+int RewriteSelfUpdates (struct AstNode* ast);
+
+#endif
@@ -0,0 +1,116 @@
+#include "Purity.h"
+#include "Inliner.h"
+
+// Returns 1 if the id is one of the arguments of the function, or of a regimen inlined in its body
+int IsArgument (char* id, struct VariableStruct* function) {
+    return (function->argumentsTable!=NULL && TryFind_Hashtable(function->argumentsTable, id, NULL)) || IsInlinedArgument(id);
+}
+
+// Returns 1 if the part of the body of the function in ast has no side effect and only depends on the arguments
+int IsBodyPure (struct AstNode* ast, struct VariableStruct* function, struct HashStruct* globalSymbolTable) {
+    if (ast==NULL)
+        return 1;
+
+    switch (ast->type)
+    {
+        case atPrint:
+        case atPrintEndl:
+        case atPrintTeam:
+        case atRead: // Each call reads another value of the input
+            return 0;
+        case atId: // Any other symbol is a global fighter, which can be changed between two calls
+            return IsArgument(ast->s, function);
+        case atBreak: // Ends the loop of the caller, which a call taken from the cache would not do
+        case atContinue:
+            return 0;
+        case atTeamSize: // The size of a team never changes
+            return 1;
+        case atTeamElement: // The teams are always global fighters
+        case atTeamSum:
+            return 0;
+        case atAssignment:
+            // A fighter of a team or a global fighter would be changed by the call
+            if (ast->child1->type!=atVoid && (ast->child1->type!=atId || !IsArgument(ast->child1->s, function)))
+                return 0;
+
+            return IsBodyPure(ast->child2, function, globalSymbolTable);
+        case atFuncCall:
+        {
+            struct VariableStruct* callee;
+            if (!TryFind_Hashtable(globalSymbolTable, ast->child1->s, &callee) || callee->functionBody==NULL || !callee->isPure)
+                return 0;
+
+            // The id of the function is not an argument, only look at the values given to it
+            return IsBodyPure(ast->child2, function, globalSymbolTable);
+        }
+        default:
+            return IsBodyPure(ast->child1, function, globalSymbolTable)
+                && IsBodyPure(ast->child2, function, globalSymbolTable)
+                && IsBodyPure(ast->child3, function, globalSymbolTable);
+    }
+}
+
+int CanMemoize (struct VariableStruct* function) {
+    // A function without return gives no value that could be cached
+    if (!function->isPure || (function->type!=integer && function->type!=floating) || !ContainsNodeType(function->functionBody, atReturn))
+        return 0;
+
+    int argCount = 0;
+    for (struct ArgList* arg = function->argumentsList; arg!=NULL; arg = arg->next) {
+        struct VariableStruct* argStruct;
+        if (!TryFind_Hashtable(function->argumentsTable, arg->id, &argStruct)
+            || (argStruct->type!=integer && argStruct->type!=floating))
+            return 0;
+
+        argCount++;
+    }
+
+    return argCount <= MEMO_MAX_ARGS;
+}
+
+int MarkPureFunctions (struct HashStruct* globalSymbolTable, int memoize) {
+    if (globalSymbolTable==NULL) {
+        printf("Error : need a global symbol table (MarkPureFunctions)\n");
+        return 0;
+    }
+
+    // Every function starts impure, and becomes pure once all the functions it calls are pure
+    // A recursive function waits for itself and so stays impure
+    int changed = 1;
+    while (changed) {
+        changed = 0;
+
+        for (unsigned int k = 0; k < globalSymbolTable->size; k++) {
+            for (struct VariableStruct* function = globalSymbolTable->table[k]; function!=NULL; function = function->nextInHash) {
+                if (function->functionBody==NULL || function->isPure)
+                    continue;
+
+                if (IsBodyPure(function->functionBody, function, globalSymbolTable)) {
+                    function->isPure = 1;
+                    changed = 1;
+                }
+            }
+        }
+    }
+
+    if (!memoize)
+        return 1;
+
+    for (unsigned int k = 0; k < globalSymbolTable->size; k++) {
+        for (struct VariableStruct* function = globalSymbolTable->table[k]; function!=NULL; function = function->nextInHash) {
+            if (function->functionBody==NULL || function->memoCache!=NULL || !CanMemoize(function))
+                continue;
+
+            int argCount = 0;
+            for (struct ArgList* arg = function->argumentsList; arg!=NULL; arg = arg->next)
+                argCount++;
+
+            if (!CreateMemoCache(&function->memoCache, argCount)) {
+                printf("Error while creating the cache of the function %s\n", function->id);
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
@@ -0,0 +1,18 @@
+#ifndef __PURITY_H__
+#define __PURITY_H__
+
+#include "../Utils/AST.h"
+#include "../Utils/Hash.h"
+
+// Sets isPure on every training regimen (function) of the global symbol table
+// A function is pure if its body only reads and assigns its own arguments, prints nothing, and only calls pure functions
+// A recursive function is never pure : its arguments are shared by all its calls, so a call can change the arguments of the call that made it
+// If memoize, a MemoCache is also given to the pure functions whose calls can be cached (see CanMemoize)
+// Returns 0 if there was an error, 1 otherwise
+int MarkPureFunctions (struct HashStruct* globalSymbolTable, int memoize);
+
+// Returns 1 if the calls of the pure function can be cached :
+// it has a return giving an integer or a floating, with at most MEMO_MAX_ARGS arguments that are all integers or floatings
+int CanMemoize (struct VariableStruct* function);
+
+#endif
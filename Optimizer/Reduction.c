@@ -0,0 +1,348 @@
+#include <string.h>
+#include <limits.h>
+
+#include "Reduction.h"
+#include "../Utils/Allocator.h"
+
+// Ids met in the body of the loop, in the order they were found
+struct IdSet {
+    char** ids;
+    int count;
+    int capacity;
+};
+
+struct ReductionContext {
+    struct HashStruct* globalSymbolTable;
+    char* counter;
+
+    // Fighters assigned, and updated in place, somewhere in the body (first pass)
+    struct IdSet assigned;
+    struct IdSet updated;
+    // Fighters already given a value in the round (second pass)
+    struct IdSet defined;
+
+    int counterUpdates;
+    int counterStep;
+
+    struct IdSet accumulators;
+    enum ReductionOperation* operations;
+    // 1 once the kind of updates of the accumulator of the same index is known
+    int* operationKnown;
+};
+
+int FindId (struct IdSet* set, char* id) {
+    for (int k = 0; k < set->count; k++) {
+        if (!strcmp(set->ids[k], id))
+            return k;
+    }
+    return -1;
+}
+
+int AddId (struct IdSet* set, char* id) {
+    if (FindId(set, id) >= 0)
+        return 1;
+
+    if (set->count == set->capacity) {
+        int capacity = set->capacity > 0 ? set->capacity * 2 : 8;
+        char** ids = UfcRealloc(set->ids, sizeof(char*) * capacity);
+        if (ids == NULL)
+            return 0;
+        set->ids = ids;
+        set->capacity = capacity;
+    }
+
+    set->ids[set->count++] = id;
+    return 1;
+}
+
+// Fills assigned and updated with the fighters the statements give a value to
+// Returns 0 if one of the statements can't be part of a reduction
+int CollectWrites (struct ReductionContext* context, struct AstNode* ast) {
+    if (ast == NULL)
+        return 1;
+
+    switch (ast->type) {
+        case atStatementList:
+            return CollectWrites(context, ast->child1) && CollectWrites(context, ast->child2);
+        case atAssignment: // A fighter of a team, or the value of a call given to nobody, is not a fighter of the round
+            return ast->child1->type == atId && AddId(&context->assigned, ast->child1->s);
+        case atAddAssign:
+        case atMinusAssign:
+        case atMultiplyAssign:
+            return AddId(&context->updated, ast->child1->s);
+        case atFuncCall:
+            return 1;
+        default: // Prints, reads, loops, tournaments, break and continue depend on the order of the rounds
+            return 0;
+    }
+}
+
+int IsWritten (struct ReductionContext* context, char* id) {
+    return FindId(&context->assigned, id) >= 0 || FindId(&context->updated, id) >= 0;
+}
+
+int CheckReads (struct ReductionContext* context, struct AstNode* ast);
+
+// Returns 1 if the call is the call of a pure regimen whose arguments can be read
+int CheckCall (struct ReductionContext* context, struct AstNode* call) {
+    struct VariableStruct* callee;
+    if (!TryFind_Hashtable(context->globalSymbolTable, call->child1->s, &callee) || callee->functionBody == NULL || !callee->isPure)
+        return 0;
+
+    for (struct AstNode* arg = call->child2; arg != NULL && arg->type == atFuncCallArgList; arg = arg->child2) {
+        if (!CheckReads(context, arg->child1))
+            return 0;
+    }
+    return 1;
+}
+
+// Returns 1 if the value of the expression only depends on the counter, on fighters the body never changes
+// and on fighters already given a value in the round
+int CheckReads (struct ReductionContext* context, struct AstNode* ast) {
+    if (ast == NULL)
+        return 1;
+
+    switch (ast->type) {
+        case atConstant:
+        case atVoid:
+            return 1;
+        case atId:
+            if (!strcmp(ast->s, context->counter))
+                return 1;
+            // The value of an accumulator in the middle of the loop depends on the rounds run before
+            if (FindId(&context->accumulators, ast->s) >= 0)
+                return 0;
+            return !IsWritten(context, ast->s) || FindId(&context->defined, ast->s) >= 0;
+        case atFuncCall:
+            return CheckCall(context, ast);
+        case atAdd:
+        case atMinus:
+        case atMultiply:
+        case atDivide:
+        case atTeamElement: // The teams can't be changed by the body
+        case atTeamSize:
+        case atTeamSum:
+        case atTeamDot:
+            return CheckReads(context, ast->child1) && CheckReads(context, ast->child2) && CheckReads(context, ast->child3);
+        default:
+            return 0;
+    }
+}
+
+// Goes through the statements in the order of a round, checking that no value comes from the round before
+int CheckRound (struct ReductionContext* context, struct AstNode* ast) {
+    if (ast == NULL)
+        return 1;
+
+    switch (ast->type) {
+        case atStatementList:
+            return CheckRound(context, ast->child1) && CheckRound(context, ast->child2);
+        case atAssignment:
+            if (!strcmp(ast->child1->s, context->counter) || !CheckReads(context, ast->child2))
+                return 0;
+            return AddId(&context->defined, ast->child1->s);
+        case atAddAssign:
+        case atMinusAssign:
+        case atMultiplyAssign:
+        {
+            char* id = ast->child1->s;
+
+            if (!strcmp(id, context->counter)) {
+                if (ast->type == atMultiplyAssign || ast->child2->type != atConstant || ast->child2->variableType != integer || ast->child2->i == 0)
+                    return 0;
+
+                context->counterUpdates++;
+                context->counterStep = ast->type == atAddAssign ? ast->child2->i : -ast->child2->i;
+                return 1;
+            }
+
+            int accumulator = FindId(&context->accumulators, id);
+            if (accumulator < 0) // Update of a fighter assigned before in the round
+                return FindId(&context->defined, id) >= 0 && CheckReads(context, ast->child2);
+
+            enum ReductionOperation operation = ast->type == atMultiplyAssign ? reductionProduct : reductionSum;
+            if (context->operationKnown[accumulator] && context->operations[accumulator] != operation)
+                return 0;
+
+            context->operations[accumulator] = operation;
+            context->operationKnown[accumulator] = 1;
+            return CheckReads(context, ast->child2);
+        }
+        case atFuncCall:
+            return CheckCall(context, ast);
+        default:
+            return 0;
+    }
+}
+
+// Value of the condition of the loop, like atWhileCompare for two famous fighters
+int CompareCounter (enum ComparatorType comparator, long long left, long long right) {
+    switch (comparator) {
+        case gtr:
+            return left >= right;
+        case str_gtr:
+            return left > right;
+        case neq:
+            return left != right;
+        case eq:
+            return left == right;
+        default:
+            return 0;
+    }
+}
+
+// Counts the rounds of the loop from the current values of the counter and of its bound
+// Returns 0 if the counter would go out of the famous values before the loop ends
+int CountRounds (struct AstNode* condition, int counterOnLeft, int counterValue, int boundValue, int step, int* outRounds) {
+    long long value = counterValue;
+    int rounds = 0;
+
+    while (counterOnLeft ? CompareCounter(condition->comparator, value, boundValue) : CompareCounter(condition->comparator, boundValue, value)) {
+        value += step;
+        if (rounds == INT_MAX || value < INT_MIN || value > INT_MAX)
+            return 0;
+        rounds++;
+    }
+
+    *outRounds = rounds;
+    return 1;
+}
+
+// Returns the statements run by a round of the loop, or NULL if they can't be looked at
+struct AstNode* GetRoundBody (struct AstNode* loop, struct HashStruct* globalSymbolTable) {
+    struct AstNode* body = loop->child2;
+    if (body->type != atFuncCall)
+        return body;
+
+    // A regimen without arguments works on the global fighters, like the lines of the main phase
+    struct VariableStruct* callee;
+    if (body->child2->type != atVoid || !TryFind_Hashtable(globalSymbolTable, body->child1->s, &callee)
+        || callee->functionBody == NULL || callee->argumentsList != NULL || ContainsNodeType(callee->functionBody, atReturn))
+        return NULL;
+
+    return callee->functionBody;
+}
+
+// Returns 1 if the fighter named id is a smart or famous fighter (or only a famous one if onlyInteger)
+int IsNumberFighter (struct HashStruct* globalSymbolTable, char* id, int onlyInteger, struct VariableStruct** outFighter) {
+    struct VariableStruct* fighter;
+    if (!TryFind_Hashtable(globalSymbolTable, id, &fighter) || fighter->functionBody != NULL
+        || (fighter->type != integer && (onlyInteger || fighter->type != floating)))
+        return 0;
+
+    if (outFighter != NULL)
+        *outFighter = fighter;
+    return 1;
+}
+
+int AnalyseReductionLoop (struct ReductionContext* context, struct AstNode* loop, struct ReductionLoop* outReduction) {
+    struct AstNode* body = GetRoundBody(loop, context->globalSymbolTable);
+    if (body == NULL || !CollectWrites(context, body))
+        return 0;
+
+    // The counter is the fighter of the condition updated in place by the body, the other side is its bound
+    struct AstNode* condition = loop->child1;
+    int counterOnLeft = condition->child1->type == atId && FindId(&context->updated, condition->child1->s) >= 0;
+    int counterOnRight = condition->child2->type == atId && FindId(&context->updated, condition->child2->s) >= 0;
+    if (counterOnLeft == counterOnRight)
+        return 0;
+
+    struct AstNode* counterNode = counterOnLeft ? condition->child1 : condition->child2;
+    struct AstNode* boundNode = counterOnLeft ? condition->child2 : condition->child1;
+    context->counter = counterNode->s;
+
+    struct VariableStruct* counter;
+    if (FindId(&context->assigned, context->counter) >= 0 || !IsNumberFighter(context->globalSymbolTable, context->counter, 1, &counter))
+        return 0;
+
+    int boundValue;
+    if (boundNode->type == atConstant && boundNode->variableType == integer)
+        boundValue = boundNode->i;
+    else {
+        struct VariableStruct* bound;
+        if (boundNode->type != atId || IsWritten(context, boundNode->s) || !IsNumberFighter(context->globalSymbolTable, boundNode->s, 1, &bound))
+            return 0;
+        boundValue = bound->i;
+    }
+
+    // The accumulators are the fighters only updated in place : each round starts from the value the round before left
+    for (int k = 0; k < context->updated.count; k++) {
+        char* id = context->updated.ids[k];
+        if (strcmp(id, context->counter) && FindId(&context->assigned, id) < 0 && !AddId(&context->accumulators, id))
+            return 0;
+    }
+    if (context->accumulators.count == 0)
+        return 0;
+
+    // Only the smart and famous fighters are copied for each thread and put back together. The accumulators must be famous :
+    // the rounding of the additions of smart fighters depends on their order, which the parts change
+    for (int k = 0; k < context->assigned.count; k++) {
+        if (!IsNumberFighter(context->globalSymbolTable, context->assigned.ids[k], 0, NULL))
+            return 0;
+    }
+    for (int k = 0; k < context->updated.count; k++) {
+        if (!IsNumberFighter(context->globalSymbolTable, context->updated.ids[k], 1, NULL))
+            return 0;
+    }
+
+    context->operations = UfcCalloc(context->accumulators.count, sizeof(enum ReductionOperation));
+    context->operationKnown = UfcCalloc(context->accumulators.count, sizeof(int));
+    if (context->operations == NULL || context->operationKnown == NULL)
+        return 0;
+
+    if (!CheckRound(context, body) || context->counterUpdates != 1)
+        return 0;
+
+    int roundCount;
+    if (!CountRounds(condition, counterOnLeft, counter->i, boundValue, context->counterStep, &roundCount))
+        return 0;
+
+    // The written fighters are the assigned ones followed by the updated ones
+    struct IdSet written = context->assigned;
+    context->assigned = (struct IdSet) { NULL, 0, 0 };
+    for (int k = 0; k < context->updated.count; k++) {
+        if (!AddId(&written, context->updated.ids[k])) {
+            UfcFree(written.ids);
+            return 0;
+        }
+    }
+
+    outReduction->counter = context->counter;
+    outReduction->counterStep = context->counterStep;
+    outReduction->roundCount = roundCount;
+    outReduction->accumulators = context->accumulators.ids;
+    outReduction->operations = context->operations;
+    outReduction->accumulatorCount = context->accumulators.count;
+    outReduction->written = written.ids;
+    outReduction->writtenCount = written.count;
+
+    context->accumulators.ids = NULL;
+    context->operations = NULL;
+    return 1;
+}
+
+int FindReductionLoop (struct AstNode* loop, struct HashStruct* globalSymbolTable, struct ReductionLoop* outReduction) {
+    if (loop == NULL || loop->type != atWhileLoop || globalSymbolTable == NULL || outReduction == NULL)
+        return 0;
+
+    struct ReductionContext context;
+    memset(&context, 0, sizeof(context));
+    context.globalSymbolTable = globalSymbolTable;
+
+    int found = AnalyseReductionLoop(&context, loop, outReduction);
+
+    UfcFree(context.assigned.ids);
+    UfcFree(context.updated.ids);
+    UfcFree(context.defined.ids);
+    UfcFree(context.accumulators.ids);
+    UfcFree(context.operations);
+    UfcFree(context.operationKnown);
+
+    return found;
+}
+
+void FreeReductionLoop (struct ReductionLoop* reduction) {
+    UfcFree(reduction->accumulators);
+    UfcFree(reduction->operations);
+    UfcFree(reduction->written);
+}
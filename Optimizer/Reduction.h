@@ -0,0 +1,46 @@
+#ifndef __REDUCTION_H__
+#define __REDUCTION_H__
+
+#include "../Utils/AST.h"
+#include "../Utils/Hash.h"
+
+// Dependence analysis of the loops whose rounds only differ by a counter and that accumulate a result, so that their rounds
+// can be run in any order and on several threads (see ParallelReduction.h). Such a loop :
+//  - compares a famous counter with a famous constant, or a famous fighter its body never changes
+//  - has a body (the line of the loop, or the body of the regimen without arguments it calls) made of a list of :
+//      - exactly one update of the counter by a constant (counter joins k and hits counter, counter tosses away k and hits counter)
+//      - in place updates of famous accumulators (acc joins x and hits acc, acc tosses away x, acc deals with x), an accumulator being
+//        never assigned nor read anywhere else in the body, and all its updates being sums or all being products. A smart accumulator
+//        is never taken : adding its parts in another order changes its value
+//      - assignments of smart or famous fighters, and calls of pure regimens (see Purity.h)
+//  - only reads, besides the counter, fighters that its body never changes or that were given a value earlier in the same round
+// Its rounds then only share the counter, which is known for each of them, and the accumulators, which can be summed
+// (or multiplied) by parts and put together afterwards
+
+enum ReductionOperation {
+    reductionSum, reductionProduct
+};
+
+struct ReductionLoop {
+    char* counter;
+    int counterStep;
+    // Number of rounds the loop will run, from the current values of the counter and of its bound
+    int roundCount;
+
+    // Ids of the accumulators, and whether they are summed or multiplied
+    char** accumulators;
+    enum ReductionOperation* operations;
+    int accumulatorCount;
+
+    // Ids of all the fighters given a value by the body (the counter and the accumulators included)
+    char** written;
+    int writtenCount;
+};
+
+// Returns 1 and fills outReduction if the loop (atWhileLoop of the main phase) is a reduction that can be run by parts, 0 otherwise
+// The ids point to the AST, and the arrays must be freed with FreeReductionLoop
+int FindReductionLoop (struct AstNode* loop, struct HashStruct* globalSymbolTable, struct ReductionLoop* outReduction);
+
+void FreeReductionLoop (struct ReductionLoop* reduction);
+
+#endif
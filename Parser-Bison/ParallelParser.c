@@ -0,0 +1,262 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "ParallelParser.h"
+#include "UF-C.tab.h"
+#include "../Utils/WorkerPool.h"
+#include "../Utils/FileReader.h"
+
+// Number of threads parsing a program, 0 for one per processor
+static int parseThreadCount = 0;
+
+struct ParsePart {
+    size_t start, length;
+    int firstLine;
+
+    struct AstNode* ast;
+    int error;
+
+    // Parse errors of the part
+    char* messages;
+    size_t messagesSize;
+};
+
+struct ParallelParse {
+    const char* source;
+    struct ParsePart* parts;
+    int partCount;
+};
+
+void SetParseThreadCount(int threadCount) {
+    parseThreadCount = threadCount;
+}
+
+int GetParseThreadCount() {
+    return parseThreadCount;
+}
+
+static int IsIdCharacter (char c) {
+    return isalnum((unsigned char) c) || c == '_';
+}
+
+int FindParseCuts (const char* source, size_t length, struct ParseCut** outCuts) {
+    static const char endOfRegimen[] = "raining is over"; // After the T or t
+
+    int capacity = 64, count = 0;
+    struct ParseCut* cuts = malloc(sizeof(struct ParseCut) * capacity);
+    if (cuts == NULL)
+        return -1;
+
+    int line = 1;
+    int inComment = 0, inString = 0;
+    // Set by the end of a regimen, the cut is made at the end of its line
+    int regimenEnded = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        char c = source[i];
+
+        if (c == '\n')
+            line++;
+
+        if (inComment) {
+            if (c == '*' && i + 1 < length && source[i + 1] == '/') {
+                inComment = 0;
+                i++;
+            }
+        }
+        else if (inString) {
+            if (c == '"')
+                inString = 0;
+        }
+        else if (c == '/' && i + 1 < length && source[i + 1] == '*') {
+            inComment = 1;
+            i++;
+        }
+        else if (c == '"')
+            inString = 1;
+        else if (c == '\n' && regimenEnded) {
+            if (count == capacity) {
+                capacity *= 2;
+                struct ParseCut* newCuts = realloc(cuts, sizeof(struct ParseCut) * capacity);
+                if (newCuts == NULL) {
+                    free(cuts);
+                    return -1;
+                }
+                cuts = newCuts;
+            }
+
+            cuts[count].offset = i + 1;
+            cuts[count].line = line;
+            count++;
+            regimenEnded = 0;
+        }
+        // Inside an identifier, the scanner would read the whole identifier instead
+        else if ((c == 'T' || c == 't') && (i == 0 || !IsIdCharacter(source[i - 1]))
+                && length - i > strlen(endOfRegimen) && !strncmp(source + i + 1, endOfRegimen, strlen(endOfRegimen))) {
+            regimenEnded = 1;
+            i += strlen(endOfRegimen);
+        }
+    }
+
+    *outCuts = cuts;
+    return count;
+}
+
+// Groups the source in partCount parts of about the same size, cut at the given cuts
+// Returns the number of parts written in parts
+static int SplitSource (size_t length, struct ParseCut* cuts, int cutCount, struct ParsePart* parts, int partCount) {
+    int count = 0;
+    size_t start = 0;
+    int firstLine = 1;
+
+    for (int i = 0; i < cutCount && count < partCount - 1; i++) {
+        // The part ends at the first cut after its share of the source
+        if (cuts[i].offset < (count + 1) * (length / partCount))
+            continue;
+
+        parts[count] = (struct ParsePart) { .start = start, .length = cuts[i].offset - start, .firstLine = firstLine };
+        count++;
+
+        start = cuts[i].offset;
+        firstLine = cuts[i].line;
+    }
+
+    parts[count] = (struct ParsePart) { .start = start, .length = length - start, .firstLine = firstLine };
+    return count + 1;
+}
+
+static void ParsePartTask (int taskIndex, int workerIndex, void* userData) {
+    struct ParallelParse* parse = (struct ParallelParse*) userData;
+    struct ParsePart* part = &parse->parts[taskIndex];
+
+    FILE* messages = open_memstream(&part->messages, &part->messagesSize);
+    FILE* input = fmemopen((void*) (parse->source + part->start), part->length, "r");
+    if (messages == NULL || input == NULL) {
+        printf("Cannot read the part of the program starting at line %d\n", part->firstLine);
+        part->error = 1;
+    }
+    else
+        part->error = ParseFileFromLine(input, messages, part->firstLine, &part->ast);
+
+    if (input != NULL)
+        fclose(input);
+    if (messages != NULL)
+        fclose(messages);
+}
+
+// Puts the definitions of all the parts in the atRoot of the last one, which has the main phase
+static struct AstNode* JoinParts (struct ParsePart* parts, int partCount) {
+    struct AstNode* root = parts[partCount - 1].ast;
+    struct AstNode* definitions = root->child1;
+
+    for (int i = partCount - 2; i >= 0; i--) {
+        struct AstNode* partRoot = parts[i].ast;
+        struct AstNode* partDefinitions = partRoot->child1;
+        partRoot->child1 = NULL;
+
+        if (partDefinitions != NULL) {
+            struct AstNode* last = partDefinitions;
+            while (last->child2 != NULL)
+                last = last->child2;
+            last->child2 = definitions;
+            definitions = partDefinitions;
+        }
+
+        // Only its main phase is left, which the cuts make empty
+        FreeAST(partRoot);
+        parts[i].ast = NULL;
+    }
+
+    root->child1 = definitions;
+    return root;
+}
+
+// Parses the source in one piece
+static int ParseSource (char* source, size_t length, FILE* messages, struct AstNode** outAst) {
+    FILE* input = fmemopen(source, length, "r");
+    if (input == NULL) {
+        printf("Cannot read the program\n");
+        return 1;
+    }
+
+    int error = ParseFile(input, messages, outAst);
+    fclose(input);
+
+    return error;
+}
+
+int ParseFileInParallel(FILE* input, FILE* messages, struct AstNode** outAst) {
+    *outAst = NULL;
+
+    int threadCount = parseThreadCount > 0 ? parseThreadCount : GetProcessorCount();
+    if (threadCount <= 1)
+        return ParseFile(input, messages, outAst);
+
+    size_t length;
+    char* source = ReadWholeFile(input, &length);
+    if (source == NULL) {
+        printf("Unable to allocate memory for the program\n");
+        return 1;
+    }
+    // fmemopen can't open an empty buffer, the input is at its end so it is parsed as the empty program
+    if (length == 0) {
+        free(source);
+        return ParseFile(input, messages, outAst);
+    }
+
+    struct ParseCut* cuts = NULL;
+    int cutCount = length < PARALLEL_PARSE_MIN_SIZE ? 0 : FindParseCuts(source, length, &cuts);
+
+    // The last part must keep a regimen, the definitions phase can't be empty before the competition begins
+    cutCount--;
+    if (cutCount <= 0) {
+        free(cuts);
+        int error = ParseSource(source, length, messages, outAst);
+        free(source);
+        return error;
+    }
+
+    int partCount = threadCount * PARSE_PARTS_PER_THREAD;
+    if (partCount > cutCount + 1)
+        partCount = cutCount + 1;
+
+    struct ParsePart* parts = malloc(sizeof(struct ParsePart) * partCount);
+    if (parts == NULL) {
+        printf("Unable to allocate memory for the parts of the program\n");
+        free(cuts);
+        free(source);
+        return 1;
+    }
+    partCount = SplitSource(length, cuts, cutCount, parts, partCount);
+    free(cuts);
+
+    struct ParallelParse parse = { .source = source, .parts = parts, .partCount = partCount };
+    int error = 0;
+    if (!RunOnWorkerPool(partCount, threadCount, ParsePartTask, &parse)) {
+        printf("Cannot start the threads parsing the program\n");
+        error = 1;
+    }
+
+    // The errors of the first part that has some are the ones ParseFile would have found
+    for (int i = 0; i < partCount && !error; i++) {
+        if (parts[i].error != 0) {
+            fwrite(parts[i].messages, 1, parts[i].messagesSize, messages != NULL ? messages : stdout);
+            error = parts[i].error;
+        }
+    }
+
+    if (!error)
+        *outAst = JoinParts(parts, partCount);
+
+    for (int i = 0; i < partCount; i++) {
+        if (error)
+            FreeAST(parts[i].ast);
+        free(parts[i].messages);
+    }
+    free(parts);
+    free(source);
+
+    return error;
+}
@@ -0,0 +1,36 @@
+#ifndef __PARALLEL_PARSER_H__
+#define __PARALLEL_PARSER_H__
+
+#include <stdio.h>
+#include "../Utils/AST.h"
+
+// A big program is cut after the end of its training regimens ("training is over"), where nothing of a definition is left open,
+// and the parts are parsed on several threads, each one from the line where it starts so that the line numbers of the nodes
+// and of the parse errors stay the ones of the file. The definitions of the parts are then put back in a single list, in order,
+// and the main phase is the one of the last part.
+
+// Inputs smaller than this (in bytes) are parsed on a single thread, the threads would cost more than they save
+#define PARALLEL_PARSE_MIN_SIZE (64 * 1024)
+
+// Number of parts given to each thread, so that a thread that gets the short regimens can take the parts left by the others
+#define PARSE_PARTS_PER_THREAD 4
+
+// Place where the program can be cut : the start of the line after the end of a training regimen
+struct ParseCut {
+    size_t offset;
+    int line;
+};
+
+// Finds where the source can be cut, skipping the comments and the strings like the scanner does
+// Returns the number of cuts written in *outCuts (to free), or -1 if there is not enough memory
+int FindParseCuts (const char* source, size_t length, struct ParseCut** outCuts);
+
+// Sets the number of threads parsing a program (0 means one per processor, the default, and 1 parses it in one piece like ParseFile)
+void SetParseThreadCount(int threadCount);
+int GetParseThreadCount();
+
+// Same as ParseFile, parsing the input on the threads given by SetParseThreadCount
+// If several parts have parse errors, only the ones of the first part are written to messages (stdout if NULL), as ParseFile would stop there
+int ParseFileInParallel(FILE* input, FILE* messages, struct AstNode** outAst);
+
+#endif
@@ -1,30 +1,107 @@
 %code requires {
+  #include <stdio.h>
   #include "../Utils/AST.h"
+
+  // Scanner of flex, one per parsing so that several inputs can be parsed at the same time
+  #ifndef YY_TYPEDEF_YY_SCANNER_T
+  #define YY_TYPEDEF_YY_SCANNER_T
+  typedef void* yyscan_t;
+  #endif
+}
+
+%code provides {
+  // Parses the whole input into an AST stored in *outAst
+  // Parse errors are written to messages (stdout if NULL)
+  // Returns 0 if the parsing succeeded, like yyparse
+  int ParseFile(FILE* input, FILE* messages, struct AstNode** outAst);
+
+  // Same as ParseFile, for an input starting at the line firstLine of a file (used to parse a file in several parts)
+  int ParseFileFromLine(FILE* input, FILE* messages, int firstLine, struct AstNode** outAst);
+
+  // Parses a part of a program typed in the REPL : some definitions, or some lines of the main phase
+  // Returns 0 if it was parsed, 1 if there was a parse error,
+  // and PARSE_INCOMPLETE (without writing any message) if the input is right so far but ends in the middle of a statement,
+  // like a training regimen or a tournament that is not over yet
+  #define PARSE_INCOMPLETE -1
+  int ParseChunk(FILE* input, FILE* messages, struct AstNode** outAst);
+
+  // Handlers of ParseStream, which own the nodes they are given
+  // The definitions handler gets the atRoot with the definitions (child1, can be NULL) as soon as the definitions phase is over
+  // The statement handler then gets each line of the main phase, in an atStatementList of one element, as soon as it is parsed
+  typedef void (*StreamDefinitionsHandler)(struct AstNode* root, void* userData);
+  typedef void (*StreamStatementHandler)(struct AstNode* statement, void* userData);
+
+  // Parses the input like ParseFile, but gives the main phase to the handlers one line at a time instead of building its AST,
+  // so that each line can be run before the next ones are read, and the memory used doesn't grow with the length of the main phase
+  // *outRoot is the atRoot given to the definitions handler (NULL if the parsing stopped before), to free once the handlers are done with it
+  // Returns 0 if the whole input was parsed, a non zero value otherwise (the lines parsed before the error were given to the handler)
+  int ParseStream(FILE* input, FILE* messages, StreamDefinitionsHandler definitionsHandler, StreamStatementHandler statementHandler, void* userData, struct AstNode** outRoot);
+
+  // State of a parsing, shared by the parser and its scanner (yyextra)
+  // Each parsing has its own, so the inputs can be parsed by several threads at the same time
+  struct ParserState {
+    // Position of the current token
+    int lineNumber;
+    int charPosInLine, currentTokenLength, previousTokenLength;
+    // Length of the last string constant read
+    int stringLength;
+    // Set by the scanner once it has given the end of the input
+    int inputEnded;
+
+    // Where the parse errors are written (stdout if NULL)
+    FILE* messages;
+
+    // Set by ParseChunk, an error on the end of the input then only means that the input is not over
+    int parsingChunk;
+    int chunkIncomplete;
+
+    // Set by ParseStream, the lines of the main phase are then given to the handlers instead of being put in a list
+    StreamDefinitionsHandler streamDefinitionsHandler;
+    StreamStatementHandler streamStatementHandler;
+    void* streamUserData;
+    struct AstNode* streamRoot;
+
+    // Last elements of the lists of the definitions and of the lines of the main phase, to add the next one without going through the list
+    struct AstNode* lastDefinition;
+    struct AstNode* lastMainLine;
+  };
 }
 
 // For debugging
 %define parse.trace
 
+// The parser keeps no global state : the scanner, and the state of the parsing it holds, are given to every call
+%define api.pure full
+%lex-param {yyscan_t scanner}
+
 %code {
-  #include <stdio.h>
   #include <stdlib.h>
+  #include "../Utils/Allocator.h"
 
-  #define CreateBasicNode(t, c1, c2, c3) CreateBasicNode(t, c1, c2, c3, line_num)
-  #define CreateWhileNode(comp, v1, v2, b) CreateWhileNode(comp, v1, v2, b, line_num)
+  // State of the parsing, in the actions of the grammar
+  #define PARSER_STATE yyget_extra(scanner)
 
-  extern int line_num;
-  extern int stringLength;
-  extern int char_pos_in_line, current_token_length, previous_token_length;
-  extern char* yytext; // Text of the current token
+  #define CreateBasicNode(t, c1, c2, c3) CreateBasicNode(t, c1, c2, c3, PARSER_STATE->lineNumber)
+  #define CreateWhileNode(comp, v1, v2, b) CreateWhileNode(comp, v1, v2, b, PARSER_STATE->lineNumber)
 
   // stuff from flex that bison needs to know about:
-  extern int yylex();
- 
-  void yyerror(struct AstNode** errorAstPtr, const char *s);
+  extern int yylex(YYSTYPE* yylval_param, yyscan_t scanner);
+  extern struct ParserState* yyget_extra(yyscan_t scanner);
+  extern char* yyget_text(yyscan_t scanner); // Text of the current token
+  extern int CreateLexer(FILE* input, struct ParserState* state, yyscan_t* outScanner);
+  extern void DestroyLexer(yyscan_t scanner);
+  extern void SetLexerInteractive(yyscan_t scanner, int interactive);
+
+  void yyerror(yyscan_t scanner, struct AstNode** errorAstPtr, const char *s);
+
+  struct AstNode* StartMainPhase(struct ParserState* state, struct AstNode* definitions);
+  struct AstNode* AddDefinition(struct ParserState* state, struct AstNode* definitions, struct AstNode* definition);
+  struct AstNode* AddMainLine(struct ParserState* state, struct AstNode* mainLines, struct AstNode* line);
+  struct AstNode* EndProgram(struct ParserState* state, struct AstNode* definitions, struct AstNode* mainLines);
 }
 
 //defines a pointer that will be required when calling the parser, allowing the caller to access the AST
-%parse-param {struct AstNode** ast}
+%parse-param {yyscan_t scanner} {struct AstNode** ast}
 
 %union {
   int ival;
@@ -43,10 +120,11 @@
 
 %token ASSIGN ASSIGN_FUNC AND
 %token IQ FANS ANNOUNCES
-%token PRINT PRINT_INT PRINT_FLOAT PRINT_STRING
+%token TEAM TEAM_INT TEAM_FLOAT TEAM_ELEMENT TEAM_OF TEAM_SIZE TEAM_SUM
+%token PRINT PRINT_INT PRINT_FLOAT PRINT_STRING PRINT_TEAM
 %token PRINT_ENDL
 
-%left ADD MINUS MULTIPLY DIVIDE
+%left ADD MINUS MULTIPLY DIVIDE TEAM_DOT
 
 %token TEST_GTR TEST_STR_GTR
 %token COLON HYPHEN COMMA
@@ -57,7 +135,7 @@
 %token BEGIN_ARGS FUNC_DEF_BEGIN_ARGS FUNC_DEF_END_ARGS END_FUNC RETURN
 %token FLOAT_FUNC_ARG INT_FUNC_ARG STRING_FUNC_ARG
 %token TYPE_FLOAT TYPE_INT TYPE_STRING TYPE_VOID
-%token BREAK CONTINUE
+%token BREAK CONTINUE READ
 
 %token BEGIN_RETURN_VAR
 
@@ -73,12 +151,19 @@
 %type<varTypeVal> funcReturnType
 %type<comparatorVal> comparator
 %type<nodeVal> start
-%type<nodeVal> definitions body_line body_lines
+%type<nodeVal> definitions definition body_line body_lines main_lines
 %type<nodeVal> varDef function_def function_body
 %type<nodeVal> while_loop func_call print return assignment assignmentOrFuncCall
+%type<nodeVal> teamElement teamValue
 %type<nodeVal> id idOrVoid constant exp void nonVoidArg nonVoidFuncCallArgs funcCallArgs nonVoidFuncDefArg nonVoidFuncDefArgs funcDefArgs
 %type<nodeVal> test test_comparisons_declarations test_comparison_declaration disjunctive_normal_form_comparisons andComparisons comparisonId test_if_branch test_elseIf_branch test_elseIf_branchs test_else_branch test_branchs
 
+// Frees what was parsed when a parse error throws it away (an input of the REPL that is not over is parsed again with the next line)
+// With ParseStream, the definitions and the program belong to the handlers once the main phase has started
+%destructor { FreeAST($$); } <nodeVal>
+%destructor { if (PARSER_STATE->streamRoot == NULL) FreeAST($$); } definitions start
+%destructor { UfcFree($$); } <sval>
+
 
 %%
 
@@ -88,17 +173,26 @@ UF-C:
   | start { *ast = $1; }
   ;
 start:
-    definitions DEFINITIONS_END endls body_lines { $$ = CreateBasicNode(atRoot, $1, $4, NULL); }
-  | definitions { $$ = CreateBasicNode(atRoot, $1, NULL, NULL); }
-  | body_lines { $$ = CreateBasicNode(atRoot, NULL, $1, NULL); }
-  | { $$ = CreateBasicNode(atRoot, NULL, NULL, NULL); }
+    definitions DEFINITIONS_END { StartMainPhase(PARSER_STATE, $1); } endls main_lines { $$ = EndProgram(PARSER_STATE, $1, $5); }
+  | definitions { $$ = EndProgram(PARSER_STATE, $1, NULL); }
+  | main_lines { $$ = EndProgram(PARSER_STATE, NULL, $1); }
+  | { $$ = EndProgram(PARSER_STATE, NULL, NULL); }
   ;
 
+// Left recursive, so that each line is reduced as soon as it is parsed and can be given to the handler of ParseStream
+main_lines:
+  main_lines body_line { $$ = AddMainLine(PARSER_STATE, $1, $2); }
+  | body_line { $$ = AddMainLine(PARSER_STATE, NULL, $1); }
+  ;
+
+// Left recursive too, so that the stack of the parser doesn't grow with the number of definitions
 definitions:
-  varDef endls definitions { $$ = CreateBasicNode(atStatementList, $1, $3, NULL); }
-  | function_def endls definitions { $$ = CreateBasicNode(atStatementList, $1, $3, NULL); }
-  | varDef endls { $$ = CreateBasicNode(atStatementList, $1, NULL, NULL); }
-  | function_def endls { $$ = CreateBasicNode(atStatementList, $1, NULL, NULL); }
+  definitions definition endls { $$ = AddDefinition(PARSER_STATE, $1, $2); }
+  | definition endls { $$ = AddDefinition(PARSER_STATE, NULL, $1); }
+  ;
+definition:
+  varDef { $$ = $1; }
+  | function_def { $$ = $1; }
   ;
 varDef:
   id FANS INT
@@ -121,11 +215,27 @@ varDef:
     {
       struct AstNode *stringDefNode = CreateBasicNode(atVariableDef, $1, NULL, NULL); 
       stringDefNode->variableType = characters;
-      stringDefNode->stringLength = stringLength;
+      stringDefNode->stringLength = PARSER_STATE->stringLength;
       stringDefNode->s = $3;
 
       $$ = stringDefNode;
     }
+  | id TEAM INT TEAM_INT
+    {
+      struct AstNode *teamDefNode = CreateBasicNode(atVariableDef, $1, NULL, NULL); 
+      teamDefNode->variableType = integerTeam;
+      teamDefNode->i = $3; // Number of fighters in the team
+
+      $$ = teamDefNode;
+    }
+  | id TEAM INT TEAM_FLOAT
+    {
+      struct AstNode *teamDefNode = CreateBasicNode(atVariableDef, $1, NULL, NULL); 
+      teamDefNode->variableType = floatingTeam;
+      teamDefNode->i = $3;
+
+      $$ = teamDefNode;
+    }
   ;
 function_def:
   id FUNC_DEF_BEGIN_ARGS funcDefArgs FUNC_DEF_END_ARGS funcReturnType COLON endls function_body
@@ -189,8 +299,10 @@ body_line:
   | func_call endls { $$ = $1; }
   | while_loop endls { $$ = $1; }
   | print endls { $$ = $1; }
-  | BREAK endls { $$ = CreateBasicNode(atBreak, NULL, NULL, NULL); }
-  | CONTINUE endls { $$ = CreateBasicNode(atContinue, NULL, NULL, NULL); }
+  // These statements can end the main phase with an error, given at their line and not at the one after the line breaks
+  | BREAK { $<ival>$ = PARSER_STATE->lineNumber; } endls { $$ = CreateBasicNode(atBreak, NULL, NULL, NULL); if ($$ != NULL) $$->lineNumInCode = $<ival>2; }
+  | CONTINUE { $<ival>$ = PARSER_STATE->lineNumber; } endls { $$ = CreateBasicNode(atContinue, NULL, NULL, NULL); if ($$ != NULL) $$->lineNumInCode = $<ival>2; }
+  | READ id { $<ival>$ = PARSER_STATE->lineNumber; } endls { $$ = CreateBasicNode(atRead, $2, NULL, NULL); if ($$ != NULL) $$->lineNumInCode = $<ival>3; }
   | return endls { $$ = $1; }
   | PRINT_ENDL endls { $$ = CreateBasicNode(atPrintEndl, NULL, NULL, NULL); }
   ;
@@ -202,12 +314,15 @@ assignment:
       struct AstNode *funcCallNode = CreateBasicNode(atFuncCall, $1, $5, NULL);
       $$ = CreateBasicNode(atAssignment, $3, funcCallNode, NULL); 
     }
+  | exp and ASSIGN teamElement { $$ = CreateBasicNode(atAssignment, $4, $1, NULL); }
+  | nonVoidArg ASSIGN teamElement { $$ = CreateBasicNode(atAssignment, $3, $1, NULL); }
   ;
 exp:
   exp ADD exp { $$ = CreateBasicNode(atAdd, $1, $3, NULL); }
   | exp MINUS exp { $$ = CreateBasicNode(atMinus, $1, $3, NULL); }
   | exp MULTIPLY exp { $$ = CreateBasicNode(atMultiply, $1, $3, NULL); }
   | exp DIVIDE exp { $$ = CreateBasicNode(atDivide, $1, $3, NULL); }
+  | exp TEAM_DOT exp { $$ = CreateBasicNode(atTeamDot, $1, $3, NULL); }
   | nonVoidArg { $$ = $1; }
   ;
 
@@ -299,6 +414,7 @@ while_loop:
       struct AstNode* zeroConstNode = CreateBasicNode(atConstant,NULL, NULL, NULL);
       zeroConstNode->variableType = integer;
       zeroConstNode->i = 0;
+      FreeAST($1); // Only there to read like the other loops
       $$ = CreateWhileNode(neq, $3, zeroConstNode, $7); 
     }
   | nonVoidArg WHILE nonVoidArg LOOP_GTR endls LOOP_BEGIN_ACTION assignmentOrFuncCall 
@@ -338,6 +454,7 @@ print:
 
       $$ = printNode;
     }
+  | PRINT PRINT_TEAM id { $$ = CreateBasicNode(atPrintTeam, $3, NULL, NULL); }
   ;
 return:
   nonVoidArg RETURN { $$ = CreateBasicNode(atReturn, $1, NULL, NULL); }
@@ -358,6 +475,15 @@ nonVoidFuncCallArgs:
 nonVoidArg:
   id { $$ = $1; }
   | constant { $$ = $1; }
+  | teamValue { $$ = $1; }
+  ;
+teamValue:
+  teamElement { $$ = $1; }
+  | TEAM_SIZE id { $$ = CreateBasicNode(atTeamSize, $2, NULL, NULL); }
+  | TEAM_SUM id { $$ = CreateBasicNode(atTeamSum, $2, NULL, NULL); }
+  ;
+teamElement:
+  TEAM_ELEMENT nonVoidArg TEAM_OF id { $$ = CreateBasicNode(atTeamElement, $4, $2, NULL); }
   ;
 constant:
   INT
@@ -418,12 +544,142 @@ and:
 %%
 
 
-void yyerror(struct AstNode** errorAstPtr, const char *s) {
+void yyerror(yyscan_t scanner, struct AstNode** errorAstPtr, const char *s) {
+  struct ParserState* state = yyget_extra(scanner);
+  if (state->parsingChunk && state->inputEnded) {
+    state->chunkIncomplete = 1;
+    return;
+  }
+
   // Bison always reads one token ahead so we need to substract the last 2 tokens length to find the position of the problematic token
-  int tokenPos = char_pos_in_line - previous_token_length - current_token_length;
-  printf("Parse error on line %d:%d (%s) : %s\n", line_num, tokenPos, yytext, s);
-  // might as well halt now:
-  if (errorAstPtr!=NULL)
-    FreeAST(*errorAstPtr);
-  exit(1);
-}
\ No newline at end of file
+  int tokenPos = state->charPosInLine - state->previousTokenLength - state->currentTokenLength;
+  fprintf(state->messages!=NULL ? state->messages : stdout, "Parse error on line %d:%d (%s) : %s\n", state->lineNumber, tokenPos, yyget_text(scanner), s);
+  // *errorAstPtr is only assigned once the whole input is parsed so there is nothing to free here
+  // yyparse stops right after and returns a non zero value to the caller
+}
+
+// The functions below are given the state of the parsing, instead of the scanner used by the actions of the grammar
+#undef CreateBasicNode
+
+// Gives the definitions to the handler of ParseStream, before the first line of the main phase
+// Returns the atRoot of the program, or NULL outside of ParseStream
+struct AstNode* StartMainPhase(struct ParserState* state, struct AstNode* definitions) {
+  if (state->streamStatementHandler == NULL)
+    return NULL;
+
+  if (state->streamRoot == NULL) {
+    state->streamRoot = CreateBasicNode(atRoot, definitions, NULL, NULL, state->lineNumber);
+    state->streamDefinitionsHandler(state->streamRoot, state->streamUserData);
+  }
+
+  return state->streamRoot;
+}
+
+// Adds a definition at the end of the list of the definitions (definitions is NULL for the first one)
+// Returns the first element of the list
+struct AstNode* AddDefinition(struct ParserState* state, struct AstNode* definitions, struct AstNode* definition) {
+  // On the line of the definition, the scanner is already past the empty lines after it, which depend on where the program was cut
+  struct AstNode* definitionNode = CreateBasicNode(atStatementList, definition, NULL, NULL, definition->lineNumInCode);
+
+  if (definitions == NULL)
+    definitions = definitionNode;
+  else
+    state->lastDefinition->child2 = definitionNode;
+  state->lastDefinition = definitionNode;
+
+  return definitions;
+}
+
+// Adds a line at the end of the main phase (mainLines is NULL for the first one), or gives it to the handler of ParseStream
+// Returns the first element of the list of the lines, NULL with ParseStream
+struct AstNode* AddMainLine(struct ParserState* state, struct AstNode* mainLines, struct AstNode* line) {
+  struct AstNode* lineNode = CreateBasicNode(atStatementList, line, NULL, NULL, state->lineNumber);
+
+  if (state->streamStatementHandler != NULL) {
+    StartMainPhase(state, NULL); // A program without definitions phase
+    state->streamStatementHandler(lineNode, state->streamUserData);
+    return NULL;
+  }
+
+  if (mainLines == NULL)
+    mainLines = lineNode;
+  else
+    state->lastMainLine->child2 = lineNode;
+  state->lastMainLine = lineNode;
+
+  return mainLines;
+}
+
+// Returns the atRoot of the parsed program
+struct AstNode* EndProgram(struct ParserState* state, struct AstNode* definitions, struct AstNode* mainLines) {
+  if (state->streamStatementHandler != NULL)
+    return StartMainPhase(state, definitions); // Only the definitions, or nothing, were written
+
+  return CreateBasicNode(atRoot, definitions, mainLines, NULL, state->lineNumber);
+}
+
+// Parses the input with a new scanner, from the state given by the caller
+int ParseWithState(FILE* input, struct ParserState* state, int interactive, struct AstNode** outAst) {
+  *outAst = NULL;
+
+  yyscan_t scanner;
+  if (!CreateLexer(input, state, &scanner)) {
+    fprintf(state->messages!=NULL ? state->messages : stdout, "Cannot create the scanner\n");
+    return 1;
+  }
+  if (interactive)
+    SetLexerInteractive(scanner, 1);
+
+  int error = yyparse(scanner, outAst);
+
+  DestroyLexer(scanner);
+
+  return error;
+}
+
+// Gives a state to start a parsing at the line firstLine
+void InitParserState(struct ParserState* state, FILE* messages, int firstLine) {
+  *state = (struct ParserState) { 0 };
+  state->lineNumber = firstLine;
+  state->charPosInLine = 1;
+  state->messages = messages;
+}
+
+int ParseFile(FILE* input, FILE* messages, struct AstNode** outAst) {
+  return ParseFileFromLine(input, messages, 1, outAst);
+}
+
+int ParseFileFromLine(FILE* input, FILE* messages, int firstLine, struct AstNode** outAst) {
+  struct ParserState state;
+  InitParserState(&state, messages, firstLine);
+
+  return ParseWithState(input, &state, 0, outAst);
+}
+
+int ParseChunk(FILE* input, FILE* messages, struct AstNode** outAst) {
+  struct ParserState state;
+  InitParserState(&state, messages, 1);
+  state.parsingChunk = 1;
+
+  int error = ParseWithState(input, &state, 0, outAst);
+  if (error != 0 && state.chunkIncomplete)
+    error = PARSE_INCOMPLETE;
+
+  return error;
+}
+
+int ParseStream(FILE* input, FILE* messages, StreamDefinitionsHandler definitionsHandler, StreamStatementHandler statementHandler, void* userData, struct AstNode** outRoot) {
+  struct ParserState state;
+  InitParserState(&state, messages, 1);
+  state.streamDefinitionsHandler = definitionsHandler;
+  state.streamStatementHandler = statementHandler;
+  state.streamUserData = userData;
+
+  // The atRoot returned by the grammar is state.streamRoot
+  // A line coming from a pipe is read as soon as it arrives, instead of waiting for a whole block of the input
+  struct AstNode* ast = NULL;
+  int error = ParseWithState(input, &state, 1, &ast);
+  *outRoot = state.streamRoot;
+
+  return error;
+}
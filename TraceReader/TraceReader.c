@@ -0,0 +1,549 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../Interpreter/Trace.h"
+#include "../Utils/AST.h"
+
+// Reads the trace written by UF-C --trace (see Trace.h) :
+//   UF-C-trace summary TRACE [N] : the N (10 by default) lines running the most nodes, regimens called the most and paths of calls costing the most
+//   UF-C-trace replay TRACE : every event, indented by the depth of the calls
+//   UF-C-trace history TRACE NAME : every value given to the fighter NAME, with the line and the regimen giving it
+// The cost of a regimen or a path is counted in events recorded while it runs, which grow like the time it takes.
+
+#define DEFAULT_TOP_COUNT 10
+
+// Events are read from the file by blocks
+#define READ_BLOCK_EVENTS 4096
+
+// Deepest calls followed, the deeper ones are counted in the last one
+#define MAX_CALL_DEPTH 4096
+
+struct TraceReader {
+    FILE* file;
+
+    struct TraceEvent block[READ_BLOCK_EVENTS];
+    size_t blockLength, blockPosition;
+
+    char** names;
+    uint32_t nameCount, nameCapacity;
+
+    unsigned long eventCount;
+};
+
+// Returns the next event of the file, or NULL at its end
+struct TraceEvent* NextRawEvent (struct TraceReader* reader) {
+    if (reader->blockPosition == reader->blockLength) {
+        reader->blockLength = fread(reader->block, sizeof(struct TraceEvent), READ_BLOCK_EVENTS, reader->file);
+        reader->blockPosition = 0;
+        if (reader->blockLength == 0)
+            return NULL;
+    }
+
+    return &reader->block[reader->blockPosition++];
+}
+
+// Reads the characters following an event in text (of size length + 1)
+// Returns 0 if the file ended before them
+int ReadCharacters (struct TraceReader* reader, size_t length, char* text) {
+    size_t count = (length + sizeof(struct TraceEvent) - 1) / sizeof(struct TraceEvent);
+    for (size_t k = 0; k < count; k++) {
+        struct TraceEvent* event = NextRawEvent(reader);
+        if (event == NULL)
+            return 0;
+        memcpy(text + k * sizeof(struct TraceEvent), event, sizeof(struct TraceEvent));
+    }
+    text[length] = '\0';
+    return 1;
+}
+
+int AddName (struct TraceReader* reader, uint32_t number, char* name) {
+    if (number >= reader->nameCapacity) {
+        uint32_t capacity = reader->nameCapacity > 0 ? reader->nameCapacity : 256;
+        while (number >= capacity)
+            capacity *= 2;
+
+        char** names = realloc(reader->names, sizeof(char*) * capacity);
+        if (names == NULL)
+            return 0;
+        memset(names + reader->nameCapacity, 0, sizeof(char*) * (capacity - reader->nameCapacity));
+        reader->names = names;
+        reader->nameCapacity = capacity;
+    }
+
+    free(reader->names[number]);
+    reader->names[number] = strdup(name);
+    if (number >= reader->nameCount)
+        reader->nameCount = number + 1;
+    return reader->names[number] != NULL;
+}
+
+const char* GetName (struct TraceReader* reader, uint32_t number) {
+    return number < reader->nameCount && reader->names[number] != NULL ? reader->names[number] : "?";
+}
+
+// Returns 1 and the file read after its header if it is a trace, 0 otherwise
+int OpenTrace (const char* fileName, struct TraceReader* reader) {
+    memset(reader, 0, sizeof(struct TraceReader));
+
+    reader->file = fopen(fileName, "rb");
+    if (reader->file == NULL) {
+        printf("Cannot open the trace %s\n", fileName);
+        return 0;
+    }
+
+    uint32_t header[4];
+    if (fread(header, sizeof(header), 1, reader->file) != 1 || memcmp(header, TRACE_MAGIC, 8) != 0
+        || header[2] != TRACE_VERSION || header[3] != sizeof(struct TraceEvent)) {
+        printf("%s is not a trace of this version of UF-C\n", fileName);
+        fclose(reader->file);
+        return 0;
+    }
+
+    return 1;
+}
+
+void CloseTrace (struct TraceReader* reader) {
+    for (uint32_t i = 0; i < reader->nameCount; i++)
+        free(reader->names[i]);
+    free(reader->names);
+    fclose(reader->file);
+}
+
+// Returns the next event that is not a name nor padding, with the characters of a string given to a fighter in text
+// (of size TRACE_MAX_NAME + 1), or NULL at the end of the trace or if it is cut
+struct TraceEvent* NextEvent (struct TraceReader* reader, char* text) {
+    struct TraceEvent* event;
+    while ((event = NextRawEvent(reader)) != NULL) {
+        switch (event->type) {
+            case tracePadding:
+                break;
+            case traceName:
+            {
+                uint32_t number = event->name;
+                if (event->value.length > TRACE_MAX_NAME || !ReadCharacters(reader, event->value.length, text)
+                    || !AddName(reader, number, text)) {
+                    printf("The trace is cut or damaged after %lu events\n", reader->eventCount);
+                    return NULL;
+                }
+                break;
+            }
+            case traceWrite:
+            {
+                text[0] = '\0';
+                // Reading the characters after the event can load the next block over it, so it is copied first
+                static struct TraceEvent write;
+                write = *event;
+
+                size_t kept = write.value.length < TRACE_MAX_STRING ? write.value.length : TRACE_MAX_STRING;
+                if (write.valueType == characters && !ReadCharacters(reader, kept, text)) {
+                    printf("The trace is cut or damaged after %lu events\n", reader->eventCount);
+                    return NULL;
+                }
+                reader->eventCount++;
+                return &write;
+            }
+            default:
+                reader->eventCount++;
+                return event;
+        }
+    }
+
+    return NULL;
+}
+
+void PrintValue (enum VariableType type, int32_t i, float f, uint32_t length, const char* text) {
+    switch (type) {
+        case integer:
+            printf("%d", i);
+            break;
+        case floating:
+            printf("%f", f);
+            break;
+        case characters:
+            printf("\"%s\"", text);
+            if (length > TRACE_MAX_STRING)
+                printf("... (%u characters)", length);
+            break;
+        default:
+            printf("nothing");
+            break;
+    }
+}
+
+/*************************** Replay ***************************/
+
+int Replay (struct TraceReader* reader) {
+    char text[TRACE_MAX_NAME + 1];
+    int depth = 0;
+
+    struct TraceEvent* event;
+    while ((event = NextEvent(reader, text)) != NULL) {
+        if (event->type == traceReturn && depth > 0)
+            depth--;
+
+        printf("%6u  %*s", event->line, depth * 2, "");
+        switch (event->type) {
+            case traceNode:
+                printf("%s\n", GetNodeTypeName(event->nodeType));
+                break;
+            case traceCall:
+                printf("call %s\n", GetName(reader, event->name));
+                depth++;
+                break;
+            case traceReturn:
+                printf("%s gives ", GetName(reader, event->name));
+                PrintValue(event->valueType, event->value.i, event->value.f, 0, "");
+                printf("\n");
+                break;
+            case traceWrite:
+                printf("%s = ", GetName(reader, event->name));
+                PrintValue(event->valueType, event->value.i, event->value.f, event->value.length, text);
+                printf("\n");
+                break;
+            case traceTeamWrite:
+                printf("team %s changed\n", GetName(reader, event->name));
+                break;
+            default:
+                printf("unknown event %d\n", event->type);
+                break;
+        }
+    }
+
+    return 1;
+}
+
+/*************************** History ***************************/
+
+int History (struct TraceReader* reader, const char* fighter) {
+    char text[TRACE_MAX_NAME + 1];
+    // Regimens being run, to tell where each value was given
+    static uint32_t callStack[MAX_CALL_DEPTH];
+    int depth = 0;
+    unsigned long changes = 0;
+
+    struct TraceEvent* event;
+    while ((event = NextEvent(reader, text)) != NULL) {
+        if (event->type == traceCall) {
+            if (depth < MAX_CALL_DEPTH)
+                callStack[depth] = event->name;
+            depth++;
+        }
+        else if (event->type == traceReturn && depth > 0)
+            depth--;
+        else if ((event->type == traceWrite || event->type == traceTeamWrite) && !strcmp(GetName(reader, event->name), fighter)) {
+            const char* place = depth > 0 ? GetName(reader, callStack[(depth < MAX_CALL_DEPTH ? depth : MAX_CALL_DEPTH) - 1]) : "main";
+
+            printf("event %lu, line %u in %s : ", reader->eventCount, event->line, place);
+            if (event->type == traceTeamWrite)
+                printf("fighters of the team changed\n");
+            else {
+                PrintValue(event->valueType, event->value.i, event->value.f, event->value.length, text);
+                printf("\n");
+            }
+            changes++;
+        }
+    }
+
+    if (changes == 0)
+        printf("No value was given to %s\n", fighter);
+    return 1;
+}
+
+/*************************** Summary ***************************/
+
+// Node of the tree of the paths of calls : a regimen called from the path of its parent
+struct CallPath {
+    int parent; // -1 for the main phase
+    uint32_t name;
+    unsigned long calls;
+    unsigned long events; // Recorded while the path was running, including the calls it made
+};
+
+struct LineCount {
+    uint32_t line;
+    unsigned long nodes;
+};
+
+struct RegimenCount {
+    uint32_t name;
+    unsigned long calls;
+    unsigned long selfEvents; // Recorded while the regimen was running, without the calls it made
+};
+
+struct Summary {
+    unsigned long* lineNodes; // Indexed by line
+    uint32_t lineCapacity;
+
+    struct RegimenCount* regimens; // Indexed by name
+    uint32_t regimenCapacity;
+
+    struct CallPath* paths;
+    int pathCount, pathCapacity;
+    // Table of the paths by (parent, name) with open addressing, whose capacity is a power of 2 and that is never more than half full
+    int* pathTable;
+    int pathTableCapacity;
+};
+
+// Makes the array at *array of *capacity elements of size elementSize hold index, setting the new elements to zero
+int GrowArray (void** array, uint32_t* capacity, size_t elementSize, uint32_t index) {
+    if (index < *capacity)
+        return 1;
+
+    uint32_t newCapacity = *capacity > 0 ? *capacity : 1024;
+    while (index >= newCapacity)
+        newCapacity *= 2;
+
+    char* newArray = realloc(*array, elementSize * newCapacity);
+    if (newArray == NULL)
+        return 0;
+    memset(newArray + elementSize * *capacity, 0, elementSize * (newCapacity - *capacity));
+
+    *array = newArray;
+    *capacity = newCapacity;
+    return 1;
+}
+
+size_t HashPath (int parent, uint32_t name) {
+    size_t hash = (size_t) (parent + 1) * 0x9E3779B97F4A7C15ull ^ (size_t) name * 0xC2B2AE3D27D4EB4Full;
+    return hash ^ (hash >> 31);
+}
+
+int InsertPathInTable (struct Summary* summary, int path) {
+    size_t mask = summary->pathTableCapacity - 1;
+    size_t slot = HashPath(summary->paths[path].parent, summary->paths[path].name) & mask;
+    while (summary->pathTable[slot] >= 0)
+        slot = (slot + 1) & mask;
+    summary->pathTable[slot] = path;
+    return 1;
+}
+
+// Returns the path calling name from parent, created if it is new, or -1 if there is not enough memory
+int FindCallPath (struct Summary* summary, int parent, uint32_t name) {
+    size_t mask = summary->pathTableCapacity - 1;
+    size_t slot = HashPath(parent, name) & mask;
+    for (; summary->pathTable[slot] >= 0; slot = (slot + 1) & mask) {
+        struct CallPath* path = &summary->paths[summary->pathTable[slot]];
+        if (path->parent == parent && path->name == name)
+            return summary->pathTable[slot];
+    }
+
+    if (summary->pathCount == summary->pathCapacity) {
+        struct CallPath* paths = realloc(summary->paths, sizeof(struct CallPath) * summary->pathCapacity * 2);
+        if (paths == NULL)
+            return -1;
+        summary->paths = paths;
+        summary->pathCapacity *= 2;
+    }
+
+    int path = summary->pathCount++;
+    summary->paths[path] = (struct CallPath) { .parent = parent, .name = name };
+
+    if (summary->pathCount * 2 > summary->pathTableCapacity) {
+        int* table = malloc(sizeof(int) * summary->pathTableCapacity * 2);
+        if (table == NULL)
+            return -1;
+        free(summary->pathTable);
+        summary->pathTable = table;
+        summary->pathTableCapacity *= 2;
+        memset(table, -1, sizeof(int) * summary->pathTableCapacity);
+        for (int p = 0; p < summary->pathCount; p++)
+            InsertPathInTable(summary, p);
+    }
+    else
+        summary->pathTable[slot] = path;
+
+    return path;
+}
+
+void PrintPath (struct TraceReader* reader, struct Summary* summary, int path) {
+    if (summary->paths[path].parent >= 0) {
+        PrintPath(reader, summary, summary->paths[path].parent);
+        printf(" > ");
+    }
+    printf("%s", GetName(reader, summary->paths[path].name));
+}
+
+static unsigned long* sortedCounts; // Counts compared by CompareByCount
+int CompareByCount (const void* a, const void* b) {
+    unsigned long countA = sortedCounts[*(const uint32_t*) a];
+    unsigned long countB = sortedCounts[*(const uint32_t*) b];
+    return countA < countB ? 1 : countA > countB ? -1 : 0;
+}
+
+// Writes in order the indices of the count largest values (count at most) of values (of valueCount elements, read every stride)
+// Returns the number of indices written
+uint32_t TopIndices (unsigned long* values, uint32_t valueCount, size_t stride, uint32_t* indices, int count) {
+    unsigned long* counts = malloc(sizeof(unsigned long) * (valueCount + 1));
+    uint32_t* all = malloc(sizeof(uint32_t) * (valueCount + 1));
+    if (counts == NULL || all == NULL) {
+        free(counts);
+        free(all);
+        return 0;
+    }
+
+    uint32_t nonZero = 0;
+    for (uint32_t i = 0; i < valueCount; i++) {
+        counts[i] = *(unsigned long*) ((char*) values + stride * i);
+        if (counts[i] > 0)
+            all[nonZero++] = i;
+    }
+
+    sortedCounts = counts;
+    qsort(all, nonZero, sizeof(uint32_t), CompareByCount);
+
+    uint32_t written = nonZero < (uint32_t) count ? nonZero : (uint32_t) count;
+    memcpy(indices, all, sizeof(uint32_t) * written);
+
+    free(counts);
+    free(all);
+    return written;
+}
+
+int Summarize (struct TraceReader* reader, int topCount) {
+    char text[TRACE_MAX_NAME + 1];
+    struct Summary summary = { 0 };
+    unsigned long typeCounts[traceTeamWrite + 1] = { 0 };
+
+    summary.pathCapacity = 1024;
+    summary.paths = malloc(sizeof(struct CallPath) * summary.pathCapacity);
+    summary.pathTableCapacity = 4096;
+    summary.pathTable = malloc(sizeof(int) * summary.pathTableCapacity);
+    uint32_t* top = malloc(sizeof(uint32_t) * topCount);
+    if (summary.paths == NULL || summary.pathTable == NULL || top == NULL) {
+        printf("Not enough memory to summarize the trace\n");
+        free(summary.paths);
+        free(summary.pathTable);
+        free(top);
+        return 0;
+    }
+    memset(summary.pathTable, -1, sizeof(int) * summary.pathTableCapacity);
+
+    // Path of each call being run, and the number of events when it started
+    static int pathStack[MAX_CALL_DEPTH];
+    static unsigned long startStack[MAX_CALL_DEPTH];
+    int depth = 0;
+    int error = 0;
+
+    struct TraceEvent* event;
+    while (!error && (event = NextEvent(reader, text)) != NULL) {
+        if (event->type <= traceTeamWrite)
+            typeCounts[event->type]++;
+
+        // The event is counted in the regimen running it
+        if (depth > 0 && depth <= MAX_CALL_DEPTH)
+            summary.regimens[summary.paths[pathStack[depth - 1]].name].selfEvents++;
+
+        switch (event->type) {
+            case traceNode:
+                if (!GrowArray((void**) &summary.lineNodes, &summary.lineCapacity, sizeof(unsigned long), event->line))
+                    error = 1;
+                else
+                    summary.lineNodes[event->line]++;
+                break;
+            case traceCall:
+            {
+                if (depth >= MAX_CALL_DEPTH) {
+                    depth++;
+                    break;
+                }
+
+                int path = FindCallPath(&summary, depth > 0 ? pathStack[depth - 1] : -1, event->name);
+                if (path < 0 || !GrowArray((void**) &summary.regimens, &summary.regimenCapacity, sizeof(struct RegimenCount), event->name)) {
+                    error = 1;
+                    break;
+                }
+
+                summary.paths[path].calls++;
+                summary.regimens[event->name].name = event->name;
+                summary.regimens[event->name].calls++;
+
+                pathStack[depth] = path;
+                startStack[depth] = reader->eventCount;
+                depth++;
+                break;
+            }
+            case traceReturn:
+                if (depth == 0)
+                    break;
+                depth--;
+                if (depth < MAX_CALL_DEPTH)
+                    summary.paths[pathStack[depth]].events += reader->eventCount - startStack[depth];
+                break;
+        }
+    }
+    // The calls not returned (the program stopped in them) run up to the end
+    while (depth > 0) {
+        depth--;
+        if (depth < MAX_CALL_DEPTH)
+            summary.paths[pathStack[depth]].events += reader->eventCount - startStack[depth];
+    }
+
+    if (error)
+        printf("Not enough memory to summarize the trace\n");
+    else {
+        printf("%lu events : %lu nodes, %lu calls, %lu values given to fighters, %lu changes of teams\n", reader->eventCount,
+            typeCounts[traceNode], typeCounts[traceCall], typeCounts[traceWrite], typeCounts[traceTeamWrite]);
+
+        uint32_t count = summary.lineNodes != NULL ? TopIndices(summary.lineNodes, summary.lineCapacity, sizeof(unsigned long), top, topCount) : 0;
+        printf("\nLines running the most nodes\n");
+        for (uint32_t k = 0; k < count; k++)
+            printf("%12lu  line %u\n", summary.lineNodes[top[k]], top[k]);
+
+        count = summary.regimens != NULL ? TopIndices(&summary.regimens[0].calls, summary.regimenCapacity, sizeof(struct RegimenCount), top, topCount) : 0;
+        printf("\nRegimens called the most (calls, events of their own)\n");
+        for (uint32_t k = 0; k < count; k++)
+            printf("%12lu %12lu  %s\n", summary.regimens[top[k]].calls, summary.regimens[top[k]].selfEvents, GetName(reader, top[k]));
+
+        count = summary.pathCount > 0 ? TopIndices(&summary.paths[0].events, summary.pathCount, sizeof(struct CallPath), top, topCount) : 0;
+        printf("\nPaths of calls costing the most (events while they run, calls)\n");
+        for (uint32_t k = 0; k < count; k++) {
+            printf("%12lu %12lu  ", summary.paths[top[k]].events, summary.paths[top[k]].calls);
+            PrintPath(reader, &summary, top[k]);
+            printf("\n");
+        }
+    }
+
+    free(summary.lineNodes);
+    free(summary.regimens);
+    free(summary.paths);
+    free(summary.pathTable);
+    free(top);
+    return !error;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || (!strcmp(argv[1], "history") && argc != 4) || (!strcmp(argv[1], "summary") && argc > 4)
+        || (!strcmp(argv[1], "replay") && argc != 3)) {
+        printf("Usage : %s summary TRACE [N] | replay TRACE | history TRACE NAME\n", argv[0]);
+        return 1;
+    }
+
+    int topCount = DEFAULT_TOP_COUNT;
+    if (!strcmp(argv[1], "summary") && argc == 4 && (topCount = atoi(argv[3])) <= 0) {
+        printf("Error : The number of lines, regimens and paths to show must be positive\n");
+        return 1;
+    }
+    if (strcmp(argv[1], "summary") && strcmp(argv[1], "replay") && strcmp(argv[1], "history")) {
+        printf("Error : Unknown command %s (summary, replay or history)\n", argv[1]);
+        return 1;
+    }
+
+    struct TraceReader* reader = malloc(sizeof(struct TraceReader));
+    if (reader == NULL || !OpenTrace(argv[2], reader)) {
+        free(reader);
+        return 1;
+    }
+
+    int success;
+    if (!strcmp(argv[1], "summary"))
+        success = Summarize(reader, topCount);
+    else if (!strcmp(argv[1], "replay"))
+        success = Replay(reader);
+    else
+        success = History(reader, argv[3]);
+
+    CloseTrace(reader);
+    free(reader);
+    return success ? 0 : 1;
+}
@@ -0,0 +1,1097 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "../Utils/ComparisonDictionnary.h"
+#include "../Optimizer/Peephole.h"
+#include "AsmTranslator.h"
+
+// Registers of the System V calling convention for the first arguments of a training regimen
+// The famous fighters and the strings take the general registers in order, the smart fighters the xmm registers
+#define GENERAL_ARGUMENT_REGISTERS 6
+#define FLOAT_ARGUMENT_REGISTERS 8
+static const char* intArgumentRegisters[GENERAL_ARGUMENT_REGISTERS] = { "%edi", "%esi", "%edx", "%ecx", "%r8d", "%r9d" };
+static const char* pointerArgumentRegisters[GENERAL_ARGUMENT_REGISTERS] = { "%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9" };
+
+// Root of the code being translated, and training regimen being translated (NULL in the main phase)
+static struct AstNode* asmRoot = NULL;
+static struct AstNode* asmFunction = NULL;
+
+// Constants of the code (floating numbers and strings), written in .rodata after the code, and number of labels used
+static FILE* constantsFile = NULL;
+static int labelCount = 0;
+
+// Labels of the condition and of the end of the nearest loop of the regimen or main phase being translated, -1 outside of a loop
+static int loopConditionLabel = -1;
+static int loopEndLabel = -1;
+
+// Comparisons and label of the end of the tournament being translated
+static struct Comparisons_Dict* asmComparisons = NULL;
+static int testEndLabel = -1;
+
+// Set when a part of the code can't be written
+static int asmFailed = 0;
+
+// Runtime of the translated program : the output is kept in a buffer of 64 KB written with the write system call,
+// and the numbers are printed as printf prints them with %d and %f (the floating numbers are rounded to the nearest, ties to even)
+// A string is a pointer to its length (8 bytes) followed by its characters.
+static const char* asmRuntimeCode =
+    "    .bss\n"
+    "    .align 16\n"
+    "ufc_output:\n"
+    "    .skip 65536\n"
+    "ufc_output_length:\n"
+    "    .skip 8\n"
+    "\n"
+    "    .data\n"
+    "ufc_signal:\n"
+    "    .long 0\n"
+    "\n"
+    "    .section .rodata\n"
+    "ufc_characters:\n"
+    "    .ascii \"-\\ninfnan\"\n"
+    "ufc_zero_fraction:\n"
+    "    .ascii \".000000\"\n"
+    "ufc_interrupted_message:\n"
+    "    .ascii \"The match can only be interrupted, or a round ended, inside a loop\\n\"\n"
+    "    .align 8\n"
+    "ufc_empty_string:\n"
+    "    .quad 0\n"
+    "\n"
+    "    .text\n"
+    "# Writes the %rdx bytes at %rsi on the standard output\n"
+    "ufc_write_all:\n"
+    "    testq %rdx, %rdx\n"
+    "    jz 2f\n"
+    "    movl $1, %eax\n"
+    "    movl $1, %edi\n"
+    "    syscall\n"
+    "    cmpq $-4, %rax\n"
+    "    je ufc_write_all\n"
+    "    testq %rax, %rax\n"
+    "    jle 2f\n"
+    "    addq %rax, %rsi\n"
+    "    subq %rax, %rdx\n"
+    "    jmp ufc_write_all\n"
+    "2:\n"
+    "    ret\n"
+    "\n"
+    "ufc_flush:\n"
+    "    leaq ufc_output(%rip), %rsi\n"
+    "    movq ufc_output_length(%rip), %rdx\n"
+    "    call ufc_write_all\n"
+    "    movq $0, ufc_output_length(%rip)\n"
+    "    ret\n"
+    "\n"
+    "# Adds the %rdx bytes at %rsi to the output\n"
+    "ufc_write:\n"
+    "    movq ufc_output_length(%rip), %rax\n"
+    "    addq %rdx, %rax\n"
+    "    cmpq $65536, %rax\n"
+    "    jbe 1f\n"
+    "    pushq %rsi\n"
+    "    pushq %rdx\n"
+    "    call ufc_flush\n"
+    "    popq %rdx\n"
+    "    popq %rsi\n"
+    "    cmpq $65536, %rdx\n"
+    "    jbe 1f\n"
+    "    jmp ufc_write_all\n"
+    "1:\n"
+    "    leaq ufc_output(%rip), %rdi\n"
+    "    addq ufc_output_length(%rip), %rdi\n"
+    "    addq %rdx, ufc_output_length(%rip)\n"
+    "    movq %rdx, %rcx\n"
+    "    rep movsb\n"
+    "    ret\n"
+    "\n"
+    "# Writes the unsigned number %rax with at least %r9 digits\n"
+    "ufc_write_unsigned:\n"
+    "    subq $40, %rsp\n"
+    "    leaq 32(%rsp), %rsi\n"
+    "    movl $10, %ecx\n"
+    "1:\n"
+    "    xorl %edx, %edx\n"
+    "    divq %rcx\n"
+    "    addb $48, %dl\n"
+    "    decq %rsi\n"
+    "    movb %dl, (%rsi)\n"
+    "    decq %r9\n"
+    "    testq %rax, %rax\n"
+    "    jnz 1b\n"
+    "    testq %r9, %r9\n"
+    "    jg 1b\n"
+    "    leaq 32(%rsp), %rdx\n"
+    "    subq %rsi, %rdx\n"
+    "    call ufc_write\n"
+    "    addq $40, %rsp\n"
+    "    ret\n"
+    "\n"
+    "# Writes the famous fighter %edi\n"
+    "ufc_print_int:\n"
+    "    movslq %edi, %rax\n"
+    "    testq %rax, %rax\n"
+    "    jns 1f\n"
+    "    pushq %rax\n"
+    "    leaq ufc_characters(%rip), %rsi\n"
+    "    movl $1, %edx\n"
+    "    call ufc_write\n"
+    "    popq %rax\n"
+    "    negq %rax\n"
+    "1:\n"
+    "    movl $1, %r9d\n"
+    "    jmp ufc_write_unsigned\n"
+    "\n"
+    "# Writes the smart fighter %xmm0 with 6 decimals : its exact value m * 2^e is rounded to a number of millionths,\n"
+    "# and the integers too large for 64 bits are written from a decimal number doubled e times\n"
+    "ufc_print_float:\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    movd %xmm0, %ebx\n"
+    "    testl %ebx, %ebx\n"
+    "    jns 1f\n"
+    "    leaq ufc_characters(%rip), %rsi\n"
+    "    movl $1, %edx\n"
+    "    call ufc_write\n"
+    "1:\n"
+    "    movl %ebx, %eax\n"
+    "    shrl $23, %eax\n"
+    "    andl $255, %eax\n"
+    "    movl %ebx, %r12d\n"
+    "    andl $8388607, %r12d\n"
+    "    cmpl $255, %eax\n"
+    "    je 9f\n"
+    "    testl %eax, %eax\n"
+    "    jz 2f\n"
+    "    orl $8388608, %r12d\n"
+    "    jmp 3f\n"
+    "2:\n"
+    "    movl $1, %eax\n"
+    "3:\n"
+    "    subl $150, %eax\n"
+    "    js 5f\n"
+    "    cmpl $39, %eax\n"
+    "    jg 4f\n"
+    "    movl %eax, %ecx\n"
+    "    movq %r12, %rax\n"
+    "    shlq %cl, %rax\n"
+    "    movl $1, %r9d\n"
+    "    call ufc_write_unsigned\n"
+    "    jmp 8f\n"
+    "4:\n"
+    "    subq $128, %rsp\n"
+    "    movl %eax, %r13d\n"
+    "    movq %r12, %rax\n"
+    "    xorl %r8d, %r8d\n"
+    "    movl $10, %ecx\n"
+    "10:\n"
+    "    xorl %edx, %edx\n"
+    "    divq %rcx\n"
+    "    movb %dl, (%rsp,%r8)\n"
+    "    incq %r8\n"
+    "    testq %rax, %rax\n"
+    "    jnz 10b\n"
+    "11:\n"
+    "    xorl %edx, %edx\n"
+    "    xorl %r9d, %r9d\n"
+    "12:\n"
+    "    movzbl (%rsp,%r9), %eax\n"
+    "    leal (%rdx,%rax,2), %eax\n"
+    "    xorl %edx, %edx\n"
+    "    cmpl $10, %eax\n"
+    "    jb 13f\n"
+    "    subl $10, %eax\n"
+    "    movl $1, %edx\n"
+    "13:\n"
+    "    movb %al, (%rsp,%r9)\n"
+    "    incq %r9\n"
+    "    cmpq %r8, %r9\n"
+    "    jb 12b\n"
+    "    testl %edx, %edx\n"
+    "    jz 14f\n"
+    "    movb $1, (%rsp,%r8)\n"
+    "    incq %r8\n"
+    "14:\n"
+    "    decl %r13d\n"
+    "    jnz 11b\n"
+    "    xorl %r9d, %r9d\n"
+    "15:\n"
+    "    movzbl (%rsp,%r9), %eax\n"
+    "    addl $48, %eax\n"
+    "    movq %r8, %r10\n"
+    "    subq %r9, %r10\n"
+    "    movb %al, 63(%rsp,%r10)\n"
+    "    incq %r9\n"
+    "    cmpq %r8, %r9\n"
+    "    jb 15b\n"
+    "    leaq 64(%rsp), %rsi\n"
+    "    movq %r8, %rdx\n"
+    "    call ufc_write\n"
+    "    addq $128, %rsp\n"
+    "    jmp 8f\n"
+    "5:\n"
+    "    negl %eax\n"
+    "    movl %eax, %ecx\n"
+    "    imulq $1000000, %r12, %rax\n"
+    "    xorl %r12d, %r12d\n"
+    "    cmpl $44, %ecx\n"
+    "    ja 7f\n"
+    "    movq %rax, %rdx\n"
+    "    shrq %cl, %rax\n"
+    "    movl $1, %r13d\n"
+    "    shlq %cl, %r13\n"
+    "    decq %r13\n"
+    "    andq %r13, %rdx\n"
+    "    shrq $1, %r13\n"
+    "    incq %r13\n"
+    "    cmpq %r13, %rdx\n"
+    "    jb 6f\n"
+    "    ja 16f\n"
+    "    testb $1, %al\n"
+    "    jz 6f\n"
+    "16:\n"
+    "    incq %rax\n"
+    "6:\n"
+    "    movq %rax, %r12\n"
+    "7:\n"
+    "    movq %r12, %rax\n"
+    "    xorl %edx, %edx\n"
+    "    movl $1000000, %ecx\n"
+    "    divq %rcx\n"
+    "    movq %rdx, %r13\n"
+    "    movl $1, %r9d\n"
+    "    call ufc_write_unsigned\n"
+    "    leaq ufc_zero_fraction(%rip), %rsi\n"
+    "    movl $1, %edx\n"
+    "    call ufc_write\n"
+    "    movq %r13, %rax\n"
+    "    movl $6, %r9d\n"
+    "    call ufc_write_unsigned\n"
+    "    jmp 17f\n"
+    "8:\n"
+    "    leaq ufc_zero_fraction(%rip), %rsi\n"
+    "    movl $7, %edx\n"
+    "    call ufc_write\n"
+    "    jmp 17f\n"
+    "9:\n"
+    "    leaq ufc_characters+2(%rip), %rsi\n"
+    "    testl %r12d, %r12d\n"
+    "    jz 18f\n"
+    "    leaq ufc_characters+5(%rip), %rsi\n"
+    "18:\n"
+    "    movl $3, %edx\n"
+    "    call ufc_write\n"
+    "17:\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    ret\n"
+    "\n"
+    "# Same error as the interpreter for a break or a continue outside of a loop of the main phase\n"
+    "ufc_interrupted:\n"
+    "    leaq ufc_interrupted_message(%rip), %rsi\n"
+    "    movl $67, %edx\n"
+    "    call ufc_write\n"
+    "    call ufc_flush\n"
+    "    movl $231, %eax\n"
+    "    movl $1, %edi\n"
+    "    syscall\n"
+    "\n"
+    "    .globl _start\n"
+    "_start:\n"
+    "    xorl %ebp, %ebp\n"
+    "    call ufc_main\n"
+    "    call ufc_flush\n"
+    "    movl $231, %eax\n"
+    "    xorl %edi, %edi\n"
+    "    syscall\n"
+    "\n";
+
+void AsmTranslatorError (char* error_msg)
+{
+    printf("Error from the assembly translator : %s\n", error_msg);
+    asmFailed = 1;
+}
+
+// Returns the number of the next label .LufcN
+int NewLabel ()
+{
+    return labelCount++;
+}
+
+// Writes the floating constant in .rodata, and returns the number of its label
+int AddAsmFloatConstant (float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    int label = NewLabel();
+    fprintf(constantsFile, "    .align 4\n.Lufc%d:\n    .long 0x%08x\n", label, bits);
+    return label;
+}
+
+// Writes the string constant in .rodata (its length followed by its characters), and returns the number of its label
+int AddAsmStringConstant (char* s)
+{
+    if (s==NULL)
+        s = "";
+
+    int label = NewLabel();
+    fprintf(constantsFile, "    .align 8\n.Lufc%d:\n    .quad %zu\n    .ascii \"", label, strlen(s));
+    for (char* c = s; *c!='\0'; c++)
+    {
+        if (*c=='"' || *c=='\\')
+            fprintf(constantsFile, "\\%c", *c);
+        else if ((unsigned char) *c < 32 || (unsigned char) *c >= 127)
+            fprintf(constantsFile, "\\%03o", (unsigned char) *c);
+        else
+            fputc(*c, constantsFile);
+    }
+    fprintf(constantsFile, "\"\n");
+
+    return label;
+}
+
+// Returns the atFuncDef node of the training regimen named id, NULL if it is not defined
+struct AstNode* FindFunctionDefinition (char* id)
+{
+    for (struct AstNode* statement = asmRoot->child1; statement!=NULL; statement = statement->child2)
+    {
+        struct AstNode* definition = statement->child1;
+        if (definition!=NULL && definition->type==atFuncDef && !strcmp(definition->child1->s, id))
+            return definition;
+    }
+
+    return NULL;
+}
+
+// Returns the position of the argument named id in the regimen being translated, -1 if it is not one of its arguments
+int FindArgumentIndex (char* id)
+{
+    if (asmFunction==NULL)
+        return -1;
+
+    int index = 0;
+    for (struct AstNode* args = asmFunction->child2; args!=NULL && args->type==atFuncDefArgsList; args = args->child2, index++)
+    {
+        if (!strcmp(args->child1->child1->s, id))
+            return index;
+    }
+
+    return -1;
+}
+
+// Returns the type of the value of the expression, noType if it can't be computed
+// As in the interpreter, an operation with a smart fighter gives a smart fighter, and the strings can't be joined
+enum VariableType ExpressionType (struct AstNode* ast)
+{
+    switch (ast->type)
+    {
+        case atConstant:
+            return ast->variableType;
+        case atId:
+        {
+            enum VariableType type = FindDefinedType(asmRoot, asmFunction, ast->s);
+            return type==integer || type==floating || type==characters ? type : noType;
+        }
+        case atAdd:
+        case atMinus:
+        case atMultiply:
+        case atDivide:
+        {
+            enum VariableType type1 = ExpressionType(ast->child1);
+            enum VariableType type2 = ExpressionType(ast->child2);
+            if ((type1!=integer && type1!=floating) || (type2!=integer && type2!=floating))
+                return noType;
+
+            return type1==integer && type2==integer ? integer : floating;
+        }
+        default:
+            return noType;
+    }
+}
+
+// Writes the operand reading a fighter or a number : a slot of the frame for an argument of the regimen, a label for a global fighter
+// or a floating constant, an immediate value for an integer constant
+void WriteOperand (struct AstNode* ast, FILE* out)
+{
+    if (ast->type==atId)
+    {
+        int index = FindArgumentIndex(ast->s);
+        if (index >= 0)
+            fprintf(out, "%d(%%rbp)", -8 * (index + 1));
+        else
+            fprintf(out, "ufc_v_%s(%%rip)", ast->s);
+    }
+    else if (ast->variableType==integer)
+        fprintf(out, "$%d", ast->i);
+    else
+        fprintf(out, ".Lufc%d(%%rip)", AddAsmFloatConstant(ast->f));
+}
+
+// Writes the load of the fighter or constant, of the given type, in the register
+void WriteLoad (struct AstNode* ast, enum VariableType type, const char* reg, FILE* out)
+{
+    switch (type)
+    {
+        case integer:
+            fprintf(out, "    movl ");
+            break;
+        case floating:
+            fprintf(out, "    movss ");
+            break;
+        default:
+            if (ast->type==atConstant)
+            {
+                fprintf(out, "    leaq .Lufc%d(%%rip), %s\n", AddAsmStringConstant(ast->s), reg);
+                return;
+            }
+            fprintf(out, "    movq ");
+            break;
+    }
+
+    WriteOperand(ast, out);
+    fprintf(out, ", %s\n", reg);
+}
+
+// Writes the store of %eax, %xmm0 or %rax (depending on the type) in the fighter
+void WriteStore (struct AstNode* target, enum VariableType type, FILE* out)
+{
+    fprintf(out, type==integer ? "    movl %%eax, " : (type==floating ? "    movss %%xmm0, " : "    movq %%rax, "));
+    WriteOperand(target, out);
+    fprintf(out, "\n");
+}
+
+enum VariableType GenerateExpression (struct AstNode* ast, FILE* out);
+
+// Writes the computation of the two members of an operation or a comparison, the left one in %eax or %xmm0 and the right one in %ecx or %xmm1,
+// both converted to floating numbers if type is floating
+// Returns 1 if they were written, 0 otherwise
+int GenerateOperands (struct AstNode* left, struct AstNode* right, enum VariableType type, FILE* out)
+{
+    enum VariableType leftType = GenerateExpression(left, out);
+    enum VariableType rightType = ExpressionType(right);
+    if (leftType==noType || rightType==noType)
+        return 0;
+
+    if (right->type==atId || right->type==atConstant)
+        WriteLoad(right, rightType, rightType==floating ? "%xmm1" : "%ecx", out);
+    else
+    {
+        // The left member waits on the stack while the right one is computed
+        fprintf(out, leftType==floating ? "    subq $8, %%rsp\n    movss %%xmm0, (%%rsp)\n" : "    pushq %%rax\n");
+        if (GenerateExpression(right, out)==noType)
+            return 0;
+        fprintf(out, rightType==floating ? "    movaps %%xmm0, %%xmm1\n" : "    movl %%eax, %%ecx\n");
+        fprintf(out, leftType==floating ? "    movss (%%rsp), %%xmm0\n    addq $8, %%rsp\n" : "    popq %%rax\n");
+    }
+
+    if (type==floating && leftType==integer)
+        fprintf(out, "    cvtsi2ssl %%eax, %%xmm0\n");
+    if (type==floating && rightType==integer)
+        fprintf(out, "    cvtsi2ssl %%ecx, %%xmm1\n");
+
+    return 1;
+}
+
+// Writes the computation of the expression in %eax (famous fighter), %xmm0 (smart fighter) or %rax (string)
+// Returns its type, noType if it couldn't be written
+enum VariableType GenerateExpression (struct AstNode* ast, FILE* out)
+{
+    enum VariableType type = ExpressionType(ast);
+    if (type==noType)
+    {
+        AsmTranslatorError("This value can't be computed by the assembly backend");
+        return noType;
+    }
+
+    if (ast->type==atId || ast->type==atConstant)
+    {
+        WriteLoad(ast, type, type==integer ? "%eax" : (type==floating ? "%xmm0" : "%rax"), out);
+        return type;
+    }
+
+    // As in the interpreter, the second member is divided by the first one
+    struct AstNode* left = ast->type==atDivide ? ast->child2 : ast->child1;
+    struct AstNode* right = ast->type==atDivide ? ast->child1 : ast->child2;
+    if (!GenerateOperands(left, right, type, out))
+        return noType;
+
+    switch (ast->type)
+    {
+        case atAdd:
+            fprintf(out, type==integer ? "    addl %%ecx, %%eax\n" : "    addss %%xmm1, %%xmm0\n");
+            break;
+        case atMinus:
+            fprintf(out, type==integer ? "    subl %%ecx, %%eax\n" : "    subss %%xmm1, %%xmm0\n");
+            break;
+        case atMultiply:
+            fprintf(out, type==integer ? "    imull %%ecx, %%eax\n" : "    mulss %%xmm1, %%xmm0\n");
+            break;
+        default: // Same integer division as the C code of the translator
+            fprintf(out, type==integer ? "    cltd\n    idivl %%ecx\n" : "    divss %%xmm1, %%xmm0\n");
+            break;
+    }
+
+    return type;
+}
+
+// Writes the comparison of two values, jumping to the label if its result is jumpIfTrue
+// The smart fighters are compared as in C : a comparison with a NaN is false, except !=
+void GenerateComparisonJump (enum ComparatorType comparator, struct AstNode* value1, struct AstNode* value2, int label, int jumpIfTrue, FILE* out)
+{
+    enum VariableType type1 = ExpressionType(value1);
+    enum VariableType type2 = ExpressionType(value2);
+    if ((type1!=integer && type1!=floating) || (type2!=integer && type2!=floating))
+    {
+        AsmTranslatorError("Only the smart and famous fighters can be compared by the assembly backend");
+        return;
+    }
+
+    enum VariableType type = type1==integer && type2==integer ? integer : floating;
+    if (!GenerateOperands(value1, value2, type, out))
+        return;
+
+    if (type==integer)
+    {
+        fprintf(out, "    cmpl %%ecx, %%eax\n");
+        switch (comparator)
+        {
+            case gtr:
+                fprintf(out, "    %s .Lufc%d\n", jumpIfTrue ? "jge" : "jl", label);
+                break;
+            case str_gtr:
+                fprintf(out, "    %s .Lufc%d\n", jumpIfTrue ? "jg" : "jle", label);
+                break;
+            case neq:
+                fprintf(out, "    %s .Lufc%d\n", jumpIfTrue ? "jne" : "je", label);
+                break;
+            default:
+                fprintf(out, "    %s .Lufc%d\n", jumpIfTrue ? "je" : "jne", label);
+                break;
+        }
+        return;
+    }
+
+    // An unordered result (NaN) sets the carry, zero and parity flags
+    fprintf(out, "    ucomiss %%xmm1, %%xmm0\n");
+    switch (comparator)
+    {
+        case gtr:
+            fprintf(out, "    %s .Lufc%d\n", jumpIfTrue ? "jae" : "jb", label);
+            break;
+        case str_gtr:
+            fprintf(out, "    %s .Lufc%d\n", jumpIfTrue ? "ja" : "jbe", label);
+            break;
+        default:
+            if ((comparator==eq) == jumpIfTrue) // Jumps if equal and ordered
+            {
+                int ordered = NewLabel();
+                fprintf(out, "    jp .Lufc%d\n    je .Lufc%d\n.Lufc%d:\n", ordered, label, ordered);
+            }
+            else // Jumps if different or unordered
+                fprintf(out, "    jp .Lufc%d\n    jne .Lufc%d\n", label, label);
+            break;
+    }
+}
+
+// Writes the test of a condition (comparisons of a tournament joined with and and or, or the comparison of a loop),
+// jumping to the label if its result is jumpIfTrue
+void GenerateConditionJump (struct AstNode* ast, int label, int jumpIfTrue, FILE* out)
+{
+    switch (ast->type)
+    {
+        case atLogicalOr:
+        case atLogicalAnd:
+            // An or that jumps when true, or an and that jumps when false, only needs one of its members to jump
+            if ((ast->type==atLogicalOr) == jumpIfTrue)
+            {
+                GenerateConditionJump(ast->child1, label, jumpIfTrue, out);
+                GenerateConditionJump(ast->child2, label, jumpIfTrue, out);
+            }
+            else
+            {
+                int skip = NewLabel();
+                GenerateConditionJump(ast->child1, skip, !jumpIfTrue, out);
+                GenerateConditionJump(ast->child2, label, jumpIfTrue, out);
+                fprintf(out, ".Lufc%d:\n", skip);
+            }
+            break;
+        case atComparisonId:
+        {
+            struct ComparisonValue *comparison;
+            if (!TryFind_ComparisonsDict(asmComparisons, ast->i, &comparison))
+            {
+                char msg[100];
+                snprintf(msg, sizeof(msg), "Unable to find the comparison (match %d) in this dictionnary", ast->i);
+                AsmTranslatorError(msg);
+                break;
+            }
+
+            GenerateComparisonJump(comparison->comparator, comparison->value1, comparison->value2, label, jumpIfTrue, out);
+            break;
+        }
+        case atWhileCompare:
+            GenerateComparisonJump(ast->comparator, ast->child1, ast->child2, label, jumpIfTrue, out);
+            break;
+        default:
+            AsmTranslatorError("Not a valid condition");
+            break;
+    }
+}
+
+// Writes the return of the regimen without value, after a break or a continue or at the end of its body
+void GenerateDefaultReturn (FILE* out)
+{
+    switch (asmFunction->variableType)
+    {
+        case integer:
+            fprintf(out, "    xorl %%eax, %%eax\n");
+            break;
+        case floating:
+            fprintf(out, "    xorps %%xmm0, %%xmm0\n");
+            break;
+        case characters:
+            fprintf(out, "    leaq ufc_empty_string(%%rip), %%rax\n");
+            break;
+        default:
+            break;
+    }
+    fprintf(out, "    leave\n    ret\n");
+}
+
+// Writes a break (signal 1) or a continue (signal 2) : a jump in a loop of the regimen, outside of it the regimen gives the signal to its caller
+void GenerateInterruption (int signal, FILE* out)
+{
+    if (loopEndLabel >= 0)
+        fprintf(out, "    jmp .Lufc%d\n", signal==1 ? loopEndLabel : loopConditionLabel);
+    else if (asmFunction!=NULL)
+    {
+        fprintf(out, "    movl $%d, ufc_signal(%%rip)\n", signal);
+        GenerateDefaultReturn(out);
+    }
+    else
+        fprintf(out, "    call ufc_interrupted\n");
+}
+
+// Writes the call of a training regimen, its value left in %eax, %xmm0 or %rax
+// The arguments are given in the registers of the System V calling convention, and the signal of a break or a continue is checked after the call
+// Returns 1 if it was written, 0 otherwise
+int GenerateCall (struct AstNode* call, FILE* out)
+{
+    struct AstNode* definition = FindFunctionDefinition(call->child1->s);
+    if (definition==NULL)
+    {
+        AsmTranslatorError("This training regimen is not defined");
+        return 0;
+    }
+
+    int generalCount = 0;
+    int floatCount = 0;
+    struct AstNode* args = definition->child2;
+    struct AstNode* values = call->child2;
+    while (args!=NULL && args->type==atFuncDefArgsList && values!=NULL && values->type==atFuncCallArgList)
+    {
+        enum VariableType type = args->child1->variableType;
+        if (ExpressionType(values->child1)!=type)
+        {
+            AsmTranslatorError("The type of the argument doesn't match the type defined in the function");
+            return 0;
+        }
+
+        if (type==floating ? floatCount==FLOAT_ARGUMENT_REGISTERS : generalCount==GENERAL_ARGUMENT_REGISTERS)
+        {
+            AsmTranslatorError("Too many arguments for the assembly backend");
+            return 0;
+        }
+
+        if (type==floating)
+        {
+            char reg[16]; // Room for any int, the count is already checked against FLOAT_ARGUMENT_REGISTERS
+            snprintf(reg, sizeof(reg), "%%xmm%d", floatCount++);
+            WriteLoad(values->child1, type, reg, out);
+        }
+        else
+        {
+            WriteLoad(values->child1, type, type==integer ? intArgumentRegisters[generalCount] : pointerArgumentRegisters[generalCount], out);
+            generalCount++;
+        }
+
+        args = args->child2;
+        values = values->child2;
+    }
+
+    if ((args!=NULL && args->type==atFuncDefArgsList) || (values!=NULL && values->type==atFuncCallArgList))
+    {
+        AsmTranslatorError("Not the same number of arguments as in the definition of the training regimen");
+        return 0;
+    }
+
+    fprintf(out, "    call ufc_f_%s\n", call->child1->s);
+
+    // After a break or a continue in the regimen, the nearest loop stops or goes on with its next round, or the signal goes to the caller
+    int noSignal = NewLabel();
+    fprintf(out, "    cmpl $0, ufc_signal(%%rip)\n    je .Lufc%d\n", noSignal);
+    if (loopEndLabel >= 0)
+        fprintf(out, "    movl ufc_signal(%%rip), %%edx\n    movl $0, ufc_signal(%%rip)\n    cmpl $1, %%edx\n    je .Lufc%d\n    jmp .Lufc%d\n",
+            loopEndLabel, loopConditionLabel);
+    else if (asmFunction!=NULL)
+        GenerateDefaultReturn(out);
+    else
+        fprintf(out, "    call ufc_interrupted\n");
+    fprintf(out, ".Lufc%d:\n", noSignal);
+
+    return 1;
+}
+
+void GenerateStatement (struct AstNode* ast, FILE* out)
+{
+    if (ast==NULL || asmFailed)
+        return;
+
+    switch (ast->type)
+    {
+        case atStatementList:
+            GenerateStatement(ast->child1, out);
+            GenerateStatement(ast->child2, out);
+            break;
+        case atAssignment:
+        {
+            if (ast->child1->type==atVoid && ast->child2->type==atFuncCall) // Call without keeping the value
+            {
+                GenerateCall(ast->child2, out);
+                break;
+            }
+
+            enum VariableType targetType = ast->child1->type==atId ? ExpressionType(ast->child1) : noType;
+            if (targetType==noType)
+            {
+                AsmTranslatorError("This fighter can't be given a value by the assembly backend");
+                break;
+            }
+
+            enum VariableType valueType;
+            if (ast->child2->type==atFuncCall)
+            {
+                struct AstNode* definition = FindFunctionDefinition(ast->child2->child1->s);
+                valueType = definition!=NULL ? definition->variableType : noType;
+                if (valueType==targetType && !GenerateCall(ast->child2, out))
+                    break;
+            }
+            else
+            {
+                valueType = ExpressionType(ast->child2);
+                if (valueType==noType)
+                {
+                    AsmTranslatorError("This value can't be computed by the assembly backend (the strings can't be joined)");
+                    break;
+                }
+                if (valueType==targetType && GenerateExpression(ast->child2, out)==noType)
+                    break;
+            }
+
+            if (valueType!=targetType)
+            {
+                AsmTranslatorError("Type of the variable not matching the type of the other hand of the assignment");
+                break;
+            }
+
+            WriteStore(ast->child1, targetType, out);
+            break;
+        }
+        case atFuncCall: // Call of a regimen without value (noone)
+            GenerateCall(ast, out);
+            break;
+        case atAddAssign: // In place updates made by RewriteSelfUpdates
+        case atMinusAssign:
+        case atMultiplyAssign:
+        {
+            enum VariableType targetType = ExpressionType(ast->child1);
+            enum VariableType operandType = ExpressionType(ast->child2);
+            if ((targetType!=integer && targetType!=floating) || operandType==noType || operandType==characters || (targetType==integer && operandType!=integer))
+            {
+                AsmTranslatorError("Type of the variable not matching the type of the other hand of the assignment");
+                break;
+            }
+
+            if (GenerateExpression(ast->child2, out)==noType)
+                break;
+
+            if (targetType==integer)
+            {
+                if (ast->type==atMultiplyAssign)
+                {
+                    fprintf(out, "    imull ");
+                    WriteOperand(ast->child1, out);
+                    fprintf(out, ", %%eax\n");
+                    WriteStore(ast->child1, integer, out);
+                }
+                else
+                {
+                    fprintf(out, ast->type==atAddAssign ? "    addl %%eax, " : "    subl %%eax, ");
+                    WriteOperand(ast->child1, out);
+                    fprintf(out, "\n");
+                }
+                break;
+            }
+
+            if (operandType==integer)
+                fprintf(out, "    cvtsi2ssl %%eax, %%xmm0\n");
+            WriteLoad(ast->child1, floating, "%xmm1", out);
+            fprintf(out, ast->type==atAddAssign ? "    addss %%xmm0, %%xmm1\n" : (ast->type==atMinusAssign ? "    subss %%xmm0, %%xmm1\n" : "    mulss %%xmm0, %%xmm1\n"));
+            fprintf(out, "    movaps %%xmm1, %%xmm0\n");
+            WriteStore(ast->child1, floating, out);
+            break;
+        }
+        case atWhileLoop: // The condition is tested at the end of each round, after a first jump to it
+        {
+            int previousCondition = loopConditionLabel;
+            int previousEnd = loopEndLabel;
+            int body = NewLabel();
+            loopConditionLabel = NewLabel();
+            loopEndLabel = NewLabel();
+
+            fprintf(out, "    jmp .Lufc%d\n.Lufc%d:\n", loopConditionLabel, body);
+            GenerateStatement(ast->child2, out);
+            fprintf(out, ".Lufc%d:\n", loopConditionLabel);
+            GenerateConditionJump(ast->child1, body, 1, out);
+            fprintf(out, ".Lufc%d:\n", loopEndLabel);
+
+            loopConditionLabel = previousCondition;
+            loopEndLabel = previousEnd;
+            break;
+        }
+        case atTest:
+        {
+            struct Comparisons_Dict* previousComparisons = asmComparisons;
+            int previousEnd = testEndLabel;
+            if (!CreateComparisonsDict(&asmComparisons))
+            {
+                AsmTranslatorError("Unable to create the dictionnary");
+                asmComparisons = previousComparisons;
+                break;
+            }
+            testEndLabel = NewLabel();
+
+            // Fills the dictionnary with all the comparisons, then writes the branches
+            GenerateStatement(ast->child1, out);
+            GenerateStatement(ast->child2, out);
+            fprintf(out, ".Lufc%d:\n", testEndLabel);
+
+            FreeComparisonsDict(asmComparisons);
+            asmComparisons = previousComparisons;
+            testEndLabel = previousEnd;
+            break;
+        }
+        case atComparisonDeclaration:
+            Add_ComparisonsDict(&asmComparisons, ast->i, ast->comparator, ast->child1, ast->child2);
+            break;
+        case atTestIfBranch:
+        case atTestElseIfBranch:
+        {
+            int nextBranch = NewLabel();
+            GenerateConditionJump(ast->child1, nextBranch, 0, out);
+            GenerateStatement(ast->child2, out);
+            fprintf(out, "    jmp .Lufc%d\n.Lufc%d:\n", testEndLabel, nextBranch);
+            break;
+        }
+        case atTestElseBranch:
+            GenerateStatement(ast->child1, out);
+            break;
+        case atBreak:
+            GenerateInterruption(1, out);
+            break;
+        case atContinue:
+            GenerateInterruption(2, out);
+            break;
+        case atReturn:
+        {
+            if (asmFunction==NULL)
+            {
+                AsmTranslatorError("Only a training regimen can throw out a fighter");
+                break;
+            }
+
+            enum VariableType type = GenerateExpression(ast->child1, out);
+            if (type==noType)
+                break;
+            if (type!=asmFunction->variableType)
+            {
+                AsmTranslatorError("The type of the fighter thrown out doesn't match the type of the training regimen");
+                break;
+            }
+            fprintf(out, "    leave\n    ret\n");
+            break;
+        }
+        case atPrint:
+            if (ast->child1->type==atConstant && ast->child1->variableType==characters)
+            {
+                fprintf(out, "    leaq .Lufc%d+8(%%rip), %%rsi\n    movl $%zu, %%edx\n    call ufc_write\n", AddAsmStringConstant(ast->child1->s), strlen(ast->child1->s));
+                break;
+            }
+
+            switch (GenerateExpression(ast->child1, out))
+            {
+                case integer:
+                    fprintf(out, "    movl %%eax, %%edi\n    call ufc_print_int\n");
+                    break;
+                case floating:
+                    fprintf(out, "    call ufc_print_float\n");
+                    break;
+                case characters:
+                    fprintf(out, "    movq (%%rax), %%rdx\n    leaq 8(%%rax), %%rsi\n    call ufc_write\n");
+                    break;
+                default:
+                    break;
+            }
+            break;
+        case atPrintEndl:
+            fprintf(out, "    leaq ufc_characters+1(%%rip), %%rsi\n    movl $1, %%edx\n    call ufc_write\n");
+            break;
+        default:
+            AsmTranslatorError("This statement can't be written by the assembly backend (teams and the standard input are not supported)");
+            break;
+    }
+}
+
+// Writes a training regimen : its arguments are kept in the frame, at -8(%rbp) for the first one, -16(%rbp) for the second one...
+void GenerateFunction (struct AstNode* definition, FILE* out)
+{
+    asmFunction = definition;
+
+    int argCount = 0;
+    for (struct AstNode* args = definition->child2; args!=NULL && args->type==atFuncDefArgsList; args = args->child2)
+        argCount++;
+
+    fprintf(out, "ufc_f_%s:\n    pushq %%rbp\n    movq %%rsp, %%rbp\n", definition->child1->s);
+    if (argCount > 0) // The stack stays aligned on 16 bytes for the calls
+        fprintf(out, "    subq $%d, %%rsp\n", 16 * ((argCount + 1) / 2));
+
+    int generalCount = 0;
+    int floatCount = 0;
+    int index = 0;
+    for (struct AstNode* args = definition->child2; args!=NULL && args->type==atFuncDefArgsList; args = args->child2, index++)
+    {
+        enum VariableType type = args->child1->variableType;
+        if (type==floating ? floatCount==FLOAT_ARGUMENT_REGISTERS : generalCount==GENERAL_ARGUMENT_REGISTERS)
+        {
+            AsmTranslatorError("Too many arguments for the assembly backend");
+            break;
+        }
+
+        if (type==integer)
+            fprintf(out, "    movl %s, %d(%%rbp)\n", intArgumentRegisters[generalCount++], -8 * (index + 1));
+        else if (type==floating)
+            fprintf(out, "    movss %%xmm%d, %d(%%rbp)\n", floatCount++, -8 * (index + 1));
+        else
+            fprintf(out, "    movq %s, %d(%%rbp)\n", pointerArgumentRegisters[generalCount++], -8 * (index + 1));
+    }
+
+    loopConditionLabel = -1;
+    loopEndLabel = -1;
+    GenerateStatement(definition->child3, out);
+    GenerateDefaultReturn(out);
+    fprintf(out, "\n");
+
+    asmFunction = NULL;
+}
+
+// Writes a fighter of the definitions in .data
+void GenerateFighter (struct AstNode* definition, FILE* out)
+{
+    switch (definition->variableType)
+    {
+        case integer:
+            fprintf(out, "    .align 4\nufc_v_%s:\n    .long %d\n", definition->child1->s, definition->i);
+            break;
+        case floating:
+        {
+            unsigned int bits;
+            memcpy(&bits, &definition->f, sizeof(bits));
+            fprintf(out, "    .align 4\nufc_v_%s:\n    .long 0x%08x\n", definition->child1->s, bits);
+            break;
+        }
+        case characters:
+            fprintf(out, "    .align 8\nufc_v_%s:\n    .quad .Lufc%d\n", definition->child1->s, AddAsmStringConstant(definition->s));
+            break;
+        default:
+            AsmTranslatorError("The teams can't be written by the assembly backend");
+            break;
+    }
+}
+
+// Copies the content of the temporary file at the end of the output file
+void AppendFile (FILE* outFile, FILE* file)
+{
+    int tempChar;
+    fseek(file, 0, SEEK_SET);
+    while ((tempChar = fgetc(file)) != EOF)
+        fputc(tempChar, outFile);
+}
+
+int TranslateASTToAssembly (struct AstNode* ast, FILE* outFile)
+{
+    if (ast==NULL || ast->type!=atRoot)
+    {
+        AsmTranslatorError("Nothing to translate");
+        return 0;
+    }
+
+    // The code and the fighters are written in temporary files, and the constants they use in constantsFile
+    FILE* codeFile = tmpfile();
+    FILE* dataFile = tmpfile();
+    constantsFile = tmpfile();
+    if (codeFile==NULL || dataFile==NULL || constantsFile==NULL)
+    {
+        printf("Can't create the temporary files of the assembly translator\n");
+        if (codeFile!=NULL)
+            fclose(codeFile);
+        if (dataFile!=NULL)
+            fclose(dataFile);
+        if (constantsFile!=NULL)
+            fclose(constantsFile);
+        constantsFile = NULL;
+        return 0;
+    }
+
+    asmRoot = ast;
+    asmFunction = NULL;
+    asmComparisons = NULL;
+    labelCount = 0;
+    asmFailed = 0;
+
+    for (struct AstNode* statement = ast->child1; statement!=NULL && !asmFailed; statement = statement->child2)
+    {
+        struct AstNode* definition = statement->child1;
+        if (definition==NULL)
+            continue;
+
+        if (definition->type==atVariableDef)
+            GenerateFighter(definition, dataFile);
+        else if (definition->type==atFuncDef)
+            GenerateFunction(definition, codeFile);
+    }
+
+    // The main phase
+    fprintf(codeFile, "ufc_main:\n    pushq %%rbp\n    movq %%rsp, %%rbp\n");
+    loopConditionLabel = -1;
+    loopEndLabel = -1;
+    GenerateStatement(ast->child2, codeFile);
+    fprintf(codeFile, "    leave\n    ret\n");
+
+    fprintf(outFile, "# Translated from UF-C\n\n%s", asmRuntimeCode);
+    AppendFile(outFile, codeFile);
+    fprintf(outFile, "\n    .data\n");
+    AppendFile(outFile, dataFile);
+    fprintf(outFile, "\n    .section .rodata\n");
+    AppendFile(outFile, constantsFile);
+    fprintf(outFile, "\n    .section .note.GNU-stack,\"\",@progbits\n");
+
+    fclose(codeFile);
+    fclose(dataFile);
+    fclose(constantsFile);
+    constantsFile = NULL;
+    asmRoot = NULL;
+
+    return !asmFailed;
+}
@@ -0,0 +1,16 @@
+#ifndef __ASM_TRANSLATOR_H__
+#define __ASM_TRANSLATOR_H__
+
+#include <stdio.h>
+#include "../Utils/AST.h"
+
+// Translates the AST into x86-64 assembly for the GNU assembler (AT&T syntax), following the System V calling convention
+// The program needs no C compiler nor C library : its runtime (buffered output, printing of the numbers) is written in the file,
+// and it talks to Linux with system calls. It is built with
+//     as in.s -o in.o && ld in.o -o in
+// The smart and famous fighters, the training regimens, the loops, the tournaments and the ring girl are written,
+// the strings can only be given, passed and shown (not joined nor compared), and the teams and the standard input are not written.
+// Returns 1 if the whole program was written, 0 otherwise
+int TranslateASTToAssembly (struct AstNode* ast, FILE* outFile);
+
+#endif
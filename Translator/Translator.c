@@ -1,11 +1,841 @@
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
 #include "../Utils/ComparisonDictionnary.h"
+#include "../Utils/Hash.h"
+#include "../Utils/SymbolTableData.h"
+#include "../Utils/Allocator.h"
+#include "../Optimizer/Peephole.h"
+#include "../Optimizer/Inliner.h"
 #include "Translator.h"
 
+// Teams defined in the code being translated (type and size), filled before translating
+static struct HashStruct* teamTable = NULL;
+static int teamCount = 0;
+
+// Training regimens that can end with a break or a continue for the loop of their caller (with their return type), filled before translating
+// In C they set _ufcSignal (1 for a break, 2 for a continue) and return, and their callers check it
+static struct HashStruct* signalTable = NULL;
+static int signalCount = 0;
+
+// Training regimen being translated (NULL in the main phase), and number of C loops around the code being translated in it
+static struct AstNode* translatedFunction = NULL;
+static int loopDepth = 0;
+
+// Root of the code being translated, to find the type of the fighters
+static struct AstNode* translatedRoot = NULL;
+
+// Optimized output (see SetTranslatorOptimization), and the fighters given a value somewhere in the code, the others being written as const
+static int optimizeOutput = 0;
+static struct HashStruct* assignedTable = NULL;
+
+// Fighters and training regimens used by the main phase or by the regimens it calls, the only ones written in optimized mode
+static struct HashStruct* usedTable = NULL;
+
+// Largest body (in number of AST nodes) of the training regimens written as static inline in optimized mode
+#define SMALL_REGIMEN_SIZE DEFAULT_INLINE_THRESHOLD
+
+// Set when the code uses strings, so that their runtime is added to the C code, and number of string constants written
+static int usesStrings = 0;
+static int stringConstantCount = 0;
+
+// Set when the string arguments of the regimen being translated are copied at its start, and freed before it returns
+static int ownsStringArguments = 0;
+
+// Runtime of the strings of the translated code : the length and capacity of each string are stored just before its characters,
+// which always end with a '\0', so that a string is still a char* given to printf or to the regimens.
+// The constants have a capacity of 0, they are never written nor freed : assigning one of them to a fighter allocates its own string.
+// The types and macros are also the part of the runtime declared in the header of the split code
+static const char* stringRuntimeTypes =
+    "struct _ufcString { size_t length; size_t capacity; char chars[]; };\n"
+    "#define _ufcHeader(s) ((struct _ufcString*) ((s) - offsetof(struct _ufcString, chars)))\n"
+    "#define _ufcLength(s) (_ufcHeader(s)->length)\n"
+    "#define _ufcConstant(name, text) struct { size_t length; size_t capacity; char chars[sizeof(text)]; } name = { sizeof(text) - 1, 0, text }\n";
+static const char* stringRuntimeCode =
+    "static _ufcConstant(_ufcEmptyString, \"\");\n"
+    "char* _ufcStringAllocate(size_t capacity) {\n"
+    "    struct _ufcString* header = malloc(sizeof(struct _ufcString) + capacity + 1);\n"
+    "    if (header == NULL) { printf(\"Unable to allocate memory for a string\\n\"); exit(1); }\n"
+    "    header->length = 0; header->capacity = capacity; header->chars[0] = '\\0';\n"
+    "    return header->chars;\n"
+    "}\n"
+    "void _ufcStringFree(char* s) { if (s != NULL && _ufcHeader(s)->capacity != 0) free(_ufcHeader(s)); }\n"
+    "void _ufcStringReserve(char** s, size_t length) {\n"
+    "    struct _ufcString* header = _ufcHeader(*s);\n"
+    "    if (header->capacity >= length && header->capacity != 0) return;\n"
+    "    size_t capacity = 2 * header->capacity > length ? 2 * header->capacity : (length < 16 ? 16 : length);\n"
+    "    char* grown;\n"
+    "    if (header->capacity == 0) { grown = _ufcStringAllocate(capacity); memcpy(grown, *s, header->length + 1); _ufcLength(grown) = header->length; }\n"
+    "    else {\n"
+    "        header = realloc(header, sizeof(struct _ufcString) + capacity + 1);\n"
+    "        if (header == NULL) { printf(\"Unable to allocate memory for a string\\n\"); exit(1); }\n"
+    "        header->capacity = capacity; grown = header->chars;\n"
+    "    }\n"
+    "    *s = grown;\n"
+    "}\n"
+    "void _ufcStringSet(char** s, const char* chars, size_t length) {\n"
+    "    char* previous = *s;\n"
+    "    if (_ufcHeader(previous)->capacity < length || _ufcHeader(previous)->capacity == 0) *s = _ufcStringAllocate(length);\n"
+    "    memcpy(*s, chars, length); (*s)[length] = '\\0'; _ufcLength(*s) = length;\n"
+    "    if (*s != previous) _ufcStringFree(previous);\n"
+    "}\n"
+    "void _ufcStringAssign(char** s, char* value) { if (*s != value) _ufcStringSet(s, value, _ufcLength(value)); }\n"
+    "void _ufcStringAppend(char** s, char* value) {\n"
+    "    size_t length = _ufcLength(*s), added = _ufcLength(value);\n"
+    "    int self = *s == value;\n"
+    "    _ufcStringReserve(s, length + added);\n"
+    "    memcpy(*s + length, self ? *s : value, added); (*s)[length + added] = '\\0'; _ufcLength(*s) = length + added;\n"
+    "}\n"
+    "char* _ufcStringCopy(char* value) { char* s = _ufcStringAllocate(_ufcLength(value)); _ufcStringSet(&s, value, _ufcLength(value)); return s; }\n"
+    "void _ufcStringMove(char** s, char* value) { _ufcStringFree(*s); *s = value != NULL ? value : _ufcEmptyString.chars; }\n"
+    "int _ufcStringCompare(char* a, char* b) {\n"
+    "    size_t lengthA = _ufcLength(a), lengthB = _ufcLength(b);\n"
+    "    int order = memcmp(a, b, lengthA < lengthB ? lengthA : lengthB);\n"
+    "    return order != 0 ? order : (lengthA > lengthB) - (lengthA < lengthB);\n"
+    "}\n"
+    "int _ufcStringEqual(char* a, char* b) { return _ufcLength(a) == _ufcLength(b) && memcmp(a, b, _ufcLength(a)) == 0; }\n\n";
+
+// Set when a fighter enters the ring, so that the reader of the standard input is added to the C code
+static int usesInput = 0;
+
+// Reader of the standard input for the translated code, same as Utils/InputReader.c :
+// blocks of 1 MB read at once, and values parsed where they are in the block
+static const char* inputReaderCode =
+    "static char _ufcInput[(1 << 20) + 1];\n"
+    "static size_t _ufcInputStart = 0, _ufcInputEnd = 0;\n"
+    "static int _ufcInputEnded = 0;\n"
+    "#define _ufcIsSpace(c) ((c)==' ' || (c)=='\\n' || (c)=='\\t' || (c)=='\\r')\n"
+    "size_t _ufcRefillInput() {\n"
+    "    if (_ufcInputEnded) return 0;\n"
+    "    memmove(_ufcInput, _ufcInput + _ufcInputStart, _ufcInputEnd - _ufcInputStart);\n"
+    "    _ufcInputEnd -= _ufcInputStart; _ufcInputStart = 0;\n"
+    "    ssize_t count;\n"
+    "    do count = read(0, _ufcInput + _ufcInputEnd, (1 << 20) - _ufcInputEnd); while (count < 0 && errno == EINTR);\n"
+    "    if (count <= 0) { _ufcInputEnded = 1; count = 0; }\n"
+    "    _ufcInputEnd += count; _ufcInput[_ufcInputEnd] = '\\0';\n"
+    "    return count;\n"
+    "}\n"
+    "char* _ufcNextWord(size_t* length) {\n"
+    "    while (1) {\n"
+    "        while (_ufcInputStart < _ufcInputEnd && _ufcIsSpace(_ufcInput[_ufcInputStart])) _ufcInputStart++;\n"
+    "        if (_ufcInputStart < _ufcInputEnd) break;\n"
+    "        if (_ufcRefillInput() == 0) return NULL;\n"
+    "    }\n"
+    "    size_t end = _ufcInputStart;\n"
+    "    while (1) {\n"
+    "        while (end < _ufcInputEnd && !_ufcIsSpace(_ufcInput[end])) end++;\n"
+    "        if (end < _ufcInputEnd || (_ufcInputStart == 0 && _ufcInputEnd == (1 << 20))) break;\n"
+    "        size_t wordLength = end - _ufcInputStart;\n"
+    "        if (_ufcRefillInput() == 0) break;\n"
+    "        end = _ufcInputStart + wordLength;\n"
+    "    }\n"
+    "    char* word = _ufcInput + _ufcInputStart;\n"
+    "    *length = end - _ufcInputStart; _ufcInputStart = end;\n"
+    "    return word;\n"
+    "}\n"
+    "void _ufcNotANumber() { printf(\"The challenger entering the ring is not a number\\n\"); exit(1); }\n"
+    "int _ufcReadInt(int* value) {\n"
+    "    size_t length; char* word = _ufcNextWord(&length);\n"
+    "    if (word == NULL) return 0;\n"
+    "    size_t k = word[0]=='-' || word[0]=='+';\n"
+    "    if (k == length) _ufcNotANumber();\n"
+    "    unsigned int parsed = 0;\n"
+    "    for (; k < length; k++) { unsigned int digit = (unsigned char) word[k] - '0'; if (digit > 9) _ufcNotANumber(); parsed = 10 * parsed + digit; }\n"
+    "    *value = word[0]=='-' ? (int) -parsed : (int) parsed;\n"
+    "    return 1;\n"
+    "}\n"
+    "int _ufcReadFloat(float* value) {\n"
+    "    size_t length; char* word = _ufcNextWord(&length);\n"
+    "    if (word == NULL) return 0;\n"
+    "    char* end; *value = strtof(word, &end);\n"
+    "    if (end != word + length) _ufcNotANumber();\n"
+    "    return 1;\n"
+    "}\n"
+    "int _ufcReadWord(char** value) {\n"
+    "    size_t length; char* word = _ufcNextWord(&length);\n"
+    "    if (word == NULL) return 0;\n"
+    "    _ufcStringSet(value, word, length);\n"
+    "    return 1;\n"
+    "}\n"
+    "int _ufcReadInts(int* values, int count) { for (int k = 0; k < count; k++) if (!_ufcReadInt(&values[k])) return k; return count; }\n"
+    "int _ufcReadFloats(float* values, int count) { for (int k = 0; k < count; k++) if (!_ufcReadFloat(&values[k])) return k; return count; }\n\n";
+
+// Reductions of the teams (the element-wise operations are plain loops written in place)
+// The floating reductions add in 8 lanes like the vectors of TeamKernels.c, then the lanes in order, then the last values,
+// so that the translated program finds the same results as the interpreter
+static const char* teamRuntimeCode =
+    "int _ufcTeamSumInt(const int* team, int size) { int sum = 0; for (int k = 0; k < size; k++) sum += team[k]; return sum; }\n"
+    "float _ufcTeamSumFloat(const float* team, int size) {\n"
+    "    float lanes[8] = { 0 }; int k = 0;\n"
+    "    for (; k + 8 <= size; k += 8) for (int lane = 0; lane < 8; lane++) lanes[lane] += team[k + lane];\n"
+    "    float sum = 0; for (int lane = 0; lane < 8; lane++) sum += lanes[lane];\n"
+    "    for (; k < size; k++) sum += team[k];\n"
+    "    return sum;\n"
+    "}\n"
+    "int _ufcTeamDotInt(const int* a, const int* b, int size) { int sum = 0; for (int k = 0; k < size; k++) sum += a[k] * b[k]; return sum; }\n"
+    "float _ufcTeamDotFloat(const float* a, const float* b, int size) {\n"
+    "    float lanes[8] = { 0 }; int k = 0;\n"
+    "    for (; k + 8 <= size; k += 8) for (int lane = 0; lane < 8; lane++) { float product = a[k + lane] * b[k + lane]; lanes[lane] += product; }\n"
+    "    float sum = 0; for (int lane = 0; lane < 8; lane++) sum += lanes[lane];\n"
+    "    for (; k < size; k++) { float product = a[k] * b[k]; sum += product; }\n"
+    "    return sum;\n"
+    "}\n"
+    "float _ufcTeamDotMixed(const int* a, const float* b, int size) {\n"
+    "    float lanes[8] = { 0 }; int k = 0;\n"
+    "    for (; k + 8 <= size; k += 8) for (int lane = 0; lane < 8; lane++) { float product = (float) a[k + lane] * b[k + lane]; lanes[lane] += product; }\n"
+    "    float sum = 0; for (int lane = 0; lane < 8; lane++) sum += lanes[lane];\n"
+    "    for (; k < size; k++) { float product = (float) a[k] * b[k]; sum += product; }\n"
+    "    return sum;\n"
+    "}\n\n";
+
+// Functions of the runtimes called by the split code, which has them in its own unit
+static const char* runtimeDeclarations =
+    "char* _ufcStringAllocate(size_t capacity);\n"
+    "void _ufcStringFree(char* s);\n"
+    "void _ufcStringReserve(char** s, size_t length);\n"
+    "void _ufcStringSet(char** s, const char* chars, size_t length);\n"
+    "void _ufcStringAssign(char** s, char* value);\n"
+    "void _ufcStringAppend(char** s, char* value);\n"
+    "char* _ufcStringCopy(char* value);\n"
+    "void _ufcStringMove(char** s, char* value);\n"
+    "int _ufcStringCompare(char* a, char* b);\n"
+    "int _ufcStringEqual(char* a, char* b);\n"
+    "int _ufcReadInt(int* value);\n"
+    "int _ufcReadFloat(float* value);\n"
+    "int _ufcReadWord(char** value);\n"
+    "int _ufcReadInts(int* values, int count);\n"
+    "int _ufcReadFloats(float* values, int count);\n"
+    "int _ufcTeamSumInt(const int* team, int size);\n"
+    "float _ufcTeamSumFloat(const float* team, int size);\n"
+    "int _ufcTeamDotInt(const int* a, const int* b, int size);\n"
+    "float _ufcTeamDotFloat(const float* a, const float* b, int size);\n"
+    "float _ufcTeamDotMixed(const int* a, const float* b, int size);\n"
+    "extern int _ufcSignal;\n\n";
+
 void TranslatorError(char* error_msg)
 {
     printf("Error from the translator : %s\n", error_msg);
 }
 
+void SetTranslatorOptimization (int enabled)
+{
+    optimizeOutput = enabled;
+}
+
+// Returns the team fighter named by the atId node, or NULL if it is not a team
+struct VariableStruct* FindTeam (struct AstNode* idNode)
+{
+    struct VariableStruct* team;
+    if (teamTable==NULL || idNode==NULL || idNode->type!=atId || !TryFind_Hashtable(teamTable, idNode->s, &team))
+        return NULL;
+
+    return team;
+}
+
+// Adds all the teams of the definitions to teamTable, so that they are known even in the functions defined before them
+void CollectTeams (struct AstNode* definitions)
+{
+    for (struct AstNode* statement = definitions; statement!=NULL; statement = statement->child2)
+    {
+        struct AstNode* definition = statement->child1;
+        if (definition==NULL || definition->type!=atVariableDef || !IsTeamType(definition->variableType))
+            continue;
+
+        struct VariableStruct* team;
+        if (!CreateVariableStruct(&team))
+        {
+            TranslatorError("Unable to remember the team");
+            continue;
+        }
+        if ((team->id = UfcStrdup(definition->child1->s)) == NULL)
+        {
+            TranslatorError("Unable to remember the team");
+            FreeVariableStruct(team);
+            continue;
+        }
+        team->type = definition->variableType;
+        team->i = definition->i; // Number of fighters
+
+        if (Add_Hashtable(teamTable, team->id, team) != 1)
+        {
+            TranslatorError("A team with this name has already been defined");
+            FreeVariableStruct(team);
+            continue;
+        }
+
+        teamCount++;
+    }
+}
+
+// Adds to assignedTable the fighter, or the team of the fighter, named by the node given a value
+void AddAssignedFighter (struct AstNode* target)
+{
+    if (target!=NULL && target->type==atTeamElement)
+        target = target->child1;
+    if (target==NULL || target->type!=atId || TryFind_Hashtable(assignedTable, target->s, NULL))
+        return;
+
+    struct VariableStruct* fighter;
+    if (!CreateVariableStruct(&fighter))
+    {
+        TranslatorError("Unable to remember the assigned fighter");
+        return;
+    }
+    if ((fighter->id = UfcStrdup(target->s)) == NULL)
+    {
+        TranslatorError("Unable to remember the assigned fighter");
+        FreeVariableStruct(fighter);
+        return;
+    }
+
+    if (Add_Hashtable(assignedTable, fighter->id, fighter) != 1)
+        FreeVariableStruct(fighter);
+}
+
+// Adds to assignedTable the fighters given a value in this part of the code
+// An argument of a regimen with the name of a global fighter makes it assigned too, which only costs a missing const
+void CollectAssignedFighters (struct AstNode* ast)
+{
+    if (ast==NULL)
+        return;
+
+    if (ast->type==atAssignment || ast->type==atAddAssign || ast->type==atMinusAssign || ast->type==atMultiplyAssign || ast->type==atRead)
+        AddAssignedFighter(ast->child1);
+
+    CollectAssignedFighters(ast->child1);
+    CollectAssignedFighters(ast->child2);
+    CollectAssignedFighters(ast->child3);
+}
+
+// Adds the name to usedTable, returns 1 if it wasn't there yet
+int AddUsedName (char* id)
+{
+    if (TryFind_Hashtable(usedTable, id, NULL))
+        return 0;
+
+    struct VariableStruct* used;
+    if (!CreateVariableStruct(&used))
+    {
+        TranslatorError("Unable to remember the used fighter");
+        return 0;
+    }
+    if ((used->id = UfcStrdup(id)) == NULL || Add_Hashtable(usedTable, used->id, used) != 1)
+    {
+        TranslatorError("Unable to remember the used fighter");
+        FreeVariableStruct(used);
+        return 0;
+    }
+
+    return 1;
+}
+
+// Adds to usedTable the fighters and regimens used by this part of the code, and by the bodies of the regimens it calls (root is the atRoot)
+void CollectUsedNames (struct AstNode* ast, struct AstNode* root)
+{
+    if (ast==NULL)
+        return;
+
+    if (ast->type==atId)
+        AddUsedName(ast->s);
+    else if (ast->type==atFuncCall && AddUsedName(ast->child1->s))
+    {
+        for (struct AstNode* statement = root->child1; statement!=NULL; statement = statement->child2)
+        {
+            struct AstNode* definition = statement->child1;
+            if (definition!=NULL && definition->type==atFuncDef && !strcmp(definition->child1->s, ast->child1->s))
+                CollectUsedNames(definition->child3, root);
+        }
+    }
+
+    CollectUsedNames(ast->child1, root);
+    CollectUsedNames(ast->child2, root);
+    CollectUsedNames(ast->child3, root);
+}
+
+// Returns 1 if the fighter or regimen defined by the node is not written, since the optimized code never uses it
+int IsUnusedDefinition (struct AstNode* definition)
+{
+    return optimizeOutput && usedTable!=NULL && !TryFind_Hashtable(usedTable, definition->child1->s, NULL);
+}
+
+// Returns 1 if the fighter defined by the atVariableDef node is written as const
+int IsConstantFighter (struct AstNode* definition)
+{
+    return optimizeOutput && assignedTable!=NULL && !TryFind_Hashtable(assignedTable, definition->child1->s, NULL);
+}
+
+// Returns the training regimen called by the atFuncCall node if it can end with a break or a continue, NULL otherwise
+struct VariableStruct* FindSignalingFunction (struct AstNode* callNode)
+{
+    struct VariableStruct* function;
+    if (signalTable==NULL || callNode==NULL || callNode->type!=atFuncCall || !TryFind_Hashtable(signalTable, callNode->child1->s, &function))
+        return NULL;
+
+    return function;
+}
+
+// Returns 1 if this part of a body can end with a break or a continue that is not caught by one of its loops
+// (a fighter entering the ring ends the loop like a break at the end of the input)
+int CanSignal (struct AstNode* ast)
+{
+    if (ast==NULL || ast->type==atWhileLoop)
+        return 0;
+
+    if (ast->type==atBreak || ast->type==atContinue || ast->type==atRead || FindSignalingFunction(ast)!=NULL)
+        return 1;
+
+    return CanSignal(ast->child1) || CanSignal(ast->child2) || CanSignal(ast->child3);
+}
+
+// Adds to signalTable the regimens of the definitions that can end with a break or a continue, directly or through the regimens they call
+void CollectSignalingFunctions (struct AstNode* definitions)
+{
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+
+        for (struct AstNode* statement = definitions; statement!=NULL; statement = statement->child2)
+        {
+            struct AstNode* definition = statement->child1;
+            if (definition==NULL || definition->type!=atFuncDef || TryFind_Hashtable(signalTable, definition->child1->s, NULL) || !CanSignal(definition->child3))
+                continue;
+
+            struct VariableStruct* function;
+            if (!CreateVariableStruct(&function))
+            {
+                TranslatorError("Unable to remember the training regimen");
+                return;
+            }
+            if ((function->id = UfcStrdup(definition->child1->s)) == NULL)
+            {
+                TranslatorError("Unable to remember the training regimen");
+                FreeVariableStruct(function);
+                return;
+            }
+            function->type = definition->variableType; // Return type
+
+            if (Add_Hashtable(signalTable, function->id, function) != 1)
+            {
+                FreeVariableStruct(function);
+                return;
+            }
+
+            signalCount++;
+            changed = 1;
+        }
+    }
+}
+
+// Returns the return type of the training regimen named id, noType if it returns nothing or is not defined
+enum VariableType FindFunctionType (char* id)
+{
+    for (struct AstNode* statement = translatedRoot->child1; statement!=NULL; statement = statement->child2)
+    {
+        struct AstNode* definition = statement->child1;
+        if (definition!=NULL && definition->type==atFuncDef && !strcmp(definition->child1->s, id))
+            return definition->variableType;
+    }
+
+    return noType;
+}
+
+// Returns 1 if the value (atId or atConstant) is a string
+int IsStringValue (struct AstNode* ast)
+{
+    if (ast->type==atConstant)
+        return ast->variableType==characters;
+
+    return ast->type==atId && FindDefinedType(translatedRoot, translatedFunction, ast->s)==characters;
+}
+
+// Returns 1 if this part of the body of the regimen can change a string, or call a regimen that can
+// The string arguments of the regimen are then copied, since they may be the strings of the fighters being changed
+int ModifiesStrings (struct AstNode* ast)
+{
+    if (ast==NULL)
+        return 0;
+
+    if (ast->type==atFuncCall || ((ast->type==atAssignment || ast->type==atRead) && IsStringValue(ast->child1)))
+        return 1;
+
+    return ModifiesStrings(ast->child1) || ModifiesStrings(ast->child2) || ModifiesStrings(ast->child3);
+}
+
+// Writes the constant string in varFile, where it is never written nor freed, and returns its number
+int AddStringConstant (char* s, FILE* varFile)
+{
+    usesStrings = 1;
+    fprintf(varFile, "static _ufcConstant(_ufcString%d, \"%s\");\n", stringConstantCount, s!=NULL ? s : "");
+    return stringConstantCount++;
+}
+
+// Returns 1 if id is a string argument of the regimen being translated
+int IsStringArgument (char* id)
+{
+    for (struct AstNode* args = translatedFunction->child2; args!=NULL && args->type==atFuncDefArgsList; args = args->child2)
+    {
+        if (!strcmp(args->child1->child1->s, id))
+            return args->child1->variableType==characters;
+    }
+
+    return 0;
+}
+
+// Writes the frees of the string arguments copied by the regimen being translated, except kept which it gives to its caller
+void TranslateStringCleanup (FILE* currentFile, char* kept)
+{
+    if (translatedFunction==NULL || !ownsStringArguments)
+        return;
+
+    for (struct AstNode* args = translatedFunction->child2; args!=NULL && args->type==atFuncDefArgsList; args = args->child2)
+    {
+        if (args->child1->variableType==characters && (kept==NULL || strcmp(args->child1->child1->s, kept)))
+            fprintf(currentFile, "_ufcStringFree(%s); ", args->child1->child1->s);
+    }
+}
+
+// Writes the return leaving the translated regimen without value, after a break or a continue or at the end of a regimen without return
+void TranslateSignalReturn (FILE* currentFile)
+{
+    TranslateStringCleanup(currentFile, NULL);
+
+    switch (translatedFunction->variableType)
+    {
+        case integer:
+        case floating:
+            fprintf(currentFile, "return 0;");
+            break;
+        case characters:
+            fprintf(currentFile, "return NULL;");
+            break;
+        default:
+            fprintf(currentFile, "return;");
+            break;
+    }
+}
+
+// Writes what follows the call of a regimen that can end with a break or a continue :
+// the nearest loop stops or goes on with its next round, and a regimen without loop passes the signal to its own caller
+void TranslateSignalCheck (FILE* currentFile)
+{
+    if (loopDepth > 0)
+        fprintf(currentFile, "if (_ufcSignal) { int _ufcBreak = _ufcSignal == 1; _ufcSignal = 0; if (_ufcBreak) break; continue; }\n");
+    else if (translatedFunction != NULL)
+    {
+        fprintf(currentFile, "if (_ufcSignal) { ");
+        TranslateSignalReturn(currentFile);
+        fprintf(currentFile, " }\n");
+    }
+    else
+        fprintf(currentFile, "if (_ufcSignal) { printf(\"The match can only be interrupted, or a round ended, inside a loop\\n\"); return 1; }\n");
+}
+
+// Writes a break : it stops the nearest loop, or outside of a loop of the regimen, the loop of the caller
+void TranslateBreak (FILE* currentFile)
+{
+    if (loopDepth > 0)
+        fprintf(currentFile, "break;\n");
+    else if (translatedFunction != NULL)
+    {
+        fprintf(currentFile, "_ufcSignal = 1; ");
+        TranslateSignalReturn(currentFile);
+        fprintf(currentFile, "\n");
+    }
+    else
+        fprintf(currentFile, "printf(\"The match can only be interrupted, or a round ended, inside a loop\\n\"); return 1;\n"); // Same error as the interpreter, when the run gets there
+}
+
+void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile, FILE* funcFile, FILE* varFile, struct Comparisons_Dict** comparisonsDict);
+
+// Priority of the C operator written for the node, the higher binding the tighter
+int OperatorPriority (struct AstNode* ast)
+{
+    switch (ast->type)
+    {
+        case atLogicalOr:
+            return 1;
+        case atLogicalAnd:
+            return 2;
+        case atAdd:
+        case atMinus:
+            return 4;
+        case atMultiply:
+        case atDivide:
+            return 5;
+        default:
+            return 6;
+    }
+}
+
+// Writes a member of an operator, in parentheses unless the output is optimized and the priorities of C make them useless
+// The right member of an operator with the same priority keeps them, so that the order of the floating operations doesn't change
+// In a condition, the conjunctions are kept in parentheses inside the disjunctions, as gcc asks with -Wall
+void TranslateOperand (struct AstNode* operand, int priority, int isRight, FILE* currentFile, FILE* mainFile, FILE* funcFile, FILE* varFile, struct Comparisons_Dict** comparisonsDict)
+{
+    int operandPriority = OperatorPriority(operand);
+    int parentheses = operandPriority < priority || (isRight && operandPriority == priority) || (priority == 1 && operand->type==atLogicalAnd);
+
+    if (optimizeOutput && parentheses)
+        fprintf(currentFile, "(");
+    TranslateASTToFiles(operand, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+    if (optimizeOutput && parentheses)
+        fprintf(currentFile, ")");
+}
+
+// Writes an arithmetic or logical operation, in parentheses unless the output is optimized
+// The interpreter divides the second member by the first one, and so does the C code
+void TranslateOperation (struct AstNode* ast, FILE* currentFile, FILE* mainFile, FILE* funcFile, FILE* varFile, struct Comparisons_Dict** comparisonsDict)
+{
+    struct AstNode* left = ast->type==atDivide ? ast->child2 : ast->child1;
+    struct AstNode* right = ast->type==atDivide ? ast->child1 : ast->child2;
+
+    const char* operator;
+    switch (ast->type)
+    {
+        case atLogicalOr:
+            operator = optimizeOutput ? " || " : "||";
+            break;
+        case atLogicalAnd:
+            operator = optimizeOutput ? " && " : "&&";
+            break;
+        case atAdd:
+            operator = " + ";
+            break;
+        case atMinus:
+            operator = " - ";
+            break;
+        case atMultiply:
+            operator = " * ";
+            break;
+        default:
+            operator = " / ";
+            break;
+    }
+
+    int priority = OperatorPriority(ast);
+
+    if (!optimizeOutput)
+        fprintf(currentFile, "(");
+    TranslateOperand(left, priority, 0, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+    fprintf(currentFile, "%s", operator);
+    TranslateOperand(right, priority, 1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+    if (!optimizeOutput)
+        fprintf(currentFile, ")");
+}
+
+// Writes the C operator of a comparator, with spaces around it in optimized mode
+void TranslateComparator (enum ComparatorType comparator, FILE* currentFile)
+{
+    const char* operator;
+    switch (comparator)
+    {
+        case gtr:
+            operator = ">=";
+            break;
+        case str_gtr:
+            operator = ">";
+            break;
+        case neq:
+            operator = "!=";
+            break;
+        case eq:
+            operator = "==";
+            break;
+        default:
+            TranslatorError("Not a valid comparator");
+            return;
+    }
+
+    fprintf(currentFile, optimizeOutput ? " %s " : "%s", operator);
+}
+
+// Writes the value of the fighter _k of a team expression, used in the loops of the bulk team operations
+// The fighters of the teams are indexed with _k, the single fighters and constants are used as they are
+void TranslateTeamExpression (struct AstNode* ast, FILE* currentFile)
+{
+    switch (ast->type)
+    {
+        case atId:
+            fprintf(currentFile, FindTeam(ast)!=NULL ? "%s[_k]" : "%s", ast->s);
+            break;
+        case atAdd:
+        case atMinus:
+        case atMultiply:
+            fprintf(currentFile, "(");
+            TranslateTeamExpression(ast->child1, currentFile);
+            fprintf(currentFile, ast->type==atAdd ? " + " : (ast->type==atMinus ? " - " : " * "));
+            TranslateTeamExpression(ast->child2, currentFile);
+            fprintf(currentFile, ")");
+            break;
+        case atDivide: // Same order as the interpreter : the second member is divided by the first one
+            fprintf(currentFile, "(");
+            TranslateTeamExpression(ast->child2, currentFile);
+            fprintf(currentFile, " / ");
+            TranslateTeamExpression(ast->child1, currentFile);
+            fprintf(currentFile, ")");
+            break;
+        case atConstant:
+        case atTeamElement:
+        case atTeamSize:
+        case atTeamSum:
+        case atTeamDot:
+            TranslateASTToFiles(ast, currentFile, currentFile, currentFile, currentFile, NULL);
+            break;
+        default:
+            TranslatorError("This can't be given to every fighter of a team");
+            break;
+    }
+}
+
+// Writes the comparison of two values, with the string runtime if they are strings (same order as strcmp in the interpreter)
+void TranslateComparison (enum ComparatorType comparator, struct AstNode* value1, struct AstNode* value2, FILE* currentFile, FILE* mainFile, FILE* funcFile, FILE* varFile, struct Comparisons_Dict** comparisonsDict)
+{
+    if (!optimizeOutput)
+        fprintf(currentFile, "(");
+
+    if (IsStringValue(value1) || IsStringValue(value2))
+    {
+        usesStrings = 1;
+
+        // The equality first compares the lengths, the order is only needed by the other comparators
+        if (comparator==eq || comparator==neq)
+            fprintf(currentFile, comparator==eq ? "_ufcStringEqual(" : "!_ufcStringEqual(");
+        else
+            fprintf(currentFile, "_ufcStringCompare(");
+        TranslateASTToFiles(value1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+        fprintf(currentFile, ", ");
+        TranslateASTToFiles(value2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+        fprintf(currentFile, ")");
+        if (comparator!=eq && comparator!=neq)
+        {
+            TranslateComparator(comparator, currentFile);
+            fprintf(currentFile, "0");
+        }
+    }
+    else
+    {
+        TranslateASTToFiles(value1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+        TranslateComparator(comparator, currentFile);
+        TranslateASTToFiles(value2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+    }
+
+    if (!optimizeOutput)
+        fprintf(currentFile, ")");
+}
+
+// Returns the number of strings joined by the operation, 1 for a single value
+int CountJoinedStrings (struct AstNode* ast)
+{
+    if (ast->type!=atAdd)
+        return 1;
+
+    return CountJoinedStrings(ast->child1) + CountJoinedStrings(ast->child2);
+}
+
+// Fills joined with the strings joined by the operation, in order, and returns their number
+int CollectJoinedStrings (struct AstNode* ast, struct AstNode** joined)
+{
+    if (ast->type!=atAdd)
+    {
+        joined[0] = ast;
+        return 1;
+    }
+
+    int count = CollectJoinedStrings(ast->child1, joined);
+    return count + CollectJoinedStrings(ast->child2, joined + count);
+}
+
+// Writes the assignment of a string fighter (atAssignment whose child1 is the fighter)
+// The string of the fighter is reused when it is large enough, and a fighter joined with other strings grows in place
+void TranslateStringAssignment (struct AstNode* ast, FILE* currentFile, FILE* mainFile, FILE* funcFile, FILE* varFile, struct Comparisons_Dict** comparisonsDict)
+{
+    char* target = ast->child1->s;
+    struct AstNode* value = ast->child2;
+    usesStrings = 1;
+
+    switch (value->type)
+    {
+        case atFuncCall: // The regimen gives a new string, that replaces the one of the fighter unless it ended with a break or a continue
+            fprintf(currentFile, "{\nchar* _ufcValue = ");
+            TranslateASTToFiles(value, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            fprintf(currentFile, "_ufcStringMove(&%s, _ufcValue);\n}\n", target);
+            return;
+        case atId:
+        case atConstant:
+            fprintf(currentFile, "_ufcStringAssign(&%s, ", target);
+            TranslateASTToFiles(value, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            fprintf(currentFile, ");\n");
+            return;
+        case atAdd:
+            break;
+        default:
+            TranslatorError("Strings can only be joined");
+            return;
+    }
+
+    int count = CountJoinedStrings(value);
+    struct AstNode** joined = malloc(sizeof(struct AstNode*) * count);
+    if (joined==NULL)
+    {
+        TranslatorError("Unable to allocate memory for the joined strings");
+        return;
+    }
+    CollectJoinedStrings(value, joined);
+
+    // The fighter can grow in place if it is joined first, and not again after the second string (its value would have changed)
+    int inPlace = joined[0]->type==atId && !strcmp(joined[0]->s, target);
+    for (int k = 0; k < count; k++)
+    {
+        if (!IsStringValue(joined[k]))
+        {
+            TranslatorError("Only strings can be joined to a string");
+            free(joined);
+            return;
+        }
+        if (k >= 2 && joined[k]->type==atId && !strcmp(joined[k]->s, target))
+            inPlace = 0;
+    }
+
+    if (inPlace)
+    {
+        for (int k = 1; k < count; k++)
+        {
+            fprintf(currentFile, "_ufcStringAppend(&%s, ", target);
+            TranslateASTToFiles(joined[k], currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            fprintf(currentFile, ");\n");
+        }
+    }
+    else
+    {
+        // The new string is allocated once with the length of all the joined strings
+        fprintf(currentFile, "{\nchar* _ufcValue = _ufcStringAllocate(");
+        for (int k = 0; k < count; k++)
+        {
+            if (k > 0)
+                fprintf(currentFile, " + ");
+            if (joined[k]->type==atConstant)
+                fprintf(currentFile, "%zu", strlen(joined[k]->s));
+            else
+                fprintf(currentFile, "_ufcLength(%s)", joined[k]->s);
+        }
+        fprintf(currentFile, ");\n");
+
+        for (int k = 0; k < count; k++)
+        {
+            fprintf(currentFile, "_ufcStringAppend(&_ufcValue, ");
+            TranslateASTToFiles(joined[k], currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            fprintf(currentFile, ");\n");
+        }
+        fprintf(currentFile, "_ufcStringMove(&%s, _ufcValue);\n}\n", target);
+    }
+
+    free(joined);
+}
+
 void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile, FILE* funcFile, FILE* varFile, struct Comparisons_Dict** comparisonsDict)
 {
     if (ast==NULL)
@@ -26,29 +856,39 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
 
             break;
         case atLogicalOr:
-            fprintf(currentFile, "(");
-            TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, "||");
-            TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, ")");
-            break;
         case atLogicalAnd:
-            fprintf(currentFile, "(");
-            TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, "&&");
-            TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, ")");
+            TranslateOperation(ast, currentFile, mainFile, funcFile, varFile, comparisonsDict);
             break;
         case atVariableDef:
+            if (IsUnusedDefinition(ast))
+                break;
+
+            if (IsTeamType(ast->variableType)) // A team is a global array with all its fighters starting at 0
+            {
+                if (optimizeOutput)
+                    fprintf(varFile, "static ");
+                if (IsConstantFighter(ast))
+                    fprintf(varFile, "const ");
+                fprintf(varFile, ast->variableType==integerTeam ? "int " : "float ");
+                TranslateASTToFiles(ast->child1, varFile, mainFile, funcFile, varFile, comparisonsDict);
+                fprintf(varFile, "[%d] = {0};\n", ast->i);
+                break;
+            }
+
+            // A string starts on a constant written just before it
+            int constant = ast->variableType==characters ? AddStringConstant(ast->s, varFile) : 0;
+            if (optimizeOutput)
+                fprintf(varFile, "static ");
+
             switch (ast->variableType) {
                 case integer:
-                    fprintf(varFile, "int ");
+                    fprintf(varFile, IsConstantFighter(ast) ? "const int " : "int ");
                     break;
                 case floating:
-                    fprintf(varFile, "float ");
+                    fprintf(varFile, IsConstantFighter(ast) ? "const float " : "float ");
                     break;
-                case characters:
-                    fprintf(varFile, "char* ");
+                case characters: // The pointer is constant, since the string is given to regimens taking a char*
+                    fprintf(varFile, IsConstantFighter(ast) ? "char* const " : "char* ");
                     break;
                 default:
                     TranslatorError("Cannot define a variable with this type");
@@ -63,10 +903,7 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
                     fprintf(varFile, " = %f;\n", ast->f);
                     break;
                 case characters:
-                    fprintf(varFile, " = malloc( 1 + %d);\n", ast->stringLength);
-                    fprintf(varFile, "sprintf(");
-                    TranslateASTToFiles(ast->child1, varFile, mainFile, funcFile, varFile, comparisonsDict);
-                    fprintf(varFile, ", %s);\n", ast->s);
+                    fprintf(varFile, " = _ufcString%d.chars;\n", constant);
                     break;
                 default:
                     TranslatorError("Cannot define a variable with this type");
@@ -74,6 +911,11 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
             }
             break;
         case atFuncDef:
+            if (IsUnusedDefinition(ast)) // Never run, or inlined in all its callers
+                break;
+            if (optimizeOutput) // Called from this file only, and the small ones can be copied in their callers
+                fprintf(funcFile, CountNodes(ast->child3) <= SMALL_REGIMEN_SIZE ? "static inline " : "static ");
+
             switch (ast->variableType)
             {
             case integer:
@@ -96,7 +938,40 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
             fprintf(funcFile, "(");
             TranslateASTToFiles(ast->child2, funcFile, mainFile, funcFile, varFile, comparisonsDict); // Writes the type and name of the arguments
             fprintf(funcFile, ") {\n");
+            translatedFunction = ast;
+            loopDepth = 0;
+
+            // The string arguments are copied if the regimen can change strings, as the interpreter gives it copies
+            ownsStringArguments = 0;
+            for (struct AstNode* args = ast->child2; args!=NULL && args->type==atFuncDefArgsList && ModifiesStrings(ast->child3); args = args->child2)
+            {
+                if (args->child1->variableType==characters)
+                {
+                    fprintf(funcFile, "%s = _ufcStringCopy(%s);\n", args->child1->child1->s, args->child1->child1->s);
+                    ownsStringArguments = 1;
+                }
+            }
+
             TranslateASTToFiles(ast->child3, funcFile, mainFile, funcFile, varFile, comparisonsDict); // Writes the body of the function
+
+            // A regimen whose body doesn't end with a return gives 0, as its value is never set
+            {
+                struct AstNode* lastStatement = ast->child3;
+                while (lastStatement!=NULL && lastStatement->child2!=NULL)
+                    lastStatement = lastStatement->child2;
+                if (ast->variableType!=noType && (lastStatement==NULL || lastStatement->child1==NULL || lastStatement->child1->type!=atReturn))
+                {
+                    TranslateSignalReturn(funcFile);
+                    fprintf(funcFile, "\n");
+                }
+                else if (ast->variableType==noType && ownsStringArguments)
+                {
+                    TranslateStringCleanup(funcFile, NULL);
+                    fprintf(funcFile, "\n");
+                }
+            }
+            translatedFunction = NULL;
+            ownsStringArguments = 0;
             fprintf(funcFile, "}\n\n");
 
             break;        
@@ -113,6 +988,7 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
                     TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, &compDict);
                     //Writes the if/else_if/else statements using the dicionnary
                     TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, &compDict);
+                    FreeComparisonsDict(compDict);
                 }
             }
             break;
@@ -124,35 +1000,12 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
                 struct ComparisonValue *comparison;
                 if (!TryFind_ComparisonsDict(*comparisonsDict, ast->i, &comparison))
                 {
-                    char* msg;
-                    sprintf(msg, "Unable to find the comparison (match %d) in this dictionnary", ast->i);
+                    char msg[100];
+                    snprintf(msg, sizeof(msg), "Unable to find the comparison (match %d) in this dictionnary", ast->i);
                     TranslatorError(msg);
                 }
-                else
-                {
-                    fprintf(currentFile, "(");
-                    TranslateASTToFiles(comparison->value1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-                    switch (ast->comparator)
-                    {
-                        case gtr:
-                            fprintf(currentFile, ">=");
-                            break;
-                        case str_gtr:
-                            fprintf(currentFile, ">");
-                            break;
-                        case neq:
-                            fprintf(currentFile, "!=");
-                            break;
-                        case eq:
-                            fprintf(currentFile, "==");
-                            break;
-                        default:
-                            TranslatorError("Not a valid comparator");
-                            break;
-                    }
-                    TranslateASTToFiles(comparison->value2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-                    fprintf(currentFile, ")");
-                }
+                else
+                    TranslateComparison(comparison->comparator, comparison->value1, comparison->value2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
                 break;
             }
         case atTestIfBranch:
@@ -170,30 +1023,111 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
             fprintf(currentFile, "}\n");
             break;
         case atTestElseBranch:
+            // In optimized mode, an else branch only made of another tournament continues the chain of else if
+            if (optimizeOutput && ast->child1!=NULL && ast->child1->type==atStatementList && ast->child1->child2==NULL
+                && ast->child1->child1!=NULL && ast->child1->child1->type==atTest)
+            {
+                fprintf(currentFile, "else ");
+                TranslateASTToFiles(ast->child1->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+                break;
+            }
+
             fprintf(currentFile, "else {\n");
             TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
             fprintf(currentFile, "}\n");
             break;
         case atAssignment:
-            if (ast->child1->type==atVoid && ast->child2->type==atFuncCall) // then it's a call of a function without catching the return value
+            if (ast->child1->type==atVoid && ast->child2->type==atFuncCall && FindFunctionType(ast->child2->child1->s)==characters) // The string given back is not kept
+            {
+                fprintf(currentFile, "{\nchar* _ufcValue = ");
+                TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+                fprintf(currentFile, "_ufcStringFree(_ufcValue);\n}\n");
+            }
+            else if (ast->child1->type==atVoid && ast->child2->type==atFuncCall) // then it's a call of a function without catching the return value
             {
                 TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
             }
+            else if (IsStringValue(ast->child1))
+                TranslateStringAssignment(ast, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            else if (FindSignalingFunction(ast->child2)!=NULL) // The value is only assigned if the regimen didn't end with a break or a continue
+            {
+                enum VariableType type = FindSignalingFunction(ast->child2)->type;
+                fprintf(currentFile, "{\n%s _ufcValue = ", type==integer ? "int" : (type==floating ? "float" : "char*"));
+                TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+                TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+                fprintf(currentFile, " = _ufcValue;\n}\n");
+            }
+            else if (FindTeam(ast->child1)!=NULL) // Assignment to a whole team : a loop over all its fighters that the C compiler can vectorize
+            {
+                if (ast->child2->type==atFuncCall)
+                {
+                    TranslatorError("A training regimen can't be assigned to a team");
+                    break;
+                }
+
+                fprintf(currentFile, "for (int _k = 0; _k < %d; _k++) ", FindTeam(ast->child1)->i);
+                TranslateTeamExpression(ast->child1, currentFile);
+                fprintf(currentFile, " = ");
+                TranslateTeamExpression(ast->child2, currentFile);
+                fprintf(currentFile, ";\n");
+            }
             else
             {
                 TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
                 fprintf(currentFile, " = ");
                 TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
                 
-                if (ast->child2->type==atId || ast->child2->type==atConstant) // Beacause atFuncCall already adds a ';' at the end
+                if (ast->child2->type!=atFuncCall) // Beacause atFuncCall already adds a ';' at the end
                     fprintf(currentFile, ";\n");
             }
             break;
+        case atAddAssign: // In place updates made by RewriteSelfUpdates
+        case atMinusAssign:
+        case atMultiplyAssign:
+            TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            fprintf(currentFile, ast->type==atAddAssign ? " += " : (ast->type==atMinusAssign ? " -= " : " *= "));
+            TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            fprintf(currentFile, ";\n");
+            break;
+        case atRead: // At the end of the input, the nearest loop stops as with a break
+        {
+            usesInput = 1;
+
+            struct VariableStruct* team = FindTeam(ast->child1);
+            if (team!=NULL)
+                fprintf(currentFile, team->type==integerTeam ? "if (_ufcReadInts(%s, %d) < %d) " : "if (_ufcReadFloats(%s, %d) < %d) ", team->id, team->i, team->i);
+            else
+            {
+                switch (FindDefinedType(translatedRoot, translatedFunction, ast->child1->s))
+                {
+                    case integer:
+                        fprintf(currentFile, "if (!_ufcReadInt(&%s)) ", ast->child1->s);
+                        break;
+                    case floating:
+                        fprintf(currentFile, "if (!_ufcReadFloat(&%s)) ", ast->child1->s);
+                        break;
+                    case characters: // The word is copied in the string of the fighter
+                        fprintf(currentFile, "if (!_ufcReadWord(&%s)) ", ast->child1->s);
+                        break;
+                    default:
+                        TranslatorError("This fighter can't enter the ring");
+                        return;
+                }
+            }
+
+            fprintf(currentFile, "{ ");
+            TranslateBreak(currentFile);
+            fprintf(currentFile, "}\n");
+            break;
+        }
         case atFuncCall:
             TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
             fprintf(currentFile, "(");
             TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
             fprintf(currentFile, ");\n");
+
+            if (FindSignalingFunction(ast)!=NULL)
+                TranslateSignalCheck(currentFile);
             break;
         case atFuncCallArgList:
             TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
@@ -203,46 +1137,55 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
             }
             break;
         case atWhileLoop:
-            fprintf(currentFile, "while(");
+            fprintf(currentFile, optimizeOutput ? "while (" : "while(");
             TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
             fprintf(currentFile, ") {\n");
+            loopDepth++;
             TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            loopDepth--;
             fprintf(currentFile, "}\n");
             break;
         case atWhileCompare:
-            fprintf(currentFile, "(");
-            TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            switch (ast->comparator)
-            {
-            case gtr:
-                fprintf(currentFile, ">=");
-                break;
-            case str_gtr:
-                fprintf(currentFile, ">");
-                break;
-            case neq:
-                fprintf(currentFile, "!=");
-                break;
-            case eq:
-                fprintf(currentFile, "==");
-                break;
-            default:
-                TranslatorError("Not a valid comparator");
-                break;
-            }
-            TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, ")");
+            TranslateComparison(ast->comparator, ast->child1, ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
             break;
-        case atBreak:
-            fprintf(currentFile, "break;\n");
+        case atBreak: // Outside of a loop of the regimen, the break is for the loop of the caller
+            TranslateBreak(currentFile);
             break;
         case atReturn:
+            if (translatedFunction!=NULL && translatedFunction->variableType==characters)
+            {
+                // The caller gets its own string : an argument already copied is given as it is, anything else is copied
+                if (ownsStringArguments && ast->child1->type==atId && IsStringArgument(ast->child1->s))
+                {
+                    TranslateStringCleanup(currentFile, ast->child1->s);
+                    fprintf(currentFile, "return(%s);\n", ast->child1->s);
+                    break;
+                }
+
+                fprintf(currentFile, "{\nchar* _ufcResult = _ufcStringCopy(");
+                TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+                fprintf(currentFile, ");\n");
+                TranslateStringCleanup(currentFile, NULL);
+                fprintf(currentFile, "return(_ufcResult);\n}\n");
+                break;
+            }
+
+            TranslateStringCleanup(currentFile, NULL);
             fprintf(currentFile, "return(");
             TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
             fprintf(currentFile, ");\n");
             break;
         case atContinue:
-            fprintf(currentFile, "continue;\n");
+            if (loopDepth > 0)
+                fprintf(currentFile, "continue;\n");
+            else if (translatedFunction != NULL)
+            {
+                fprintf(currentFile, "_ufcSignal = 2; ");
+                TranslateSignalReturn(currentFile);
+                fprintf(currentFile, "\n");
+            }
+            else
+                fprintf(currentFile, "printf(\"The match can only be interrupted, or a round ended, inside a loop\\n\"); return 1;\n"); // Same error as the interpreter, when the run gets there
             break;
         case atId:
             fprintf(currentFile, "%s", ast->s);
@@ -284,7 +1227,7 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
                 fprintf(currentFile, "%f", ast->f);
                 break;
             case characters:
-                fprintf(currentFile, "%s", ast->s);
+                fprintf(currentFile, "_ufcString%d.chars", AddStringConstant(ast->s, varFile));
                 break;            
             default:
                 TranslatorError("Not a valid constant type");
@@ -296,37 +1239,22 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
              // Nothing to write in C
             break;
         case atAdd:
-            fprintf(currentFile, "(");
-            TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, " + ");
-            TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, ");\n");
-            break;
         case atMinus:
-            fprintf(currentFile, "(");
-            TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, " - ");
-            TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, ");\n");
-            break;
         case atMultiply:
-            fprintf(currentFile, "(");
-            TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, " * ");
-            TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, ");\n");
-            break;
         case atDivide:
-            fprintf(currentFile, "(");
-            TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, " / ");
-            TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
-            fprintf(currentFile, ");\n");
+            TranslateOperation(ast, currentFile, mainFile, funcFile, varFile, comparisonsDict);
             break;
         case atPrint:
             switch (ast->child1->type)
             {
                 case atId:
+                    if (ast->variableType==characters) // The length of the string is known
+                    {
+                        usesStrings = 1;
+                        fprintf(currentFile, "fwrite(%s, 1, _ufcLength(%s), stdout);\n", ast->child1->s, ast->child1->s);
+                        break;
+                    }
+
                     switch(ast->variableType)
                     {
                         case integer:
@@ -335,9 +1263,6 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
                         case floating:
                             fprintf(currentFile, "printf(\"%%f\",");
                         break;
-                        case characters:
-                            fprintf(currentFile, "printf(\"%%s\",");
-                        break;
                         default:
                             TranslatorError("Not a valid variable type to print");
                         break;
@@ -347,9 +1272,12 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
                     fprintf(currentFile, ");\n");
                     
                     break;
-                case atConstant:
+                case atConstant: // A string is written as it is, not as a constant of the runtime
                     fprintf(currentFile, "printf(\"");
-                    TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+                    if (ast->child1->variableType==characters)
+                        fprintf(currentFile, "%s", ast->child1->s);
+                    else
+                        TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
                     fprintf(currentFile, "\");\n");
                     break;
                 default:
@@ -360,6 +1288,52 @@ void TranslateASTToFiles (struct AstNode* ast, FILE* currentFile, FILE* mainFile
         case atPrintEndl:
             fprintf(currentFile, "printf(\"\\n\");\n");
             break;
+        case atTeamElement:
+            TranslateASTToFiles(ast->child1, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            fprintf(currentFile, "[");
+            TranslateASTToFiles(ast->child2, currentFile, mainFile, funcFile, varFile, comparisonsDict);
+            fprintf(currentFile, "]");
+            break;
+        case atTeamSize:
+            if (FindTeam(ast->child1)==NULL)
+                TranslatorError("Only a team has a size");
+            else
+                fprintf(currentFile, "%d", FindTeam(ast->child1)->i);
+            break;
+        case atTeamSum:
+            if (FindTeam(ast->child1)==NULL)
+                TranslatorError("Only a team has a strength");
+            else
+                fprintf(currentFile, "%s(%s, %d)", FindTeam(ast->child1)->type==integerTeam ? "_ufcTeamSumInt" : "_ufcTeamSumFloat", ast->child1->s, FindTeam(ast->child1)->i);
+            break;
+        case atTeamDot:
+            {
+                struct VariableStruct* team1 = FindTeam(ast->child1);
+                struct VariableStruct* team2 = FindTeam(ast->child2);
+                if (team1==NULL || team2==NULL)
+                {
+                    TranslatorError("Only two named teams can spar with each other");
+                    break;
+                }
+
+                // The helpers for mixed teams take the famous team first
+                if (team1->type==integerTeam && team2->type==integerTeam)
+                    fprintf(currentFile, "_ufcTeamDotInt(%s, %s, %d)", team1->id, team2->id, team1->i);
+                else if (team1->type==floatingTeam && team2->type==floatingTeam)
+                    fprintf(currentFile, "_ufcTeamDotFloat(%s, %s, %d)", team1->id, team2->id, team1->i);
+                else if (team1->type==integerTeam)
+                    fprintf(currentFile, "_ufcTeamDotMixed(%s, %s, %d)", team1->id, team2->id, team1->i);
+                else
+                    fprintf(currentFile, "_ufcTeamDotMixed(%s, %s, %d)", team2->id, team1->id, team1->i);
+                break;
+            }
+        case atPrintTeam:
+            if (FindTeam(ast->child1)==NULL)
+                TranslatorError("The ring girl can only show the fighters of a team");
+            else
+                fprintf(currentFile, "for (int _k = 0; _k < %d; _k++) printf(_k==0 ? \"%s\" : \" %s\", %s[_k]);\n",
+                    FindTeam(ast->child1)->i, FindTeam(ast->child1)->type==integerTeam ? "%d" : "%f", FindTeam(ast->child1)->type==integerTeam ? "%d" : "%f", ast->child1->s);
+            break;
         default:
             TranslatorError("Node not valid");
             return;
@@ -376,7 +1350,28 @@ void MergeFiles(FILE* outFile, FILE* mainFile, FILE* funcFile, FILE* varFile)
     // Adding the includes
     fprintf(outFile, "#include <stdio.h>\n");
     fprintf(outFile, "#include <stdlib.h>\n");
-    fprintf(outFile, "#include <string.h>\n\n");
+    fprintf(outFile, "#include <string.h>\n");
+    if (usesStrings || usesInput)
+        fprintf(outFile, "#include <stddef.h>\n");
+    if (usesInput)
+        fprintf(outFile, "#include <errno.h>\n#include <unistd.h>\n");
+    fprintf(outFile, "\n");
+
+    // Adding the runtime of the strings, also used by the reader of the standard input
+    if (usesStrings || usesInput)
+        fprintf(outFile, "%s%s", stringRuntimeTypes, stringRuntimeCode);
+
+    // Adding the reader of the standard input
+    if (usesInput)
+        fprintf(outFile, "%s", inputReaderCode);
+
+    // Adding the reductions of the teams
+    if (teamCount > 0)
+        fprintf(outFile, "%s", teamRuntimeCode);
+
+    // Adding the signal of the regimens ending with a break or a continue for the loop of their caller
+    if (signalCount > 0)
+        fprintf(outFile, "int _ufcSignal = 0;\n\n");
 
     // Adding the variables definitions
     fseek(varFile, 0, SEEK_SET);
@@ -401,6 +1396,60 @@ void MergeFiles(FILE* outFile, FILE* mainFile, FILE* funcFile, FILE* varFile)
     fprintf(outFile, "\nreturn 0;\n}");
 }
 
+// Fills the tables needed before translating the code of the AST, and resets what the translation finds
+void StartTranslation (struct AstNode* ast)
+{
+    // The teams must be known before translating the code that uses them
+    teamCount = 0;
+    if (!Create_Hashtable(&teamTable))
+        printf("Can't create the table of the teams\n");
+    else if (ast!=NULL && ast->type==atRoot)
+        CollectTeams(ast->child1);
+
+    // So must the regimens that can end the loop of their caller
+    signalCount = 0;
+    if (!Create_Hashtable(&signalTable))
+        printf("Can't create the table of the training regimens ending with a break or a continue\n");
+    else if (ast!=NULL && ast->type==atRoot)
+        CollectSignalingFunctions(ast->child1);
+
+    // And in optimized mode, the fighters that are assigned
+    if (optimizeOutput)
+    {
+        if (!Create_Hashtable(&assignedTable))
+            printf("Can't create the table of the assigned fighters\n");
+        else
+            CollectAssignedFighters(ast);
+
+        if (!Create_Hashtable(&usedTable))
+            printf("Can't create the table of the used fighters\n");
+        else if (ast!=NULL && ast->type==atRoot)
+            CollectUsedNames(ast->child2, ast);
+    }
+
+    translatedRoot = ast;
+    usesInput = 0;
+    usesStrings = 0;
+    stringConstantCount = 0;
+}
+
+// Frees the tables filled by StartTranslation
+void EndTranslation ()
+{
+    translatedRoot = NULL;
+
+    Free_Hashtable(teamTable);
+    teamTable = NULL;
+    Free_Hashtable(signalTable);
+    signalTable = NULL;
+    if (assignedTable!=NULL)
+        Free_Hashtable(assignedTable);
+    assignedTable = NULL;
+    if (usedTable!=NULL)
+        Free_Hashtable(usedTable);
+    usedTable = NULL;
+}
+
 int TranslateAST (struct AstNode* ast, FILE* outFile)
 {
     // We read the AST and add the functions definitions into a temporary funcFile, 
@@ -434,7 +1483,9 @@ int TranslateAST (struct AstNode* ast, FILE* outFile)
     }
 
     // Fill the mainFile, funcFile and varFile according to the AST
+    StartTranslation(ast);
     TranslateASTToFiles(ast, NULL, mainFile, funcFile, varFile, NULL);
+    EndTranslation();
 
     // Merge these 3 files into the output file with the correct syntax
     MergeFiles(outFile, mainFile, funcFile, varFile);
@@ -455,4 +1506,375 @@ int TranslateAST (struct AstNode* ast, FILE* outFile)
    
     return 1;
     
-}
\ No newline at end of file
+}
+
+/************************ Translation in several units *************************/
+
+// Returns the FNV-1a hash of the text, written at the top of each unit
+unsigned long long HashUnitText (const char* text, size_t size)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= (unsigned char) text[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// Writes the text in the file name of the directory, after a first line giving its hash (commentStart and commentEnd around it)
+// The file is left as it is when its first line already gives this hash, so that make doesn't build it again
+// Returns 1 if the file is up to date, 0 otherwise
+int WriteUnit (const char* directory, const char* name, const char* text, size_t size, const char* commentStart, const char* commentEnd)
+{
+    char hashLine[64];
+    snprintf(hashLine, sizeof(hashLine), "%sUF-C unit %016llx%s\n", commentStart, HashUnitText(text, size), commentEnd);
+
+    char* path = malloc(strlen(directory) + strlen(name) + 2);
+    if (path==NULL)
+    {
+        printf("Can't create the name of the unit %s\n", name);
+        return 0;
+    }
+    sprintf(path, "%s/%s", directory, name);
+
+    FILE* previous = fopen(path, "r");
+    if (previous!=NULL)
+    {
+        char previousLine[64];
+        int unchanged = fgets(previousLine, sizeof(previousLine), previous)!=NULL && !strcmp(previousLine, hashLine);
+        fclose(previous);
+        if (unchanged)
+        {
+            free(path);
+            return 1;
+        }
+    }
+
+    FILE* unitFile = fopen(path, "w");
+    if (unitFile==NULL)
+    {
+        printf("Can't create the unit %s\n", path);
+        free(path);
+        return 0;
+    }
+    fprintf(unitFile, "%s", hashLine);
+    fwrite(text, 1, size, unitFile);
+    fclose(unitFile);
+
+    free(path);
+    return 1;
+}
+
+// Writes the C type of the fighters or regimens of this type
+void TranslateCType (enum VariableType type, FILE* currentFile)
+{
+    switch (type)
+    {
+        case integer:
+            fprintf(currentFile, "int ");
+            break;
+        case floating:
+            fprintf(currentFile, "float ");
+            break;
+        case characters:
+            fprintf(currentFile, "char* ");
+            break;
+        case noType:
+            fprintf(currentFile, "void ");
+            break;
+        default:
+            TranslatorError("Not a valid type");
+            break;
+    }
+}
+
+// Writes in the header the declaration of the global fighter defined by the atVariableDef node
+void TranslateExternDeclaration (struct AstNode* definition, FILE* headerFile)
+{
+    if (IsTeamType(definition->variableType))
+    {
+        fprintf(headerFile, "extern %s %s[%d];\n", definition->variableType==integerTeam ? "int" : "float", definition->child1->s, definition->i);
+        return;
+    }
+
+    fprintf(headerFile, "extern ");
+    TranslateCType(definition->variableType, headerFile);
+    fprintf(headerFile, "%s;\n", definition->child1->s);
+}
+
+// Writes in the header the prototype of the training regimen defined by the atFuncDef node
+void TranslatePrototype (struct AstNode* definition, FILE* headerFile)
+{
+    TranslateCType(definition->variableType, headerFile);
+    fprintf(headerFile, "%s(", definition->child1->s);
+    TranslateASTToFiles(definition->child2, headerFile, headerFile, headerFile, headerFile, NULL); // Writes the type and name of the arguments
+    fprintf(headerFile, ");\n");
+}
+
+// Text of a unit written in memory, and compared with the file already written before it replaces it
+struct TranslationUnit
+{
+    char* text;
+    size_t size;
+    FILE* file;
+};
+
+// Returns 1 if the unit could be opened, 0 otherwise
+int OpenTranslationUnit (struct TranslationUnit* unit)
+{
+    unit->text = NULL;
+    unit->size = 0;
+    unit->file = open_memstream(&unit->text, &unit->size);
+    if (unit->file==NULL)
+    {
+        printf("Can't create a unit of the translated code\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+// Closes the unit and writes it in the file name of the directory, if it changed
+// Returns 1 if the file is up to date, 0 otherwise
+int CloseTranslationUnit (struct TranslationUnit* unit, const char* directory, const char* name)
+{
+    fclose(unit->file);
+    int written = WriteUnit(directory, name, unit->text, unit->size, "/* ", " */");
+    free(unit->text);
+
+    return written;
+}
+
+// Writes a unit made of the include of the header, the string constants and the code
+int WriteCodeUnit (const char* directory, const char* name, struct TranslationUnit* constants, struct TranslationUnit* code)
+{
+    fclose(constants->file);
+    fclose(code->file);
+
+    struct TranslationUnit unit;
+    int written = OpenTranslationUnit(&unit);
+    if (written)
+    {
+        fprintf(unit.file, "#include \"" UNITS_HEADER_NAME "\"\n\n");
+        fwrite(constants->text, 1, constants->size, unit.file);
+        if (constants->size > 0)
+            fprintf(unit.file, "\n");
+        fwrite(code->text, 1, code->size, unit.file);
+        written = CloseTranslationUnit(&unit, directory, name);
+    }
+
+    free(constants->text);
+    free(code->text);
+    return written;
+}
+
+int CompareUnitNames (const void* name1, const void* name2)
+{
+    return strcmp(*(char* const*) name1, *(char* const*) name2);
+}
+
+// Removes the units (and their objects) of the regimens that are not in the program anymore
+// names are the names of the regimens, sorted
+void RemoveStaleUnits (const char* directory, char** names, int nameCount)
+{
+    DIR* dir = opendir(directory);
+    if (dir==NULL)
+        return;
+
+    size_t prefixLength = strlen(REGIMEN_UNIT_PREFIX);
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        size_t length = strlen(entry->d_name);
+        if (length < prefixLength + 3 || strncmp(entry->d_name, REGIMEN_UNIT_PREFIX, prefixLength)
+            || entry->d_name[length - 2]!='.' || (entry->d_name[length - 1]!='c' && entry->d_name[length - 1]!='o'))
+            continue;
+
+        char name[sizeof(entry->d_name)];
+        memcpy(name, entry->d_name + prefixLength, length - prefixLength - 2);
+        name[length - prefixLength - 2] = '\0';
+        char* key = name;
+        if (bsearch(&key, names, nameCount, sizeof(char*), CompareUnitNames) != NULL)
+            continue;
+
+        char path[strlen(directory) + length + 2];
+        sprintf(path, "%s/%s", directory, entry->d_name);
+        if (remove(path))
+            printf("Can't delete the old unit %s\n", path);
+    }
+
+    closedir(dir);
+}
+
+// Writes the Makefile building the program from all the units, with the objects of the regimens (sorted names)
+int WriteUnitsMakefile (const char* directory, const char* programName, char** names, int nameCount)
+{
+    char* text = NULL;
+    size_t size = 0;
+    FILE* makefile = open_memstream(&text, &size);
+    if (makefile==NULL)
+    {
+        printf("Can't create the Makefile of the units\n");
+        return 0;
+    }
+
+    fprintf(makefile, "# Built with make -j, only the units that changed since the last build are compiled again\n\n");
+    fprintf(makefile, "CFLAGS = -O2\n");
+    fprintf(makefile, "PROGRAM = %s\n", programName);
+    fprintf(makefile, "OBJECTS = " RUNTIME_UNIT_NAME ".o " GLOBALS_UNIT_NAME ".o " MAIN_UNIT_NAME ".o");
+    for (int i = 0; i < nameCount; i++)
+        fprintf(makefile, " \\\n\t" REGIMEN_UNIT_PREFIX "%s.o", names[i]);
+    fprintf(makefile, "\n\n");
+
+    fprintf(makefile, "$(PROGRAM): $(OBJECTS)\n\t$(CC) $(CFLAGS) $(OBJECTS) -o $(PROGRAM)\n\n");
+    // The runtime doesn't include the header
+    fprintf(makefile, RUNTIME_UNIT_NAME ".o: " RUNTIME_UNIT_NAME ".c\n\t$(CC) $(CFLAGS) -c $< -o $@\n\n");
+    fprintf(makefile, "%%.o: %%.c " UNITS_HEADER_NAME "\n\t$(CC) $(CFLAGS) -c $< -o $@\n\n");
+    fprintf(makefile, "clean:\n\trm -f $(OBJECTS) $(PROGRAM)\n\n.PHONY: clean\n");
+    fclose(makefile);
+
+    int written = WriteUnit(directory, "Makefile", text, size, "# ", "");
+    free(text);
+    return written;
+}
+
+int TranslateASTToUnits (struct AstNode* ast, const char* directory, const char* programName)
+{
+    if (ast==NULL || ast->type!=atRoot)
+    {
+        printf("Nothing to translate\n");
+        return 0;
+    }
+
+    if (optimizeOutput)
+    {
+        printf("The optimized C can't be split in units, its regimens and fighters are static\n");
+        return 0;
+    }
+
+    if (mkdir(directory, 0777) && errno!=EEXIST)
+    {
+        printf("Can't create the directory %s\n", directory);
+        return 0;
+    }
+
+    // Names of the regimens, for the Makefile and to find the units to remove
+    int nameCount = 0;
+    for (struct AstNode* statement = ast->child1; statement!=NULL; statement = statement->child2)
+        if (statement->child1!=NULL && statement->child1->type==atFuncDef)
+            nameCount++;
+    char** names = malloc(sizeof(char*) * (nameCount + 1));
+    if (names==NULL)
+    {
+        printf("Unable to allocate memory for the names of the units\n");
+        return 0;
+    }
+
+    struct TranslationUnit header, globals, globalConstants;
+    if (!OpenTranslationUnit(&header) || !OpenTranslationUnit(&globals) || !OpenTranslationUnit(&globalConstants))
+    {
+        free(names);
+        return 0;
+    }
+
+    StartTranslation(ast);
+    int written = 1;
+    nameCount = 0;
+
+    // Each regimen is written in its own unit, with its own string constants numbered from 0,
+    // so that the units of the other regimens don't change when one of them gets a new constant
+    for (struct AstNode* statement = ast->child1; statement!=NULL && written; statement = statement->child2)
+    {
+        struct AstNode* definition = statement->child1;
+        if (definition==NULL)
+            continue;
+
+        if (definition->type==atVariableDef)
+        {
+            TranslateASTToFiles(definition, globals.file, globals.file, globals.file, globalConstants.file, NULL);
+            TranslateExternDeclaration(definition, header.file);
+            continue;
+        }
+
+        struct TranslationUnit constants, code;
+        if (!OpenTranslationUnit(&constants) || !OpenTranslationUnit(&code))
+        {
+            written = 0;
+            break;
+        }
+
+        int constantCount = stringConstantCount;
+        stringConstantCount = 0;
+        TranslateASTToFiles(definition, code.file, code.file, code.file, constants.file, NULL);
+        stringConstantCount = constantCount;
+        TranslatePrototype(definition, header.file);
+
+        char* name = definition->child1->s;
+        char unitName[strlen(REGIMEN_UNIT_PREFIX) + strlen(name) + 3];
+        sprintf(unitName, REGIMEN_UNIT_PREFIX "%s.c", name);
+        written = WriteCodeUnit(directory, unitName, &constants, &code);
+        names[nameCount++] = name;
+    }
+
+    // The main phase
+    struct TranslationUnit constants, code;
+    if (written && OpenTranslationUnit(&constants) && OpenTranslationUnit(&code))
+    {
+        stringConstantCount = 0;
+        fprintf(code.file, "int main(int argc, char* argv[]) {\n");
+        TranslateASTToFiles(ast->child2, code.file, code.file, NULL, constants.file, NULL);
+        fprintf(code.file, "\nreturn 0;\n}\n");
+        written = WriteCodeUnit(directory, MAIN_UNIT_NAME ".c", &constants, &code);
+    }
+    else
+        written = 0;
+
+    EndTranslation();
+
+    // The fighters, after their string constants
+    fclose(globals.file);
+    fclose(globalConstants.file);
+    if (written && OpenTranslationUnit(&code))
+    {
+        fprintf(code.file, "#include \"" UNITS_HEADER_NAME "\"\n\n");
+        fwrite(globalConstants.text, 1, globalConstants.size, code.file);
+        fwrite(globals.text, 1, globals.size, code.file);
+        written = CloseTranslationUnit(&code, directory, GLOBALS_UNIT_NAME ".c");
+    }
+    free(globals.text);
+    free(globalConstants.text);
+
+    // The header, with all the runtime declared since the units using it aren't known in advance
+    fclose(header.file);
+    if (written && OpenTranslationUnit(&code))
+    {
+        fprintf(code.file, "#ifndef __UFC_UNITS_H__\n#define __UFC_UNITS_H__\n\n");
+        fprintf(code.file, "#include <stdio.h>\n#include <stdlib.h>\n#include <string.h>\n#include <stddef.h>\n\n");
+        fprintf(code.file, "%s%s", stringRuntimeTypes, runtimeDeclarations);
+        fwrite(header.text, 1, header.size, code.file);
+        fprintf(code.file, "\n#endif\n");
+        written = CloseTranslationUnit(&code, directory, UNITS_HEADER_NAME);
+    }
+    free(header.text);
+
+    // The runtime, the same for every program
+    if (written && OpenTranslationUnit(&code))
+    {
+        fprintf(code.file, "#include <stdio.h>\n#include <stdlib.h>\n#include <string.h>\n#include <stddef.h>\n#include <errno.h>\n#include <unistd.h>\n\n");
+        fprintf(code.file, "%s%s%s%s", stringRuntimeTypes, stringRuntimeCode, inputReaderCode, teamRuntimeCode);
+        fprintf(code.file, "int _ufcSignal = 0;\n");
+        written = CloseTranslationUnit(&code, directory, RUNTIME_UNIT_NAME ".c");
+    }
+
+    if (written)
+    {
+        qsort(names, nameCount, sizeof(char*), CompareUnitNames);
+        written = WriteUnitsMakefile(directory, programName, names, nameCount);
+        RemoveStaleUnits(directory, names, nameCount);
+    }
+
+    free(names);
+    return written;
+}
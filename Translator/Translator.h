@@ -5,9 +5,28 @@
 #define FUNC_TEMP_NAME "_funcTemp"
 #define MAIN_TEMP_NAME "_mainTemp"
 
+// Files written by TranslateASTToUnits, the units of the regimens being named after them (regimen_Name.c)
+#define UNITS_HEADER_NAME "ufc.h"
+#define RUNTIME_UNIT_NAME "runtime"
+#define GLOBALS_UNIT_NAME "globals"
+#define MAIN_UNIT_NAME "main"
+#define REGIMEN_UNIT_PREFIX "regimen_"
+
 #include <stdio.h>
 #include "../Utils/AST.h"
 
+// Sets whether TranslateAST writes optimized C (disabled by default) : static functions and fighters, const fighters when they are never assigned,
+// static inline small training regimens, and expressions and conditions without the parentheses that the priorities of C make useless
+void SetTranslatorOptimization (int enabled);
+
 int TranslateAST (struct AstNode* ast, FILE* outFile);
 
+// Translates the AST into several C files written in directory (created if needed), so that a change in one regimen
+// only compiles that regimen again : a header declaring the fighters, the regimens and the runtime, one unit per regimen,
+// units for the fighters, the main phase and the runtime, and a Makefile building programName from them with make -j.
+// The first line of each file gives the hash of its content, and a file whose hash didn't change is not written again,
+// so make doesn't compile it again. The units of the regimens removed from the program are deleted.
+// Can't be used with the optimized C. Returns 1 if all the files were written, 0 otherwise
+int TranslateASTToUnits (struct AstNode* ast, const char* directory, const char* programName);
+
 #endif
\ No newline at end of file
@@ -1,10 +1,12 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "AST.h"
+#include "Allocator.h"
 
 struct AstNode* CreateBasicNode (enum AstType _type, struct AstNode* _child1, struct AstNode* _child2, struct AstNode* _child3, const int lineNum)
 {
-    struct AstNode* node = (struct AstNode*) malloc(sizeof (struct AstNode));
+    struct AstNode* node = (struct AstNode*) UfcMalloc(sizeof (struct AstNode));
     if (node==NULL)
     {
         printf("Memory error : cannot allocate memory to a new AST node\n");
@@ -12,12 +14,23 @@ struct AstNode* CreateBasicNode (enum AstType _type, struct AstNode* _child1, st
     }
 
     node->type = _type;
+    node->comparator = gtr;
+    node->variableType = noType;
+
+    node->stringLength = 0;
+    node->s = NULL;
+    node->i = 0;
+    node->f = 0;
+
     node->child1 = _child1;
     node->child2 = _child2;
     node->child3 = _child3;
 
     node->lineNumInCode = lineNum;
 
+    node->evaluationCount = 0;
+    node->trueCount = 0;
+
     return node;
 }
 
@@ -29,6 +42,36 @@ struct AstNode* CreateWhileNode (enum ComparatorType _comparator, struct AstNode
     return CreateBasicNode(atWhileLoop, conditionNode, _whileBranch, NULL, lineNum);
 }
 
+int ContainsNodeType (struct AstNode* ast, enum AstType nodeType)
+{
+    if (ast == NULL)
+        return 0;
+
+    return ast->type == nodeType || ContainsNodeType(ast->child1, nodeType) || ContainsNodeType(ast->child2, nodeType) || ContainsNodeType(ast->child3, nodeType);
+}
+
+struct AstNode* CopyAST (struct AstNode* ast)
+{
+    if (ast == NULL)
+        return NULL;
+
+    struct AstNode* node = CreateBasicNode(ast->type, CopyAST(ast->child1), CopyAST(ast->child2), CopyAST(ast->child3), ast->lineNumInCode);
+
+    node->comparator = ast->comparator;
+    node->variableType = ast->variableType;
+    node->stringLength = ast->stringLength;
+    node->i = ast->i;
+    node->f = ast->f;
+
+    if (ast->s != NULL && (node->s = UfcStrdup(ast->s)) == NULL)
+    {
+        printf("Memory error : cannot allocate memory to copy the string of an AST node\n");
+        exit(1);
+    }
+
+    return node;
+}
+
 void FreeAST (struct AstNode* ast)
 {
     if (ast == NULL)
@@ -39,7 +82,24 @@ void FreeAST (struct AstNode* ast)
     FreeAST(ast->child3);
 
     if (ast->s != NULL)
-        free(ast->s);
+        UfcFree(ast->s);
     
-    free(ast);
-}
\ No newline at end of file
+    UfcFree(ast);
+}
+const char* GetNodeTypeName (enum AstType type)
+{
+    // In the order of enum AstType
+    static const char* names[] = {
+        "atRoot",
+        "atStatementList", "atLogicalOr", "atLogicalAnd",
+        "atVariableDef", "atFuncDef",
+        "atTest", "atComparisonDeclaration", "atComparisonId", "atTestIfBranch", "atTestElseIfBranch", "atTestElseBranch",
+        "atAssignment", "atFuncCall", "atFuncCallArgList", "atWhileLoop", "atWhileCompare", "atBreak", "atReturn", "atContinue",
+        "atId", "atFuncDefArgsList", "atFuncDefArg", "atConstant", "atVoid",
+        "atAdd", "atMinus", "atMultiply", "atDivide", "atPrint", "atPrintEndl",
+        "atTeamElement", "atTeamSize", "atTeamSum", "atTeamDot", "atPrintTeam",
+        "atAddAssign", "atMinusAssign", "atMultiplyAssign", "atRead"
+    };
+
+    return (unsigned) type < sizeof(names) / sizeof(names[0]) ? names[type] : "unknown node";
+}
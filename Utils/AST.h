@@ -11,7 +11,9 @@ enum AstType
     atTest, atComparisonDeclaration, atComparisonId, atTestIfBranch, atTestElseIfBranch, atTestElseBranch,
     atAssignment, atFuncCall, atFuncCallArgList, atWhileLoop, atWhileCompare, atBreak, atReturn, atContinue,
     atId, atFuncDefArgsList, atFuncDefArg, atConstant, atVoid,
-    atAdd, atMinus, atMultiply, atDivide, atPrint, atPrintEndl
+    atAdd, atMinus, atMultiply, atDivide, atPrint, atPrintEndl,
+    atTeamElement, atTeamSize, atTeamSum, atTeamDot, atPrintTeam,
+    atAddAssign, atMinusAssign, atMultiplyAssign, atRead
 };
 
 enum ComparatorType
@@ -21,9 +23,11 @@ enum ComparatorType
 
 enum VariableType
 {
-    integer, floating, characters, noType
+    integer, floating, characters, integerTeam, floatingTeam, noType
 };
 
+#define IsTeamType(type) ((type)==integerTeam || (type)==floatingTeam)
+
 struct AstNode
 {
     enum AstType type;
@@ -35,6 +39,10 @@ struct AstNode
 
     int lineNumInCode;
 
+    // Number of times a condition of a tournament was evaluated, and found true (see BranchProfile.h)
+    unsigned long evaluationCount;
+    unsigned long trueCount;
+
     struct AstNode *child1;
     struct AstNode *child2;
     struct AstNode *child3;
@@ -44,6 +52,15 @@ struct AstNode* CreateBasicNode (enum AstType _type, struct AstNode* _child1, st
 
 struct AstNode* CreateWhileNode (enum ComparatorType _comparator, struct AstNode* _var1, struct AstNode* _var2, struct AstNode* _whileBranch, const int lineNum);
 
+// Returns 1 if the node or one of its children has the type nodeType
+int ContainsNodeType (struct AstNode* ast, enum AstType nodeType);
+
+// Copies the node and all its children (the strings are copied too)
+struct AstNode* CopyAST (struct AstNode* ast);
+
 void FreeAST (struct AstNode* ast);
 
+// Returns the name of the type of node (its name in enum AstType)
+const char* GetNodeTypeName (enum AstType type);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,470 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#include "Allocator.h"
+
+void* LibraryAllocate (size_t size, size_t alignment, const char* file, int line, void* userData) {
+    if (alignment == 0)
+        return malloc(size);
+
+    // aligned_alloc needs a size multiple of the alignment
+    return aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+}
+
+void* LibraryReallocate (void* pointer, size_t size, const char* file, int line, void* userData) {
+    return realloc(pointer, size);
+}
+
+void LibraryRelease (void* pointer, void* userData) {
+    free(pointer);
+}
+
+// Allocator used by the macros, the C library unless SetAllocator replaced it
+static struct Allocator currentAllocator = { LibraryAllocate, LibraryReallocate, LibraryRelease, NULL };
+
+void SetAllocator(const struct Allocator* allocator) {
+    if (allocator != NULL)
+        currentAllocator = *allocator;
+    else
+        currentAllocator = (struct Allocator) { LibraryAllocate, LibraryReallocate, LibraryRelease, NULL };
+}
+
+void* UfcAllocate(size_t size, size_t alignment, const char* file, int line) {
+    return currentAllocator.allocate(size, alignment, file, line, currentAllocator.userData);
+}
+
+void* UfcAllocateZeroed(size_t count, size_t size, const char* file, int line) {
+    if (size != 0 && count > SIZE_MAX / size)
+        return NULL;
+
+    void* pointer = currentAllocator.allocate(count * size, 0, file, line, currentAllocator.userData);
+    if (pointer != NULL)
+        memset(pointer, 0, count * size);
+
+    return pointer;
+}
+
+void* UfcReallocate(void* pointer, size_t size, const char* file, int line) {
+    return currentAllocator.reallocate(pointer, size, file, line, currentAllocator.userData);
+}
+
+char* UfcDuplicate(const char* string, const char* file, int line) {
+    size_t length = strlen(string) + 1;
+
+    char* copy = currentAllocator.allocate(length, 0, file, line, currentAllocator.userData);
+    if (copy != NULL)
+        memcpy(copy, string, length);
+
+    return copy;
+}
+
+void UfcRelease(void* pointer) {
+    currentAllocator.release(pointer, currentAllocator.userData);
+}
+
+/*************************** Tracking allocator ***************************/
+
+// Place in the code that allocates memory
+struct AllocationSite {
+    const char* file; // NULL for an empty slot of the table
+    int line;
+
+    size_t liveBytes;
+    size_t liveCount;
+    unsigned long allocationCount;
+};
+
+// Memory allocated and not released yet
+struct TrackedBlock {
+    void* pointer; // NULL for an empty slot of the table
+    size_t size;
+    struct AllocationSite* site;
+    // Budget of the run that allocated it, given back the size when it is released
+    struct MemoryBudget* budget;
+};
+
+// The blocks and the sites are kept in tables with open addressing (linear probing), whose capacity is a power of 2
+// and that are never more than half full. Their own memory is allocated by the C library and not counted.
+struct AllocationTracker {
+    pthread_mutex_t lock;
+
+    struct TrackedBlock* blocks;
+    size_t blockCapacity;
+    size_t blockCount;
+
+    struct AllocationSite** sites;
+    size_t siteCapacity;
+    size_t siteCount;
+
+    size_t liveBytes;
+    size_t peakBytes;
+    unsigned long allocationCount;
+
+    size_t memoryLimit;
+};
+
+static struct AllocationTracker tracker = { .lock = PTHREAD_MUTEX_INITIALIZER };
+static int trackingEnabled = 0;
+
+// Budget of the memory allocated outside of the runs, and of the thread running one (NULL outside of the runs)
+static struct MemoryBudget processBudget;
+static _Thread_local struct MemoryBudget* currentBudget = NULL;
+
+size_t HashPointer (const void* pointer) {
+    uint64_t hash = (uintptr_t) pointer;
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+
+    return (size_t) hash;
+}
+
+// Gives the site of the file and line, adding it if it is new
+// Returns NULL if there is not enough memory
+struct AllocationSite* FindAllocationSite (const char* file, int line) {
+    // The file names are the __FILE__ of the macros, so the same file always gives the same pointer
+    if (2 * (tracker.siteCount + 1) > tracker.siteCapacity) {
+        size_t newCapacity = tracker.siteCapacity == 0 ? 256 : 2 * tracker.siteCapacity;
+        struct AllocationSite** newSites = calloc(newCapacity, sizeof(struct AllocationSite*));
+        if (newSites == NULL)
+            return NULL;
+
+        for (size_t i = 0; i < tracker.siteCapacity; i++) {
+            struct AllocationSite* site = tracker.sites[i];
+            if (site == NULL)
+                continue;
+
+            size_t k = (HashPointer(site->file) + site->line) & (newCapacity - 1);
+            while (newSites[k] != NULL)
+                k = (k + 1) & (newCapacity - 1);
+            newSites[k] = site;
+        }
+
+        free(tracker.sites);
+        tracker.sites = newSites;
+        tracker.siteCapacity = newCapacity;
+    }
+
+    size_t k = (HashPointer(file) + line) & (tracker.siteCapacity - 1);
+    for (; tracker.sites[k] != NULL; k = (k + 1) & (tracker.siteCapacity - 1)) {
+        if (tracker.sites[k]->file == file && tracker.sites[k]->line == line)
+            return tracker.sites[k];
+    }
+
+    struct AllocationSite* site = calloc(1, sizeof(struct AllocationSite));
+    if (site == NULL)
+        return NULL;
+    site->file = file;
+    site->line = line;
+
+    tracker.sites[k] = site;
+    tracker.siteCount++;
+
+    return site;
+}
+
+// Gives the slot of the block of the pointer, or NULL if it isn't tracked (allocated by the C library)
+struct TrackedBlock* FindTrackedBlock (const void* pointer) {
+    if (tracker.blockCapacity == 0)
+        return NULL;
+
+    for (size_t k = HashPointer(pointer) & (tracker.blockCapacity - 1); tracker.blocks[k].pointer != NULL; k = (k + 1) & (tracker.blockCapacity - 1)) {
+        if (tracker.blocks[k].pointer == pointer)
+            return &tracker.blocks[k];
+    }
+
+    return NULL;
+}
+
+// Empties the slot of a block, moving back the blocks after it that can't be found anymore across the hole
+void RemoveTrackedBlock (struct TrackedBlock* block) {
+    block->site->liveBytes -= block->size;
+    block->site->liveCount--;
+    block->budget->liveBytes -= block->size;
+    tracker.liveBytes -= block->size;
+    tracker.blockCount--;
+
+    size_t mask = tracker.blockCapacity - 1;
+    size_t hole = block - tracker.blocks;
+    for (size_t k = (hole + 1) & mask; tracker.blocks[k].pointer != NULL; k = (k + 1) & mask) {
+        // A block can fill the hole if its home slot isn't between the hole and its slot
+        size_t home = HashPointer(tracker.blocks[k].pointer) & mask;
+        if (((k - home) & mask) >= ((k - hole) & mask)) {
+            tracker.blocks[hole] = tracker.blocks[k];
+            hole = k;
+        }
+    }
+
+    tracker.blocks[hole].pointer = NULL;
+}
+
+// Returns 1 if the table has room for one more block, 0 if there is not enough memory
+int ReserveTrackedBlock () {
+    if (2 * (tracker.blockCount + 1) <= tracker.blockCapacity)
+        return 1;
+
+    size_t newCapacity = tracker.blockCapacity == 0 ? 4096 : 2 * tracker.blockCapacity;
+    struct TrackedBlock* newBlocks = calloc(newCapacity, sizeof(struct TrackedBlock));
+    if (newBlocks == NULL)
+        return 0;
+
+    for (size_t i = 0; i < tracker.blockCapacity; i++) {
+        if (tracker.blocks[i].pointer == NULL)
+            continue;
+
+        size_t k = HashPointer(tracker.blocks[i].pointer) & (newCapacity - 1);
+        while (newBlocks[k].pointer != NULL)
+            k = (k + 1) & (newCapacity - 1);
+        newBlocks[k] = tracker.blocks[i];
+    }
+
+    free(tracker.blocks);
+    tracker.blocks = newBlocks;
+    tracker.blockCapacity = newCapacity;
+
+    return 1;
+}
+
+// Puts a block in its slot, which was reserved, and counts its bytes as in use
+void InsertTrackedBlock (struct TrackedBlock block) {
+    // A block released with free instead of UfcFree left its address in the table, where the C library gave it again
+    struct TrackedBlock* stale = FindTrackedBlock(block.pointer);
+    if (stale != NULL)
+        RemoveTrackedBlock(stale);
+
+    size_t k = HashPointer(block.pointer) & (tracker.blockCapacity - 1);
+    while (tracker.blocks[k].pointer != NULL)
+        k = (k + 1) & (tracker.blockCapacity - 1);
+    tracker.blocks[k] = block;
+    tracker.blockCount++;
+
+    block.site->liveBytes += block.size;
+    block.site->liveCount++;
+    block.budget->liveBytes += block.size;
+
+    tracker.liveBytes += block.size;
+    if (tracker.liveBytes > tracker.peakBytes)
+        tracker.peakBytes = tracker.liveBytes;
+}
+
+// Adds a new block, whose slot was reserved
+void AddTrackedBlock (void* pointer, size_t size, struct AllocationSite* site, struct MemoryBudget* budget) {
+    InsertTrackedBlock((struct TrackedBlock) { .pointer = pointer, .size = size, .site = site, .budget = budget });
+
+    site->allocationCount++;
+    tracker.allocationCount++;
+}
+
+int CompareSitesByLiveBytes (const void* a, const void* b) {
+    const struct AllocationSite* siteA = *(struct AllocationSite* const*) a;
+    const struct AllocationSite* siteB = *(struct AllocationSite* const*) b;
+
+    if (siteA->liveBytes != siteB->liveBytes)
+        return siteA->liveBytes < siteB->liveBytes ? 1 : -1;
+    return siteA->line - siteB->line;
+}
+
+// Same as PrintAllocationReport, with the lock of the tracker taken
+void PrintAllocationReportLocked (FILE* output) {
+    fprintf(output, "Memory : %zu bytes in use in %zu blocks, peak of %zu bytes, %lu allocations\n",
+        tracker.liveBytes, tracker.blockCount, tracker.peakBytes, tracker.allocationCount);
+    if (tracker.blockCount == 0)
+        return;
+
+    struct AllocationSite** liveSites = malloc(sizeof(struct AllocationSite*) * tracker.siteCount);
+    if (liveSites == NULL)
+        return;
+
+    int liveSiteCount = 0;
+    for (size_t i = 0; i < tracker.siteCapacity; i++) {
+        if (tracker.sites[i] != NULL && tracker.sites[i]->liveCount > 0)
+            liveSites[liveSiteCount++] = tracker.sites[i];
+    }
+    qsort(liveSites, liveSiteCount, sizeof(struct AllocationSite*), CompareSitesByLiveBytes);
+
+    for (int i = 0; i < liveSiteCount && i < ALLOCATION_REPORT_SITES; i++) {
+        fprintf(output, "    %zu bytes in %zu blocks allocated at %s:%d (%lu allocations there)\n",
+            liveSites[i]->liveBytes, liveSites[i]->liveCount, liveSites[i]->file, liveSites[i]->line, liveSites[i]->allocationCount);
+    }
+    if (liveSiteCount > ALLOCATION_REPORT_SITES)
+        fprintf(output, "    and %d more places\n", liveSiteCount - ALLOCATION_REPORT_SITES);
+
+    free(liveSites);
+}
+
+void PrintAllocationReport(FILE* output) {
+    pthread_mutex_lock(&tracker.lock);
+    PrintAllocationReportLocked(output);
+    pthread_mutex_unlock(&tracker.lock);
+}
+
+struct MemoryBudget* GetChargedBudget () {
+    return currentBudget != NULL ? currentBudget : &processBudget;
+}
+
+// Returns 1 if size more bytes would make the budget go over the memory limit, and then remembers the first allocation that did
+// Called with the lock of the tracker taken
+int IsOverBudget (struct MemoryBudget* budget, size_t size, const char* file, int line) {
+    if (tracker.memoryLimit == 0 || (budget->liveBytes <= tracker.memoryLimit && size <= tracker.memoryLimit - budget->liveBytes))
+        return 0;
+
+    if (!budget->exceeded) {
+        budget->exceeded = 1;
+        budget->exceededSize = size;
+        budget->exceededFile = file;
+        budget->exceededLine = line;
+    }
+    return 1;
+}
+
+void* TrackingAllocate (size_t size, size_t alignment, const char* file, int line, void* userData) {
+    pthread_mutex_lock(&tracker.lock);
+
+    struct MemoryBudget* budget = GetChargedBudget();
+    void* pointer = NULL;
+    if (!IsOverBudget(budget, size, file, line)) {
+        struct AllocationSite* site = FindAllocationSite(file, line);
+        if (site != NULL && ReserveTrackedBlock())
+            pointer = LibraryAllocate(size, alignment, file, line, NULL);
+        if (pointer != NULL)
+            AddTrackedBlock(pointer, size, site, budget);
+    }
+
+    pthread_mutex_unlock(&tracker.lock);
+    return pointer;
+}
+
+void* TrackingReallocate (void* pointer, size_t size, const char* file, int line, void* userData) {
+    pthread_mutex_lock(&tracker.lock);
+
+    // A block keeps the budget of the run that allocated it
+    struct TrackedBlock* block = pointer != NULL ? FindTrackedBlock(pointer) : NULL;
+    struct MemoryBudget* budget = block != NULL ? block->budget : GetChargedBudget();
+    size_t oldSize = block != NULL ? block->size : 0;
+    if (size > oldSize && IsOverBudget(budget, size - oldSize, file, line)) {
+        pthread_mutex_unlock(&tracker.lock);
+        return NULL;
+    }
+
+    struct AllocationSite* site = FindAllocationSite(file, line);
+    if (site == NULL || !ReserveTrackedBlock()) {
+        pthread_mutex_unlock(&tracker.lock);
+        return NULL;
+    }
+
+    // The old block is removed before realloc releases it (the table may have moved while making room),
+    // and put back if realloc fails, since the pointer is then still allocated
+    struct TrackedBlock oldBlock = { NULL };
+    block = pointer != NULL ? FindTrackedBlock(pointer) : NULL;
+    if (block != NULL) {
+        oldBlock = *block;
+        RemoveTrackedBlock(block);
+    }
+
+    void* newPointer = realloc(pointer, size);
+    if (newPointer != NULL)
+        AddTrackedBlock(newPointer, size, site, budget);
+    else if (oldBlock.pointer != NULL)
+        InsertTrackedBlock(oldBlock);
+
+    pthread_mutex_unlock(&tracker.lock);
+    return newPointer;
+}
+
+void TrackingRelease (void* pointer, void* userData) {
+    if (pointer == NULL)
+        return;
+
+    pthread_mutex_lock(&tracker.lock);
+    struct TrackedBlock* block = FindTrackedBlock(pointer);
+    if (block != NULL)
+        RemoveTrackedBlock(block);
+    pthread_mutex_unlock(&tracker.lock);
+
+    free(pointer);
+}
+
+void StartMemoryBudget(struct MemoryBudget* budget) {
+    *budget = (struct MemoryBudget) { 0 };
+    currentBudget = budget;
+}
+
+void EndMemoryBudget(struct MemoryBudget* budget) {
+    if (currentBudget == budget)
+        currentBudget = NULL;
+
+    // The blocks the run didn't release (given to the next runs or leaked) are charged to the process from now on
+    pthread_mutex_lock(&tracker.lock);
+    for (size_t i = 0; budget->liveBytes > 0 && i < tracker.blockCapacity; i++) {
+        if (tracker.blocks[i].pointer != NULL && tracker.blocks[i].budget == budget) {
+            budget->liveBytes -= tracker.blocks[i].size;
+            processBudget.liveBytes += tracker.blocks[i].size;
+            tracker.blocks[i].budget = &processBudget;
+        }
+    }
+    pthread_mutex_unlock(&tracker.lock);
+}
+
+struct MemoryBudget* GetMemoryBudget() {
+    return currentBudget;
+}
+
+void SetMemoryBudget(struct MemoryBudget* budget) {
+    currentBudget = budget;
+}
+
+int PrintMemoryLimitError(FILE* output, const struct MemoryBudget* budget) {
+    if (budget == NULL)
+        budget = &processBudget;
+    if (!budget->exceeded)
+        return 0;
+
+    fprintf(output, "Memory limit of %zu bytes exceeded : %zu more bytes asked at %s:%d\n",
+        tracker.memoryLimit, budget->exceededSize, budget->exceededFile, budget->exceededLine);
+    return 1;
+}
+
+void EnableAllocationTracking(size_t memoryLimit) {
+    tracker.memoryLimit = memoryLimit;
+    trackingEnabled = 1;
+
+    struct Allocator trackingAllocator = { TrackingAllocate, TrackingReallocate, TrackingRelease, NULL };
+    SetAllocator(&trackingAllocator);
+}
+
+int IsAllocationTracking() {
+    return trackingEnabled;
+}
+
+void GetAllocationStats(size_t* outLiveBytes, size_t* outPeakBytes) {
+    pthread_mutex_lock(&tracker.lock);
+    *outLiveBytes = tracker.liveBytes;
+    *outPeakBytes = tracker.peakBytes;
+    pthread_mutex_unlock(&tracker.lock);
+}
+
+int ParseMemorySize(const char* text, size_t* outSize) {
+    char* end;
+    unsigned long long size = strtoull(text, &end, 10);
+    if (end == text || text[0] == '-')
+        return 0;
+
+    int shift = 0;
+    if (*end == 'k' || *end == 'K')
+        shift = 10;
+    else if (*end == 'm' || *end == 'M')
+        shift = 20;
+    else if (*end == 'g' || *end == 'G')
+        shift = 30;
+    if (shift != 0)
+        end++;
+
+    if (*end != '\0' || size > (SIZE_MAX >> shift))
+        return 0;
+
+    *outSize = (size_t) size << shift;
+    return 1;
+}
@@ -0,0 +1,96 @@
+#ifndef __ALLOCATOR_H__
+#define __ALLOCATOR_H__
+
+#include <stddef.h>
+#include <stdio.h>
+
+// The interpreter, the utils and the optimizer allocate their memory with the macros below instead of malloc and free,
+// so that the functions doing the allocations can be replaced (SetAllocator). Each allocation gives the place in the code
+// (file and line) that asked for it.
+// Memory allocated by the C library (before the allocator was replaced for instance) can be released with UfcFree too,
+// so an allocator must release with free the pointers that it didn't allocate.
+
+// Functions doing the allocations
+struct Allocator {
+    // Allocates size bytes aligned on alignment bytes (0 for the alignment of malloc), returns NULL if it failed
+    void* (*allocate)(size_t size, size_t alignment, const char* file, int line, void* userData);
+    // Same as realloc (the pointer can be NULL), returns NULL if it failed and then the pointer is still allocated
+    void* (*reallocate)(void* pointer, size_t size, const char* file, int line, void* userData);
+    // Same as free (the pointer can be NULL)
+    void (*release)(void* pointer, void* userData);
+
+    void* userData;
+};
+
+// Replaces the functions doing the allocations, NULL goes back to the ones of the C library
+// Must be called before any program is run
+void SetAllocator(const struct Allocator* allocator);
+
+void* UfcAllocate(size_t size, size_t alignment, const char* file, int line);
+void* UfcAllocateZeroed(size_t count, size_t size, const char* file, int line);
+void* UfcReallocate(void* pointer, size_t size, const char* file, int line);
+char* UfcDuplicate(const char* string, const char* file, int line);
+void UfcRelease(void* pointer);
+
+#define UfcMalloc(size) UfcAllocate(size, 0, __FILE__, __LINE__)
+#define UfcCalloc(count, size) UfcAllocateZeroed(count, size, __FILE__, __LINE__)
+#define UfcRealloc(pointer, size) UfcReallocate(pointer, size, __FILE__, __LINE__)
+#define UfcAlignedAlloc(alignment, size) UfcAllocate(size, alignment, __FILE__, __LINE__)
+#define UfcStrdup(string) UfcDuplicate(string, __FILE__, __LINE__)
+#define UfcFree(pointer) UfcRelease(pointer)
+
+/*************************** Tracking allocator ***************************/
+
+// Exit code of the program when the memory allocated outside of the runs of the batch and table modes went over the limit
+#define MEMORY_LIMIT_EXIT_CODE 3
+
+// Number of places in the code shown by the reports, the ones holding the most memory first
+#define ALLOCATION_REPORT_SITES 20
+
+// Replaces the allocator by one counting the bytes in use (live), their peak and the bytes in use for each place in the code that
+// allocated them. The bytes are also counted in the budget of the run that allocated them, and an allocation that would make
+// the bytes of its budget go over memoryLimit (0 for no limit) fails (returns NULL), so that only that run stops with an error.
+void EnableAllocationTracking(size_t memoryLimit);
+
+// Memory of a run (a script of the batch mode, a row of the table mode) : each one has the whole limit for itself.
+// The memory allocated outside of the runs (the single program of the other modes, the code and the definitions shared by the rows)
+// has a budget of its own.
+struct MemoryBudget {
+    // Bytes allocated by the run and not released yet
+    size_t liveBytes;
+
+    // Set by the first allocation that went over the limit, with its size and its place in the code
+    int exceeded;
+    size_t exceededSize;
+    const char* exceededFile;
+    int exceededLine;
+};
+
+// Charges the allocations of the calling thread to the budget until EndMemoryBudget
+void StartMemoryBudget(struct MemoryBudget* budget);
+
+// Stops charging the budget, the memory of the run still in use is charged to the process from then on
+void EndMemoryBudget(struct MemoryBudget* budget);
+
+// Budget charged by the calling thread (NULL outside of the runs), to give it to a thread running a part of the same run,
+// or back to a green thread when it is resumed
+struct MemoryBudget* GetMemoryBudget();
+void SetMemoryBudget(struct MemoryBudget* budget);
+
+// Writes to output the allocation that went over the limit of the budget (NULL for the one of the process)
+// Returns 1 if the budget went over the limit, 0 otherwise
+int PrintMemoryLimitError(FILE* output, const struct MemoryBudget* budget);
+
+int IsAllocationTracking();
+
+// Writes the bytes in use and their peak since the tracking was enabled
+void GetAllocationStats(size_t* outLiveBytes, size_t* outPeakBytes);
+
+// Reads a number of bytes with an optional k, M or G suffix (1024 based)
+// Returns 1 if it is valid, 0 otherwise
+int ParseMemorySize(const char* text, size_t* outSize);
+
+// Writes the bytes in use and their peak, and the places in the code that still hold memory (the leaks when the program ended)
+void PrintAllocationReport(FILE* output);
+
+#endif
@@ -1,16 +1,22 @@
 #include <stdlib.h>
 #include "ComparisonDictionnary.h"
+#include "Allocator.h"
 
 // Creates a new dictionnary
 // Return 1 if it was created successfully, 0 otherwise
 int CreateComparisonsDict(struct Comparisons_Dict** outDict) {
-    *outDict = malloc(sizeof(struct Comparisons_Dict));
+    *outDict = UfcMalloc(sizeof(struct Comparisons_Dict));
 
     if (*outDict==NULL) {
         printf("Unable to allocate memory for the dictionnary\n");
         return 0;
     }
 
+    // The first element is an empty head, it holds no comparison
+    (*outDict)->key = 0;
+    (*outDict)->value = NULL;
+    (*outDict)->next = NULL;
+
     return 1;
 }
 
@@ -22,9 +28,9 @@ void FreeComparisonsDict(struct Comparisons_Dict *dict) {
     FreeComparisonsDict(dict->next);
     
     if (dict->value!=NULL)
-        free(dict->value);
+        UfcFree(dict->value);
 
-    free(dict);
+    UfcFree(dict);
 }
 
 // Tries to find the element in the dictionnary and returns 1 if found, 0 otherwise
@@ -39,8 +45,9 @@ int TryFind_ComparisonsDict(struct Comparisons_Dict *dict, int key, struct Compa
     struct Comparisons_Dict *ptr;
 
     for (ptr = dict; ptr != NULL; ptr = ptr->next) {
-        if (ptr->key==key) {
-            *out = ptr->value;
+        if (ptr->value!=NULL && ptr->key==key) {
+            if (out!=NULL)
+                *out = ptr->value;
             return 1;
         }
     }
@@ -62,7 +69,7 @@ int Add_ComparisonsDict(struct Comparisons_Dict **dict, int key, enum Comparator
     }
 
     // Creation of the ComparisonValue element to store in the dictionnary
-    struct ComparisonValue* value = malloc(sizeof(struct ComparisonValue));
+    struct ComparisonValue* value = UfcMalloc(sizeof(struct ComparisonValue));
     if (value==NULL) {
         printf("Unable to allocate memory for the comparison structure in the dictionnary\n");
         return 0;
@@ -73,7 +80,7 @@ int Add_ComparisonsDict(struct Comparisons_Dict **dict, int key, enum Comparator
     value->value2 = value2;
 
     // Creation of the entry in the dictionnary
-    struct Comparisons_Dict *d = malloc(sizeof(struct Comparisons_Dict));
+    struct Comparisons_Dict *d = UfcMalloc(sizeof(struct Comparisons_Dict));
     d->key = key;
     d->value = value;
     d->next = *dict;
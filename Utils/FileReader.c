@@ -0,0 +1,27 @@
+#include <stdlib.h>
+
+#include "FileReader.h"
+
+char* ReadWholeFile (FILE* file, size_t* outLength) {
+    size_t capacity = 1 << 16, length = 0, readCount;
+    char* text = malloc(capacity + 1);
+    if (text==NULL)
+        return NULL;
+
+    while ((readCount = fread(text + length, 1, capacity - length, file)) > 0) {
+        length += readCount;
+        if (length == capacity) {
+            capacity *= 2;
+            char* newText = realloc(text, capacity + 1);
+            if (newText==NULL) {
+                free(text);
+                return NULL;
+            }
+            text = newText;
+        }
+    }
+
+    text[length] = '\0';
+    *outLength = length;
+    return text;
+}
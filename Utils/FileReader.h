@@ -0,0 +1,11 @@
+#ifndef __FILE_READER_H__
+#define __FILE_READER_H__
+
+#include <stdio.h>
+
+// Reads the whole file (a code file, a table or a program given on the standard input) in a '\0' terminated buffer,
+// so that it can be cut or scanned in memory. *outLength doesn't count the '\0'.
+// Returns the buffer (to free), or NULL if there is not enough memory
+char* ReadWholeFile (FILE* file, size_t* outLength);
+
+#endif
@@ -0,0 +1,173 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "GreenThreads.h"
+#include "Allocator.h"
+
+_Thread_local int greenThreadCountdown = 0;
+
+struct GreenThread {
+    ucontext_t context;
+    void* stack; // NULL until the green thread is started, and again once it is done
+    int taskIndex;
+    int done;
+
+    double cpuTime; // of the finished slices
+    double sliceStart;
+    int sliceCount;
+};
+
+struct GreenScheduler {
+    ucontext_t context; // where the green threads come back when they yield or end
+    struct GreenThread* threads;
+    int threadCount;
+    int current;
+
+    GreenThreadTask task;
+    void* userData;
+};
+
+// Scheduler running on the OS thread, NULL outside of RunGreenThreads
+static _Thread_local struct GreenScheduler* currentScheduler = NULL;
+
+double GetThreadCpuTime() {
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+
+    return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+// Start of every green thread, its task is found through the scheduler since makecontext can only give int arguments
+void GreenThreadEntry() {
+    struct GreenScheduler* scheduler = currentScheduler;
+    struct GreenThread* thread = &scheduler->threads[scheduler->current];
+
+    scheduler->task(thread->taskIndex, scheduler->userData);
+
+    // Returning goes back to the scheduler through uc_link
+    thread->done = 1;
+}
+
+// Allocates the stack of a green thread, with a page without access at its bottom so that an overflow crashes instead of writing over the memory
+// Returns 1 if it was started, 0 otherwise
+int StartGreenThread (struct GreenScheduler* scheduler, struct GreenThread* thread) {
+    long pageSize = sysconf(_SC_PAGESIZE);
+
+    void* stack = mmap(NULL, GREEN_THREAD_STACK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+    if (stack == MAP_FAILED) {
+        printf("Unable to allocate the stack of a green thread\n");
+        return 0;
+    }
+    mprotect(stack, pageSize, PROT_NONE);
+
+    if (getcontext(&thread->context) != 0) {
+        printf("Unable to create the context of a green thread\n");
+        munmap(stack, GREEN_THREAD_STACK_SIZE);
+        return 0;
+    }
+    thread->context.uc_stack.ss_sp = stack;
+    thread->context.uc_stack.ss_size = GREEN_THREAD_STACK_SIZE;
+    thread->context.uc_link = &scheduler->context;
+    makecontext(&thread->context, GreenThreadEntry, 0);
+
+    thread->stack = stack;
+    return 1;
+}
+
+int RunGreenThreads (const int* taskIndexes, int taskCount, int timeSlice, GreenThreadTask task, void* userData) {
+    if (currentScheduler != NULL) {
+        printf("Error : The green threads can't start other green threads\n");
+        return 0;
+    }
+
+    struct GreenScheduler scheduler;
+    scheduler.threads = UfcCalloc(taskCount > 0 ? taskCount : 1, sizeof(struct GreenThread));
+    if (scheduler.threads == NULL) {
+        printf("Unable to allocate memory for the green threads\n");
+        return 0;
+    }
+    scheduler.threadCount = taskCount;
+    scheduler.current = -1;
+    scheduler.task = task;
+    scheduler.userData = userData;
+
+    for (int i = 0; i<taskCount; i++)
+        scheduler.threads[i].taskIndex = taskIndexes[i];
+
+    currentScheduler = &scheduler;
+
+    // Round-robin over the green threads that are not done
+    int success = 1;
+    int running = taskCount;
+    while (success && running > 0) {
+        for (int i = 0; success && i<taskCount; i++) {
+            struct GreenThread* thread = &scheduler.threads[i];
+            if (thread->done)
+                continue;
+
+            if (thread->stack == NULL && !StartGreenThread(&scheduler, thread)) {
+                success = 0;
+                break;
+            }
+
+            scheduler.current = i;
+            greenThreadCountdown = timeSlice > 0 ? timeSlice : 1;
+            thread->sliceCount++;
+            thread->sliceStart = GetThreadCpuTime();
+
+            if (swapcontext(&scheduler.context, &thread->context) != 0) {
+                printf("Unable to switch to a green thread\n");
+                success = 0;
+            }
+
+            thread->cpuTime += GetThreadCpuTime() - thread->sliceStart;
+
+            if (thread->done) {
+                munmap(thread->stack, GREEN_THREAD_STACK_SIZE);
+                thread->stack = NULL;
+                running--;
+            }
+        }
+    }
+
+    greenThreadCountdown = 0;
+    currentScheduler = NULL;
+
+    // The green threads left suspended after an error are dropped with their stacks
+    for (int i = 0; i<taskCount; i++) {
+        if (scheduler.threads[i].stack != NULL)
+            munmap(scheduler.threads[i].stack, GREEN_THREAD_STACK_SIZE);
+    }
+    UfcFree(scheduler.threads);
+
+    return success;
+}
+
+void GreenThreadYield () {
+    struct GreenScheduler* scheduler = currentScheduler;
+    if (scheduler == NULL || scheduler->current < 0)
+        return;
+
+    swapcontext(&scheduler->threads[scheduler->current].context, &scheduler->context);
+}
+
+double GetGreenThreadCpuTime () {
+    struct GreenScheduler* scheduler = currentScheduler;
+    if (scheduler == NULL || scheduler->current < 0)
+        return GetThreadCpuTime();
+
+    struct GreenThread* thread = &scheduler->threads[scheduler->current];
+    return thread->cpuTime + GetThreadCpuTime() - thread->sliceStart;
+}
+
+int GetGreenThreadSliceCount () {
+    struct GreenScheduler* scheduler = currentScheduler;
+    if (scheduler == NULL || scheduler->current < 0)
+        return 0;
+
+    return scheduler->threads[scheduler->current].sliceCount;
+}
@@ -0,0 +1,34 @@
+#ifndef __GREEN_THREADS_H__
+#define __GREEN_THREADS_H__
+
+// Size of the stack of each green thread, only the pages really used take memory
+#define GREEN_THREAD_STACK_SIZE (8 * 1024 * 1024)
+
+// Function run by a green thread, taskIndex is one of the indexes given to RunGreenThreads
+typedef void (*GreenThreadTask)(int taskIndex, void* userData);
+
+// Number of checkpoints the running green thread can still go through before giving the processor back
+// 0 when the OS thread is not running a green thread, so that the checkpoints do nothing
+extern _Thread_local int greenThreadCountdown;
+
+// Place where the running green thread can be suspended, used at the points where a program can run for a long time
+// Costs a single test of greenThreadCountdown outside of the green threads
+#define GreenThreadCheckpoint() do { if (greenThreadCountdown > 0 && --greenThreadCountdown == 0) GreenThreadYield(); } while (0)
+
+// Runs the tasks taskIndexes[0] to taskIndexes[taskCount-1] on the calling OS thread, each in its own green thread with its own stack
+// The green threads run in turn (round-robin) : each one runs until it has gone through timeSlice checkpoints or until it is done,
+// then gives the processor to the next one, so that a task that never ends doesn't stop the others
+// Returns 1 if all the tasks were run, 0 otherwise
+int RunGreenThreads (const int* taskIndexes, int taskCount, int timeSlice, GreenThreadTask task, void* userData);
+
+// Suspends the running green thread and goes on with the next one (does nothing outside of the green threads)
+void GreenThreadYield ();
+
+// Processor time (in seconds) used so far by the running green thread, only counting its own slices
+// Outside of the green threads, processor time used by the calling OS thread
+double GetGreenThreadCpuTime ();
+
+// Number of slices the running green thread was given so far (0 outside of the green threads)
+int GetGreenThreadSliceCount ();
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "Hash.h"
 #include "SymbolTableData.h"
+#include "Allocator.h"
 
 // Hash function for char* named djb2
 unsigned long djb2_hash (char *str) {
@@ -20,14 +21,14 @@ unsigned long djb2_hash (char *str) {
 
 // Allocate memory for a new hashtable of size HASH_TABLE_SIZE
 int Create_Hashtable (struct HashStruct** hashtable) {
-    struct HashStruct* hash = malloc(sizeof(struct HashStruct));
+    struct HashStruct* hash = UfcMalloc(sizeof(struct HashStruct));
 
 	if (hash==NULL) {
         printf("Unable to allocate memory for the hash struct\n");
 		return 0;
     }
 
-    hash->table = malloc(sizeof(struct VariableStruct*) * HASH_TABLE_SIZE);
+    hash->table = UfcMalloc(sizeof(struct VariableStruct*) * HASH_TABLE_SIZE);
 
 	if(hash->table== NULL) {
         printf("Unable to allocate memory for the hashtable\n");
@@ -51,9 +52,9 @@ void Free_Hashtable (struct HashStruct* hashtable) {
     for (int i = 0; i<hashtable->size; i++)
         FreeVariableStruct(hashtable->table[i]);
     
-    free(hashtable->table);
+    UfcFree(hashtable->table);
 
-    free(hashtable);
+    UfcFree(hashtable);
 }
 
 // Tries to find an element with the key in the hashtable
@@ -105,3 +106,33 @@ int Add_Hashtable (struct HashStruct* hashtable, char* key, struct VariableStruc
     
     return 1;
 }
+
+// Copies the hashtable and all its elements in a new hashtable stored at *outClone
+// Returns 1 if it was copied successfully, 0 otherwise
+int Clone_Hashtable (struct HashStruct* hashtable, struct HashStruct** outClone) {
+    if (hashtable==NULL || hashtable->table==NULL) {
+        printf("Can't copy a null hashtable\n");
+        return 0;
+    }
+
+    struct HashStruct* clone;
+    if (!Create_Hashtable(&clone))
+        return 0;
+
+    for (int i = 0; i<hashtable->size; i++) {
+        // Copy the chain of the bucket keeping the same order
+        struct VariableStruct** tail = &clone->table[i];
+
+        for (struct VariableStruct* element = hashtable->table[i]; element!=NULL; element = element->nextInHash) {
+            if (!CloneVariableStruct(element, tail)) {
+                Free_Hashtable(clone);
+                return 0;
+            }
+
+            tail = &(*tail)->nextInHash;
+        }
+    }
+
+    *outClone = clone;
+    return 1;
+}
@@ -24,6 +24,10 @@ void Free_Hashtable(struct HashStruct* hashtable);
 // Returns 0 otherwise
 int TryFind_Hashtable (struct HashStruct* hashtable, char* key, struct VariableStruct** foundValue);
 
+// Copies the hashtable and all its elements in a new hashtable stored at *outClone
+// Returns 1 if it was copied successfully, 0 otherwise
+int Clone_Hashtable (struct HashStruct* hashtable, struct HashStruct** outClone);
+
 // This function adds a key/value pair to the table if the key doesn't already exist
 // It returns 1 if the pair was added, 0 if there was an error and 2 if the key already existed in the hashtable
 int Add_Hashtable (struct HashStruct* hashtable, char* key, struct VariableStruct* value);
@@ -0,0 +1,208 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "InputReader.h"
+#include "Allocator.h"
+
+// Block of the input being read, always followed by a '\0' so that strtof stops at its end
+// It only grows beyond INPUT_BLOCK_SIZE to keep the input read since the mark
+static char* inputBlock = NULL;
+static size_t inputCapacity = 0;
+static size_t inputStart = 0; // first byte not read yet
+static size_t inputEnd = 0;
+static int inputEnded = 0;
+
+static int inputMarked = 0;
+static size_t inputMark = 0;
+
+#define IsInputSpace(c) ((c)==' ' || (c)=='\n' || (c)=='\t' || (c)=='\r')
+
+// Moves what is left of the block to its start, then fills the rest of it from the standard input
+// Returns the number of bytes added, 0 at the end of the input
+size_t RefillInput() {
+    if (inputEnded)
+        return 0;
+
+    // The input before the mark or the next word is not needed anymore
+    size_t kept = inputMarked ? inputMark : inputStart;
+    if (kept > 0) {
+        memmove(inputBlock, inputBlock + kept, inputEnd - kept);
+        inputEnd -= kept;
+        inputStart -= kept;
+        inputMark = 0;
+    }
+
+    if (inputBlock==NULL || (inputMarked && inputEnd==inputCapacity)) {
+        size_t newCapacity = inputBlock==NULL ? INPUT_BLOCK_SIZE : 2 * inputCapacity;
+        // The block is shared by all the programs, so it isn't charged to the budget of the one reading it
+        struct MemoryBudget* budget = GetMemoryBudget();
+        SetMemoryBudget(NULL);
+        char* newBlock = UfcRealloc(inputBlock, newCapacity + 1);
+        SetMemoryBudget(budget);
+        if (newBlock==NULL) {
+            fprintf(stderr, "Unable to allocate memory for the standard input\n");
+            return 0;
+        }
+
+        inputBlock = newBlock;
+        inputCapacity = newCapacity;
+    }
+
+    // read gives what is already there instead of waiting for a whole block, so a value is read as soon as its line is given
+    ssize_t count;
+    do {
+        count = read(STDIN_FILENO, inputBlock + inputEnd, inputCapacity - inputEnd);
+    } while (count < 0 && errno == EINTR);
+
+    if (count <= 0) {
+        inputEnded = 1;
+        count = 0;
+    }
+
+    inputEnd += count;
+    inputBlock[inputEnd] = '\0';
+
+    return count;
+}
+
+// Finds the next word of the input, making sure it is whole in the block (a word longer than a block is cut)
+// Returns 1 with the word in inputBlock[*outBegin, *outEnd[, 0 at the end of the input
+int NextInputWord (size_t* outBegin, size_t* outEnd) {
+    while (1) {
+        while (inputStart < inputEnd && IsInputSpace(inputBlock[inputStart]))
+            inputStart++;
+
+        if (inputStart < inputEnd)
+            break;
+        if (RefillInput() == 0)
+            return 0;
+    }
+
+    size_t end = inputStart;
+    while (1) {
+        while (end < inputEnd && !IsInputSpace(inputBlock[end]))
+            end++;
+
+        // Most words end in the block, only the last one of the block must wait for the next one
+        if (end < inputEnd || (inputStart == 0 && inputEnd == inputCapacity))
+            break;
+
+        size_t length = end - inputStart;
+        if (RefillInput() == 0)
+            break;
+        end = inputStart + length;
+    }
+
+    *outBegin = inputStart;
+    *outEnd = end;
+    inputStart = end;
+
+    return 1;
+}
+
+// Returns INPUT_READ if the word inputBlock[begin, end[ is an integer, written in *outValue, INPUT_NOT_A_NUMBER otherwise
+int ParseInputInt (size_t begin, size_t end, int* outValue) {
+    int negative = 0;
+    if (inputBlock[begin]=='-' || inputBlock[begin]=='+') {
+        negative = inputBlock[begin]=='-';
+        begin++;
+    }
+
+    if (begin == end)
+        return INPUT_NOT_A_NUMBER;
+
+    unsigned int value = 0;
+    for (size_t k = begin; k < end; k++) {
+        unsigned int digit = (unsigned char) inputBlock[k] - '0';
+        if (digit > 9)
+            return INPUT_NOT_A_NUMBER;
+        value = 10 * value + digit;
+    }
+
+    *outValue = negative ? (int) -value : (int) value;
+    return INPUT_READ;
+}
+
+int ParseInputFloat (size_t begin, size_t end, float* outValue) {
+    char* parsedEnd;
+    float value = strtof(inputBlock + begin, &parsedEnd);
+    if (parsedEnd != inputBlock + end)
+        return INPUT_NOT_A_NUMBER;
+
+    *outValue = value;
+    return INPUT_READ;
+}
+
+int ReadInputInt (int* outValue) {
+    size_t begin, end;
+    if (!NextInputWord(&begin, &end))
+        return INPUT_END;
+
+    return ParseInputInt(begin, end, outValue);
+}
+
+int ReadInputFloat (float* outValue) {
+    size_t begin, end;
+    if (!NextInputWord(&begin, &end))
+        return INPUT_END;
+
+    return ParseInputFloat(begin, end, outValue);
+}
+
+int ReadInputWord (const char** outWord, int* outLength) {
+    size_t begin, end;
+    if (!NextInputWord(&begin, &end))
+        return INPUT_END;
+
+    *outWord = inputBlock + begin;
+    *outLength = end - begin;
+    return INPUT_READ;
+}
+
+int ReadInputInts (int* values, int count) {
+    size_t begin, end;
+    for (int k = 0; k < count; k++) {
+        if (!NextInputWord(&begin, &end))
+            return k;
+        if (ParseInputInt(begin, end, &values[k]) != INPUT_READ)
+            return INPUT_NOT_A_NUMBER;
+    }
+
+    return count;
+}
+
+int ReadInputFloats (float* values, int count) {
+    size_t begin, end;
+    for (int k = 0; k < count; k++) {
+        if (!NextInputWord(&begin, &end))
+            return k;
+        if (ParseInputFloat(begin, end, &values[k]) != INPUT_READ)
+            return INPUT_NOT_A_NUMBER;
+    }
+
+    return count;
+}
+
+void MarkInput() {
+    inputMarked = 1;
+    inputMark = inputStart;
+}
+
+void RewindInput() {
+    if (!inputMarked)
+        return;
+
+    inputStart = inputMark;
+    inputMarked = 0;
+}
+
+void ReleaseInput() {
+    UfcFree(inputBlock);
+    inputBlock = NULL;
+    inputCapacity = 0;
+    inputStart = 0;
+    inputEnd = 0;
+}
@@ -0,0 +1,34 @@
+#ifndef __INPUT_READER_H__
+#define __INPUT_READER_H__
+
+// Reads the values given to the programs on the standard input (the challengers entering the ring), separated by spaces or line breaks
+// The input is read by blocks of up to INPUT_BLOCK_SIZE bytes, and the values are parsed where they are in the block, without being copied.
+// There is only one input for the whole process, so it must not be read by programs running at the same time.
+
+#define INPUT_BLOCK_SIZE (1 << 20)
+
+// Results of the functions reading a value
+#define INPUT_READ 1
+#define INPUT_END 0
+#define INPUT_NOT_A_NUMBER -1 // the word read is skipped
+
+int ReadInputInt (int* outValue);
+int ReadInputFloat (float* outValue);
+
+// *outWord points to the next word in the block, of length *outLength, and is only valid until the next read
+int ReadInputWord (const char** outWord, int* outLength);
+
+// Fast path to fill a whole team : reads up to count values in one call
+// Returns the number of values read, less than count at the end of the input, or INPUT_NOT_A_NUMBER
+int ReadInputInts (int* values, int count);
+int ReadInputFloats (float* values, int count);
+
+// Remembers the current position of the input, then RewindInput reads it again from there
+// The input read in the meantime is kept in memory, so that two engines can run a program on the same values
+void MarkInput ();
+void RewindInput ();
+
+// Releases the block of the input once no program reads it anymore, so that the leak report doesn't count it
+void ReleaseInput ();
+
+#endif
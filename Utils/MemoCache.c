@@ -0,0 +1,81 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "MemoCache.h"
+#include "Allocator.h"
+
+// Place of the key in the cache, with the same hash function as the hashtables (djb2) on the bytes of the arguments
+unsigned int MemoCacheSlot (struct MemoCache* cache, const int32_t* key) {
+    const unsigned char* bytes = (const unsigned char*) key;
+    unsigned long hash = 5381;
+
+    for (size_t k = 0; k < sizeof(int32_t) * cache->argCount; k++)
+        hash = ((hash << 5) + hash) + bytes[k]; /* hash * 33 + c */
+
+    return hash % MEMO_CACHE_SIZE;
+}
+
+int CreateMemoCache (struct MemoCache** cache, int argCount) {
+    if (cache==NULL || argCount < 0 || argCount > MEMO_MAX_ARGS) {
+        printf("Error : need a pointer to store the MemoCache and at most %d arguments (CreateMemoCache)\n", MEMO_MAX_ARGS);
+        return 0;
+    }
+
+    struct MemoCache* _cache = UfcMalloc(sizeof(struct MemoCache));
+    if (_cache==NULL) {
+        printf("Could not allocate memory for _cache in CreateMemoCache\n");
+        return 0;
+    }
+
+    _cache->argCount = argCount;
+    _cache->hits = 0;
+    _cache->misses = 0;
+    _cache->entries = UfcCalloc(MEMO_CACHE_SIZE, sizeof(struct MemoEntry));
+    // One more value so that the allocation is never empty for functions without arguments
+    _cache->keys = UfcMalloc(sizeof(int32_t) * (MEMO_CACHE_SIZE * argCount + 1));
+
+    if (_cache->entries==NULL || _cache->keys==NULL) {
+        printf("Could not allocate memory for the entries in CreateMemoCache\n");
+        FreeMemoCache(_cache);
+        return 0;
+    }
+
+    for (int k = 0; k < MEMO_CACHE_SIZE; k++)
+        _cache->entries[k].key = _cache->keys + k * argCount;
+
+    *cache = _cache;
+
+    return 1;
+}
+
+void FreeMemoCache (struct MemoCache* cache) {
+    if (cache==NULL)
+        return;
+
+    UfcFree(cache->entries);
+    UfcFree(cache->keys);
+    UfcFree(cache);
+}
+
+int TryFind_MemoCache (struct MemoCache* cache, const int32_t* key, struct MemoEntry** outEntry) {
+    struct MemoEntry* entry = &cache->entries[MemoCacheSlot(cache, key)];
+
+    if (entry->used && !memcmp(entry->key, key, sizeof(int32_t) * cache->argCount)) {
+        cache->hits++;
+        *outEntry = entry;
+        return 1;
+    }
+
+    cache->misses++;
+    return 0;
+}
+
+void Add_MemoCache (struct MemoCache* cache, const int32_t* key, enum VariableType resultType, int i, float f) {
+    struct MemoEntry* entry = &cache->entries[MemoCacheSlot(cache, key)];
+
+    entry->used = 1;
+    memcpy(entry->key, key, sizeof(int32_t) * cache->argCount);
+    entry->resultType = resultType;
+    entry->i = i;
+    entry->f = f;
+}
@@ -0,0 +1,48 @@
+#ifndef __MEMO_CACHE_H__
+#define __MEMO_CACHE_H__
+
+#include <stdint.h>
+
+#include "AST.h"
+
+// Number of results remembered for each function
+#define MEMO_CACHE_SIZE 256
+// Functions with more arguments are not memoized
+#define MEMO_MAX_ARGS 16
+
+// Result of one call of a function, for the arguments in key
+struct MemoEntry {
+    int used;
+    // Values of the arguments (the bits of the floats), argCount of them
+    int32_t* key;
+
+    enum VariableType resultType;
+    int i;
+    float f;
+};
+
+// Bounded cache of the results of a pure function, keyed on the values of its arguments
+// Each key has only one place in the cache (given by its hash), and a new result replaces the one that was there
+struct MemoCache {
+    int argCount;
+    struct MemoEntry* entries;
+    int32_t* keys;
+
+    long hits;
+    long misses;
+};
+
+// Creates an empty cache for a function with argCount arguments
+// Returns 1 if it was created successfully, 0 otherwise
+int CreateMemoCache (struct MemoCache** cache, int argCount);
+
+void FreeMemoCache (struct MemoCache* cache);
+
+// Looks for the result of the call with the arguments in key, and counts a hit or a miss
+// Returns 1 and sets *outEntry if it was found, 0 otherwise
+int TryFind_MemoCache (struct MemoCache* cache, const int32_t* key, struct MemoEntry** outEntry);
+
+// Remembers the result of the call with the arguments in key
+void Add_MemoCache (struct MemoCache* cache, const int32_t* key, enum VariableType resultType, int i, float f);
+
+#endif
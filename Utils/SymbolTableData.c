@@ -3,6 +3,7 @@
 
 #include "SymbolTableData.h"
 #include "Hash.h"
+#include "Allocator.h"
 
 int CreateArgList (struct ArgList** argList)
 {
@@ -11,7 +12,7 @@ int CreateArgList (struct ArgList** argList)
         return 0;
     }
 
-    struct ArgList* _argList = malloc(sizeof(struct ArgList));
+    struct ArgList* _argList = UfcMalloc(sizeof(struct ArgList));
     if (_argList == NULL) {
         printf("Could not allocate memory for _argList in CreateArgList\n");
         return 0;
@@ -31,16 +32,19 @@ int CreateVariableStruct (struct VariableStruct** varStruct)
         return 0;
     }
 
-    struct VariableStruct* _varStruct = malloc(sizeof(struct VariableStruct));
+    struct VariableStruct* _varStruct = UfcMalloc(sizeof(struct VariableStruct));
     if (_varStruct == NULL) {
         printf("Could not allocate memory for _varStruct in CreateVariableStruct\n");
         return 0;
     }
     _varStruct->id = NULL;
     _varStruct->s = NULL;
+    _varStruct->team = NULL;
     _varStruct->argumentsTable = NULL;
     _varStruct->argumentsList = NULL;
     _varStruct->functionBody = NULL;
+    _varStruct->isPure = 0;
+    _varStruct->memoCache = NULL;
     _varStruct->nextInHash = NULL;
 
     *varStruct = _varStruct;
@@ -48,16 +52,84 @@ int CreateVariableStruct (struct VariableStruct** varStruct)
     return 1;
 }
 
+int CreateTeam (struct Team** team, enum VariableType elementType, int size)
+{
+    if (team==NULL) {
+        printf("Error : need a pointer to store the created Team\n");
+        return 0;
+    }
+
+    if (size <= 0 || (elementType!=integer && elementType!=floating)) {
+        printf("Error : a team needs a positive size and integer or floating fighters (CreateTeam)\n");
+        return 0;
+    }
+
+    struct Team* _team = UfcMalloc(sizeof(struct Team));
+    if (_team == NULL) {
+        printf("Could not allocate memory for _team in CreateTeam\n");
+        return 0;
+    }
+    _team->elementType = elementType;
+    _team->size = size;
+    _team->i = NULL;
+    _team->f = NULL;
+
+    // aligned_alloc needs a size multiple of the alignment
+    size_t byteCount = ((sizeof(float) * size + TEAM_ALIGNMENT - 1) / TEAM_ALIGNMENT) * TEAM_ALIGNMENT;
+    void* values = UfcAlignedAlloc(TEAM_ALIGNMENT, byteCount);
+    if (values == NULL) {
+        printf("Could not allocate memory for the values of the team in CreateTeam\n");
+        UfcFree(_team);
+        return 0;
+    }
+    memset(values, 0, byteCount);
+
+    if (elementType==integer)
+        _team->i = values;
+    else
+        _team->f = values;
+
+    *team = _team;
+
+    return 1;
+}
+
+void FreeTeam (struct Team* team) {
+    if (team==NULL)
+        return;
+
+    UfcFree(team->i);
+    UfcFree(team->f);
+    UfcFree(team);
+}
+
+int CloneTeam (struct Team* team, struct Team** outClone) {
+    if (team==NULL || outClone==NULL) {
+        printf("Error : need a Team to copy and a pointer to store the copy (CloneTeam)\n");
+        return 0;
+    }
+
+    if (!CreateTeam(outClone, team->elementType, team->size))
+        return 0;
+
+    if (team->elementType==integer)
+        memcpy((*outClone)->i, team->i, sizeof(int) * team->size);
+    else
+        memcpy((*outClone)->f, team->f, sizeof(float) * team->size);
+
+    return 1;
+}
+
 void FreeArgList(struct ArgList* argList) {
     if (argList==NULL)
         return;
 
     if (argList->id!=NULL)
-        free(argList->id);
+        UfcFree(argList->id);
 
     FreeArgList(argList->next);
 
-    free(argList);
+    UfcFree(argList);
 }
 
 // Free the memory used by a VariableStruct
@@ -68,17 +140,96 @@ void FreeVariableStruct (struct VariableStruct* varStruct) {
     FreeVariableStruct(varStruct->nextInHash);
 
     if (varStruct->s!=NULL)
-        free(varStruct->s);
+        UfcFree(varStruct->s);
     
     if (varStruct->id!=NULL)
-        free(varStruct->id);
+        UfcFree(varStruct->id);
     
+    FreeTeam(varStruct->team);
     FreeArgList(varStruct->argumentsList);
     Free_Hashtable(varStruct->argumentsTable);
+    FreeMemoCache(varStruct->memoCache);
 
     // functionBody will be freed with the ast (to avoid a double free)
 
-    free(varStruct);
+    UfcFree(varStruct);
+}
+
+// Copies the list of arguments in a new list stored at *outClone
+// Returns 1 if it was copied successfully, 0 otherwise
+int CloneArgList (struct ArgList* argList, struct ArgList** outClone) {
+    *outClone = NULL;
+
+    // Pointer to the field where the next copied element is stored
+    struct ArgList** tail = outClone;
+
+    for (struct ArgList* arg = argList; arg!=NULL; arg = arg->next) {
+        if (!CreateArgList(tail)) {
+            FreeArgList(*outClone);
+            *outClone = NULL;
+            return 0;
+        }
+
+        if (arg->id!=NULL && ((*tail)->id = UfcStrdup(arg->id)) == NULL) {
+            printf("Could not allocate memory for the id of the argument in CloneArgList\n");
+            FreeArgList(*outClone);
+            *outClone = NULL;
+            return 0;
+        }
+
+        tail = &(*tail)->next;
+    }
+
+    return 1;
+}
+
+// Copies a single VariableStruct (not the rest of its hashtable chain) in a new VariableStruct stored at *outClone
+// Returns 1 if it was copied successfully, 0 otherwise
+int CloneVariableStruct (struct VariableStruct* varStruct, struct VariableStruct** outClone) {
+    if (varStruct==NULL || outClone==NULL) {
+        printf("Error : need a VariableStruct to copy and a pointer to store the copy (CloneVariableStruct)\n");
+        return 0;
+    }
+
+    struct VariableStruct* clone;
+    if (!CreateVariableStruct(&clone))
+        return 0;
+
+    clone->type = varStruct->type;
+    clone->i = varStruct->i;
+    clone->f = varStruct->f;
+    clone->functionBody = varStruct->functionBody; // The AST is never modified while interpreting, so it can be shared
+    clone->isPure = varStruct->isPure;
+
+    if ((varStruct->id!=NULL && (clone->id = UfcStrdup(varStruct->id)) == NULL)
+        || (varStruct->s!=NULL && (clone->s = UfcStrdup(varStruct->s)) == NULL)) {
+        printf("Could not allocate memory for the strings of the VariableStruct in CloneVariableStruct\n");
+        FreeVariableStruct(clone);
+        return 0;
+    }
+
+    if (varStruct->team!=NULL && !CloneTeam(varStruct->team, &clone->team)) {
+        printf("Could not copy the team %s\n", varStruct->id);
+        FreeVariableStruct(clone);
+        return 0;
+    }
+
+    if ((varStruct->argumentsTable!=NULL && !Clone_Hashtable(varStruct->argumentsTable, &clone->argumentsTable))
+        || !CloneArgList(varStruct->argumentsList, &clone->argumentsList)) {
+        printf("Could not copy the arguments of the function %s\n", varStruct->id);
+        FreeVariableStruct(clone);
+        return 0;
+    }
+
+    // The copy starts with an empty cache of its own, so that copies used by different threads never share one
+    if (varStruct->memoCache!=NULL && !CreateMemoCache(&clone->memoCache, varStruct->memoCache->argCount)) {
+        FreeVariableStruct(clone);
+        return 0;
+    }
+
+    *outClone = clone;
+
+    return 1;
 }
 
 // This function steps through the list of VariableStruct to try and find one with an id matching the key
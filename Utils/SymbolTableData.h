@@ -2,6 +2,19 @@
 #define __SYMBOL_TABLE_DATA_H__
 
 #include "AST.h"
+#include "MemoCache.h"
+
+// Array of fighters all of the same type (integer or floating)
+struct Team {
+    enum VariableType elementType;
+    int size;
+
+    // Only the array matching elementType is allocated, aligned on TEAM_ALIGNMENT bytes for the vectorized kernels
+    int* i;
+    float* f;
+};
+
+#define TEAM_ALIGNMENT 32
 
 struct VariableStruct {
     char* id;
@@ -10,6 +23,8 @@ struct VariableStruct {
     int i;
     float f;
     char* s;
+    // Values of a team fighter (type integerTeam or floatingTeam)
+    struct Team* team;
 
     /******Used to define or call a function******/
 
@@ -19,6 +34,10 @@ struct VariableStruct {
     struct ArgList* argumentsList;
     // Pointer to the body of the function in the AST
     struct AstNode* functionBody;
+    // 1 if the function only uses its arguments and calls pure functions (set by MarkPureFunctions)
+    int isPure;
+    // Results of the previous calls of a pure function, NULL if its calls are not memoized
+    struct MemoCache* memoCache;
 
     /*********************************************/
 
@@ -33,6 +52,16 @@ struct ArgList {
 
 int CreateArgList (struct ArgList** argList);
 
+// Creates a team of size fighters of type elementType (integer or floating), all starting at 0
+// Returns 1 if it was created successfully, 0 otherwise
+int CreateTeam (struct Team** team, enum VariableType elementType, int size);
+
+void FreeTeam (struct Team* team);
+
+// Copies the team and all its values in a new team stored at *outClone
+// Returns 1 if it was copied successfully, 0 otherwise
+int CloneTeam (struct Team* team, struct Team** outClone);
+
 int CreateVariableStruct (struct VariableStruct** varStruct);
 
 // Free the memory used by a VariableStruct
@@ -40,6 +69,15 @@ void FreeVariableStruct (struct VariableStruct* varStruct);
 
 void FreeArgList(struct ArgList* argList);
 
+// Copies the list of arguments in a new list stored at *outClone
+// Returns 1 if it was copied successfully, 0 otherwise
+int CloneArgList (struct ArgList* argList, struct ArgList** outClone);
+
+// Copies a single VariableStruct (not the rest of its hashtable chain) in a new VariableStruct stored at *outClone
+// The arguments table and list of a function are copied too, but the function body is shared with the AST
+// Returns 1 if it was copied successfully, 0 otherwise
+int CloneVariableStruct (struct VariableStruct* varStruct, struct VariableStruct** outClone);
+
 // This function steps through the list of VariableStruct to try and find one with an id matching the key
 // If it found one, *ouVal will point to it and the function will return 1
 // Otherwise the function returns 0
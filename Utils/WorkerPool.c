@@ -0,0 +1,256 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <stdatomic.h>
+
+#include "WorkerPool.h"
+#include "Allocator.h"
+
+// Range of tasks [begin, end[ that a worker still has to run
+struct TaskRange {
+    pthread_mutex_t lock;
+    int begin;
+    int end;
+};
+
+struct WorkerPool {
+    struct TaskRange* ranges;
+    int workerCount;
+
+    WorkerTask task;
+    void* userData;
+};
+
+struct WorkerArgs {
+    struct WorkerPool* pool;
+    int workerIndex;
+};
+
+int GetProcessorCount() {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (int) count : 1;
+}
+
+// Takes the next task at the front of the range of a worker
+// Returns 1 if a task was found, 0 if the range is empty
+int TakeOwnTask (struct TaskRange* range, int* outTask) {
+    int found = 0;
+
+    pthread_mutex_lock(&range->lock);
+    if (range->begin < range->end) {
+        *outTask = range->begin++;
+        found = 1;
+    }
+    pthread_mutex_unlock(&range->lock);
+
+    return found;
+}
+
+// Moves the second half of the biggest range left to the other workers into the (empty) range of the thief
+// Returns 1 if some tasks were stolen, 0 if there is nothing left to steal
+int StealTasks (struct WorkerPool* pool, int thiefIndex) {
+    while (1) {
+        // Find the worker with the most tasks left
+        int victimIndex = -1;
+        int victimSize = 0;
+        for (int i = 0; i<pool->workerCount; i++) {
+            if (i == thiefIndex)
+                continue;
+
+            pthread_mutex_lock(&pool->ranges[i].lock);
+            int size = pool->ranges[i].end - pool->ranges[i].begin;
+            pthread_mutex_unlock(&pool->ranges[i].lock);
+
+            if (size > victimSize) {
+                victimIndex = i;
+                victimSize = size;
+            }
+        }
+
+        if (victimIndex < 0) // Every other worker is done
+            return 0;
+
+        // The range may have shrunk since we looked at it, so the half to steal is computed again under the lock
+        struct TaskRange* victim = &pool->ranges[victimIndex];
+        int stolenBegin, stolenEnd;
+
+        pthread_mutex_lock(&victim->lock);
+        stolenEnd = victim->end;
+        stolenBegin = victim->begin + (victim->end - victim->begin) / 2;
+        victim->end = stolenBegin;
+        pthread_mutex_unlock(&victim->lock);
+
+        if (stolenBegin < stolenEnd) {
+            struct TaskRange* own = &pool->ranges[thiefIndex];
+
+            pthread_mutex_lock(&own->lock);
+            own->begin = stolenBegin;
+            own->end = stolenEnd;
+            pthread_mutex_unlock(&own->lock);
+
+            return 1;
+        }
+        // Otherwise the victim finished its range in the meantime : look for another one
+    }
+}
+
+void* WorkerMain (void* args) {
+    struct WorkerPool* pool = ((struct WorkerArgs*) args)->pool;
+    int workerIndex = ((struct WorkerArgs*) args)->workerIndex;
+
+    int taskIndex;
+    while (1) {
+        if (TakeOwnTask(&pool->ranges[workerIndex], &taskIndex))
+            pool->task(taskIndex, workerIndex, pool->userData);
+        else if (!StealTasks(pool, workerIndex))
+            break;
+    }
+
+    return NULL;
+}
+
+int RunOnWorkerPool(int taskCount, int workerCount, WorkerTask task, void* userData) {
+    if (task == NULL) {
+        printf("A task is needed to run the worker pool\n");
+        return 0;
+    }
+
+    if (taskCount <= 0)
+        return 1;
+
+    if (workerCount <= 0)
+        workerCount = GetProcessorCount();
+    if (workerCount > taskCount)
+        workerCount = taskCount;
+
+    struct WorkerPool pool;
+    pool.workerCount = workerCount;
+    pool.task = task;
+    pool.userData = userData;
+    pool.ranges = UfcMalloc(sizeof(struct TaskRange) * workerCount);
+
+    struct WorkerArgs* args = UfcMalloc(sizeof(struct WorkerArgs) * workerCount);
+    pthread_t* threads = UfcMalloc(sizeof(pthread_t) * workerCount);
+    int* threadStarted = UfcCalloc(workerCount, sizeof(int));
+
+    if (pool.ranges == NULL || args == NULL || threads == NULL || threadStarted == NULL) {
+        printf("Unable to allocate memory for the worker pool\n");
+        UfcFree(pool.ranges);
+        UfcFree(args);
+        UfcFree(threads);
+        UfcFree(threadStarted);
+        return 0;
+    }
+
+    // Each worker starts with a contiguous block of tasks
+    for (int i = 0; i<workerCount; i++) {
+        pthread_mutex_init(&pool.ranges[i].lock, NULL);
+        pool.ranges[i].begin = (int) ((long) taskCount * i / workerCount);
+        pool.ranges[i].end = (int) ((long) taskCount * (i+1) / workerCount);
+
+        args[i].pool = &pool;
+        args[i].workerIndex = i;
+    }
+
+    // The calling thread is the worker 0. If a thread can't be started, its tasks are stolen by the others
+    for (int i = 1; i<workerCount; i++)
+        threadStarted[i] = pthread_create(&threads[i], NULL, WorkerMain, &args[i]) == 0;
+
+    WorkerMain(&args[0]);
+
+    for (int i = 1; i<workerCount; i++) {
+        if (threadStarted[i])
+            pthread_join(threads[i], NULL);
+    }
+
+    for (int i = 0; i<workerCount; i++)
+        pthread_mutex_destroy(&pool.ranges[i].lock);
+
+    UfcFree(pool.ranges);
+    UfcFree(args);
+    UfcFree(threads);
+    UfcFree(threadStarted);
+
+    return 1;
+}
+
+struct OrderedPool {
+    atomic_int nextTask;
+    int taskCount;
+
+    WorkerTask task;
+    void* userData;
+};
+
+struct OrderedWorkerArgs {
+    struct OrderedPool* pool;
+    int workerIndex;
+};
+
+void* OrderedWorkerMain (void* args) {
+    struct OrderedPool* pool = ((struct OrderedWorkerArgs*) args)->pool;
+    int workerIndex = ((struct OrderedWorkerArgs*) args)->workerIndex;
+
+    int taskIndex;
+    while ((taskIndex = atomic_fetch_add(&pool->nextTask, 1)) < pool->taskCount)
+        pool->task(taskIndex, workerIndex, pool->userData);
+
+    return NULL;
+}
+
+int RunOnWorkerPoolInOrder(int taskCount, int workerCount, WorkerTask task, void* userData) {
+    if (task == NULL) {
+        printf("A task is needed to run the worker pool\n");
+        return 0;
+    }
+
+    if (taskCount <= 0)
+        return 1;
+
+    if (workerCount <= 0)
+        workerCount = GetProcessorCount();
+    if (workerCount > taskCount)
+        workerCount = taskCount;
+
+    struct OrderedPool pool;
+    atomic_init(&pool.nextTask, 0);
+    pool.taskCount = taskCount;
+    pool.task = task;
+    pool.userData = userData;
+
+    struct OrderedWorkerArgs* args = UfcMalloc(sizeof(struct OrderedWorkerArgs) * workerCount);
+    pthread_t* threads = UfcMalloc(sizeof(pthread_t) * workerCount);
+    int* threadStarted = UfcCalloc(workerCount, sizeof(int));
+
+    if (args == NULL || threads == NULL || threadStarted == NULL) {
+        printf("Unable to allocate memory for the worker pool\n");
+        UfcFree(args);
+        UfcFree(threads);
+        UfcFree(threadStarted);
+        return 0;
+    }
+
+    for (int i = 0; i<workerCount; i++) {
+        args[i].pool = &pool;
+        args[i].workerIndex = i;
+    }
+
+    // The calling thread is the worker 0
+    for (int i = 1; i<workerCount; i++)
+        threadStarted[i] = pthread_create(&threads[i], NULL, OrderedWorkerMain, &args[i]) == 0;
+
+    OrderedWorkerMain(&args[0]);
+
+    for (int i = 1; i<workerCount; i++) {
+        if (threadStarted[i])
+            pthread_join(threads[i], NULL);
+    }
+
+    UfcFree(args);
+    UfcFree(threads);
+    UfcFree(threadStarted);
+
+    return 1;
+}
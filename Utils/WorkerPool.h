@@ -0,0 +1,22 @@
+#ifndef __WORKER_POOL_H__
+#define __WORKER_POOL_H__
+
+// Function run by the workers for each task
+// taskIndex is in [0, taskCount[ and workerIndex in [0, workerCount[
+typedef void (*WorkerTask)(int taskIndex, int workerIndex, void* userData);
+
+// Returns the number of processors available, used as the default number of workers
+int GetProcessorCount();
+
+// Runs the tasks 0 to taskCount-1 on workerCount threads (workerCount <= 0 means one per processor)
+// Each worker starts with a contiguous range of tasks that it runs in order,
+// and when it has nothing left to do it steals the second half of the biggest range left to another worker
+// Returns 1 if all the tasks were run, 0 otherwise
+int RunOnWorkerPool(int taskCount, int workerCount, WorkerTask task, void* userData);
+
+// Same as RunOnWorkerPool, but the workers all take their next task from a shared counter,
+// so the tasks are started in increasing order and finish roughly in that order.
+// Used when the results of the tasks are consumed in order while the others are still running
+int RunOnWorkerPoolInOrder(int taskCount, int workerCount, WorkerTask task, void* userData);
+
+#endif